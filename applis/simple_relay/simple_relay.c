@@ -0,0 +1,174 @@
+/*
+ * Simple demo of in-network recoding on top of the SWIF-codec API.
+ * See README.TXT.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+
+#include "../../src/swif_api.h"
+#include "../../src/swif_recoder.h"
+
+
+/*
+ * Simulation parameters...
+ * Change as required
+ */
+#define CODEPOINT	SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC
+#define SYMBOL_SIZE	1024		/* symbol size, in bytes */
+#define	EW_SIZE		16		/* encoding window size at the source */
+#define RELAY_SIZE	(2 * EW_SIZE)	/* linear system size at the relay */
+#define REPAIR_PERIOD	2		/* one repair symbol every 2 source symbols on link 1 */
+#define DEFAULT_TOT_SRC	5000		/* default number of source symbols */
+#define DEFAULT_LOSS	0.10		/* default loss rate on each link */
+#define VERBOSITY	0
+
+
+static uint8_t	(*src_symbols_tab)[SYMBOL_SIZE];	/* source symbols, to check decoding */
+static bool*	available_tab;				/* received or decoded at destination */
+static uint32_t	n_decoded;
+static uint32_t	n_corrupted;
+
+
+static bool	lost (double loss_rate)
+{
+	return ((double)rand() / RAND_MAX) < loss_rate;
+}
+
+
+static void	decoded_source_symbol_callback (void*	context,
+						void*	new_symbol_buf,
+						esi_t	esi)
+{
+	if (memcmp(new_symbol_buf, src_symbols_tab[esi], SYMBOL_SIZE) != 0) {
+		n_corrupted++;
+	} else if (!available_tab[esi]) {
+		available_tab[esi] = true;
+		n_decoded++;
+	}
+	free(new_symbol_buf);
+}
+
+
+int
+main (int argc, char* argv[])
+{
+	uint32_t	tot_src = (argc > 1) ? atoi(argv[1]) : DEFAULT_TOT_SRC;
+	double		loss1 = (argc > 2) ? atof(argv[2]) : DEFAULT_LOSS;
+	double		loss2 = (argc > 3) ? atof(argv[3]) : DEFAULT_LOSS;
+	swif_encoder_t*	enc = NULL;
+	swif_recoder_t*	rec = NULL;
+	swif_decoder_t*	dec = NULL;
+	uint8_t		repair_buf[SYMBOL_SIZE];	/* recoded repair symbol, sent on link 2 */
+	uint8_t		coefs_tab[RELAY_SIZE];		/* and its coding coefficients */
+	uint32_t	n_src_recvd = 0;
+	uint32_t	n_relay_repairs = 0;
+	clock_t		relay_clock = 0;
+	int		ret = -1;
+	esi_t		esi;
+
+	if (tot_src == 0 || loss1 < 0 || loss1 >= 1 || loss2 < 0 || loss2 >= 1) {
+		fprintf(stderr, "usage: %s [tot_src [loss_rate_link1 [loss_rate_link2]]]\n", argv[0]);
+		return -1;
+	}
+	src_symbols_tab = calloc(tot_src, SYMBOL_SIZE);
+	available_tab = calloc(tot_src, sizeof(bool));
+	if (src_symbols_tab == NULL || available_tab == NULL) {
+		fprintf(stderr, "Error, no memory (tot_src=%u)\n", tot_src);
+		goto end;
+	}
+	if ((enc = swif_encoder_create(CODEPOINT, VERBOSITY, SYMBOL_SIZE, EW_SIZE)) == NULL ||
+	    (rec = swif_recoder_create(CODEPOINT, VERBOSITY, SYMBOL_SIZE, RELAY_SIZE)) == NULL ||
+	    (dec = swif_decoder_create(CODEPOINT, VERBOSITY, SYMBOL_SIZE, RELAY_SIZE, 2 * RELAY_SIZE)) == NULL) {
+		fprintf(stderr, "Error, codec creation failed\n");
+		goto end;
+	}
+	if (swif_decoder_set_callback_functions(dec, NULL, NULL, &decoded_source_symbol_callback, NULL) != SWIF_STATUS_OK) {
+		fprintf(stderr, "Error, swif_decoder_set_callback_functions() failed\n");
+		goto end;
+	}
+	srand(1);
+	for (esi = 0; esi < tot_src; esi++) {
+		esi_t		first;
+		uint32_t	nb_coefs;
+		clock_t		t0;
+
+		for (uint32_t i = 0; i < SYMBOL_SIZE; i++) {
+			src_symbols_tab[esi][i] = (uint8_t)rand();
+		}
+		/* source: a source symbol, and periodically a repair symbol */
+		swif_encoder_add_source_symbol_to_coding_window(enc, src_symbols_tab[esi], esi);
+		if (!lost(loss1)) {
+			/* relay: forward it, and remember it */
+			t0 = clock();
+			swif_recoder_add_source_symbol(rec, src_symbols_tab[esi], esi);
+			relay_clock += clock() - t0;
+			if (!lost(loss2)) {
+				/* destination */
+				n_src_recvd++;
+				available_tab[esi] = true;
+				swif_decoder_decode_with_new_source_symbol(dec, src_symbols_tab[esi], esi);
+			}
+		}
+		if (esi % REPAIR_PERIOD == REPAIR_PERIOD - 1) {
+			void*		up_buf = NULL;
+			void*		up_coefs;
+			esi_t		last;
+			uint32_t	nss;
+
+			swif_encoder_generate_coding_coefs(enc, esi, 0);
+			if (swif_build_repair_symbol(enc, &up_buf) != SWIF_STATUS_OK) {
+				fprintf(stderr, "Error, swif_build_repair_symbol() failed\n");
+				goto end;
+			}
+			swif_encoder_get_coding_window_information(enc, &first, &last, &nss);
+			swif_encoder_get_coding_coefs_tab(enc, &up_coefs, &nb_coefs);
+			if (!lost(loss1)) {
+				/* relay: the upstream repair symbol is not forwarded */
+				t0 = clock();
+				swif_recoder_add_repair_symbol(rec, up_buf, first, up_coefs, nb_coefs);
+				relay_clock += clock() - t0;
+			}
+			free(up_buf);
+		}
+		/* relay: a new repair symbol for link 2, written in place */
+		t0 = clock();
+		if (swif_recoder_build_repair_symbol(rec, esi, repair_buf, coefs_tab, &first, &nb_coefs) != SWIF_STATUS_OK) {
+			continue;
+		}
+		relay_clock += clock() - t0;
+		n_relay_repairs++;
+		if (!lost(loss2)) {
+			/* destination: the coefficients come with the repair symbol */
+			swif_decoder_reset_coding_window(dec);
+			for (esi_t i = first; i < first + nb_coefs; i++) {
+				swif_decoder_add_source_symbol_to_coding_window(dec, i);
+			}
+			swif_decoder_set_coding_coefs_tab(dec, coefs_tab, nb_coefs);
+			swif_decoder_decode_with_new_repair_symbol(dec, repair_buf, first);
+		}
+	}
+	printf("%u source symbols, loss rates %.2f (link 1) and %.2f (link 2)\n", tot_src, loss1, loss2);
+	printf("relay: %u repair symbols recoded, %.1f us per source symbol\n", n_relay_repairs,
+		1e6 * (double)relay_clock / CLOCKS_PER_SEC / tot_src);
+	printf("destination: %u source symbols available: %u received, %u decoded, %u corrupted\n",
+		n_src_recvd + n_decoded, n_src_recvd, n_decoded, n_corrupted);
+	ret = (n_corrupted == 0) ? 0 : -1;
+
+end:
+	if (enc) {
+		swif_encoder_release(enc);
+	}
+	if (rec) {
+		swif_recoder_release(rec);
+	}
+	if (dec) {
+		swif_decoder_release(dec);
+	}
+	free(src_symbols_tab);
+	free(available_tab);
+	return ret;
+}
@@ -0,0 +1,465 @@
+/*
+ * Throughput benchmark of the SWIF-codec: encoder -> loss channel ->
+ * decoder, in a single process, over a sweep of parameters.
+ * See README.TXT.
+ */
+
+#define _GNU_SOURCE	/* getopt(), strdup(), clock_gettime() */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../src/swif_api.h"
+#include "../src/swif_channel.h"
+
+
+/*
+ * Default sweep, see usage()
+ */
+#define DEFAULT_CODECS		"gf256"
+#define DEFAULT_SIZES		"64,256,1024,1400,4096"
+#define DEFAULT_WINDOWS		"8,32,128"
+#define DEFAULT_DENSITIES	"-1"
+#define DEFAULT_LOSSES		"0.01,0.05,0.1"
+#define DEFAULT_REPAIR_RATIO	0.2	/* repair symbols per source symbol */
+#define DEFAULT_NB_SOURCE	20000	/* source symbols per configuration */
+#define LS_FACTOR		4	/* max_linear_system_size / max_coding_window_size */
+#define MAX_LIST		32
+
+
+/* one point of the sweep */
+typedef struct {
+	swif_codepoint_t	codepoint;
+	const char*		codec_name;
+	uint32_t		symbol_size;
+	uint32_t		window_size;
+	int32_t			dt;		/* -1: codec default */
+	double			loss;
+	double			repair_ratio;
+	uint32_t		nb_source;
+	bool			check;
+} bench_config_t;
+
+/* and its results */
+typedef struct {
+	uint32_t	nb_repair;	/* built */
+	uint32_t	nb_lost;	/* source symbols lost */
+	uint32_t	nb_recovered;	/* and decoded */
+	uint32_t	nb_bad;		/* decoded but corrupted (with -x) */
+	uint64_t	encode_ns;
+	uint64_t	decode_ns;
+} bench_result_t;
+
+
+static const struct {
+	const char*		name;
+	swif_codepoint_t	codepoint;
+} codec_tab[] = {
+	{ "gf256",	SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC },
+	{ "gf16",	SWIF_CODEPOINT_RLC_GF_16_CODEC },
+	{ "gf2",	SWIF_CODEPOINT_RLC_GF_2_CODEC },
+};
+
+
+/* decoder side buffers, by esi, and results of the current configuration */
+static uint8_t*		decoded_tab;
+static uint32_t		nb_bufs;
+static const bench_config_t*	cur_config;
+static bench_result_t*	cur_result;
+
+
+/* CPU time of this thread: preemptions and page faults of other processes
+ * are not charged to the codec calls being timed */
+static inline uint64_t	now_ns (void)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+
+/* xorshift64*: a fast, deterministic PRNG for the payloads */
+static inline uint64_t	bench_rand (uint64_t*	state)
+{
+	uint64_t	x = *state;
+
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	*state = x;
+	return x * 0x2545F4914F6CDD1DULL;
+}
+
+/* content of a source symbol, a function of its esi */
+static void	fill_source (uint8_t*	buf,
+			     uint32_t	size,
+			     esi_t	esi)
+{
+	uint64_t	state = 0x9E3779B97F4A7C15ULL ^ ((uint64_t)esi << 1 | 1);
+	uint32_t	i = 0;
+
+	for (; i + 8 <= size; i += 8) {
+		uint64_t x = bench_rand(&state);
+		memcpy(buf + i, &x, 8);
+	}
+	for (; i < size; i++) {
+		buf[i] = (uint8_t)bench_rand(&state);
+	}
+}
+
+
+static void*	decodable_source_symbol_callback (void*	context,
+						  esi_t	esi)
+{
+	return decoded_tab + (size_t)(esi % nb_bufs) * cur_config->symbol_size;
+}
+
+static void	decoded_source_symbol_callback (void*	context,
+						void*	new_symbol_buf,
+						esi_t	esi)
+{
+	cur_result->nb_recovered++;
+	if (cur_config->check) {
+		uint8_t	ref[cur_config->symbol_size];
+
+		fill_source(ref, cur_config->symbol_size, esi);
+		if (memcmp(ref, new_symbol_buf, cur_config->symbol_size) != 0) {
+			cur_result->nb_bad++;
+		}
+	}
+}
+
+
+static int	run_config (const bench_config_t*	c,
+			    bench_result_t*		r)
+{
+	uint32_t	ls_size = LS_FACTOR * c->window_size;
+	swif_encoder_t*	enc = NULL;
+	swif_decoder_t*	dec = NULL;
+	uint8_t*	src_tab = NULL;		/* source symbols, by esi */
+	uint8_t*	repair_buf = NULL;
+	swif_channel_params_t	channel_params = { .model = SWIF_CHANNEL_BERNOULLI, .loss_rate = c->loss };
+	swif_channel_t*	channel = NULL;
+	double		credit = 0;
+	uint64_t	t0;
+	int		ret = -1;
+
+	memset(r, 0, sizeof(*r));
+	cur_config = c;
+	cur_result = r;
+	/* the encoder keeps the last window_size source symbols, the
+	 * decoder may decode any of the last ls_size ones */
+	nb_bufs = 2 * ls_size;
+	src_tab = malloc((size_t)nb_bufs * c->symbol_size);
+	decoded_tab = malloc((size_t)nb_bufs * c->symbol_size);
+	repair_buf = malloc(c->symbol_size);
+	if (src_tab == NULL || decoded_tab == NULL || repair_buf == NULL) {
+		fprintf(stderr, "Error, no memory\n");
+		goto end;
+	}
+	if ((channel = swif_channel_create(&channel_params, 1)) == NULL) {
+		goto end;
+	}
+	if ((enc = swif_encoder_create(c->codepoint, 0, c->symbol_size, c->window_size)) == NULL ||
+	    (dec = swif_decoder_create(c->codepoint, 0, c->symbol_size, c->window_size, ls_size)) == NULL) {
+		fprintf(stderr, "Error, codec creation failed\n");
+		goto end;
+	}
+	if (c->dt >= 0) {
+		uint32_t	dt = (uint32_t)c->dt;
+
+		if (swif_encoder_set_parameters(enc, swif_ENCODER_SET_PARAM_RLC_DENSITY_THRESHOLD, sizeof(dt), &dt) != SWIF_STATUS_OK ||
+		    swif_decoder_set_parameters(dec, swif_DECODER_SET_PARAM_RLC_DENSITY_THRESHOLD, sizeof(dt), &dt) != SWIF_STATUS_OK) {
+			fprintf(stderr, "Error, bad density threshold %d\n", c->dt);
+			goto end;
+		}
+	}
+	if (swif_decoder_set_callback_functions(dec, NULL, decodable_source_symbol_callback,
+						decoded_source_symbol_callback, NULL) != SWIF_STATUS_OK) {
+		fprintf(stderr, "Error, swif_decoder_set_callback_functions() failed\n");
+		goto end;
+	}
+	for (esi_t esi = 0; esi < c->nb_source; esi++) {
+		uint8_t*	src = src_tab + (size_t)(esi % nb_bufs) * c->symbol_size;
+
+		fill_source(src, c->symbol_size, esi);
+		t0 = now_ns();
+		swif_encoder_add_source_symbol_to_coding_window(enc, src, esi);
+		r->encode_ns += now_ns() - t0;
+		if (swif_channel_is_lost(channel)) {
+			r->nb_lost++;
+		} else {
+			t0 = now_ns();
+			swif_decoder_decode_with_new_source_symbol(dec, src, esi);
+			r->decode_ns += now_ns() - t0;
+		}
+		for (credit += c->repair_ratio; credit >= 1; credit -= 1) {
+			void*		buf = repair_buf;
+			esi_t		first, last;
+			uint32_t	nss;
+			uint32_t	key = r->nb_repair;
+
+			t0 = now_ns();
+			swif_encoder_generate_coding_coefs(enc, key, 0);
+			swif_build_repair_symbol(enc, &buf);
+			r->encode_ns += now_ns() - t0;
+			r->nb_repair++;
+			swif_encoder_get_coding_window_information(enc, &first, &last, &nss);
+			if (swif_channel_is_lost(channel)) {
+				continue;
+			}
+			/* the repair packet carries first, nss and key */
+			t0 = now_ns();
+			swif_decoder_reset_coding_window(dec);
+			for (esi_t i = first; i < first + nss; i++) {
+				swif_decoder_add_source_symbol_to_coding_window(dec, i);
+			}
+			swif_decoder_generate_coding_coefs(dec, key, 0);
+			swif_decoder_decode_with_new_repair_symbol(dec, repair_buf, first);
+			r->decode_ns += now_ns() - t0;
+		}
+	}
+	ret = 0;
+
+end:
+	if (enc) {
+		swif_encoder_release(enc);
+	}
+	if (dec) {
+		swif_decoder_release(dec);
+	}
+	swif_channel_release(channel);
+	free(src_tab);
+	free(decoded_tab);
+	free(repair_buf);
+	decoded_tab = NULL;
+	return ret;
+}
+
+
+/*
+ * Output
+ */
+
+typedef enum { FORMAT_CSV, FORMAT_JSON } bench_format_t;
+
+static void	print_result (FILE*			out,
+			      bench_format_t		format,
+			      bool			first,
+			      const bench_config_t*	c,
+			      const bench_result_t*	r)
+{
+	double	mbytes = (double)c->nb_source * c->symbol_size / 1e6;
+	double	encode_mbps = (r->encode_ns > 0) ? mbytes / (r->encode_ns * 1e-9) : 0;
+	double	decode_mbps = (r->decode_ns > 0) ? mbytes / (r->decode_ns * 1e-9) : 0;
+	double	repairs_per_s = (r->encode_ns > 0) ? r->nb_repair / (r->encode_ns * 1e-9) : 0;
+	double	ns_per_recovered = (r->nb_recovered > 0) ? (double)r->decode_ns / r->nb_recovered : 0;
+	double	residual_loss = (double)(r->nb_lost > r->nb_recovered ? r->nb_lost - r->nb_recovered : 0) / c->nb_source;
+
+	if (format == FORMAT_CSV) {
+		if (first) {
+			fprintf(out, "codec,symbol_size,window_size,dt,loss,repair_ratio,nb_source,nb_repair,"
+				"nb_lost,nb_recovered,nb_bad,residual_loss,encode_MBps,decode_MBps,"
+				"repairs_per_s,decode_ns_per_recovered\n");
+		}
+		fprintf(out, "%s,%u,%u,%d,%g,%g,%u,%u,%u,%u,%u,%g,%.1f,%.1f,%.0f,%.0f\n",
+			c->codec_name, c->symbol_size, c->window_size, c->dt, c->loss, c->repair_ratio,
+			c->nb_source, r->nb_repair, r->nb_lost, r->nb_recovered, r->nb_bad, residual_loss,
+			encode_mbps, decode_mbps, repairs_per_s, ns_per_recovered);
+	} else {
+		fprintf(out, "%s\n  {\"codec\": \"%s\", \"symbol_size\": %u, \"window_size\": %u, \"dt\": %d, "
+			"\"loss\": %g, \"repair_ratio\": %g, \"nb_source\": %u, \"nb_repair\": %u, "
+			"\"nb_lost\": %u, \"nb_recovered\": %u, \"nb_bad\": %u, \"residual_loss\": %g, "
+			"\"encode_MBps\": %.1f, \"decode_MBps\": %.1f, \"repairs_per_s\": %.0f, "
+			"\"decode_ns_per_recovered\": %.0f}",
+			first ? "[" : ",", c->codec_name, c->symbol_size, c->window_size, c->dt,
+			c->loss, c->repair_ratio, c->nb_source, r->nb_repair, r->nb_lost,
+			r->nb_recovered, r->nb_bad, residual_loss, encode_mbps, decode_mbps,
+			repairs_per_s, ns_per_recovered);
+	}
+	fflush(out);
+}
+
+
+/*
+ * Command line
+ */
+
+static void	usage (const char*	name)
+{
+	fprintf(stderr,
+		"usage: %s [options]\n"
+		"  -c codecs       comma-separated list of gf256, gf16, gf2 (default %s)\n"
+		"  -s sizes        symbol sizes, in bytes (default %s)\n"
+		"  -w windows      max_coding_window_size values (default %s)\n"
+		"  -d densities    density thresholds dt in [0; 15], -1 for the codec default (default %s)\n"
+		"  -l losses       loss rates of the channel, in [0; 1[ (default %s)\n"
+		"  -r ratio        repair symbols per source symbol (default %g)\n"
+		"  -n nb_source    source symbols per configuration (default %u)\n"
+		"  -f csv|json     output format (default csv)\n"
+		"  -o file         output file (default stdout)\n"
+		"  -x              check the decoded symbols (slower decoding)\n",
+		name, DEFAULT_CODECS, DEFAULT_SIZES, DEFAULT_WINDOWS, DEFAULT_DENSITIES,
+		DEFAULT_LOSSES, DEFAULT_REPAIR_RATIO, DEFAULT_NB_SOURCE);
+}
+
+/* parse a comma-separated list of numbers, return the number of values or -1 */
+static int	parse_list (const char*	arg,
+			    double*	tab)
+{
+	char*	s = strdup(arg);
+	char*	save = NULL;
+	int	n = 0;
+
+	for (char* tok = strtok_r(s, ",", &save); tok != NULL; tok = strtok_r(NULL, ",", &save)) {
+		char*	end;
+
+		if (n == MAX_LIST) {
+			n = -1;
+			break;
+		}
+		tab[n] = strtod(tok, &end);
+		if (*end != '\0' || end == tok) {
+			n = -1;
+			break;
+		}
+		n++;
+	}
+	free(s);
+	return n;
+}
+
+static int	parse_codecs (const char*	arg,
+			      uint32_t*		tab)
+{
+	char*	s = strdup(arg);
+	char*	save = NULL;
+	int	n = 0;
+
+	for (char* tok = strtok_r(s, ",", &save); tok != NULL && n >= 0; tok = strtok_r(NULL, ",", &save)) {
+		uint32_t	i;
+
+		for (i = 0; i < sizeof(codec_tab) / sizeof(codec_tab[0]); i++) {
+			if (strcmp(tok, codec_tab[i].name) == 0) {
+				break;
+			}
+		}
+		if (i == sizeof(codec_tab) / sizeof(codec_tab[0]) || n == MAX_LIST) {
+			n = -1;
+		} else {
+			tab[n++] = i;
+		}
+	}
+	free(s);
+	return n;
+}
+
+
+int
+main (int argc, char* argv[])
+{
+	const char*	codecs = DEFAULT_CODECS;
+	const char*	sizes = DEFAULT_SIZES;
+	const char*	windows = DEFAULT_WINDOWS;
+	const char*	densities = DEFAULT_DENSITIES;
+	const char*	losses = DEFAULT_LOSSES;
+	double		repair_ratio = DEFAULT_REPAIR_RATIO;
+	uint32_t	nb_source = DEFAULT_NB_SOURCE;
+	bench_format_t	format = FORMAT_CSV;
+	bool		check = false;
+	FILE*		out = stdout;
+	uint32_t	codec_idx[MAX_LIST];
+	double		size_tab[MAX_LIST], window_tab[MAX_LIST], dt_tab[MAX_LIST], loss_tab[MAX_LIST];
+	int		nb_codecs, nb_sizes, nb_windows, nb_dts, nb_losses;
+	bool		first = true;
+	int		opt;
+	int		ret = 0;
+
+	while ((opt = getopt(argc, argv, "c:s:w:d:l:r:n:f:o:xh")) != -1) {
+		switch (opt) {
+		case 'c': codecs = optarg; break;
+		case 's': sizes = optarg; break;
+		case 'w': windows = optarg; break;
+		case 'd': densities = optarg; break;
+		case 'l': losses = optarg; break;
+		case 'r': repair_ratio = atof(optarg); break;
+		case 'n': nb_source = (uint32_t)atoi(optarg); break;
+		case 'x': check = true; break;
+		case 'f':
+			if (strcmp(optarg, "csv") == 0) {
+				format = FORMAT_CSV;
+			} else if (strcmp(optarg, "json") == 0) {
+				format = FORMAT_JSON;
+			} else {
+				usage(argv[0]);
+				return -1;
+			}
+			break;
+		case 'o':
+			if ((out = fopen(optarg, "w")) == NULL) {
+				fprintf(stderr, "Error, cannot open %s\n", optarg);
+				return -1;
+			}
+			break;
+		default:
+			usage(argv[0]);
+			return -1;
+		}
+	}
+	nb_codecs = parse_codecs(codecs, codec_idx);
+	nb_sizes = parse_list(sizes, size_tab);
+	nb_windows = parse_list(windows, window_tab);
+	nb_dts = parse_list(densities, dt_tab);
+	nb_losses = parse_list(losses, loss_tab);
+	if (nb_codecs <= 0 || nb_sizes <= 0 || nb_windows <= 0 || nb_dts <= 0 || nb_losses <= 0
+	    || repair_ratio < 0 || nb_source == 0) {
+		usage(argv[0]);
+		return -1;
+	}
+	for (int ic = 0; ic < nb_codecs; ic++)
+	for (int is = 0; is < nb_sizes; is++)
+	for (int iw = 0; iw < nb_windows; iw++)
+	for (int id = 0; id < nb_dts; id++)
+	for (int il = 0; il < nb_losses; il++) {
+		bench_config_t	c = {
+			.codepoint = codec_tab[codec_idx[ic]].codepoint,
+			.codec_name = codec_tab[codec_idx[ic]].name,
+			.symbol_size = (uint32_t)size_tab[is],
+			.window_size = (uint32_t)window_tab[iw],
+			.dt = (int32_t)dt_tab[id],
+			.loss = loss_tab[il],
+			.repair_ratio = repair_ratio,
+			.nb_source = nb_source,
+			.check = check
+		};
+		bench_result_t	r;
+
+		if (c.symbol_size == 0 || c.window_size == 0 || c.dt > 15 || c.loss < 0 || c.loss >= 1) {
+			fprintf(stderr, "Error, bad configuration (size %u, window %u, dt %d, loss %g)\n",
+				c.symbol_size, c.window_size, c.dt, c.loss);
+			ret = -1;
+			continue;
+		}
+		if (run_config(&c, &r) != 0) {
+			ret = -1;
+			continue;
+		}
+		print_result(out, format, first, &c, &r);
+		first = false;
+		if (r.nb_bad > 0) {
+			ret = -1;
+		}
+	}
+	if (format == FORMAT_JSON) {
+		fprintf(out, "%s]\n", first ? "[" : "\n");
+	}
+	if (out != stdout) {
+		fclose(out);
+	}
+	return ret;
+}
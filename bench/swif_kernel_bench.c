@@ -0,0 +1,559 @@
+/*
+ * Microbenchmarks of the SWIF-codec kernels: each symbol and finite field
+ * primitive, for each of its variants, over a range of sizes.
+ * See README.TXT.
+ */
+
+#define _GNU_SOURCE	/* getopt(), strdup(), clock_gettime() */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_RDTSC
+#endif
+
+#include "../src/swif_api.h"
+#include "../src/swif_symbol.h"
+#include "../src/swif_linear-code.h"
+#include "../src/swif_coding_coefficients.h"
+#include "../src/swif_prng.h"
+#include "../src/swif_full_symbol.h"
+
+
+#define DEFAULT_SIZES	"16,32,64,128,256,512,1024,1400,1500,2048,4096,8192,16384,32768,65536"
+#define MAX_SIZE	65536
+#define MAX_LIST	32
+#define MIN_BYTES	(8u << 20)	/* processed per measurement */
+#define MIN_CALLS	10		/* per measurement */
+#define NB_REPEAT	3		/* measurements, the best one is kept */
+
+#define COEF_GF256	0x53
+#define COEF_GF16	0x0b
+
+#ifndef MIN
+#define MIN(a,b)	((a) < (b) ? (a) : (b))
+#define MAX(a,b)	((a) > (b) ? (a) : (b))
+#endif
+
+/* full_symbol_add() is in the internal interface of swif_full_symbol.c */
+extern swif_full_symbol_t* full_symbol_add (swif_full_symbol_t *symbol1,
+					    swif_full_symbol_t *symbol2);
+
+
+/* operands: a and b inputs, r result, ref result of the scalar reference */
+static uint8_t*	a;
+static uint8_t*	b;
+static uint8_t*	r;
+static uint8_t*	ref;
+static uint8_t*	cc_tab_tab[TINYMT32_MULTI_LANES];
+static swif_full_symbol_t*	fs_a;
+static swif_full_symbol_t*	fs_b;
+static const symbol_kernels_t*	kernels;	/* of the current size */
+
+
+/*
+ * Kernels: run() performs one call over `size' bytes, available() tells
+ * whether the variant exists for this size, reference() computes in ref
+ * what run() computes in r with the scalar tables of swif_symbol.c and
+ * swif_linear-code.c (or, for check() kernels, checks the result itself).
+ */
+typedef struct {
+	const char*	name;
+	const char*	variant;
+	bool		(*available) (uint32_t size);
+	void		(*prepare) (uint32_t size);
+	void		(*run) (uint32_t size);
+	void		(*reference) (uint32_t size);
+	bool		(*check) (uint32_t size);	/* NULL: compare r and ref */
+} kernel_t;
+
+
+static bool	always (uint32_t size)		{ return true; }
+static bool	aligned_size (uint32_t size)	{ return size % SYMBOL_ALIGNMENT == 0; }
+static bool	fixed_size (uint32_t size)	{ return symbol_get_kernels(size, 0) != NULL; }
+static bool	fixed_aligned_size (uint32_t size)	{ return symbol_get_kernels(size, 1) != NULL; }
+static bool	gf16_fixed_size (uint32_t size)	{ return lc_get_kernels(size, 2, 0) != NULL; }
+
+/* r is an accumulator for the in-place kernels: restart from b */
+static void	reset_r (uint32_t size)		{ memcpy(r, b, size); memcpy(ref, b, size); }
+
+static void	no_prepare (uint32_t size)	{ }
+static void	prepare_fixed (uint32_t size)	{ reset_r(size); kernels = symbol_get_kernels(size, 0); }
+static void	prepare_fixed_aligned (uint32_t size)	{ reset_r(size); kernels = symbol_get_kernels(size, 1); }
+static void	prepare_gf16_fixed (uint32_t size)	{ reset_r(size); kernels = lc_get_kernels(size, 2, 0); }
+
+
+/* symbol_add: r = a + b, or r += a for the in-place variants */
+static void	run_add (uint32_t size)		{ symbol_add(a, b, size, r); }
+static void	run_xor (uint32_t size)		{ symbol_xor(r, a, size); }
+static void	run_xor_aligned (uint32_t size)	{ symbol_xor_aligned(r, a, size); }
+
+static void	ref_add (uint32_t size)
+{
+	for (uint32_t i = 0; i < size; i++) {
+		ref[i] = gf256_add(a[i], b[i]);
+	}
+}
+
+static void	ref_xor (uint32_t size)
+{
+	for (uint32_t i = 0; i < size; i++) {
+		ref[i] = gf256_add(ref[i], a[i]);
+	}
+}
+
+
+/* symbol_add_scaled: r += coef * a */
+static void	run_add_scaled (uint32_t size)	{ symbol_add_scaled(r, COEF_GF256, a, size); }
+static void	run_add_scaled_aligned (uint32_t size)	{ symbol_add_scaled_aligned(r, COEF_GF256, a, size); }
+static void	run_add_scaled_fixed (uint32_t size)	{ kernels->add_mul(COEF_GF256, a, r); }
+static void	run_add_scaled_gf16 (uint32_t size)	{ lc_vector_add_mul(COEF_GF16, a, size, 2, r); }
+static void	run_add_scaled_gf16_aligned (uint32_t size)	{ lc_vector_add_mul_aligned(COEF_GF16, a, size, 2, r); }
+static void	run_add_scaled_gf16_fixed (uint32_t size)	{ kernels->add_mul(COEF_GF16, a, r); }
+
+static void	ref_add_scaled (uint32_t size)
+{
+	for (uint32_t i = 0; i < size; i++) {
+		ref[i] ^= gf256_mul(COEF_GF256, a[i]);
+	}
+}
+
+static inline uint8_t	gf16_mul_byte (uint8_t	coef,
+				       uint8_t	x)
+{
+	return lc_mul(coef, x & 0x0f, 2) | (lc_mul(coef, x >> 4, 2) << 4);
+}
+
+static void	ref_add_scaled_gf16 (uint32_t size)
+{
+	for (uint32_t i = 0; i < size; i++) {
+		ref[i] ^= gf16_mul_byte(COEF_GF16, a[i]);
+	}
+}
+
+
+/* symbol_mul: r = coef * a */
+static void	run_mul (uint32_t size)		{ symbol_mul(a, COEF_GF256, size, r); }
+static void	run_mul_aligned (uint32_t size)	{ symbol_mul_aligned(a, COEF_GF256, size, r); }
+static void	run_mul_fixed (uint32_t size)	{ kernels->mul(COEF_GF256, a, r); }
+static void	run_mul_gf16 (uint32_t size)	{ lc_vector_mul(COEF_GF16, a, size, 2, r); }
+static void	run_mul_gf16_aligned (uint32_t size)	{ lc_vector_mul_aligned(COEF_GF16, a, size, 2, r); }
+static void	run_mul_gf16_fixed (uint32_t size)	{ kernels->mul(COEF_GF16, a, r); }
+
+static void	ref_mul (uint32_t size)
+{
+	for (uint32_t i = 0; i < size; i++) {
+		ref[i] = gf256_mul(COEF_GF256, a[i]);
+	}
+}
+
+static void	ref_mul_gf16 (uint32_t size)
+{
+	for (uint32_t i = 0; i < size; i++) {
+		ref[i] = gf16_mul_byte(COEF_GF16, a[i]);
+	}
+}
+
+
+/* symbol_div: r = a / coef */
+static void	run_div (uint32_t size)		{ symbol_div(a, size, COEF_GF256, r); }
+
+static void	ref_div (uint32_t size)
+{
+	for (uint32_t i = 0; i < size; i++) {
+		ref[i] = gf256_mul(a[i], gf256_inv(COEF_GF256));
+	}
+}
+
+
+/* gf256_inv and gf256_div, one call per element */
+static void	run_inv (uint32_t size)
+{
+	for (uint32_t i = 0; i < size; i++) {
+		r[i] = gf256_inv(a[i]);
+	}
+}
+
+static bool	check_inv (uint32_t size)
+{
+	for (uint32_t i = 0; i < size; i++) {
+		if (gf256_mul(a[i], r[i]) != (a[i] != 0)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static void	run_gf_div (uint32_t size)
+{
+	for (uint32_t i = 0; i < size; i++) {
+		r[i] = gf256_div(a[i], b[i]);
+	}
+}
+
+static bool	check_gf_div (uint32_t size)
+{
+	for (uint32_t i = 0; i < size; i++) {
+		if (b[i] == 0 ? r[i] != 0 : gf256_mul(r[i], b[i]) != a[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/* coding coefficients, GF(256) and full density: `size' coefficients per key */
+static inline uint16_t	cc_nb (uint32_t size)	{ return (uint16_t)MIN(size, 0xffffu); }
+
+static void	run_cc (uint32_t size)
+{
+	swif_rlc_generate_coding_coefficients(1234, r, cc_nb(size), 15, 8);
+}
+
+static void	run_cc_multi (uint32_t size)
+{
+	uint16_t	key_tab[TINYMT32_MULTI_LANES];
+
+	for (uint32_t k = 0; k < TINYMT32_MULTI_LANES; k++) {
+		key_tab[k] = 1234 + k;
+	}
+	swif_rlc_generate_coding_coefficients_multi(key_tab, cc_tab_tab, cc_nb(size),
+						    TINYMT32_MULTI_LANES, 15, 8);
+}
+
+static bool	check_cc (uint32_t size)
+{
+	for (uint32_t i = 0; i < cc_nb(size); i++) {
+		if (r[i] == 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool	check_cc_multi (uint32_t size)
+{
+	for (uint32_t k = 0; k < TINYMT32_MULTI_LANES; k++) {
+		swif_rlc_generate_coding_coefficients(1234 + k, ref, cc_nb(size), 15, 8);
+		if (memcmp(ref, cc_tab_tab[k], cc_nb(size)) != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+
+/* full_symbol_add: a new full symbol, the sum of two others */
+static void	prepare_fs (uint32_t size)
+{
+	uint8_t	coef_tab[2] = { 1, COEF_GF256 };
+
+	if (fs_a != NULL) {
+		full_symbol_free(fs_a);
+		full_symbol_free(fs_b);
+	}
+	fs_a = full_symbol_create(coef_tab, 0, 2, a, size);
+	fs_b = full_symbol_create(coef_tab, 1, 2, b, size);
+}
+
+static void	run_fs_add (uint32_t size)
+{
+	full_symbol_free(full_symbol_add(fs_a, fs_b));
+}
+
+static bool	check_fs_add (uint32_t size)
+{
+	swif_full_symbol_t*	sum = full_symbol_add(fs_a, fs_b);
+	bool			ok;
+
+	full_symbol_get_data(sum, r);
+	ref_add(size);
+	ok = memcmp(r, ref, size) == 0
+	     && full_symbol_get_coef(sum, 0) == 1
+	     && full_symbol_get_coef(sum, 1) == (1 ^ COEF_GF256)
+	     && full_symbol_get_coef(sum, 2) == COEF_GF256;
+	full_symbol_free(sum);
+	return ok;
+}
+
+
+/* bytes processed (written) by one call */
+static uint32_t	call_bytes (const kernel_t*	k,
+			    uint32_t		size)
+{
+	if (k->run == run_cc) {
+		return cc_nb(size);
+	}
+	if (k->run == run_cc_multi) {
+		return cc_nb(size) * TINYMT32_MULTI_LANES;
+	}
+	return size;
+}
+
+
+static const kernel_t	kernel_tab[] = {
+	{ "symbol_add",		"generic",	always,		no_prepare,	run_add,	ref_add,	NULL },
+	{ "symbol_add",		"xor",		always,		reset_r,	run_xor,	ref_xor,	NULL },
+	{ "symbol_add",		"xor_aligned",	aligned_size,	reset_r,	run_xor_aligned, ref_xor,	NULL },
+	{ "symbol_add_scaled",	"generic",	always,		reset_r,	run_add_scaled,	ref_add_scaled,	NULL },
+	{ "symbol_add_scaled",	"aligned",	aligned_size,	reset_r,	run_add_scaled_aligned, ref_add_scaled, NULL },
+	{ "symbol_add_scaled",	"fixed",	fixed_size,	prepare_fixed,	run_add_scaled_fixed, ref_add_scaled, NULL },
+	{ "symbol_add_scaled",	"fixed_aligned", fixed_aligned_size, prepare_fixed_aligned, run_add_scaled_fixed, ref_add_scaled, NULL },
+	{ "symbol_add_scaled",	"gf16",		always,		reset_r,	run_add_scaled_gf16, ref_add_scaled_gf16, NULL },
+	{ "symbol_add_scaled",	"gf16_aligned",	aligned_size,	reset_r,	run_add_scaled_gf16_aligned, ref_add_scaled_gf16, NULL },
+	{ "symbol_add_scaled",	"gf16_fixed",	gf16_fixed_size, prepare_gf16_fixed, run_add_scaled_gf16_fixed, ref_add_scaled_gf16, NULL },
+	{ "symbol_mul",		"generic",	always,		no_prepare,	run_mul,	ref_mul,	NULL },
+	{ "symbol_mul",		"aligned",	aligned_size,	no_prepare,	run_mul_aligned, ref_mul,	NULL },
+	{ "symbol_mul",		"fixed",	fixed_size,	prepare_fixed,	run_mul_fixed,	ref_mul,	NULL },
+	{ "symbol_mul",		"fixed_aligned", fixed_aligned_size, prepare_fixed_aligned, run_mul_fixed, ref_mul, NULL },
+	{ "symbol_mul",		"gf16",		always,		no_prepare,	run_mul_gf16,	ref_mul_gf16,	NULL },
+	{ "symbol_mul",		"gf16_aligned",	aligned_size,	no_prepare,	run_mul_gf16_aligned, ref_mul_gf16, NULL },
+	{ "symbol_mul",		"gf16_fixed",	gf16_fixed_size, prepare_gf16_fixed, run_mul_gf16_fixed, ref_mul_gf16, NULL },
+	{ "symbol_div",		"generic",	always,		no_prepare,	run_div,	ref_div,	NULL },
+	{ "gf256_inv",		"table",	always,		no_prepare,	run_inv,	NULL,		check_inv },
+	{ "gf256_div",		"table",	always,		no_prepare,	run_gf_div,	NULL,		check_gf_div },
+	{ "coding_coefs",	"single",	always,		no_prepare,	run_cc,		NULL,		check_cc },
+	{ "coding_coefs",	"multi",	always,		no_prepare,	run_cc_multi,	NULL,		check_cc_multi },
+	{ "full_symbol_add",	"alloc",	always,		prepare_fs,	run_fs_add,	NULL,		check_fs_add },
+};
+
+#define NB_KERNELS	(sizeof(kernel_tab) / sizeof(kernel_tab[0]))
+
+
+static inline uint64_t	now_ns (void)
+{
+	struct timespec	ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t	now_cycles (void)
+{
+#ifdef HAVE_RDTSC
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+
+/*
+ * Run kernel k over `size' bytes: first once, compared with the
+ * reference, then NB_REPEAT times nb_calls calls, keeping the fastest.
+ */
+static bool	bench_kernel (const kernel_t*	k,
+			      uint32_t		size,
+			      double*		ns_per_call,
+			      double*		cycles_per_call)
+{
+	uint32_t	nb_calls = MAX(MIN_CALLS, MIN_BYTES / call_bytes(k, size));
+	bool		ok;
+
+	k->prepare(size);
+	k->run(size);
+	if (k->check != NULL) {
+		ok = k->check(size);
+	} else {
+		k->reference(size);
+		ok = memcmp(r, ref, size) == 0;
+	}
+	*ns_per_call = *cycles_per_call = 0;
+	for (uint32_t rep = 0; rep < NB_REPEAT; rep++) {
+		uint64_t	t0 = now_ns();
+		uint64_t	c0 = now_cycles();
+
+		for (uint32_t i = 0; i < nb_calls; i++) {
+			k->run(size);
+		}
+		double	cycles = (double)(now_cycles() - c0) / nb_calls;
+		double	ns = (double)(now_ns() - t0) / nb_calls;
+
+		if (rep == 0 || ns < *ns_per_call) {
+			*ns_per_call = ns;
+			*cycles_per_call = cycles;
+		}
+	}
+	return ok;
+}
+
+
+typedef enum { FORMAT_CSV, FORMAT_JSON } bench_format_t;
+
+static void	print_result (FILE*		out,
+			      bench_format_t	format,
+			      bool		first,
+			      const kernel_t*	k,
+			      uint32_t		size,
+			      double		ns_per_call,
+			      double		cycles_per_call,
+			      bool		ok)
+{
+	uint32_t	bytes = call_bytes(k, size);
+	double		gbps = (ns_per_call > 0) ? bytes / ns_per_call : 0;	/* bytes/ns = GB/s */
+	double		cycles_per_byte = cycles_per_call / bytes;
+
+	if (format == FORMAT_CSV) {
+		if (first) {
+			fprintf(out, "kernel,variant,size,ns_per_call,GBps,cycles_per_byte,check\n");
+		}
+		fprintf(out, "%s,%s,%u,%.1f,%.3f,%.3f,%s\n", k->name, k->variant, size,
+			ns_per_call, gbps, cycles_per_byte, ok ? "ok" : "FAILED");
+	} else {
+		fprintf(out, "%s\n  {\"kernel\": \"%s\", \"variant\": \"%s\", \"size\": %u, "
+			"\"ns_per_call\": %.1f, \"GBps\": %.3f, \"cycles_per_byte\": %.3f, \"check\": %s}",
+			first ? "[" : ",", k->name, k->variant, size, ns_per_call, gbps,
+			cycles_per_byte, ok ? "true" : "false");
+	}
+	fflush(out);
+}
+
+
+static void	usage (const char*	name)
+{
+	fprintf(stderr,
+		"usage: %s [options]\n"
+		"  -k kernels      comma-separated list of kernel names (default all):\n"
+		"                  symbol_add, symbol_add_scaled, symbol_mul, symbol_div,\n"
+		"                  gf256_inv, gf256_div, coding_coefs, full_symbol_add\n"
+		"  -s sizes        sizes, in bytes, up to %u (default %s)\n"
+		"  -f csv|json     output format (default csv)\n"
+		"  -o file         output file (default stdout)\n",
+		name, MAX_SIZE, DEFAULT_SIZES);
+}
+
+static bool	kernel_selected (const char*	list,
+				 const char*	name)
+{
+	size_t	len = strlen(name);
+
+	if (list == NULL) {
+		return true;
+	}
+	for (const char* p = list; (p = strstr(p, name)) != NULL; p += len) {
+		if ((p == list || p[-1] == ',') && (p[len] == ',' || p[len] == '\0')) {
+			return true;
+		}
+	}
+	return false;
+}
+
+
+int
+main (int argc, char* argv[])
+{
+	const char*	kernels_list = NULL;
+	const char*	sizes = DEFAULT_SIZES;
+	bench_format_t	format = FORMAT_CSV;
+	FILE*		out = stdout;
+	uint32_t	size_tab[MAX_LIST];
+	uint32_t	nb_sizes = 0;
+	bool		first = true;
+	int		opt;
+	int		ret = 0;
+
+	while ((opt = getopt(argc, argv, "k:s:f:o:h")) != -1) {
+		switch (opt) {
+		case 'k': kernels_list = optarg; break;
+		case 's': sizes = optarg; break;
+		case 'f':
+			if (strcmp(optarg, "csv") == 0) {
+				format = FORMAT_CSV;
+			} else if (strcmp(optarg, "json") == 0) {
+				format = FORMAT_JSON;
+			} else {
+				usage(argv[0]);
+				return -1;
+			}
+			break;
+		case 'o':
+			if ((out = fopen(optarg, "w")) == NULL) {
+				fprintf(stderr, "Error, cannot open %s\n", optarg);
+				return -1;
+			}
+			break;
+		default:
+			usage(argv[0]);
+			return -1;
+		}
+	}
+	for (const char* p = sizes; *p != '\0'; ) {
+		char*	end;
+		long	size = strtol(p, &end, 10);
+
+		if (end == p || size <= 0 || size > MAX_SIZE || nb_sizes == MAX_LIST
+		    || (*end != ',' && *end != '\0')) {
+			usage(argv[0]);
+			return -1;
+		}
+		size_tab[nb_sizes++] = (uint32_t)size;
+		p = (*end == ',') ? end + 1 : end;
+	}
+	if (nb_sizes == 0) {
+		usage(argv[0]);
+		return -1;
+	}
+	a = swif_symbol_buffer_alloc(MAX_SIZE);
+	b = swif_symbol_buffer_alloc(MAX_SIZE);
+	r = swif_symbol_buffer_alloc(MAX_SIZE);
+	ref = swif_symbol_buffer_alloc(MAX_SIZE);
+	if (a == NULL || b == NULL || r == NULL || ref == NULL) {
+		fprintf(stderr, "Error, no memory\n");
+		return -1;
+	}
+	for (uint32_t k = 0; k < TINYMT32_MULTI_LANES; k++) {
+		if ((cc_tab_tab[k] = malloc(MAX_SIZE)) == NULL) {
+			fprintf(stderr, "Error, no memory\n");
+			return -1;
+		}
+	}
+	srand(7);
+	for (uint32_t i = 0; i < MAX_SIZE; i++) {
+		a[i] = (uint8_t)rand();
+		b[i] = (uint8_t)rand();
+	}
+	for (uint32_t ik = 0; ik < NB_KERNELS; ik++) {
+		const kernel_t*	k = &kernel_tab[ik];
+
+		if (!kernel_selected(kernels_list, k->name)) {
+			continue;
+		}
+		for (uint32_t is = 0; is < nb_sizes; is++) {
+			double	ns_per_call, cycles_per_call;
+			bool	ok;
+
+			if (!k->available(size_tab[is])) {
+				continue;
+			}
+			ok = bench_kernel(k, size_tab[is], &ns_per_call, &cycles_per_call);
+			print_result(out, format, first, k, size_tab[is], ns_per_call, cycles_per_call, ok);
+			first = false;
+			if (!ok) {
+				ret = -1;
+			}
+		}
+	}
+	if (format == FORMAT_JSON) {
+		fprintf(out, "%s]\n", first ? "[" : "\n");
+	}
+	if (out != stdout) {
+		fclose(out);
+	}
+	if (fs_a != NULL) {
+		full_symbol_free(fs_a);
+		full_symbol_free(fs_b);
+	}
+	for (uint32_t k = 0; k < TINYMT32_MULTI_LANES; k++) {
+		free(cc_tab_tab[k]);
+	}
+	swif_symbol_buffer_free(a);
+	swif_symbol_buffer_free(b);
+	swif_symbol_buffer_free(r);
+	swif_symbol_buffer_free(ref);
+	return ret;
+}
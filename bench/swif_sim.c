@@ -0,0 +1,302 @@
+/*
+ * Monte Carlo evaluation of the SWIF-codec through loss channels, on all
+ * the cores, with swif_simulator.h.
+ * See README.TXT.
+ */
+
+#define _GNU_SOURCE	/* getopt(), strdup() */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../src/swif_api.h"
+#include "../src/swif_channel.h"
+#include "../src/swif_simulator.h"
+
+
+#define DEFAULT_RATIOS		"0.1,0.15,0.2,0.25,0.3"
+#define DEFAULT_MODEL		"bernoulli:0.05"
+#define DEFAULT_NB_SOURCE	1000000
+#define MAX_LIST		32
+
+#ifndef MIN
+#define MIN(a,b)		((a) < (b) ? (a) : (b))
+#endif
+
+
+static const struct {
+	const char*		name;
+	swif_codepoint_t	codepoint;
+} codec_tab[] = {
+	{ "gf256",	SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC },
+	{ "gf16",	SWIF_CODEPOINT_RLC_GF_16_CODEC },
+	{ "gf2",	SWIF_CODEPOINT_RLC_GF_2_CODEC },
+};
+
+typedef enum { FORMAT_CSV, FORMAT_JSON } sim_format_t;
+
+
+static void	usage (const char*	name)
+{
+	fprintf(stderr,
+		"usage: %s [options]\n"
+		"  -c codec        gf256, gf16 or gf2 (default gf256)\n"
+		"  -s size         symbol size, in bytes (default 1024)\n"
+		"  -w window       max_coding_window_size (default 32)\n"
+		"  -L ls_size      max_linear_system_size (default 4 * window)\n"
+		"  -d dt           density threshold in [0; 15], -1 for the codec default (default -1)\n"
+		"  -r ratios       comma-separated repair ratios, repair symbols per source\n"
+		"                  symbol (default %s)\n"
+		"  -m model        loss model, may be repeated (default %s):\n"
+		"                    bernoulli:loss_rate\n"
+		"                    ge:p_good_to_bad,p_bad_to_good[,loss_good,loss_bad]\n"
+		"                      (Gilbert-Elliott, loss_good 0 and loss_bad 1 by default)\n"
+		"                    trace:file (text file of 0 and 1, 1 for a lost packet)\n"
+		"  -n nb_source    source symbols per simulation, over all threads (default %u)\n"
+		"  -t threads      number of threads (default one per online CPU)\n"
+		"  -S seed         seed of the channels (default 1)\n"
+		"  -x              check the decoded symbols\n"
+		"  -H              with -f json, add the decoding delay histogram\n"
+		"  -f csv|json     output format (default csv)\n"
+		"  -o file         output file (default stdout)\n",
+		name, DEFAULT_RATIOS, DEFAULT_MODEL, DEFAULT_NB_SOURCE);
+}
+
+
+/* parse a loss model specification, the trace being loaded (to be freed) */
+static int	parse_model (const char*		spec,
+			     swif_channel_params_t*	params)
+{
+	const char*	arg = strchr(spec, ':');
+	double		v[4] = { 0, 0, 0, 1 };
+	int		nb = 0;
+
+	memset(params, 0, sizeof(*params));
+	if (arg == NULL) {
+		return -1;
+	}
+	arg++;
+	if (strncmp(spec, "trace:", 6) == 0) {
+		uint8_t*	trace;
+
+		if (swif_channel_load_trace(arg, &trace, &params->trace_len) != SWIF_STATUS_OK) {
+			return -1;
+		}
+		params->model = SWIF_CHANNEL_TRACE;
+		params->trace = trace;
+		return 0;
+	}
+	for (const char* p = arg; nb < 4; nb++) {
+		char*	end;
+
+		v[nb] = strtod(p, &end);
+		if (end == p || (*end != ',' && *end != '\0')) {
+			return -1;
+		}
+		if (*end == '\0') {
+			nb++;
+			break;
+		}
+		p = end + 1;
+	}
+	if (strncmp(spec, "bernoulli:", 10) == 0 && nb == 1) {
+		params->model = SWIF_CHANNEL_BERNOULLI;
+		params->loss_rate = v[0];
+	} else if (strncmp(spec, "ge:", 3) == 0 && (nb == 2 || nb == 4)) {
+		params->model = SWIF_CHANNEL_GILBERT_ELLIOTT;
+		params->p_good_to_bad = v[0];
+		params->p_bad_to_good = v[1];
+		params->loss_good = v[2];
+		params->loss_bad = v[3];
+	} else {
+		return -1;
+	}
+	return (swif_channel_get_mean_loss_rate(params) < 0) ? -1 : 0;
+}
+
+
+static void	print_result (FILE*				out,
+			      sim_format_t			format,
+			      bool				first,
+			      bool				with_hist,
+			      const char*			codec_name,
+			      const char*			model,
+			      const swif_sim_params_t*		p,
+			      const swif_sim_results_t*		r)
+{
+	double		mean_loss = swif_channel_get_mean_loss_rate(&p->channel);
+	uint32_t	ls_size = p->max_linear_system_size ? p->max_linear_system_size : 4 * p->max_coding_window_size;
+	double		cpu_ns_per_source = (double)r->cpu_ns / r->nb_source;
+	double		msymbols_per_s = r->nb_source / (r->wall_ns * 1e-3);
+
+	if (format == FORMAT_CSV) {
+		if (first) {
+			fprintf(out, "codec,symbol_size,window_size,ls_size,dt,model,mean_loss,repair_ratio,"
+				"nb_threads,nb_source,nb_repair,nb_source_lost,nb_repair_lost,nb_recovered,"
+				"nb_bad,residual_loss,delay_mean,delay_p50,delay_p90,delay_p99,delay_max,"
+				"cpu_ns_per_source,Msymbols_per_s\n");
+		}
+		fprintf(out, "%s,%u,%u,%u,%d,%s,%g,%g,%u,%lu,%lu,%lu,%lu,%lu,%lu,%g,%.2f,%u,%u,%u,%u,%.0f,%.3f\n",
+			codec_name, p->symbol_size, p->max_coding_window_size, ls_size, p->dt, model,
+			mean_loss, p->repair_ratio, r->nb_threads, (unsigned long)r->nb_source,
+			(unsigned long)r->nb_repair, (unsigned long)r->nb_source_lost,
+			(unsigned long)r->nb_repair_lost, (unsigned long)r->nb_recovered,
+			(unsigned long)r->nb_bad, r->residual_loss, r->delay_mean,
+			swif_sim_get_delay_percentile(r, 50), swif_sim_get_delay_percentile(r, 90),
+			swif_sim_get_delay_percentile(r, 99), r->delay_max, cpu_ns_per_source,
+			msymbols_per_s);
+	} else {
+		fprintf(out, "%s\n  {\"codec\": \"%s\", \"symbol_size\": %u, \"window_size\": %u, "
+			"\"ls_size\": %u, \"dt\": %d, \"model\": \"%s\", \"mean_loss\": %g, "
+			"\"repair_ratio\": %g, \"nb_threads\": %u, \"nb_source\": %lu, \"nb_repair\": %lu, "
+			"\"nb_source_lost\": %lu, \"nb_repair_lost\": %lu, \"nb_recovered\": %lu, "
+			"\"nb_bad\": %lu, \"residual_loss\": %g, \"delay_mean\": %.2f, \"delay_p50\": %u, "
+			"\"delay_p90\": %u, \"delay_p99\": %u, \"delay_max\": %u, "
+			"\"cpu_ns_per_source\": %.0f, \"Msymbols_per_s\": %.3f",
+			first ? "[" : ",", codec_name, p->symbol_size, p->max_coding_window_size,
+			ls_size, p->dt, model, mean_loss, p->repair_ratio, r->nb_threads,
+			(unsigned long)r->nb_source, (unsigned long)r->nb_repair,
+			(unsigned long)r->nb_source_lost, (unsigned long)r->nb_repair_lost,
+			(unsigned long)r->nb_recovered, (unsigned long)r->nb_bad, r->residual_loss,
+			r->delay_mean, swif_sim_get_delay_percentile(r, 50),
+			swif_sim_get_delay_percentile(r, 90), swif_sim_get_delay_percentile(r, 99),
+			r->delay_max, cpu_ns_per_source, msymbols_per_s);
+		if (with_hist) {
+			/* up to the last nonzero entry */
+			uint32_t	len = MIN(r->delay_max + 1, SWIF_SIM_DELAY_HIST_SIZE);
+
+			fprintf(out, ", \"delay_hist\": [");
+			for (uint32_t d = 0; d < len; d++) {
+				fprintf(out, "%s%lu", d ? ", " : "", (unsigned long)r->delay_hist[d]);
+			}
+			fprintf(out, "]");
+		}
+		fprintf(out, "}");
+	}
+	fflush(out);
+}
+
+
+int
+main (int argc, char* argv[])
+{
+	static swif_sim_results_t	results;	/* large delay histogram */
+	swif_sim_params_t	params;
+	const char*		codec_name = "gf256";
+	const char*		ratios = DEFAULT_RATIOS;
+	const char*		model_tab[MAX_LIST];
+	swif_channel_params_t	channel_tab[MAX_LIST];
+	double			ratio_tab[MAX_LIST];
+	uint32_t		nb_models = 0, nb_ratios = 0;
+	sim_format_t		format = FORMAT_CSV;
+	bool			with_hist = false;
+	bool			first = true;
+	FILE*			out = stdout;
+	uint32_t		i;
+	int			opt;
+	int			ret = 0;
+
+	memset(&params, 0, sizeof(params));
+	params.codepoint = SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC;
+	params.symbol_size = 1024;
+	params.max_coding_window_size = 32;
+	params.dt = -1;
+	params.nb_source = DEFAULT_NB_SOURCE;
+	params.seed = 1;
+	while ((opt = getopt(argc, argv, "c:s:w:L:d:r:m:n:t:S:xHf:o:h")) != -1) {
+		switch (opt) {
+		case 'c':
+			for (i = 0; i < sizeof(codec_tab) / sizeof(codec_tab[0]); i++) {
+				if (strcmp(optarg, codec_tab[i].name) == 0) {
+					break;
+				}
+			}
+			if (i == sizeof(codec_tab) / sizeof(codec_tab[0])) {
+				usage(argv[0]);
+				return -1;
+			}
+			codec_name = codec_tab[i].name;
+			params.codepoint = codec_tab[i].codepoint;
+			break;
+		case 's': params.symbol_size = (uint32_t)atoi(optarg); break;
+		case 'w': params.max_coding_window_size = (uint32_t)atoi(optarg); break;
+		case 'L': params.max_linear_system_size = (uint32_t)atoi(optarg); break;
+		case 'd': params.dt = atoi(optarg); break;
+		case 'r': ratios = optarg; break;
+		case 'm':
+			if (nb_models == MAX_LIST || parse_model(optarg, &channel_tab[nb_models]) != 0) {
+				fprintf(stderr, "Error, bad loss model %s\n", optarg);
+				return -1;
+			}
+			model_tab[nb_models++] = optarg;
+			break;
+		case 'n': params.nb_source = strtoull(optarg, NULL, 10); break;
+		case 't': params.nb_threads = (uint32_t)atoi(optarg); break;
+		case 'S': params.seed = strtoull(optarg, NULL, 10); break;
+		case 'x': params.check = true; break;
+		case 'H': with_hist = true; break;
+		case 'f':
+			if (strcmp(optarg, "csv") == 0) {
+				format = FORMAT_CSV;
+			} else if (strcmp(optarg, "json") == 0) {
+				format = FORMAT_JSON;
+			} else {
+				usage(argv[0]);
+				return -1;
+			}
+			break;
+		case 'o':
+			if ((out = fopen(optarg, "w")) == NULL) {
+				fprintf(stderr, "Error, cannot open %s\n", optarg);
+				return -1;
+			}
+			break;
+		default:
+			usage(argv[0]);
+			return -1;
+		}
+	}
+	if (nb_models == 0) {
+		parse_model(DEFAULT_MODEL, &channel_tab[0]);
+		model_tab[nb_models++] = DEFAULT_MODEL;
+	}
+	for (const char* p = ratios; *p != '\0'; ) {
+		char*	end;
+		double	ratio = strtod(p, &end);
+
+		if (end == p || ratio < 0 || nb_ratios == MAX_LIST || (*end != ',' && *end != '\0')) {
+			usage(argv[0]);
+			return -1;
+		}
+		ratio_tab[nb_ratios++] = ratio;
+		p = (*end == ',') ? end + 1 : end;
+	}
+	for (uint32_t im = 0; im < nb_models; im++) {
+		for (uint32_t ir = 0; ir < nb_ratios; ir++) {
+			params.channel = channel_tab[im];
+			params.repair_ratio = ratio_tab[ir];
+			if (swif_sim_run(&params, &results) != SWIF_STATUS_OK) {
+				ret = -1;
+				continue;
+			}
+			print_result(out, format, first, with_hist, codec_name, model_tab[im], &params, &results);
+			first = false;
+			if (results.nb_bad > 0) {
+				ret = -1;
+			}
+		}
+	}
+	if (format == FORMAT_JSON) {
+		fprintf(out, "%s]\n", first ? "[" : "\n");
+	}
+	if (out != stdout) {
+		fclose(out);
+	}
+	for (uint32_t im = 0; im < nb_models; im++) {
+		free((void*)channel_tab[im].trace);
+	}
+	return ret;
+}
@@ -0,0 +1,62 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+#define _GNU_SOURCE	/* posix_memalign() */
+#include "swif_includes.h"
+
+
+static void* swif_default_alloc (void* context, size_t size)
+{
+    return malloc(size);
+}
+
+static void* swif_default_aligned_alloc (void* context, size_t alignment, size_t size)
+{
+    void *p;
+
+    if (posix_memalign(&p, alignment, size) != 0) {
+        return NULL;
+    }
+    return p;
+}
+
+static void swif_default_free (void* context, void* ptr)
+{
+    free(ptr);
+}
+
+
+const swif_allocator_t swif_default_allocator = {
+    swif_default_alloc,
+    swif_default_aligned_alloc,
+    swif_default_free,
+    NULL
+};
+
+
+bool swif_allocator_is_valid (const swif_allocator_t* allocator)
+{
+    return (allocator->alloc_func != NULL && allocator->aligned_alloc_func != NULL
+            && allocator->free_func != NULL);
+}
+
+
+void* swif_symbol_buffer_alloc (uint32_t symbol_size)
+{
+    uint32_t	size = SWIF_SYMBOL_PADDED_SIZE(MAX(symbol_size, 1));
+    void	*p;
+
+    if (size < symbol_size || posix_memalign(&p, SWIF_SYMBOL_ALIGNMENT, size) != 0) {
+        fprintf(stderr, "swif_symbol_buffer_alloc() failed! No memory\n");
+        return NULL;
+    }
+    return memset(p, 0, size);
+}
+
+
+void swif_symbol_buffer_free (void* symbol_buf)
+{
+    free(symbol_buf);
+}
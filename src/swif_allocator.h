@@ -0,0 +1,70 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+#ifndef SWIF_ALLOCATOR_H
+#define SWIF_ALLOCATOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+
+/**
+ * Internal memory allocation functions, through the allocator of a codec
+ * instance (see swif_allocator_t in swif_api.h). Instances created without
+ * an allocator keep a copy of swif_default_allocator (malloc and free).
+ */
+
+/* malloc(), posix_memalign() and free() */
+extern const swif_allocator_t	swif_default_allocator;
+
+/* true if none of the functions of allocator is missing */
+bool swif_allocator_is_valid (const swif_allocator_t* allocator);
+
+static inline void* swif_mem_alloc (const swif_allocator_t*	a,
+				    size_t			size)
+{
+	return a->alloc_func(a->context, size);
+}
+
+/* zeroed, as calloc() */
+static inline void* swif_mem_calloc (const swif_allocator_t*	a,
+				     size_t			nb,
+				     size_t			size)
+{
+	void	*p;
+
+	if (size != 0 && nb > SIZE_MAX / size) {
+		return NULL;
+	}
+	if ((p = a->alloc_func(a->context, nb * size)) != NULL) {
+		memset(p, 0, nb * size);
+	}
+	return p;
+}
+
+/* zeroed as well, alignment being a power of two multiple of sizeof(void*) */
+static inline void* swif_mem_aligned_calloc (const swif_allocator_t*	a,
+					     size_t			alignment,
+					     size_t			size)
+{
+	void	*p;
+
+	if ((p = a->aligned_alloc_func(a->context, alignment, size)) != NULL) {
+		memset(p, 0, size);
+	}
+	return p;
+}
+
+static inline void swif_mem_free (const swif_allocator_t*	a,
+				  void*				p)
+{
+	if (p != NULL) {
+		a->free_func(a->context, p);
+	}
+}
+
+#endif /* SWIF_ALLOCATOR_H */
@@ -3,9 +3,9 @@
  * https://github.com/irtf-nwcrg/swif-codec
  */
 
-#define DEBUG 1
 #include "swif_includes.h"
 #include "swif_rlc_api.c"
+#include "swif_rlc_gf2_decoder.h"
 
 
 /*******************************************************************************
@@ -22,10 +22,29 @@ swif_encoder_t* swif_encoder_create (
                                 uint32_t        symbol_size,
                                 uint32_t        max_coding_window_size)
 {
+    return swif_encoder_create_with_allocator(codepoint, verbosity, symbol_size,
+                                              max_coding_window_size, NULL);
+}
+
+
+swif_encoder_t* swif_encoder_create_with_allocator (
+                                swif_codepoint_t codepoint,
+                                uint32_t        verbosity,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size,
+                                const swif_allocator_t* allocator)
+{
+    if (allocator != NULL && !swif_allocator_is_valid(allocator)) {
+        fprintf(stderr, "swif_encoder_create() failed! incomplete allocator\n");
+        return NULL;
+    }
     /* initialize the encoder */
     switch (codepoint) {
         case SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC:
-            return (swif_rlc_encoder_create(codepoint, verbosity, symbol_size, max_coding_window_size));
+        case SWIF_CODEPOINT_RLC_GF_2_CODEC:
+        case SWIF_CODEPOINT_RLC_GF_16_CODEC:
+            return (swif_rlc_encoder_create_with_allocator(codepoint, verbosity, symbol_size,
+                                                           max_coding_window_size, allocator));
         default:
             fprintf(stderr, "Error, swif_encoder_create: codepoint not recognized\n");
             return NULL;
@@ -41,6 +60,8 @@ swif_status_t   swif_encoder_release (swif_encoder_t*        enc)
     /* initialize the encoder */
     switch (enc->codepoint) {
         case SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC:
+        case SWIF_CODEPOINT_RLC_GF_2_CODEC:
+        case SWIF_CODEPOINT_RLC_GF_16_CODEC:
             return (swif_rlc_encoder_release(enc));
         default:
             fprintf(stderr, "Error, swif_encoder_release: codepoint not recognized\n");
@@ -102,6 +123,19 @@ swif_status_t   swif_build_repair_symbol (
 }
 
 
+/**
+ * Create one repair symbol for each selected layer in a single pass.
+ */
+swif_status_t   swif_build_layer_repair_symbols (
+                                swif_encoder_t* enc,
+                                uint32_t        layer_mask,
+                                const uint32_t* key_tab,
+                                void**          new_buf_tab)
+{
+    return (*enc->build_layer_repair_symbols)(enc, layer_mask, key_tab, new_buf_tab);
+}
+
+
 /*******************************************************************************
  * Decoder functions
  */
@@ -117,10 +151,35 @@ swif_decoder_t* swif_decoder_create (
                                 uint32_t        max_coding_window_size,
                                 uint32_t        max_linear_system_size)
 {
+    return swif_decoder_create_with_allocator(codepoint, verbosity, symbol_size,
+                                              max_coding_window_size,
+                                              max_linear_system_size, NULL);
+}
+
+
+swif_decoder_t* swif_decoder_create_with_allocator (
+                                swif_codepoint_t codepoint,
+                                uint32_t        verbosity,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size,
+                                uint32_t        max_linear_system_size,
+                                const swif_allocator_t* allocator)
+{
+    if (allocator != NULL && !swif_allocator_is_valid(allocator)) {
+        fprintf(stderr, "swif_decoder_create() failed! incomplete allocator\n");
+        return NULL;
+    }
     /* initialize the decoder */
     switch (codepoint) {
         case SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC:
-            return (swif_rlc_decoder_create(codepoint, verbosity, symbol_size, max_coding_window_size, max_linear_system_size));
+        case SWIF_CODEPOINT_RLC_GF_16_CODEC:
+            return (swif_rlc_decoder_create_with_allocator(codepoint, verbosity, symbol_size,
+                                                           max_coding_window_size,
+                                                           max_linear_system_size, allocator));
+        case SWIF_CODEPOINT_RLC_GF_2_CODEC:
+            return (swif_rlc_gf2_decoder_create(codepoint, verbosity, symbol_size,
+                                                max_coding_window_size,
+                                                max_linear_system_size, allocator));
         default:
             fprintf(stderr, "Error, swif_decoder_create: codepoint not recognized\n");
             return NULL;
@@ -135,7 +194,10 @@ swif_status_t   swif_decoder_release (swif_decoder_t*        dec)
 {
     switch (dec->codepoint) {
         case SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC:
+        case SWIF_CODEPOINT_RLC_GF_16_CODEC:
             return (swif_rlc_decoder_release(dec));
+        case SWIF_CODEPOINT_RLC_GF_2_CODEC:
+            return (swif_rlc_gf2_decoder_release(dec));
         default:
             fprintf(stderr, "Error, swif_decoder_release: codepoint not recognized\n");
             return SWIF_STATUS_ERROR;
@@ -302,6 +364,19 @@ swif_status_t   swif_encoder_get_coding_window_information (
 }
 
 
+/**
+ * Restrict the next repair symbols to a contiguous sub-range of the
+ * coding window.
+ */
+swif_status_t   swif_encoder_set_repair_window (
+                                swif_encoder_t* enc,
+                                esi_t           first,
+                                uint32_t        nss)
+{
+    return (*enc->set_repair_window)(enc, first, nss);
+}
+
+
 /*******************************************************************************
  * Coding Coefficients Functions at an Encoder and Decoder
  */
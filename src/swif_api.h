@@ -14,6 +14,7 @@
  * https://github.com/irtf-nwcrg/swif-codec
  */
 #include <stdint.h>
+#include <stddef.h>
 #ifndef __SWIF_API_H__
 #define __SWIF_API_H__
 
@@ -48,6 +49,12 @@ typedef enum {
 typedef enum {
         SWIF_ERRNO_NULL = 0,            /* everything is fine */
         SWIF_ERRNO_UNSUPPORTED_CODEPOINT,
+        SWIF_ERRNO_UNSUPPORTED_PARAMETER,
+        SWIF_ERRNO_INVALID_SYMBOL_LENGTH,
+        SWIF_ERRNO_MISALIGNED_SYMBOL_BUFFER,
+        SWIF_ERRNO_EMPTY_REPAIR_WINDOW,  /* no source symbol to build a repair
+                                          * symbol from, e.g. see
+                                          * swif_encoder_set_repair_window() */
         /* and many more... */
 } swif_errno_t;
 
@@ -72,7 +79,22 @@ typedef enum {
 
         /* codepoint for RLC sliding window code, GF(2^8) and full
          * density (simplified version of FECFRAME FEC Enc. ID XXX). */
-        SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC
+        SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC,
+
+        /* codepoint for RLC sliding window code, GF(2), i.e. coding
+         * coefficients in {0, 1} and XOR-only encoding and decoding.
+         * The density threshold defaults to 7 (i.e. each source symbol
+         * is in a repair symbol with probability 1/2) and can be
+         * changed with the *_SET_PARAM_RLC_DENSITY_THRESHOLD parameters,
+         * the same value being used on both sides. */
+        SWIF_CODEPOINT_RLC_GF_2_CODEC,
+
+        /* codepoint for RLC sliding window code, GF(2^4) and full
+         * density. Symbols are processed as two GF(2^4) elements per
+         * byte and coding coefficient tables exchanged with
+         * swif_*_coding_coefs_tab() also hold two coefficients per byte
+         * (first coefficient in the low nibble). */
+        SWIF_CODEPOINT_RLC_GF_16_CODEC
 
         /* list here other identifiers for any codec of interest... */
 } swif_codepoint_t;
@@ -89,6 +111,104 @@ typedef uint32_t    esi_t;
 #define INVALID_ESI	0xFFFFFFFF
 
 
+/**
+ * Variable-length source symbols.
+ * When this mode is enabled (see the *_SET_PARAM_VARIABLE_LENGTH_SYMBOLS
+ * parameters), each source symbol starts with a 2-byte length prefix, in
+ * network byte order, that contains the number of payload bytes following
+ * the prefix (similar to the RLC FEC Scheme for QUIC). Only the first
+ * SWIF_LENGTH_PREFIX_SIZE + length bytes of a source symbol are meaningful,
+ * the remaining bytes up to symbol_size are considered to be zero and are
+ * never accessed by the codec. A repair symbol is then only as long as the
+ * longest source symbol of its coding window.
+ */
+#define SWIF_LENGTH_PREFIX_SIZE	2
+
+/**
+ * Write the length prefix of a variable-length source symbol.
+ */
+static inline void swif_set_symbol_length_prefix (void*	symbol_buf,
+						  uint16_t	payload_length)
+{
+	((uint8_t*)symbol_buf)[0] = (uint8_t)(payload_length >> 8);
+	((uint8_t*)symbol_buf)[1] = (uint8_t)(payload_length & 0xFF);
+}
+
+/**
+ * Read the length prefix of a variable-length source symbol and return the
+ * number of meaningful bytes of this symbol, prefix included.
+ */
+static inline uint32_t swif_get_symbol_length (const void*	symbol_buf)
+{
+	const uint8_t	*p = (const uint8_t*)symbol_buf;
+
+	return SWIF_LENGTH_PREFIX_SIZE + (((uint32_t)p[0] << 8) | p[1]);
+}
+
+
+/*******************************************************************************
+ * Memory allocation
+ */
+
+/**
+ * Memory allocator of an encoder or decoder instance (see
+ * swif_encoder_create_with_allocator() and
+ * swif_decoder_create_with_allocator()), e.g. to back sessions with
+ * per-thread arenas, hugepage pools or NUMA-local memory, or to account
+ * for the memory used by each session.
+ * All the memory of the instance then comes from alloc_func and
+ * aligned_alloc_func, including the symbol buffers it hands over to the
+ * application: the repair symbols built by swif_build_repair_symbol() and
+ * swif_build_layer_repair_symbols() in new buffers, and the decoded source
+ * symbols given to decoded_source_symbol_callback when there is no
+ * decodable_source_symbol_callback. The application releases them with
+ * free_func.
+ * alignment is a power of two, multiple of sizeof(void*) (as with
+ * posix_memalign()). free_func releases memory returned by any of the two
+ * functions. The three functions are required and are called with context.
+ * The codec only keeps a copy of this structure.
+ *
+ * Steady state: an encoder or decoder allocates all its memory when it is
+ * created, or when a parameter that needs memory is set (e.g. layers,
+ * block decoding, variable-length symbols). Nothing is allocated while
+ * encoding or decoding, as long as the application provides the symbol
+ * buffers: a buffer to swif_build_repair_symbol() (*new_buf != NULL) and
+ * swif_build_layer_repair_symbols(), and a decodable_source_symbol_callback
+ * to the decoder. See tests/swif_steady_state_test.c.
+ */
+typedef struct swif_allocator {
+	void*	(*alloc_func) (void* context, size_t size);
+	void*	(*aligned_alloc_func) (void* context, size_t alignment, size_t size);
+	void	(*free_func) (void* context, void* ptr);
+	void*	context;
+} swif_allocator_t;
+
+
+/**
+ * Aligned symbol buffers.
+ * A buffer returned by swif_symbol_buffer_alloc() starts on a
+ * SWIF_SYMBOL_ALIGNMENT boundary and is SWIF_SYMBOL_PADDED_SIZE(symbol_size)
+ * bytes long, the padding bytes being zero. When an encoder is told that
+ * all its symbol buffers are such buffers (see
+ * swif_ENCODER_SET_PARAM_ALIGNED_SYMBOLS), it works over the padded size
+ * with aligned loads and stores only, without any unaligned head or tail.
+ * The padding bytes of the source symbols must remain zero; those of the
+ * repair symbols are zero as well, and need not be sent.
+ * Decoders always keep their own symbols aligned and padded.
+ */
+#define SWIF_SYMBOL_ALIGNMENT		64
+#define SWIF_SYMBOL_PADDED_SIZE(size)	\
+	(((size) + SWIF_SYMBOL_ALIGNMENT - 1) & ~(uint32_t)(SWIF_SYMBOL_ALIGNMENT - 1))
+
+/**
+ * Allocate a zeroed symbol buffer (with malloc()'s heap), NULL if there
+ * is no memory. To be released with swif_symbol_buffer_free().
+ */
+void*	swif_symbol_buffer_alloc (uint32_t	symbol_size);
+
+void	swif_symbol_buffer_free (void*	symbol_buf);
+
+
 /*******************************************************************************
  * Encoder functions
  */
@@ -137,6 +257,10 @@ typedef struct swif_encoder {
 		struct swif_encoder*, uint32_t, uint32_t);
 	swif_status_t   (*get_coding_coefs_tab) (
 		struct swif_encoder*, void**, uint32_t*);
+	swif_status_t	(*set_repair_window) (
+		struct swif_encoder*, esi_t, uint32_t);
+	swif_status_t   (*build_layer_repair_symbols) (
+		struct swif_encoder*, uint32_t, const uint32_t*, void**);
 } swif_encoder_t;
 
 
@@ -161,6 +285,19 @@ swif_encoder_t* swif_encoder_create (
                                 uint32_t        max_coding_window_size);
 
 
+/**
+ * Same as swif_encoder_create(), all the memory of the encoder being
+ * allocated with allocator (see swif_allocator_t).
+ * A NULL allocator is the same as swif_encoder_create().
+ **/
+swif_encoder_t* swif_encoder_create_with_allocator (
+                                swif_codepoint_t codepoint,
+                                uint32_t        verbosity,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size,
+                                const swif_allocator_t* allocator);
+
+
 /**
  * Release an encoder and its associated ressources.
  **/
@@ -240,10 +377,73 @@ swif_status_t   swif_encoder_get_parameters  (
  */
 enum {
         swif_ENCODER_GET_PARAM_ENCODER_STATISTICS = 1,
-        swif_ENCODER_SET_PARAM_RLC_DENSITY_THRESHOLD
+        /* value: uint32_t, RLC density threshold dt in [0; 15], see
+         * swif_rlc_generate_coding_coefficients(). Must be identical
+         * on both sides. */
+        swif_ENCODER_SET_PARAM_RLC_DENSITY_THRESHOLD,
+        /* value: uint32_t, 1 to enable length-prefixed source symbols
+         * (see SWIF_LENGTH_PREFIX_SIZE), 0 to disable. Must be set before
+         * the first source symbol is added to the coding window. */
+        swif_ENCODER_SET_PARAM_VARIABLE_LENGTH_SYMBOLS,
+        /* value: uint32_t, number of meaningful bytes of the last repair
+         * symbol built, i.e. the number of bytes to actually send. */
+        swif_ENCODER_GET_PARAM_REPAIR_SYMBOL_SIZE,
+        /* value: swif_cc_cache_t*, coding coefficients cache to use (see
+         * swif_coding_coefficients.h), NULL to stop using it. The cache
+         * is not owned by the encoder and must outlive it. */
+        swif_ENCODER_SET_PARAM_CODING_COEFS_CACHE,
+        /* value: swif_encoder_layer_t[n], length n * sizeof(swif_encoder_layer_t)
+         * with n <= SWIF_MAX_ENCODER_LAYERS (0 removes the layers). Each
+         * window_size must be <= max_coding_window_size. */
+        swif_ENCODER_SET_PARAM_LAYERS,
+        /* value: uint32_t, bit mask of the layers whose repair_period says
+         * a repair symbol is due after the last source symbol added. */
+        swif_ENCODER_GET_PARAM_DUE_LAYERS,
+        /* value: uint32_t[n], length n * sizeof(uint32_t), the number of
+         * meaningful bytes of the repair symbol of each of the n first
+         * layers, as built by the last swif_build_layer_repair_symbols(). */
+        swif_ENCODER_GET_PARAM_LAYER_REPAIR_SYMBOL_SIZES,
+        /* value: swif_stripe_pool_t*, threads sharing the payload work of
+         * each repair symbol (see swif_stripe_pool.h), NULL to stop using
+         * them. Worth it with large symbols only. The pool is not owned
+         * by the encoder and must outlive it. */
+        swif_ENCODER_SET_PARAM_STRIPE_POOL,
+        /* value: uint32_t, 1 if all the source and repair symbol buffers
+         * given to the encoder come from swif_symbol_buffer_alloc() (see
+         * SWIF_SYMBOL_ALIGNMENT), 0 otherwise (default). Must be set
+         * before the first source symbol is added to the coding window,
+         * and is incompatible with variable-length symbols. A misaligned
+         * buffer is then refused (SWIF_ERRNO_MISALIGNED_SYMBOL_BUFFER). */
+        swif_ENCODER_SET_PARAM_ALIGNED_SYMBOLS
 };
 
 
+/**
+ * Multi-layer coding windows.
+ * An encoder can keep several nested coding windows, or layers, over the
+ * same source symbols, for instance the last 8 source symbols for low
+ * latency recovery and the last 256 ones for bursts, without keeping
+ * several encoders with their own copy of the coding window.
+ * Layer i covers the last MIN(window_size, nss) source symbols of the
+ * coding window, nss being returned by
+ * swif_encoder_get_coding_window_information(), so that the application
+ * knows the first ESI to put in the repair packet. The coding window
+ * itself, and therefore max_coding_window_size, must be as large as the
+ * largest layer: the source_symbol_removed_from_coding_window callback is
+ * only called once a source symbol has left all the layers.
+ */
+#define SWIF_MAX_ENCODER_LAYERS	8
+
+typedef struct swif_encoder_layer {
+	/* number of most recent source symbols covered by the layer */
+	uint32_t	window_size;
+	/* one repair symbol is due every repair_period source symbols
+	 * added, see swif_ENCODER_GET_PARAM_DUE_LAYERS. 0 if the
+	 * application decides on its own */
+	uint32_t	repair_period;
+} swif_encoder_layer_t;
+
+
 /**
  * Create a single repair symbol (i.e. perform an encoding).
  *
@@ -260,6 +460,29 @@ swif_status_t   swif_build_repair_symbol (
                                 void**          new_buf);
 
 
+/**
+ * Create one repair symbol for each selected layer (see
+ * swif_ENCODER_SET_PARAM_LAYERS) in a single pass over the source
+ * symbols, each one being read once for all the layers that cover it.
+ * The coding coefficients of layer i are generated from key_tab[i] as
+ * with swif_encoder_generate_coding_coefs(), over the source symbols of
+ * the layer.
+ *
+ * @param layer_mask    (IN) bit mask of the layers, for instance the
+ *			value of swif_ENCODER_GET_PARAM_DUE_LAYERS.
+ * @param key_tab       (IN) repair key of each layer, indexed by layer.
+ * @param new_buf_tab   (IN/OUT) repair symbol buffer of each layer,
+ *			indexed by layer, allocated by this function
+ *			when NULL (see swif_build_repair_symbol()).
+ * @return
+ */
+swif_status_t   swif_build_layer_repair_symbols (
+                                swif_encoder_t* enc,
+                                uint32_t        layer_mask,
+                                const uint32_t* key_tab,
+                                void**          new_buf_tab);
+
+
 /*******************************************************************************
  * Decoder functions
  */
@@ -329,6 +552,20 @@ swif_decoder_t* swif_decoder_create (
                                 uint32_t        max_linear_system_size);
 
 
+/**
+ * Same as swif_decoder_create(), all the memory of the decoder being
+ * allocated with allocator (see swif_allocator_t).
+ * A NULL allocator is the same as swif_decoder_create().
+ **/
+swif_decoder_t* swif_decoder_create_with_allocator (
+                                swif_codepoint_t codepoint,
+                                uint32_t        verbosity,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size,
+                                uint32_t        max_linear_system_size,
+                                const swif_allocator_t* allocator);
+
+
 /**
  * Release a decoder and its associated ressources.
  *
@@ -350,7 +587,10 @@ swif_status_t   swif_decoder_release (swif_decoder_t*        dec);
  *              the left side of the linear system.
  *              This callback is called each time the linear system slides
  *              to the right and an old source symbol needs to be removed
- *              on the left. This function does not return anything.
+ *              on the left, in esi order, and only if an equation (e.g.
+ *              the one of the source symbol itself, or of a repair
+ *              symbol) still referred to it. All the RLC codecs behave
+ *              the same way. This function does not return anything.
  * @param decodable_source_symbol_callback
  *              (IN) Pointer to the function, within the application, that
  *              needs to be called each time a source symbol is decodable.
@@ -375,7 +615,11 @@ swif_status_t   swif_decoder_release (swif_decoder_t*        dec);
  *              operations) have been performed. In any case, it is the
  *              responsibility of the application to free this buffer when
  *              needed, once decoding is over (but not before since the
- *              codec does not keep any internal copy). This function does
+ *              codec does not keep any internal copy). When there is no
+ *              decodable_source_symbol_callback, or when it returned NULL,
+ *              new_symbol_buf was allocated by the codec, and the
+ *              application MUST release it with free() (or the free_func
+ *              of its swif_allocator_t), or it leaks. This function does
  *              not return anything.
  * @param context_4_callback
  *              (IN) Pointer to the application-specific context that will be
@@ -442,11 +686,58 @@ swif_status_t   swif_decoder_get_parameters  (
  * List here the FEC codec specific control parameters.
  */
 enum {
+        /* not supported yet by the RLC GF(2) decoder, which returns
+         * SWIF_STATUS_ERROR with SWIF_ERRNO_UNSUPPORTED_PARAMETER */
         swif_DECODER_GET_PARAM_DECODER_STATISTICS = 1,
-        swif_DECODER_SET_PARAM_RLC_DENSITY_THRESHOLD
+        /* value: uint32_t, RLC density threshold dt in [0; 15], see
+         * swif_rlc_generate_coding_coefficients(). Must be identical
+         * on both sides. */
+        swif_DECODER_SET_PARAM_RLC_DENSITY_THRESHOLD,
+        /* value: uint32_t, 1 to enable length-prefixed source symbols
+         * (see SWIF_LENGTH_PREFIX_SIZE), 0 to disable. */
+        swif_DECODER_SET_PARAM_VARIABLE_LENGTH_SYMBOLS,
+        /* value: uint32_t, number of bytes of the repair symbol under
+         * preparation, as received (the missing bytes up to symbol_size
+         * are considered to be zero). Reset to symbol_size by
+         * swif_decoder_reset_coding_window(). */
+        swif_DECODER_SET_PARAM_REPAIR_SYMBOL_SIZE,
+        /* value: swif_cc_cache_t*, coding coefficients cache to use (see
+         * swif_coding_coefficients.h), NULL to stop using it. The cache
+         * is not owned by the decoder and must outlive it. */
+        swif_DECODER_SET_PARAM_CODING_COEFS_CACHE,
+        /* value: uint32_t, 1 to use block decoding, 0 (default) for
+         * incremental decoding. In block mode, repair symbols are
+         * collected until all the missing source symbols they cover can
+         * be recovered at once, by inverting the coefficient submatrix of
+         * these missing symbols. Cheaper with bursty losses, but nothing
+         * is decoded before that point. Must be set before decoding. */
+        swif_DECODER_SET_PARAM_BLOCK_DECODING,
+        /* value: uint32_t, a swif_pivot_policy_t, how incremental decoding
+         * chooses the source symbol that each new repair symbol resolves.
+         * Can be changed at any time. */
+        swif_DECODER_SET_PARAM_PIVOT_POLICY,
+        /* value: swif_stripe_pool_t*, threads sharing the payload work of
+         * each elimination step (see swif_stripe_pool.h), NULL to stop
+         * using them. Worth it with large symbols only. The pool is not
+         * owned by the decoder and must outlive it. */
+        swif_DECODER_SET_PARAM_STRIPE_POOL
 };
 
 
+/**
+ * Pivot selection policies of the incremental decoder.
+ */
+typedef enum {
+        /* resolve the oldest source symbol of the repair symbol first
+         * (default): in-order delivery is blocked on it */
+        SWIF_PIVOT_POLICY_OLDEST_ESI = 0,
+        /* resolve the source symbol whose elimination updates the fewest
+         * equations of the linear system (Markowitz, minimum fill-in),
+         * oldest source symbol first on ties */
+        SWIF_PIVOT_POLICY_MIN_FILL_IN
+} swif_pivot_policy_t;
+
+
 /**
  * Submit a received source symbol and try to progress in the decoding.
  * For each decoded source symbol (if any), the application is informed
@@ -591,7 +882,10 @@ swif_status_t   swif_decoder_remove_source_symbol_from_coding_window (
  *			symbol in the coding window (inclusive)
  * @param nss		(in/out) pointer to number of source symbols
  *			in the coding window
- * @return
+ * @return		SWIF_STATUS_FAILURE (SWIF_ERRNO_EMPTY_REPAIR_WINDOW)
+ *			if the range selected by swif_encoder_set_repair_window()
+ *			has left the coding window: *nss is 0, first and last
+ *			are left unchanged
  */
 swif_status_t	swif_encoder_get_coding_window_information (
 				swif_encoder_t*	enc,
@@ -600,6 +894,33 @@ swif_status_t	swif_encoder_get_coding_window_information (
 				uint32_t*	nss);
 
 
+/**
+ * Restrict the next repair symbols to a contiguous sub-range of the
+ * coding window, for instance to mix short-window repair symbols (cheap
+ * to build and to decode, for recent losses) with full-window ones (for
+ * bursts). The selection remains until the next call, and applies to
+ * swif_encoder_generate_coding_coefs(), swif_build_repair_symbol(),
+ * swif_encoder_get_coding_coefs_tab() and
+ * swif_encoder_get_coding_window_information(), that reports the range
+ * actually used: the decoder side needs nothing specific. Source symbols
+ * of the range that have left the coding window since are skipped. Once
+ * they have all left it, these four functions return SWIF_STATUS_FAILURE
+ * with SWIF_ERRNO_EMPTY_REPAIR_WINDOW, and nothing is built or reported,
+ * until a new range is selected.
+ *
+ * @param enc
+ * @param first		(in) ESI of the first source symbol of the range,
+ *			which must be in the coding window
+ * @param nss		(in) number of source symbols of the range, or 0 to
+ *			use the whole coding window again
+ * @return
+ */
+swif_status_t	swif_encoder_set_repair_window (
+				swif_encoder_t*	enc,
+				esi_t		first,
+				uint32_t	nss);
+
+
 /*******************************************************************************
  * Coding Coefficients Functions at an Encoder and Decoder
  */
@@ -629,9 +950,16 @@ swif_status_t	swif_encoder_get_coding_window_information (
  *              The size (number of bits) of each coefficient depends on
  *              the FEC Scheme. The allocation and release of this table
  *              is under the responsibility of the application.
+ *              A decoder using one byte per coefficient reads this
+ *              table in place, without any copy: it MUST remain
+ *              unchanged until decode_with_new_repair_symbol() returns.
+ *              A table received with the repair packet can therefore be
+ *              passed directly from the packet buffer.
  * @param nb_coefs_in_tab
  *              (IN) number of entries (i.e., coefficients) in the table.
- * @return
+ * @return      SWIF_STATUS_ERROR (SWIF_ERRNO_UNSUPPORTED_PARAMETER) if
+ *              nb_coefs_in_tab is larger than the maximum coding window
+ *              size, since it usually comes from a received packet.
  */
 swif_status_t   swif_encoder_set_coding_coefs_tab (
                                 swif_encoder_t* enc,
@@ -683,10 +1011,13 @@ swif_status_t   swif_decoder_generate_coding_coefs (
  * @param coding_coefs_tab
  *              (OUT) pointer to a table of coding coefficients.
  *              The size (number of bits) of each coefficient depends on
- *              the FEC scheme. Upon return of this function, this table
- *              is allocated and filled with coefficient values. The
- *              release of this table is under the responsibility of the
- *              application.
+ *              the FEC scheme. Upon return of this function, this
+ *              pointer refers to the encoder's own table, filled with
+ *              coefficient values: it can be copied directly in the
+ *              repair packet header, or given as is to a local decoder.
+ *              It MUST NOT be released nor modified, and remains valid
+ *              until the next coding coefficients of this encoder are
+ *              generated or set.
  * @param nb_coefs_in_tab
  *              (IN/OUT) pointer to the number of entries (i.e.,
  *              coefficients) in the table.
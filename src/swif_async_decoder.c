@@ -0,0 +1,323 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+/**
+ * Asynchronous decoder, see swif_async_decoder.h.
+ */
+
+#define _GNU_SOURCE	/* nanosleep() */
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/eventfd.h>
+#endif
+
+#include "swif_includes.h"
+#include "swif_async_decoder.h"
+
+
+typedef enum {
+	SWIF_ASYNC_OP_SOURCE_SYMBOL = 1,
+	SWIF_ASYNC_OP_REPAIR_SYMBOL
+} swif_async_op_t;
+
+/* symbol submitted to the worker */
+typedef struct swif_async_msg {
+	swif_async_op_t		op;
+	void*			buf;
+	esi_t			esi;
+	uint32_t		nss;
+	uint32_t		key;
+} swif_async_msg_t;
+
+struct swif_async_decoder {
+	/* input ring: in_tail written by the I/O thread, in_head by the
+	 * worker */
+	uint32_t		in_tail SWIF_ALIGNED;
+	uint32_t		in_head SWIF_ALIGNED;
+	swif_async_msg_t*	in_tab;
+	uint32_t		in_mask;
+
+	/* event ring: out_tail written by the worker, out_head by the
+	 * polling thread */
+	uint32_t		out_tail SWIF_ALIGNED;
+	uint32_t		out_head SWIF_ALIGNED;
+	swif_engine_event_t*	out_tab;
+	uint32_t		out_mask;
+
+	/* set by the polling thread once it has seen all the events, to
+	 * ask for a notification of the next one */
+	uint32_t		armed SWIF_ALIGNED;
+	int			event_fd;
+
+	/* worker only */
+	swif_decoder_t*		dec SWIF_ALIGNED;
+	pthread_t		thread;
+	bool			started;
+	uint32_t		stop;
+	uint32_t		exited;
+};
+
+
+/*******************************************************************************
+ * Rings
+ */
+
+/* worker thread: waits while the ring is full */
+static void swif_async_decoder_post (swif_async_decoder_t*  adec,
+                                     swif_engine_event_type_t type,
+                                     void*                  buf,
+                                     esi_t                  esi)
+{
+    swif_engine_event_t	ev = { 0, type, buf, esi, 0, 0 };
+    uint32_t		tail = adec->out_tail;
+
+    while (tail - __atomic_load_n(&adec->out_head, __ATOMIC_ACQUIRE) > adec->out_mask) {
+        sched_yield();
+    }
+    adec->out_tab[tail & adec->out_mask] = ev;
+    /* seq_cst with armed: either the poller sees this event, or this
+     * thread sees armed and notifies it */
+    __atomic_store_n(&adec->out_tail, tail + 1, __ATOMIC_SEQ_CST);
+    if (adec->event_fd >= 0 && __atomic_exchange_n(&adec->armed, 0, __ATOMIC_SEQ_CST)) {
+        uint64_t one = 1;
+        if (write(adec->event_fd, &one, sizeof(one)) < 0) {
+            /* counter saturated: the fd is readable anyway */
+        }
+    }
+}
+
+static void swif_async_decoder_decoded (void*  context,
+                                        void*  new_symbol_buf,
+                                        esi_t  esi)
+{
+    swif_async_decoder_post(context, SWIF_ENGINE_EV_DECODED, new_symbol_buf, esi);
+}
+
+static swif_status_t swif_async_decoder_process (swif_async_decoder_t*    adec,
+                                                 const swif_async_msg_t*  msg)
+{
+    swif_decoder_t *dec = adec->dec;
+
+    if (msg->op == SWIF_ASYNC_OP_SOURCE_SYMBOL) {
+        return swif_decoder_decode_with_new_source_symbol(dec, msg->buf, msg->esi);
+    }
+    if (swif_decoder_reset_coding_window(dec) != SWIF_STATUS_OK) {
+        return SWIF_STATUS_ERROR;
+    }
+    for (uint32_t i = 0; i < msg->nss; i++) {
+        if (swif_decoder_add_source_symbol_to_coding_window(dec, msg->esi + i) != SWIF_STATUS_OK) {
+            return SWIF_STATUS_ERROR;
+        }
+    }
+    if (swif_decoder_generate_coding_coefs(dec, msg->key, 0) != SWIF_STATUS_OK) {
+        return SWIF_STATUS_ERROR;
+    }
+    return swif_decoder_decode_with_new_repair_symbol(dec, msg->buf, msg->esi);
+}
+
+static void* swif_async_decoder_worker_main (void* arg)
+{
+    swif_async_decoder_t	*adec = arg;
+    uint32_t			idle = 0;
+
+    for (;;) {
+        uint32_t head = adec->in_head;
+        if (head == __atomic_load_n(&adec->in_tail, __ATOMIC_ACQUIRE)) {
+            /* the ring is only empty for good once stop is seen */
+            if (__atomic_load_n(&adec->stop, __ATOMIC_ACQUIRE)
+                && head == __atomic_load_n(&adec->in_tail, __ATOMIC_ACQUIRE)) {
+                break;
+            }
+            if (++idle < 64) {
+                sched_yield();
+            } else {
+                struct timespec ts = { 0, 50000 };
+                nanosleep(&ts, NULL);
+            }
+            continue;
+        }
+        idle = 0;
+        swif_async_msg_t msg = adec->in_tab[head & adec->in_mask];
+        __atomic_store_n(&adec->in_head, head + 1, __ATOMIC_RELEASE);
+        /* the decoder keeps a copy: the buffer is returned at once */
+        swif_async_decoder_post(adec, (swif_async_decoder_process(adec, &msg) == SWIF_STATUS_OK)
+                                      ? SWIF_ENGINE_EV_RELEASED : SWIF_ENGINE_EV_ERROR,
+                                msg.buf, msg.esi);
+    }
+    __atomic_store_n(&adec->exited, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+
+/*******************************************************************************
+ * API
+ */
+
+swif_async_decoder_t* swif_async_decoder_create (
+                                swif_codepoint_t codepoint,
+                                uint32_t        verbosity,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size,
+                                uint32_t        max_linear_system_size,
+                                uint32_t        queue_size)
+{
+    swif_async_decoder_t	*adec;
+    void			*p;
+    uint32_t			size = 1;
+
+    if (queue_size == 0 || queue_size > (1u << 30)) {
+        fprintf(stderr, "swif_async_decoder_create() failed! bad queue size\n");
+        return NULL;
+    }
+    while (size < queue_size) {
+        size <<= 1;
+    }
+    if (posix_memalign(&p, SWIF_CACHE_LINE, sizeof(swif_async_decoder_t)) != 0) {
+        fprintf(stderr, "swif_async_decoder_create() failed! No memory\n");
+        return NULL;
+    }
+    adec = memset(p, 0, sizeof(swif_async_decoder_t));
+    adec->event_fd = -1;
+    adec->in_mask = adec->out_mask = size - 1;
+    adec->in_tab = calloc(size, sizeof(swif_async_msg_t));
+    adec->out_tab = calloc(size, sizeof(swif_engine_event_t));
+    if (adec->in_tab == NULL || adec->out_tab == NULL) {
+        fprintf(stderr, "swif_async_decoder_create() failed! No memory\n");
+        goto error;
+    }
+    adec->dec = swif_decoder_create(codepoint, verbosity, symbol_size,
+                                    max_coding_window_size, max_linear_system_size);
+    if (adec->dec == NULL
+        || swif_decoder_set_callback_functions(adec->dec, NULL, NULL, swif_async_decoder_decoded, adec) != SWIF_STATUS_OK) {
+        fprintf(stderr, "swif_async_decoder_create() failed! cannot create the decoder\n");
+        goto error;
+    }
+#if defined(__linux__)
+    adec->event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    adec->armed = 1;
+#endif
+    if (pthread_create(&adec->thread, NULL, swif_async_decoder_worker_main, adec) != 0) {
+        fprintf(stderr, "swif_async_decoder_create() failed! cannot create the worker\n");
+        goto error;
+    }
+    adec->started = true;
+    return adec;
+
+error:
+    swif_async_decoder_release(adec);
+    return NULL;
+}
+
+
+swif_status_t   swif_async_decoder_release (swif_async_decoder_t* adec)
+{
+    swif_engine_event_t	ev[16];
+    uint32_t		n;
+
+    assert(adec);
+    __atomic_store_n(&adec->stop, 1, __ATOMIC_RELEASE);
+    /* the worker may wait for room in the event ring */
+    for (;;) {
+        bool exited = !adec->started || __atomic_load_n(&adec->exited, __ATOMIC_ACQUIRE);
+        while ((n = swif_async_decoder_poll(adec, ev, 16)) > 0) {
+            while (n > 0) {
+                if (ev[--n].type == SWIF_ENGINE_EV_DECODED) {
+                    free(ev[n].buf);
+                }
+            }
+        }
+        if (exited) {
+            break;
+        }
+        sched_yield();
+    }
+    if (adec->started) {
+        pthread_join(adec->thread, NULL);
+    }
+    if (adec->dec != NULL) {
+        swif_decoder_release(adec->dec);
+    }
+    if (adec->event_fd >= 0) {
+        close(adec->event_fd);
+    }
+    free(adec->in_tab);
+    free(adec->out_tab);
+    free(adec);
+    return SWIF_STATUS_OK;
+}
+
+
+int             swif_async_decoder_get_event_fd (swif_async_decoder_t* adec)
+{
+    return adec->event_fd;
+}
+
+
+static swif_status_t swif_async_decoder_submit (swif_async_decoder_t*    adec,
+                                                const swif_async_msg_t*  msg)
+{
+    uint32_t tail = adec->in_tail;
+
+    if (tail - __atomic_load_n(&adec->in_head, __ATOMIC_ACQUIRE) > adec->in_mask) {
+        return SWIF_STATUS_FAILURE;
+    }
+    adec->in_tab[tail & adec->in_mask] = *msg;
+    __atomic_store_n(&adec->in_tail, tail + 1, __ATOMIC_RELEASE);
+    return SWIF_STATUS_OK;
+}
+
+
+swif_status_t   swif_async_decoder_submit_source_symbol (
+                                swif_async_decoder_t* adec,
+                                void*           buf,
+                                esi_t           esi)
+{
+    swif_async_msg_t msg = { SWIF_ASYNC_OP_SOURCE_SYMBOL, buf, esi, 0, 0 };
+
+    return swif_async_decoder_submit(adec, &msg);
+}
+
+
+swif_status_t   swif_async_decoder_submit_repair_symbol (
+                                swif_async_decoder_t* adec,
+                                void*           buf,
+                                esi_t           first_esi,
+                                uint32_t        nss,
+                                uint32_t        key)
+{
+    swif_async_msg_t msg = { SWIF_ASYNC_OP_REPAIR_SYMBOL, buf, first_esi, nss, key };
+
+    return swif_async_decoder_submit(adec, &msg);
+}
+
+
+uint32_t        swif_async_decoder_poll (
+                                swif_async_decoder_t*   adec,
+                                swif_engine_event_t*    event_tab,
+                                uint32_t                max_events)
+{
+    uint32_t head = adec->out_head;
+    uint32_t n;
+
+    /* armed still set: nothing was notified since the last call */
+    if (adec->event_fd >= 0 && !__atomic_load_n(&adec->armed, __ATOMIC_SEQ_CST)) {
+        uint64_t count;
+        if (read(adec->event_fd, &count, sizeof(count)) < 0) {
+            /* EAGAIN: not notified */
+        }
+        /* before looking at the ring, see swif_async_decoder_post() */
+        __atomic_store_n(&adec->armed, 1, __ATOMIC_SEQ_CST);
+    }
+    n = __atomic_load_n(&adec->out_tail, __ATOMIC_SEQ_CST) - head;
+    n = MIN(n, max_events);
+    for (uint32_t i = 0; i < n; i++) {
+        event_tab[i] = adec->out_tab[(head + i) & adec->out_mask];
+    }
+    __atomic_store_n(&adec->out_head, head + n, __ATOMIC_RELEASE);
+    return n;
+}
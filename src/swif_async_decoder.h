@@ -0,0 +1,97 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+#ifndef SWIF_ASYNC_DECODER_H
+#define SWIF_ASYNC_DECODER_H
+#include "swif_includes.h"
+#include "swif_engine.h"
+
+
+/**
+ * Asynchronous decoder: a decoder run by its own worker thread, so that
+ * the receiving thread never pays for decoding (e.g. the elimination
+ * work of a repair symbol during a loss burst).
+ * One thread (the I/O thread) submits the symbols received through a
+ * lock-free ring (one producer, one consumer), and one thread (possibly
+ * the same) polls the results from a second ring. Decoding itself is
+ * the one of swif_decoder_t, whose synchronous API is unchanged.
+ *
+ * Results are swif_engine_event_t events (flow_id is always 0), with the
+ * buffer ownership rules of swif_engine.h: every submitted buffer comes
+ * back once, in a SWIF_ENGINE_EV_RELEASED or SWIF_ENGINE_EV_ERROR event,
+ * and the buffers of SWIF_ENGINE_EV_DECODED events belong to the
+ * application.
+ */
+typedef struct swif_async_decoder swif_async_decoder_t;
+
+
+/**
+ * Create an asynchronous decoder and start its worker.
+ *
+ * @param codepoint, verbosity, symbol_size, max_coding_window_size,
+ *        max_linear_system_size
+ *                      (IN) as in swif_decoder_create().
+ * @param queue_size    (IN) number of entries of the input and event
+ *                      rings (rounded up to a power of 2).
+ * @return              the decoder, or NULL in case of error.
+ */
+swif_async_decoder_t* swif_async_decoder_create (
+                                swif_codepoint_t codepoint,
+                                uint32_t        verbosity,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size,
+                                uint32_t        max_linear_system_size,
+                                uint32_t        queue_size);
+
+/**
+ * Stop the worker once all the symbols submitted are processed, and
+ * release the decoder. The events not polled are discarded (the buffers
+ * of SWIF_ENGINE_EV_DECODED events being freed).
+ */
+swif_status_t   swif_async_decoder_release (swif_async_decoder_t* adec);
+
+/**
+ * Return a file descriptor that becomes readable when events are
+ * available (an eventfd, Linux only), to wait with poll(), select() or
+ * epoll, or -1 if not supported (then swif_async_decoder_poll() must be
+ * called periodically). It is cleared by swif_async_decoder_poll().
+ */
+int             swif_async_decoder_get_event_fd (swif_async_decoder_t* adec);
+
+/**
+ * Submit a received source symbol (resp. a received repair symbol, that
+ * covers nss source symbols from first_esi, with the coding coefficients
+ * of key). The buffer is owned by the decoder until it is returned.
+ * Single producer: only one thread at a time may submit.
+ *
+ * @return              SWIF_STATUS_FAILURE if the input ring is full
+ *                      (nothing is done, retry later), SWIF_STATUS_OK
+ *                      otherwise.
+ */
+swif_status_t   swif_async_decoder_submit_source_symbol (
+                                swif_async_decoder_t* adec,
+                                void*           buf,
+                                esi_t           esi);
+
+swif_status_t   swif_async_decoder_submit_repair_symbol (
+                                swif_async_decoder_t* adec,
+                                void*           buf,
+                                esi_t           first_esi,
+                                uint32_t        nss,
+                                uint32_t        key);
+
+/**
+ * Retrieve up to max_events events. Call it again until it returns less
+ * than max_events: the event fd is only notified again for new events.
+ * The worker waits when the event ring is full.
+ *
+ * @return              number of events copied to event_tab.
+ */
+uint32_t        swif_async_decoder_poll (
+                                swif_async_decoder_t*   adec,
+                                swif_engine_event_t*    event_tab,
+                                uint32_t                max_events);
+
+#endif /* SWIF_ASYNC_DECODER_H */
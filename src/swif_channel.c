@@ -0,0 +1,220 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+/**
+ * Loss channel models, see swif_channel.h.
+ */
+
+#include "swif_includes.h"
+#include "swif_channel.h"
+
+
+struct swif_channel {
+	swif_channel_model_t	model;
+	uint64_t		prng;
+	/* probabilities, as thresholds on 53-bit random values */
+	uint64_t		loss_good;	/* or loss_rate */
+	uint64_t		loss_bad;
+	uint64_t		p_good_to_bad;
+	uint64_t		p_bad_to_good;
+	bool			bad;
+	uint8_t*		trace;
+	uint32_t		trace_len;
+	uint32_t		trace_pos;
+};
+
+
+static bool swif_channel_is_proba (double p)
+{
+    return p >= 0 && p <= 1;
+}
+
+static inline uint64_t swif_channel_threshold (double p)
+{
+    return (uint64_t)(p * 9007199254740992.0);	/* 2^53 */
+}
+
+/* xorshift64*, on 53 bits */
+static inline uint64_t swif_channel_rand (swif_channel_t* channel)
+{
+    uint64_t x = channel->prng;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    channel->prng = x;
+    return (x * 0x2545F4914F6CDD1DULL) >> 11;
+}
+
+/* splitmix64, so that close seeds give unrelated sequences (never 0) */
+static uint64_t swif_channel_seed (uint64_t seed)
+{
+    uint64_t z = seed + 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return (z != 0) ? z : 1;
+}
+
+
+double swif_channel_get_mean_loss_rate (const swif_channel_params_t*  params)
+{
+    switch (params->model) {
+    case SWIF_CHANNEL_BERNOULLI:
+        if (!swif_channel_is_proba(params->loss_rate)) {
+            return -1;
+        }
+        return params->loss_rate;
+
+    case SWIF_CHANNEL_GILBERT_ELLIOTT: {
+        double p = params->p_good_to_bad, q = params->p_bad_to_good;
+        if (!swif_channel_is_proba(p) || !swif_channel_is_proba(q)
+            || !swif_channel_is_proba(params->loss_good) || !swif_channel_is_proba(params->loss_bad)) {
+            return -1;
+        }
+        if (p + q == 0) {
+            return params->loss_good;	/* never leaves the good state */
+        }
+        return (q * params->loss_good + p * params->loss_bad) / (p + q);
+    }
+
+    case SWIF_CHANNEL_TRACE: {
+        uint32_t nb_lost = 0;
+        if (params->trace == NULL || params->trace_len == 0) {
+            return -1;
+        }
+        for (uint32_t i = 0; i < params->trace_len; i++) {
+            nb_lost += (params->trace[i] != 0);
+        }
+        return (double)nb_lost / params->trace_len;
+    }
+
+    default:
+        return -1;
+    }
+}
+
+
+swif_channel_t* swif_channel_create (const swif_channel_params_t*  params,
+                                     uint64_t                      seed)
+{
+    swif_channel_t	*channel;
+
+    if (swif_channel_get_mean_loss_rate(params) < 0) {
+        fprintf(stderr, "swif_channel_create() failed! bad parameters\n");
+        return NULL;
+    }
+    if ((channel = calloc(1, sizeof(swif_channel_t))) == NULL) {
+        fprintf(stderr, "swif_channel_create() failed! No memory\n");
+        return NULL;
+    }
+    channel->model = params->model;
+    channel->prng = swif_channel_seed(seed);
+    switch (params->model) {
+    case SWIF_CHANNEL_BERNOULLI:
+        channel->loss_good = swif_channel_threshold(params->loss_rate);
+        break;
+
+    case SWIF_CHANNEL_GILBERT_ELLIOTT:
+        channel->loss_good = swif_channel_threshold(params->loss_good);
+        channel->loss_bad = swif_channel_threshold(params->loss_bad);
+        channel->p_good_to_bad = swif_channel_threshold(params->p_good_to_bad);
+        channel->p_bad_to_good = swif_channel_threshold(params->p_bad_to_good);
+        break;
+
+    case SWIF_CHANNEL_TRACE:
+        if ((channel->trace = malloc(params->trace_len)) == NULL) {
+            fprintf(stderr, "swif_channel_create() failed! No memory\n");
+            free(channel);
+            return NULL;
+        }
+        memcpy(channel->trace, params->trace, params->trace_len);
+        channel->trace_len = params->trace_len;
+        channel->trace_pos = params->trace_offset % params->trace_len;
+        break;
+    }
+    return channel;
+}
+
+
+void swif_channel_release (swif_channel_t*  channel)
+{
+    if (channel != NULL) {
+        free(channel->trace);
+        free(channel);
+    }
+}
+
+
+bool swif_channel_is_lost (swif_channel_t*  channel)
+{
+    bool lost;
+
+    switch (channel->model) {
+    case SWIF_CHANNEL_BERNOULLI:
+        return swif_channel_rand(channel) < channel->loss_good;
+
+    case SWIF_CHANNEL_GILBERT_ELLIOTT:
+        if (channel->bad) {
+            lost = swif_channel_rand(channel) < channel->loss_bad;
+            channel->bad = !(swif_channel_rand(channel) < channel->p_bad_to_good);
+        } else {
+            lost = swif_channel_rand(channel) < channel->loss_good;
+            channel->bad = swif_channel_rand(channel) < channel->p_good_to_bad;
+        }
+        return lost;
+
+    case SWIF_CHANNEL_TRACE:
+        lost = channel->trace[channel->trace_pos] != 0;
+        if (++channel->trace_pos == channel->trace_len) {
+            channel->trace_pos = 0;
+        }
+        return lost;
+
+    default:
+        return false;
+    }
+}
+
+
+swif_status_t swif_channel_load_trace (const char*  path,
+                                       uint8_t**    trace,
+                                       uint32_t*    trace_len)
+{
+    FILE	*f;
+    uint8_t	*tab = NULL;
+    uint32_t	len = 0, size = 0;
+    int		c;
+
+    if ((f = fopen(path, "r")) == NULL) {
+        fprintf(stderr, "swif_channel_load_trace() failed! cannot open %s\n", path);
+        return SWIF_STATUS_ERROR;
+    }
+    while ((c = getc(f)) != EOF) {
+        if (c != '0' && c != '1') {
+            continue;
+        }
+        if (len == size) {
+            uint8_t *new_tab;
+            size = (size == 0) ? 4096 : 2 * size;
+            if (size == 0 || (new_tab = realloc(tab, size)) == NULL) {
+                fprintf(stderr, "swif_channel_load_trace() failed! No memory\n");
+                free(tab);
+                fclose(f);
+                return SWIF_STATUS_ERROR;
+            }
+            tab = new_tab;
+        }
+        tab[len++] = (c == '1');
+    }
+    fclose(f);
+    if (len == 0) {
+        fprintf(stderr, "swif_channel_load_trace() failed! no entry in %s\n", path);
+        free(tab);
+        return SWIF_STATUS_ERROR;
+    }
+    *trace = tab;
+    *trace_len = len;
+    return SWIF_STATUS_OK;
+}
@@ -0,0 +1,98 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+#ifndef SWIF_CHANNEL_H
+#define SWIF_CHANNEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "swif_api.h"
+
+
+/**
+ * Loss channel: a packet erasure model, to evaluate the codec in process
+ * (see swif_simulator.h) instead of with closed-form estimations.
+ * Each call to swif_channel_is_lost() is one packet sent, source or
+ * repair, and tells whether it is erased. A channel has its own seeded
+ * PRNG: the same parameters and seed give the same losses.
+ * A channel is used by a single thread.
+ */
+typedef struct swif_channel swif_channel_t;
+
+typedef enum {
+	/* independent losses, with probability loss_rate */
+	SWIF_CHANNEL_BERNOULLI = 1,
+	/* two-state Markov chain (Gilbert-Elliott): each packet is lost
+	 * with probability loss_good (resp. loss_bad) in the good (resp. bad)
+	 * state, then the chain moves from good to bad with probability
+	 * p_good_to_bad, and from bad to good with probability p_bad_to_good.
+	 * Loss bursts last 1 / p_bad_to_good packets on average with
+	 * loss_good = 0 and loss_bad = 1 (Gilbert model). */
+	SWIF_CHANNEL_GILBERT_ELLIOTT,
+	/* replay of a recorded loss trace, cyclically */
+	SWIF_CHANNEL_TRACE
+} swif_channel_model_t;
+
+typedef struct swif_channel_params {
+	swif_channel_model_t	model;
+	/* SWIF_CHANNEL_BERNOULLI */
+	double			loss_rate;
+	/* SWIF_CHANNEL_GILBERT_ELLIOTT, starting in the good state */
+	double			p_good_to_bad;
+	double			p_bad_to_good;
+	double			loss_good;
+	double			loss_bad;
+	/* SWIF_CHANNEL_TRACE: trace_len entries, 1 for a lost packet, 0
+	 * otherwise (copied by swif_channel_create()), replayed from entry
+	 * trace_offset (modulo trace_len) */
+	const uint8_t*		trace;
+	uint32_t		trace_len;
+	uint32_t		trace_offset;
+} swif_channel_params_t;
+
+
+/**
+ * Create a channel.
+ *
+ * @param params        (IN) the model and its parameters.
+ * @param seed          (IN) seed of the PRNG (unused with a trace).
+ * @return              the channel, or NULL in case of error (bad
+ *                      parameters or no memory).
+ */
+swif_channel_t* swif_channel_create (const swif_channel_params_t*  params,
+                                     uint64_t                      seed);
+
+/**
+ * Release a channel.
+ */
+void            swif_channel_release (swif_channel_t*  channel);
+
+/**
+ * Send a packet through the channel: return true if it is lost.
+ */
+bool            swif_channel_is_lost (swif_channel_t*  channel);
+
+/**
+ * Return the long-term loss rate of a model (the stationary one of a
+ * Gilbert-Elliott channel, the proportion of losses of a trace), or a
+ * negative value with bad parameters.
+ */
+double          swif_channel_get_mean_loss_rate (const swif_channel_params_t*  params);
+
+/**
+ * Load a loss trace from a text file: each '1' (lost packet) or '0'
+ * (received packet) character is an entry, any other character (e.g.
+ * separators, end of lines) being ignored.
+ *
+ * @param trace         (OUT) the trace, to be released with free().
+ * @param trace_len     (OUT) its number of entries.
+ * @return              SWIF_STATUS_OK, or SWIF_STATUS_ERROR if the file
+ *                      cannot be read or has no entry.
+ */
+swif_status_t   swif_channel_load_trace (const char*  path,
+                                         uint8_t**    trace,
+                                         uint32_t*    trace_len);
+
+#endif /* SWIF_CHANNEL_H */
@@ -30,8 +30,10 @@
  *                    (i.e. equal to 1 with GF(2) and equal to a
  *                    value in {1,... 255} with GF(2^^8)), otherwise
  *                    a fraction of them will be 0.
- * (in) m             Finite Field GF(2^^m) parameter. In this
- *                    document only values 1 and 8 are considered.
+ * (in) m             Finite Field GF(2^^m) parameter. The RLC
+ *                    document only considers values 1 and 8; value 4
+ *                    (GF(2^^4)) is a local extension that draws values
+ *                    in {1,... 15} the same way as with GF(2^^8).
  * (out)              returns 0 in case of success, an error code
  *                    different than 0 otherwise.
  */
@@ -61,6 +63,7 @@ int swif_rlc_generate_coding_coefficients (uint16_t  repair_key,
         }
         break;
 
+    case 4:
     case 8:
         tinymt32_init(&s, repair_key);
         if (dt == 15) {
@@ -68,7 +71,7 @@ int swif_rlc_generate_coding_coefficients (uint16_t  repair_key,
              * all the source symbols */
             for (i = 0 ; i < cc_nb ; i++) {
                 do {
-                    cc_tab[i] = (uint8_t) tinymt32_rand256(&s);
+                    cc_tab[i] = (uint8_t) ((m == 8) ? tinymt32_rand256(&s) : tinymt32_rand16(&s));
                 } while (cc_tab[i] == 0);
             }
         } else {
@@ -76,7 +79,7 @@ int swif_rlc_generate_coding_coefficients (uint16_t  repair_key,
             for (i = 0 ; i < cc_nb ; i++) {
                 if (tinymt32_rand16(&s) <= dt) {
                     do {
-                        cc_tab[i] = (uint8_t) tinymt32_rand256(&s);
+                        cc_tab[i] = (uint8_t) ((m == 8) ? tinymt32_rand256(&s) : tinymt32_rand16(&s));
                     } while (cc_tab[i] == 0);
                 } else {
                     cc_tab[i] = 0;
@@ -91,3 +94,338 @@ int swif_rlc_generate_coding_coefficients (uint16_t  repair_key,
     return 0; /* success */
 }
 
+
+
+int swif_rlc_generate_coding_coefficients_multi (const uint16_t  repair_key_tab[],
+                                                 uint8_t*        cc_tab_tab[],
+                                                 uint16_t        cc_nb,
+                                                 uint32_t        nb_keys,
+                                                 uint8_t         dt,
+                                                 uint8_t         m)
+{
+    tinymt32_multi_t	s;	/* PRNG internal states */
+    uint32_t		seed[TINYMT32_MULTI_LANES];
+    uint32_t		r[TINYMT32_MULTI_LANES];
+    uint8_t*		cc_tab[TINYMT32_MULTI_LANES];
+    uint32_t		i[TINYMT32_MULTI_LANES];	/* next coef of each lane */
+    bool		draw_value[TINYMT32_MULTI_LANES];
+    uint32_t		k;
+    uint32_t		l;
+    uint32_t		nb_lanes;
+    uint32_t		nb_done;
+    uint8_t		c;
+    uint32_t		value_mask = (m == 8) ? 0xFF : 0xF;
+
+    if (dt > 15) {
+        return -1; /* error, bad dt parameter */
+    }
+    if (m != 1 && m != 4 && m != 8) {
+        return -2; /* error, bad parameter m */
+    }
+    if (m == 1 && dt == 15) {
+        /* all coefficients are 1 */
+        for (k = 0; k < nb_keys; k++) {
+            memset(cc_tab_tab[k], 1, cc_nb);
+        }
+        return 0;
+    }
+    for (k = 0; k < nb_keys; k += nb_lanes) {
+        nb_lanes = MIN(nb_keys - k, TINYMT32_MULTI_LANES);
+        for (l = 0; l < TINYMT32_MULTI_LANES; l++) {
+            /* unused lanes are simply ignored */
+            seed[l] = (l < nb_lanes) ? repair_key_tab[k + l] : 0;
+            cc_tab[l] = (l < nb_lanes) ? cc_tab_tab[k + l] : NULL;
+            i[l] = (l < nb_lanes) ? 0 : cc_nb;
+            draw_value[l] = (m != 1 && dt == 15);
+        }
+        tinymt32_multi_init(&s, seed);
+        /* all lanes draw the same number of values, but each lane
+         * consumes them as swif_rlc_generate_coding_coefficients()
+         * would, so they don't progress at the same pace */
+        nb_done = TINYMT32_MULTI_LANES - nb_lanes + ((cc_nb == 0) ? nb_lanes : 0);
+        while (nb_done < TINYMT32_MULTI_LANES) {
+            tinymt32_multi_generate_uint32(&s, r);
+            for (l = 0; l < nb_lanes; l++) {
+                if (i[l] >= cc_nb) {
+                    continue;
+                }
+                if (m == 1) {
+                    cc_tab[l][i[l]++] = ((r[l] & 0xF) <= dt) ? 1 : 0;
+                } else if (draw_value[l]) {
+                    /* coefficient 0 is avoided here */
+                    if ((c = (uint8_t)(r[l] & value_mask)) != 0) {
+                        cc_tab[l][i[l]++] = c;
+                        draw_value[l] = (dt == 15);
+                    }
+                } else if ((r[l] & 0xF) <= dt) {
+                    draw_value[l] = true;
+                } else {
+                    cc_tab[l][i[l]++] = 0;
+                }
+                if (i[l] == cc_nb) {
+                    nb_done++;
+                }
+            }
+        }
+    }
+    return 0; /* success */
+}
+
+
+/*
+ * Coding coefficients cache.
+ */
+
+#define CC_CACHE_NONE	((uint32_t)-1)
+
+typedef struct {
+    uint16_t	repair_key;
+    uint8_t	dt;
+    uint8_t	m;
+    bool	in_hash;	/* linked in its hash bucket (i.e. used) */
+    uint32_t	hash_next;	/* next entry in the same hash bucket */
+    uint32_t	lru_prev;	/* more recently used entry */
+    uint32_t	lru_next;	/* less recently used entry */
+    uint8_t*	cc_tab;		/* max_cc_nb bytes within cc_block */
+} swif_cc_cache_entry_t;
+
+struct swif_cc_cache {
+    uint32_t			nb_entries;
+    uint16_t			max_cc_nb;
+    swif_cc_cache_entry_t*	entry_tab;
+    uint8_t*			cc_block;
+    uint32_t*			hash_tab;	/* first entry of each bucket */
+    uint32_t			hash_mask;
+    uint32_t			lru_head;	/* most recently used */
+    uint32_t			lru_tail;	/* least recently used */
+    /* optional table of max_cc_nb coefficients for each key */
+    uint8_t*			precomp_tab;
+    uint8_t			precomp_dt;
+    uint8_t			precomp_m;
+    uint64_t			hits;
+    uint64_t			misses;
+};
+
+
+static inline uint32_t cc_cache_hash (const swif_cc_cache_t*  cache,
+                                      uint16_t                repair_key,
+                                      uint8_t                 dt,
+                                      uint8_t                 m)
+{
+    uint32_t h = ((uint32_t)repair_key | ((uint32_t)dt << 16) | ((uint32_t)m << 20));
+    return (h * 2654435761u >> 8) & cache->hash_mask;
+}
+
+
+static void cc_cache_lru_unlink (swif_cc_cache_t*  cache,
+                                 uint32_t          idx)
+{
+    swif_cc_cache_entry_t *e = &cache->entry_tab[idx];
+
+    if (e->lru_prev != CC_CACHE_NONE)
+        cache->entry_tab[e->lru_prev].lru_next = e->lru_next;
+    else
+        cache->lru_head = e->lru_next;
+    if (e->lru_next != CC_CACHE_NONE)
+        cache->entry_tab[e->lru_next].lru_prev = e->lru_prev;
+    else
+        cache->lru_tail = e->lru_prev;
+}
+
+
+static void cc_cache_lru_push_front (swif_cc_cache_t*  cache,
+                                     uint32_t          idx)
+{
+    swif_cc_cache_entry_t *e = &cache->entry_tab[idx];
+
+    e->lru_prev = CC_CACHE_NONE;
+    e->lru_next = cache->lru_head;
+    if (cache->lru_head != CC_CACHE_NONE)
+        cache->entry_tab[cache->lru_head].lru_prev = idx;
+    else
+        cache->lru_tail = idx;
+    cache->lru_head = idx;
+}
+
+
+static void cc_cache_hash_remove (swif_cc_cache_t*  cache,
+                                  uint32_t          idx)
+{
+    swif_cc_cache_entry_t *e = &cache->entry_tab[idx];
+    uint32_t *p = &cache->hash_tab[cc_cache_hash(cache, e->repair_key, e->dt, e->m)];
+
+    while (*p != idx) {
+        assert(*p != CC_CACHE_NONE);
+        p = &cache->entry_tab[*p].hash_next;
+    }
+    *p = e->hash_next;
+}
+
+
+swif_cc_cache_t* swif_cc_cache_create (uint32_t  nb_entries,
+                                       uint16_t  max_cc_nb)
+{
+    swif_cc_cache_t	*cache;
+    uint32_t		hash_size;
+    uint32_t		i;
+
+    if (max_cc_nb == 0) {
+        fprintf(stderr, "swif_cc_cache_create() failed! max_cc_nb must be > 0\n");
+        return NULL;
+    }
+    if ((cache = calloc(1, sizeof(swif_cc_cache_t))) == NULL) {
+        goto no_mem;
+    }
+    cache->nb_entries = nb_entries;
+    cache->max_cc_nb = max_cc_nb;
+    cache->lru_head = cache->lru_tail = CC_CACHE_NONE;
+    /* power of two, at least twice the number of entries */
+    for (hash_size = 1; hash_size < 2 * nb_entries; hash_size <<= 1);
+    cache->hash_mask = hash_size - 1;
+    if ((cache->hash_tab = malloc(hash_size * sizeof(uint32_t))) == NULL) {
+        goto no_mem;
+    }
+    for (i = 0; i < hash_size; i++) {
+        cache->hash_tab[i] = CC_CACHE_NONE;
+    }
+    if (nb_entries > 0) {
+        if ((cache->entry_tab = calloc(nb_entries, sizeof(swif_cc_cache_entry_t))) == NULL
+            || (cache->cc_block = malloc((size_t)nb_entries * max_cc_nb)) == NULL) {
+            goto no_mem;
+        }
+        /* all entries are initially unused and in LRU order */
+        for (i = 0; i < nb_entries; i++) {
+            cache->entry_tab[i].cc_tab = cache->cc_block + (size_t)i * max_cc_nb;
+            cache->entry_tab[i].hash_next = CC_CACHE_NONE;
+            cc_cache_lru_push_front(cache, i);
+        }
+    }
+    return cache;
+
+no_mem:
+    fprintf(stderr, "swif_cc_cache_create() failed! No memory\n");
+    swif_cc_cache_release(cache);
+    return NULL;
+}
+
+
+void swif_cc_cache_release (swif_cc_cache_t*  cache)
+{
+    if (cache == NULL)
+        return;
+    free(cache->entry_tab);
+    free(cache->cc_block);
+    free(cache->hash_tab);
+    free(cache->precomp_tab);
+    free(cache);
+}
+
+
+int swif_cc_cache_precompute_all_keys (swif_cc_cache_t*  cache,
+                                       uint8_t           dt,
+                                       uint8_t           m)
+{
+    uint8_t	*tab;
+    uint16_t	key_tab[TINYMT32_MULTI_LANES];
+    uint8_t	*cc_tab_tab[TINYMT32_MULTI_LANES];
+    uint32_t	key;
+    uint32_t	l;
+    int		err;
+
+    if ((tab = malloc((size_t)65536 * cache->max_cc_nb)) == NULL) {
+        fprintf(stderr, "swif_cc_cache_precompute_all_keys() failed! No memory\n");
+        return -3;
+    }
+    for (key = 0; key < 65536; key += TINYMT32_MULTI_LANES) {
+        for (l = 0; l < TINYMT32_MULTI_LANES; l++) {
+            key_tab[l] = (uint16_t)(key + l);
+            cc_tab_tab[l] = tab + (size_t)(key + l) * cache->max_cc_nb;
+        }
+        err = swif_rlc_generate_coding_coefficients_multi(key_tab, cc_tab_tab,
+                    cache->max_cc_nb, TINYMT32_MULTI_LANES, dt, m);
+        if (err != 0) {
+            free(tab);
+            return err;
+        }
+    }
+    free(cache->precomp_tab);
+    cache->precomp_tab = tab;
+    cache->precomp_dt = dt;
+    cache->precomp_m = m;
+    return 0;
+}
+
+
+int swif_cc_cache_get_coding_coefficients (swif_cc_cache_t*  cache,
+                                           uint16_t          repair_key,
+                                           uint8_t           cc_tab[],
+                                           uint16_t          cc_nb,
+                                           uint8_t           dt,
+                                           uint8_t           m)
+{
+    swif_cc_cache_entry_t	*e;
+    uint32_t			h;
+    uint32_t			idx;
+
+    if (cache == NULL || cc_nb == 0 || cc_nb > cache->max_cc_nb || dt > 15
+        || (m != 1 && m != 4 && m != 8) || (m == 1 && dt == 15)) {
+        /* nothing to cache (bad parameters are reported by the
+         * generator, m=1/dt=15 is only a memset, and an empty vector
+         * is never worth an entry) */
+        return swif_rlc_generate_coding_coefficients(repair_key, cc_tab, cc_nb, dt, m);
+    }
+    if (cache->precomp_tab != NULL && dt == cache->precomp_dt && m == cache->precomp_m) {
+        memcpy(cc_tab, cache->precomp_tab + (size_t)repair_key * cache->max_cc_nb, cc_nb);
+        cache->hits++;
+        return 0;
+    }
+    if (cache->nb_entries == 0) {
+        cache->misses++;
+        return swif_rlc_generate_coding_coefficients(repair_key, cc_tab, cc_nb, dt, m);
+    }
+    h = cc_cache_hash(cache, repair_key, dt, m);
+    for (idx = cache->hash_tab[h]; idx != CC_CACHE_NONE; idx = cache->entry_tab[idx].hash_next) {
+        e = &cache->entry_tab[idx];
+        if (e->repair_key == repair_key && e->dt == dt && e->m == m) {
+            break;
+        }
+    }
+    if (idx != CC_CACHE_NONE) {
+        /* hit: cached vectors always hold max_cc_nb coefficients */
+        e = &cache->entry_tab[idx];
+        memcpy(cc_tab, e->cc_tab, cc_nb);
+        cache->hits++;
+    } else {
+        /* recycle the least recently used entry. Shorter vectors are a
+         * prefix of longer ones, so generate the longest one once and
+         * serve every later window size of this key from it */
+        cache->misses++;
+        idx = cache->lru_tail;
+        e = &cache->entry_tab[idx];
+        if (e->in_hash) {
+            cc_cache_hash_remove(cache, idx);
+        }
+        e->repair_key = repair_key;
+        e->dt = dt;
+        e->m = m;
+        e->hash_next = cache->hash_tab[h];
+        cache->hash_tab[h] = idx;
+        e->in_hash = true;
+        swif_rlc_generate_coding_coefficients(repair_key, e->cc_tab, cache->max_cc_nb, dt, m);
+        memcpy(cc_tab, e->cc_tab, cc_nb);
+    }
+    if (cache->lru_head != idx) {
+        cc_cache_lru_unlink(cache, idx);
+        cc_cache_lru_push_front(cache, idx);
+    }
+    return 0;
+}
+
+
+void swif_cc_cache_get_stats (const swif_cc_cache_t*  cache,
+                              uint64_t*               hits,
+                              uint64_t*               misses)
+{
+    *hits = cache->hits;
+    *misses = cache->misses;
+}
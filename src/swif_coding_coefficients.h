@@ -3,6 +3,11 @@
  * https://github.com/irtf-nwcrg/swif-codec
  */
 
+#ifndef __SWIF_CODING_COEFFICIENTS_H__
+#define __SWIF_CODING_COEFFICIENTS_H__
+
+#include <stdint.h>
+
 
 /**
  * Coding coefficients generator coming from RLC FEC Scheme Internet-Draft:
@@ -28,8 +33,10 @@
  *                    (i.e. equal to 1 with GF(2) and equal to a
  *                    value in {1,... 255} with GF(2^^8)), otherwise
  *                    a fraction of them will be 0.
- * (in) m             Finite Field GF(2^^m) parameter. In this
- *                    document only values 1 and 8 are considered.
+ * (in) m             Finite Field GF(2^^m) parameter. The RLC
+ *                    document only considers values 1 and 8; value 4
+ *                    (GF(2^^4)) is a local extension that draws values
+ *                    in {1,... 15} the same way as with GF(2^^8).
  * (out)              returns 0 in case of success, an error code
  *                    different than 0 otherwise.
  */
@@ -39,3 +46,109 @@ int swif_rlc_generate_coding_coefficients (uint16_t  repair_key,
                                            uint8_t   dt,
                                            uint8_t   m);
 
+
+/*
+ * Batch version of swif_rlc_generate_coding_coefficients(), for
+ * several repair keys at once (e.g. when several repair symbols are
+ * built for the same coding window). The PRNGs of up to
+ * TINYMT32_MULTI_LANES keys are stepped together (see swif_prng.h),
+ * and the result for each key is identical to that of
+ * swif_rlc_generate_coding_coefficients().
+ *
+ * (in) repair_key_tab[] table of nb_keys repair keys.
+ * (in/out) cc_tab_tab[] table of nb_keys pointers to tables of cc_nb
+ *                    entries, cc_tab_tab[k] receiving the coding
+ *                    coefficients of repair_key_tab[k].
+ * (in) cc_nb         number of coefficients per key.
+ * (in) nb_keys       number of keys.
+ * (in) dt, m         same as swif_rlc_generate_coding_coefficients().
+ * (out)              returns 0 in case of success, an error code
+ *                    different than 0 otherwise.
+ */
+int swif_rlc_generate_coding_coefficients_multi (const uint16_t  repair_key_tab[],
+                                                 uint8_t*        cc_tab_tab[],
+                                                 uint16_t        cc_nb,
+                                                 uint32_t        nb_keys,
+                                                 uint8_t         dt,
+                                                 uint8_t         m);
+
+
+/*
+ * Coding coefficients cache.
+ *
+ * Generating coefficients requires a PRNG initialization (with its
+ * warm-up iterations) and rejection sampling, on both the encoder and
+ * the decoder, for each repair symbol. Since repair keys are usually
+ * reused (they are 16-bit and often cycle through a small set), an
+ * LRU cache of already generated coefficient vectors, keyed by
+ * (repair_key, dt, m), avoids most of this work.
+ *
+ * Because the coefficients for cc_nb symbols are the first cc_nb
+ * coefficients of those for any larger window with the same key, each
+ * entry is filled with max_cc_nb coefficients on a miss and then
+ * serves any request for that key, whatever the window size.
+ *
+ * A cache may also hold a precomputed table for the whole 16-bit key
+ * space, for a single (dt, m) pair. Once built, this table is only
+ * read, so it can be shared by any number of codec instances, in any
+ * thread. The LRU part is updated on each lookup and is therefore not
+ * thread-safe: use one cache per thread, or only the precomputed table.
+ *
+ * A cache is attached to a codec with the
+ * swif_{EN,DE}CODER_SET_PARAM_CODING_COEFS_CACHE parameters and must
+ * outlive all the codecs using it.
+ */
+typedef struct swif_cc_cache swif_cc_cache_t;
+
+/*
+ * Create a cache.
+ *
+ * (in) nb_entries    number of coefficient vectors kept in the LRU
+ *                    cache (0 if only the precomputed table is used).
+ * (in) max_cc_nb     maximum number of coefficients per vector,
+ *                    usually the maximum coding window size. Larger
+ *                    requests bypass the cache.
+ * (out)              returns the cache or NULL in case of error.
+ */
+swif_cc_cache_t* swif_cc_cache_create (uint32_t  nb_entries,
+                                       uint16_t  max_cc_nb);
+
+/*
+ * Release a cache and its precomputed table, if any.
+ */
+void swif_cc_cache_release (swif_cc_cache_t*  cache);
+
+/*
+ * Precompute the max_cc_nb coefficients of each of the 65536 repair
+ * keys for the (dt, m) pair provided. This requires 65536 * max_cc_nb
+ * bytes. A previous precomputed table is replaced.
+ *
+ * (out)              returns 0 in case of success, an error code
+ *                    different than 0 otherwise.
+ */
+int swif_cc_cache_precompute_all_keys (swif_cc_cache_t*  cache,
+                                       uint8_t           dt,
+                                       uint8_t           m);
+
+/*
+ * Same as swif_rlc_generate_coding_coefficients(), using the cache
+ * when possible. The result is always identical to that of
+ * swif_rlc_generate_coding_coefficients(). A NULL cache is accepted,
+ * in which case the coefficients are simply generated.
+ */
+int swif_cc_cache_get_coding_coefficients (swif_cc_cache_t*  cache,
+                                           uint16_t          repair_key,
+                                           uint8_t           cc_tab[],
+                                           uint16_t          cc_nb,
+                                           uint8_t           dt,
+                                           uint8_t           m);
+
+/*
+ * Retrieve the number of lookups served by the cache (precomputed
+ * table included) and of lookups that required a generation.
+ */
+void swif_cc_cache_get_stats (const swif_cc_cache_t*  cache,
+                              uint64_t*               hits,
+                              uint64_t*               misses);
+
+#endif /* __SWIF_CODING_COEFFICIENTS_H__ */
@@ -0,0 +1,705 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+/**
+ * Multi-session engine, see swif_engine.h.
+ */
+
+#define _GNU_SOURCE	/* pthread_setaffinity_np(), nanosleep() */
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "swif_includes.h"
+#include "swif_engine.h"
+
+
+typedef enum {
+	SWIF_ENGINE_OP_CREATE_ENCODER = 1,
+	SWIF_ENGINE_OP_CREATE_DECODER,
+	SWIF_ENGINE_OP_RELEASE_SESSION,
+	SWIF_ENGINE_OP_SOURCE_SYMBOL,
+	SWIF_ENGINE_OP_REPAIR_SYMBOL,
+	SWIF_ENGINE_OP_BUILD_REPAIR
+} swif_engine_op_t;
+
+/* request submitted to a worker */
+typedef struct swif_engine_msg {
+	uint64_t		flow_id;
+	swif_engine_op_t	op;
+	void*			buf;
+	esi_t			esi;
+	uint32_t		nss;
+	uint32_t		key;
+	/* session creation only */
+	swif_codepoint_t	codepoint;
+	uint32_t		symbol_size;
+	uint32_t		max_coding_window_size;
+	uint32_t		max_linear_system_size;
+} swif_engine_msg_t;
+
+/* input queue entry: seq == position when free for this position,
+ * position + 1 once the message is written */
+typedef struct swif_engine_cell {
+	uint32_t		seq;
+	swif_engine_msg_t	msg;
+} swif_engine_cell_t;
+
+/* source symbol kept by an encoder session */
+typedef struct swif_engine_buf {
+	void*			buf;
+	esi_t			esi;
+} swif_engine_buf_t;
+
+typedef struct swif_engine_worker swif_engine_worker_t;
+
+typedef struct swif_engine_session {
+	uint64_t		flow_id;
+	swif_engine_worker_t*	worker;
+	swif_encoder_t*		enc;
+	swif_decoder_t*		dec;
+
+	/* encoder: source symbols of the coding window, oldest first */
+	swif_engine_buf_t*	buf_ring;
+	uint32_t		buf_ring_size;
+	uint32_t		buf_first;
+	uint32_t		nb_bufs;
+
+	struct swif_engine_session* next;
+} swif_engine_session_t;
+
+struct swif_engine_worker {
+	/* input queue: producers share in_tail, only the worker uses in_head */
+	uint32_t		in_tail SWIF_ALIGNED;
+	uint32_t		in_head SWIF_ALIGNED;
+	swif_engine_cell_t*	in_tab;
+	uint32_t		in_mask;
+
+	/* completion ring: out_tail written by the worker, out_head by the
+	 * polling thread */
+	uint32_t		out_tail SWIF_ALIGNED;
+	uint32_t		out_head SWIF_ALIGNED;
+	swif_engine_event_t*	out_tab;
+	uint32_t		out_mask;
+
+	/* worker only: its sessions, hashed by flow ID */
+	swif_engine_session_t**	session_tab SWIF_ALIGNED;
+	uint32_t		session_tab_size;
+	uint32_t		nb_sessions;
+
+	swif_engine_t*		engine;
+	uint32_t		index;
+	pthread_t		thread;
+	bool			started;
+	uint32_t		exited;
+};
+
+struct swif_engine {
+	swif_engine_worker_t*	worker_tab;
+	uint32_t		nb_workers;
+	bool			pin_cpus;
+	uint32_t		stop SWIF_ALIGNED;
+};
+
+
+static uint32_t swif_engine_pow2 (uint32_t n)
+{
+    uint32_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+static uint32_t swif_engine_hash (uint64_t flow_id)
+{
+    return (uint32_t)((flow_id * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+
+/*******************************************************************************
+ * Queues
+ */
+
+/* any producer thread */
+static bool swif_engine_enqueue (swif_engine_worker_t*      w,
+                                 const swif_engine_msg_t*   msg)
+{
+    uint32_t		pos = __atomic_load_n(&w->in_tail, __ATOMIC_RELAXED);
+    swif_engine_cell_t	*cell;
+
+    for (;;) {
+        cell = &w->in_tab[pos & w->in_mask];
+        int32_t diff = (int32_t)(__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0) {
+            /* free entry, try to take it (pos is updated on failure) */
+            if (__atomic_compare_exchange_n(&w->in_tail, &pos, pos + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            /* not consumed yet: full */
+            return false;
+        } else {
+            pos = __atomic_load_n(&w->in_tail, __ATOMIC_RELAXED);
+        }
+    }
+    cell->msg = *msg;
+    __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/* worker thread */
+static bool swif_engine_dequeue (swif_engine_worker_t*  w,
+                                 swif_engine_msg_t*     msg)
+{
+    swif_engine_cell_t	*cell = &w->in_tab[w->in_head & w->in_mask];
+
+    if (__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) != w->in_head + 1) {
+        return false;
+    }
+    *msg = cell->msg;
+    /* free for the producer of the next round */
+    __atomic_store_n(&cell->seq, w->in_head + w->in_mask + 1, __ATOMIC_RELEASE);
+    w->in_head++;
+    return true;
+}
+
+/* worker thread: waits while the ring is full */
+static void swif_engine_post (swif_engine_worker_t*      w,
+                              const swif_engine_event_t* ev)
+{
+    uint32_t tail = w->out_tail;
+
+    while (tail - __atomic_load_n(&w->out_head, __ATOMIC_ACQUIRE) > w->out_mask) {
+        sched_yield();
+    }
+    w->out_tab[tail & w->out_mask] = *ev;
+    __atomic_store_n(&w->out_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+static void swif_engine_post_event (swif_engine_worker_t*     w,
+                                    uint64_t                  flow_id,
+                                    swif_engine_event_type_t  type,
+                                    void*                     buf,
+                                    esi_t                     esi)
+{
+    swif_engine_event_t ev = { flow_id, type, buf, esi, 0, 0 };
+    swif_engine_post(w, &ev);
+}
+
+
+/*******************************************************************************
+ * Sessions (worker thread only)
+ */
+
+static swif_engine_session_t** swif_engine_find (swif_engine_worker_t*  w,
+                                                 uint64_t               flow_id)
+{
+    swif_engine_session_t **s = &w->session_tab[swif_engine_hash(flow_id) & (w->session_tab_size - 1)];
+
+    while (*s != NULL && (*s)->flow_id != flow_id) {
+        s = &(*s)->next;
+    }
+    return s;
+}
+
+static bool swif_engine_grow_session_tab (swif_engine_worker_t* w)
+{
+    uint32_t			new_size = MAX(2 * w->session_tab_size, 64);
+    swif_engine_session_t	**new_tab = calloc(new_size, sizeof(swif_engine_session_t*));
+
+    if (new_tab == NULL) {
+        return false;
+    }
+    for (uint32_t i = 0; i < w->session_tab_size; i++) {
+        swif_engine_session_t *s = w->session_tab[i], *next;
+        for (; s != NULL; s = next) {
+            uint32_t h = swif_engine_hash(s->flow_id) & (new_size - 1);
+            next = s->next;
+            s->next = new_tab[h];
+            new_tab[h] = s;
+        }
+    }
+    free(w->session_tab);
+    w->session_tab = new_tab;
+    w->session_tab_size = new_size;
+    return true;
+}
+
+static void swif_engine_source_removed (void*   context,
+                                        esi_t   old_symbol_esi)
+{
+    swif_engine_session_t *s = context;
+
+    assert(s->nb_bufs > 0 && s->buf_ring[s->buf_first].esi == old_symbol_esi);
+    swif_engine_post_event(s->worker, s->flow_id, SWIF_ENGINE_EV_RELEASED,
+                           s->buf_ring[s->buf_first].buf, old_symbol_esi);
+    s->buf_first = (s->buf_first + 1) % s->buf_ring_size;
+    s->nb_bufs--;
+}
+
+static void swif_engine_decoded (void*  context,
+                                 void*  new_symbol_buf,
+                                 esi_t  esi)
+{
+    swif_engine_session_t *s = context;
+
+    swif_engine_post_event(s->worker, s->flow_id, SWIF_ENGINE_EV_DECODED, new_symbol_buf, esi);
+}
+
+static void swif_engine_create_session (swif_engine_worker_t*      w,
+                                        const swif_engine_msg_t*   msg)
+{
+    swif_engine_session_t	*s;
+
+    if (*swif_engine_find(w, msg->flow_id) != NULL
+        || (w->nb_sessions >= w->session_tab_size && !swif_engine_grow_session_tab(w))
+        || (s = calloc(1, sizeof(swif_engine_session_t))) == NULL) {
+        swif_engine_post_event(w, msg->flow_id, SWIF_ENGINE_EV_ERROR, NULL, 0);
+        return;
+    }
+    s->flow_id = msg->flow_id;
+    s->worker = w;
+    if (msg->op == SWIF_ENGINE_OP_CREATE_ENCODER) {
+        s->enc = swif_encoder_create(msg->codepoint, 0, msg->symbol_size,
+                                     msg->max_coding_window_size);
+        s->buf_ring_size = msg->max_coding_window_size;
+        s->buf_ring = calloc(s->buf_ring_size, sizeof(swif_engine_buf_t));
+        if (s->enc == NULL || s->buf_ring == NULL
+            || swif_encoder_set_callback_functions(s->enc, swif_engine_source_removed, s) != SWIF_STATUS_OK) {
+            goto error;
+        }
+    } else {
+        s->dec = swif_decoder_create(msg->codepoint, 0, msg->symbol_size,
+                                     msg->max_coding_window_size, msg->max_linear_system_size);
+        if (s->dec == NULL
+            || swif_decoder_set_callback_functions(s->dec, NULL, NULL, swif_engine_decoded, s) != SWIF_STATUS_OK) {
+            goto error;
+        }
+    }
+    swif_engine_session_t **head = &w->session_tab[swif_engine_hash(s->flow_id) & (w->session_tab_size - 1)];
+    s->next = *head;
+    *head = s;
+    w->nb_sessions++;
+    return;
+
+error:
+    if (s->enc != NULL) {
+        swif_encoder_release(s->enc);
+    }
+    if (s->dec != NULL) {
+        swif_decoder_release(s->dec);
+    }
+    free(s->buf_ring);
+    free(s);
+    swif_engine_post_event(w, msg->flow_id, SWIF_ENGINE_EV_ERROR, NULL, 0);
+}
+
+static void swif_engine_free_session (swif_engine_session_t* s)
+{
+    if (s->enc != NULL) {
+        swif_encoder_release(s->enc);
+    }
+    if (s->dec != NULL) {
+        swif_decoder_release(s->dec);
+    }
+    free(s->buf_ring);
+    free(s);
+}
+
+static void swif_engine_release_session_now (swif_engine_worker_t*  w,
+                                             swif_engine_session_t* s)
+{
+    for (; s->nb_bufs > 0; s->nb_bufs--) {
+        swif_engine_post_event(w, s->flow_id, SWIF_ENGINE_EV_RELEASED,
+                               s->buf_ring[s->buf_first].buf, s->buf_ring[s->buf_first].esi);
+        s->buf_first = (s->buf_first + 1) % s->buf_ring_size;
+    }
+    swif_engine_free_session(s);
+}
+
+static void swif_engine_process (swif_engine_worker_t*      w,
+                                 const swif_engine_msg_t*   msg)
+{
+    swif_engine_session_t	**ps;
+    swif_engine_session_t	*s;
+
+    if (msg->op == SWIF_ENGINE_OP_CREATE_ENCODER || msg->op == SWIF_ENGINE_OP_CREATE_DECODER) {
+        swif_engine_create_session(w, msg);
+        return;
+    }
+    ps = swif_engine_find(w, msg->flow_id);
+    if ((s = *ps) == NULL) {
+        goto error;
+    }
+    switch (msg->op) {
+    case SWIF_ENGINE_OP_RELEASE_SESSION:
+        *ps = s->next;
+        w->nb_sessions--;
+        swif_engine_release_session_now(w, s);
+        return;
+
+    case SWIF_ENGINE_OP_SOURCE_SYMBOL:
+        if (s->enc != NULL) {
+            if (swif_encoder_add_source_symbol_to_coding_window(s->enc, msg->buf, msg->esi) != SWIF_STATUS_OK) {
+                goto error;
+            }
+            /* kept while in the coding window */
+            assert(s->nb_bufs < s->buf_ring_size);
+            s->buf_ring[(s->buf_first + s->nb_bufs) % s->buf_ring_size].buf = msg->buf;
+            s->buf_ring[(s->buf_first + s->nb_bufs) % s->buf_ring_size].esi = msg->esi;
+            s->nb_bufs++;
+            return;
+        }
+        if (swif_decoder_decode_with_new_source_symbol(s->dec, msg->buf, msg->esi) != SWIF_STATUS_OK) {
+            goto error;
+        }
+        break;
+
+    case SWIF_ENGINE_OP_REPAIR_SYMBOL:
+        if (s->dec == NULL
+            || swif_decoder_reset_coding_window(s->dec) != SWIF_STATUS_OK) {
+            goto error;
+        }
+        for (uint32_t i = 0; i < msg->nss; i++) {
+            if (swif_decoder_add_source_symbol_to_coding_window(s->dec, msg->esi + i) != SWIF_STATUS_OK) {
+                goto error;
+            }
+        }
+        if (swif_decoder_generate_coding_coefs(s->dec, msg->key, 0) != SWIF_STATUS_OK
+            || swif_decoder_decode_with_new_repair_symbol(s->dec, msg->buf, msg->esi) != SWIF_STATUS_OK) {
+            goto error;
+        }
+        break;
+
+    case SWIF_ENGINE_OP_BUILD_REPAIR: {
+        swif_engine_event_t	ev = { msg->flow_id, SWIF_ENGINE_EV_REPAIR, NULL, 0, 0, msg->key };
+        esi_t			last;
+
+        if (s->enc == NULL
+            || swif_encoder_generate_coding_coefs(s->enc, msg->key, 0) != SWIF_STATUS_OK
+            || swif_build_repair_symbol(s->enc, &ev.buf) != SWIF_STATUS_OK) {
+            goto error;
+        }
+        swif_encoder_get_coding_window_information(s->enc, &ev.esi, &last, &ev.nss);
+        swif_encoder_get_parameters(s->enc, swif_ENCODER_GET_PARAM_REPAIR_SYMBOL_SIZE,
+                                    sizeof(ev.size), &ev.size);
+        swif_engine_post(w, &ev);
+        return;
+    }
+
+    default:
+        goto error;
+    }
+    swif_engine_post_event(w, msg->flow_id, SWIF_ENGINE_EV_RELEASED, msg->buf, msg->esi);
+    return;
+
+error:
+    swif_engine_post_event(w, msg->flow_id, SWIF_ENGINE_EV_ERROR, msg->buf, msg->esi);
+}
+
+
+/*******************************************************************************
+ * Workers
+ */
+
+static void* swif_engine_worker_main (void* arg)
+{
+    swif_engine_worker_t	*w = arg;
+    swif_engine_msg_t		msg;
+    uint32_t			idle = 0;
+
+    for (;;) {
+        if (swif_engine_dequeue(w, &msg)) {
+            swif_engine_process(w, &msg);
+            idle = 0;
+            continue;
+        }
+        /* the queue is only empty for good once stop is seen */
+        if (__atomic_load_n(&w->engine->stop, __ATOMIC_ACQUIRE)) {
+            if (!swif_engine_dequeue(w, &msg)) {
+                break;
+            }
+            swif_engine_process(w, &msg);
+            continue;
+        }
+        if (++idle < 64) {
+            sched_yield();
+        } else {
+            struct timespec ts = { 0, 50000 };
+            nanosleep(&ts, NULL);
+        }
+    }
+    for (uint32_t i = 0; i < w->session_tab_size; i++) {
+        swif_engine_session_t *s = w->session_tab[i], *next;
+        for (; s != NULL; s = next) {
+            next = s->next;
+            swif_engine_free_session(s);
+        }
+    }
+    __atomic_store_n(&w->exited, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+
+swif_engine_t*  swif_engine_create (
+                                uint32_t        nb_workers,
+                                uint32_t        queue_size,
+                                bool            pin_cpus)
+{
+    swif_engine_t	*engine;
+    void		*tab;
+    uint32_t		i, j;
+
+    if (nb_workers == 0 || queue_size == 0 || queue_size > (1u << 30)) {
+        fprintf(stderr, "swif_engine_create() failed! bad parameters\n");
+        return NULL;
+    }
+    queue_size = swif_engine_pow2(queue_size);
+    if ((engine = calloc(1, sizeof(swif_engine_t))) == NULL
+        || posix_memalign(&tab, SWIF_CACHE_LINE, nb_workers * sizeof(swif_engine_worker_t)) != 0) {
+        fprintf(stderr, "swif_engine_create() failed! No memory\n");
+        free(engine);
+        return NULL;
+    }
+    memset(tab, 0, nb_workers * sizeof(swif_engine_worker_t));
+    engine->worker_tab = tab;
+    engine->nb_workers = nb_workers;
+    engine->pin_cpus = pin_cpus;
+    for (i = 0; i < nb_workers; i++) {
+        swif_engine_worker_t *w = &engine->worker_tab[i];
+        w->engine = engine;
+        w->index = i;
+        w->in_mask = w->out_mask = queue_size - 1;
+        w->in_tab = calloc(queue_size, sizeof(swif_engine_cell_t));
+        w->out_tab = calloc(queue_size, sizeof(swif_engine_event_t));
+        if (w->in_tab == NULL || w->out_tab == NULL || !swif_engine_grow_session_tab(w)) {
+            fprintf(stderr, "swif_engine_create() failed! No memory\n");
+            swif_engine_release(engine);
+            return NULL;
+        }
+        for (j = 0; j < queue_size; j++) {
+            w->in_tab[j].seq = j;
+        }
+    }
+    for (i = 0; i < nb_workers; i++) {
+        swif_engine_worker_t *w = &engine->worker_tab[i];
+        if (pthread_create(&w->thread, NULL, swif_engine_worker_main, w) != 0) {
+            fprintf(stderr, "swif_engine_create() failed! cannot create worker %u\n", i);
+            swif_engine_release(engine);
+            return NULL;
+        }
+        w->started = true;
+#if defined(__linux__)
+        if (pin_cpus) {
+            long	nb_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+            cpu_set_t	set;
+            CPU_ZERO(&set);
+            CPU_SET(i % (nb_cpus > 0 ? nb_cpus : 1), &set);
+            pthread_setaffinity_np(w->thread, sizeof(set), &set);
+        }
+#endif
+    }
+    return engine;
+}
+
+
+/* discard an event not polled, freeing the buffers allocated by a codec */
+static void swif_engine_discard (const swif_engine_event_t* ev)
+{
+    if (ev->type == SWIF_ENGINE_EV_DECODED || ev->type == SWIF_ENGINE_EV_REPAIR) {
+        free(ev->buf);
+    }
+}
+
+swif_status_t   swif_engine_release (swif_engine_t*   engine)
+{
+    swif_engine_event_t	ev[16];
+    uint32_t		i, n;
+    bool		running = true;
+
+    assert(engine);
+    __atomic_store_n(&engine->stop, 1, __ATOMIC_RELEASE);
+    /* the workers may wait for room in their completion ring */
+    while (running) {
+        running = false;
+        for (i = 0; i < engine->nb_workers; i++) {
+            swif_engine_worker_t *w = &engine->worker_tab[i];
+            if (w->started && !__atomic_load_n(&w->exited, __ATOMIC_ACQUIRE)) {
+                running = true;
+            }
+            while ((n = swif_engine_poll(engine, i, ev, 16)) > 0) {
+                while (n > 0) {
+                    swif_engine_discard(&ev[--n]);
+                }
+            }
+        }
+        if (running) {
+            sched_yield();
+        }
+    }
+    for (i = 0; i < engine->nb_workers; i++) {
+        swif_engine_worker_t *w = &engine->worker_tab[i];
+        if (w->started) {
+            pthread_join(w->thread, NULL);
+        }
+        while ((n = swif_engine_poll(engine, i, ev, 16)) > 0) {
+            while (n > 0) {
+                swif_engine_discard(&ev[--n]);
+            }
+        }
+        free(w->in_tab);
+        free(w->out_tab);
+        free(w->session_tab);
+    }
+    free(engine->worker_tab);
+    free(engine);
+    return SWIF_STATUS_OK;
+}
+
+
+uint32_t        swif_engine_get_nb_workers (swif_engine_t*   engine)
+{
+    return engine->nb_workers;
+}
+
+
+uint32_t        swif_engine_get_worker_index (
+                                swif_engine_t*  engine,
+                                uint64_t        flow_id)
+{
+    /* not the same bits as the session hash tables of the worker */
+    return (uint32_t)(((uint64_t)(swif_engine_hash(flow_id) >> 8) * engine->nb_workers) >> 24);
+}
+
+
+static swif_status_t swif_engine_submit (swif_engine_t*             engine,
+                                         const swif_engine_msg_t*   msg)
+{
+    swif_engine_worker_t *w = &engine->worker_tab[swif_engine_get_worker_index(engine, msg->flow_id)];
+
+    return swif_engine_enqueue(w, msg) ? SWIF_STATUS_OK : SWIF_STATUS_FAILURE;
+}
+
+
+swif_status_t   swif_engine_create_encoder (
+                                swif_engine_t*  engine,
+                                uint64_t        flow_id,
+                                swif_codepoint_t codepoint,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size)
+{
+    swif_engine_msg_t msg = { 0 };
+
+    msg.flow_id = flow_id;
+    msg.op = SWIF_ENGINE_OP_CREATE_ENCODER;
+    msg.codepoint = codepoint;
+    msg.symbol_size = symbol_size;
+    msg.max_coding_window_size = max_coding_window_size;
+    return swif_engine_submit(engine, &msg);
+}
+
+
+swif_status_t   swif_engine_create_decoder (
+                                swif_engine_t*  engine,
+                                uint64_t        flow_id,
+                                swif_codepoint_t codepoint,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size,
+                                uint32_t        max_linear_system_size)
+{
+    swif_engine_msg_t msg = { 0 };
+
+    msg.flow_id = flow_id;
+    msg.op = SWIF_ENGINE_OP_CREATE_DECODER;
+    msg.codepoint = codepoint;
+    msg.symbol_size = symbol_size;
+    msg.max_coding_window_size = max_coding_window_size;
+    msg.max_linear_system_size = max_linear_system_size;
+    return swif_engine_submit(engine, &msg);
+}
+
+
+swif_status_t   swif_engine_release_session (
+                                swif_engine_t*  engine,
+                                uint64_t        flow_id)
+{
+    swif_engine_msg_t msg = { 0 };
+
+    msg.flow_id = flow_id;
+    msg.op = SWIF_ENGINE_OP_RELEASE_SESSION;
+    return swif_engine_submit(engine, &msg);
+}
+
+
+swif_status_t   swif_engine_submit_source_symbol (
+                                swif_engine_t*  engine,
+                                uint64_t        flow_id,
+                                void*           buf,
+                                esi_t           esi)
+{
+    swif_engine_msg_t msg = { 0 };
+
+    msg.flow_id = flow_id;
+    msg.op = SWIF_ENGINE_OP_SOURCE_SYMBOL;
+    msg.buf = buf;
+    msg.esi = esi;
+    return swif_engine_submit(engine, &msg);
+}
+
+
+swif_status_t   swif_engine_submit_repair_symbol (
+                                swif_engine_t*  engine,
+                                uint64_t        flow_id,
+                                void*           buf,
+                                esi_t           first_esi,
+                                uint32_t        nss,
+                                uint32_t        key)
+{
+    swif_engine_msg_t msg = { 0 };
+
+    msg.flow_id = flow_id;
+    msg.op = SWIF_ENGINE_OP_REPAIR_SYMBOL;
+    msg.buf = buf;
+    msg.esi = first_esi;
+    msg.nss = nss;
+    msg.key = key;
+    return swif_engine_submit(engine, &msg);
+}
+
+
+swif_status_t   swif_engine_build_repair_symbol (
+                                swif_engine_t*  engine,
+                                uint64_t        flow_id,
+                                uint32_t        key)
+{
+    swif_engine_msg_t msg = { 0 };
+
+    msg.flow_id = flow_id;
+    msg.op = SWIF_ENGINE_OP_BUILD_REPAIR;
+    msg.key = key;
+    return swif_engine_submit(engine, &msg);
+}
+
+
+uint32_t        swif_engine_poll (
+                                swif_engine_t*          engine,
+                                uint32_t                worker_index,
+                                swif_engine_event_t*    event_tab,
+                                uint32_t                max_events)
+{
+    swif_engine_worker_t	*w = &engine->worker_tab[worker_index];
+    uint32_t			head = w->out_head;
+    uint32_t			n = __atomic_load_n(&w->out_tail, __ATOMIC_ACQUIRE) - head;
+
+    n = MIN(n, max_events);
+    for (uint32_t i = 0; i < n; i++) {
+        event_tab[i] = w->out_tab[(head + i) & w->out_mask];
+    }
+    __atomic_store_n(&w->out_head, head + n, __ATOMIC_RELEASE);
+    return n;
+}
@@ -0,0 +1,167 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+#ifndef SWIF_ENGINE_H
+#define SWIF_ENGINE_H
+#include "swif_includes.h"
+
+
+/**
+ * Multi-session engine, to run many encoders and decoders (sessions) on
+ * several threads.
+ * A codec instance being single-threaded, each session, identified by a
+ * flow ID, is pinned to one worker thread that creates, uses and
+ * releases it: sessions are never shared, and need no lock.
+ * Any thread submits packets through the lock-free input queue of the
+ * worker of the flow (multiple producers, one consumer). Outputs come
+ * back as events in a completion ring per worker (one producer, one
+ * consumer), to be polled by the application: one thread at a time per
+ * ring.
+ *
+ * Buffers: every buffer submitted is owned by the engine until it comes
+ * back in a SWIF_ENGINE_EV_RELEASED (or SWIF_ENGINE_EV_ERROR) event. An
+ * encoder keeps its source symbols while they are in its coding window,
+ * a decoder returns them at once. The buffers of the
+ * SWIF_ENGINE_EV_DECODED and SWIF_ENGINE_EV_REPAIR events are allocated
+ * by the codec and belong to the application.
+ */
+typedef struct swif_engine swif_engine_t;
+
+typedef enum {
+	/* a source symbol was decoded: buf, esi */
+	SWIF_ENGINE_EV_DECODED = 1,
+	/* a repair symbol was built: buf, esi (first source symbol), nss,
+	 * key, and size */
+	SWIF_ENGINE_EV_REPAIR,
+	/* a submitted buffer is returned: buf, esi */
+	SWIF_ENGINE_EV_RELEASED,
+	/* a request failed (unknown flow, codec error...): its buffer, if
+	 * any, is returned in buf */
+	SWIF_ENGINE_EV_ERROR
+} swif_engine_event_type_t;
+
+typedef struct swif_engine_event {
+	uint64_t		flow_id;
+	swif_engine_event_type_t type;
+	void*			buf;
+	esi_t			esi;
+	uint32_t		nss;
+	uint32_t		key;
+	/* meaningful bytes of a repair symbol, i.e. the number of bytes to
+	 * send (less than symbol_size with variable-length symbols) */
+	uint32_t		size;
+} swif_engine_event_t;
+
+
+/**
+ * Create an engine and start its workers.
+ *
+ * @param nb_workers    (IN) number of worker threads, e.g. one per core.
+ * @param queue_size    (IN) number of entries of each input queue and
+ *                      completion ring (rounded up to a power of 2).
+ * @param pin_cpus      (IN) if true, worker i runs on CPU i (modulo the
+ *                      number of CPUs), where supported.
+ * @return              the engine, or NULL in case of error.
+ */
+swif_engine_t*  swif_engine_create (
+                                uint32_t        nb_workers,
+                                uint32_t        queue_size,
+                                bool            pin_cpus);
+
+/**
+ * Stop the workers once all the requests submitted are processed, and
+ * release the engine. The sessions not released yet are released without
+ * returning their buffers, and the events not polled are discarded
+ * (their codec buffers being freed).
+ */
+swif_status_t   swif_engine_release (swif_engine_t*   engine);
+
+/**
+ * Return the number of workers, and the worker (i.e. completion ring) of
+ * a flow.
+ */
+uint32_t        swif_engine_get_nb_workers (swif_engine_t*   engine);
+
+uint32_t        swif_engine_get_worker_index (
+                                swif_engine_t*  engine,
+                                uint64_t        flow_id);
+
+/**
+ * Create a session, with the same parameters as swif_encoder_create()
+ * (resp. swif_decoder_create()). The session is created by its worker:
+ * an SWIF_ENGINE_EV_ERROR event is posted if this fails.
+ *
+ * The following functions queue a request to the worker of the flow, and
+ * return SWIF_STATUS_FAILURE when its input queue is full (nothing is
+ * done, retry later), or SWIF_STATUS_OK.
+ */
+swif_status_t   swif_engine_create_encoder (
+                                swif_engine_t*  engine,
+                                uint64_t        flow_id,
+                                swif_codepoint_t codepoint,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size);
+
+swif_status_t   swif_engine_create_decoder (
+                                swif_engine_t*  engine,
+                                uint64_t        flow_id,
+                                swif_codepoint_t codepoint,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size,
+                                uint32_t        max_linear_system_size);
+
+/**
+ * Release a session. An encoder returns the source symbols of its coding
+ * window.
+ */
+swif_status_t   swif_engine_release_session (
+                                swif_engine_t*  engine,
+                                uint64_t        flow_id);
+
+/**
+ * Encoder: add a source symbol to the coding window.
+ * Decoder: submit a received source symbol.
+ */
+swif_status_t   swif_engine_submit_source_symbol (
+                                swif_engine_t*  engine,
+                                uint64_t        flow_id,
+                                void*           buf,
+                                esi_t           esi);
+
+/**
+ * Decoder: submit a received repair symbol, that covers nss source
+ * symbols from first_esi, with the coding coefficients of key.
+ */
+swif_status_t   swif_engine_submit_repair_symbol (
+                                swif_engine_t*  engine,
+                                uint64_t        flow_id,
+                                void*           buf,
+                                esi_t           first_esi,
+                                uint32_t        nss,
+                                uint32_t        key);
+
+/**
+ * Encoder: build a repair symbol over the coding window, with the coding
+ * coefficients of key. It comes back in a SWIF_ENGINE_EV_REPAIR event.
+ */
+swif_status_t   swif_engine_build_repair_symbol (
+                                swif_engine_t*  engine,
+                                uint64_t        flow_id,
+                                uint32_t        key);
+
+/**
+ * Retrieve up to max_events events from the completion ring of a worker.
+ * A worker waits when its ring is full, so rings must be polled
+ * regularly.
+ *
+ * @return              number of events copied to event_tab.
+ */
+uint32_t        swif_engine_poll (
+                                swif_engine_t*          engine,
+                                uint32_t                worker_index,
+                                swif_engine_event_t*    event_tab,
+                                uint32_t                max_events);
+
+#endif /* SWIF_ENGINE_H */
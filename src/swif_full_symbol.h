@@ -153,6 +153,13 @@ void full_symbol_dump(swif_full_symbol_t *full_symbol, FILE *out);
  */
 swif_full_symbol_set_t *full_symbol_set_alloc(void);
 
+/**
+ * @brief Same as full_symbol_set_alloc(), for a linear system of up to
+ *        `size' consecutive source symbols: when newer source symbols are
+ *        added, the equations of the oldest ones are removed.
+ */
+swif_full_symbol_set_t *full_symbol_set_alloc_with_size(uint32_t size);
+
 /**
  * @brief Free a full_symbol set
  */
@@ -169,6 +176,16 @@ void full_symbol_set_free(swif_full_symbol_set_t *set);
 uint32_t full_symbol_set_add
 (swif_full_symbol_set_t *set, swif_full_symbol_t *full_symbol);
 
+/**
+ * @brief Same as full_symbol_set_add() for the equation whose coefficients
+ *        of source symbols first_id .. first_id+nb_id-1 are coef_tab, and
+ *        whose data is data (data_size bytes), without building a
+ *        full_symbol: both arrays are only read during the call.
+ */
+uint32_t full_symbol_set_add_coefs
+(swif_full_symbol_set_t *set, const uint8_t *coef_tab, symbol_id_t first_id,
+ uint32_t nb_id, const uint8_t *data, uint32_t data_size);
+
 static inline bool full_symbol_includes_id(swif_full_symbol_t* symbol,
                                            symbol_id_t id);
 
@@ -8,6 +8,9 @@
 
 //#include "swif_full_symbol_impl.h" 
 #include "swif_includes.h"
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 /*---------------------------------------------------------------------------*/
 
@@ -16,51 +19,518 @@
  *  A swif_full_symbol_set is a data structure that contains "full symbols", e.g.
  * coded symbols with the encoding header.
  *  It is used to do automatically Gaussian elimination when a coded packet is added
+ *
+ *  The linear system is kept fully reduced in a dense form: one coefficient
+ * matrix with a fixed stride, where the column of source symbol `id' is
+ * `id % size', and where the row of column `c' is the equation whose pivot
+ * (by default its oldest source symbol) is in column `c'. size is a power
+ * of two, so that consecutive ids keep consecutive columns when they wrap
+ * around 2^32, and ids are ordered relative to the newest one.
  */
 
-const uint32_t FULL_SYMBOL_SET_INITIAL_SIZE = 16;
+const uint32_t FULL_SYMBOL_SET_DEFAULT_SIZE = 256;
 
-swif_full_symbol_set_t *full_symbol_set_alloc()
+/* row alignment (in bytes) of the coefficient matrix, one AVX2 register */
+#define FULL_SYMBOL_SET_ROW_ALIGN 32
+
+#define NO_COL 0xfffffffful
+
+enum {
+    ROW_NONE = 0,	/* no equation with a pivot in this column */
+    ROW_PIVOT,		/* equation with a pivot in this column */
+    ROW_DECODED		/* same, and the source symbol is decoded */
+};
+
+swif_full_symbol_set_t *full_symbol_set_alloc_with_size(uint32_t size)
+{
+    return full_symbol_set_alloc_with_allocator(size, &swif_default_allocator);
+}
+
+swif_full_symbol_set_t *full_symbol_set_alloc_with_allocator
+(uint32_t size, const swif_allocator_t *allocator)
 {
+    assert(size > 0);
     /* allocate the struct */
     swif_full_symbol_set_t *result
-        = (swif_full_symbol_set_t *)calloc(1, sizeof(swif_full_symbol_set_t));
+        = (swif_full_symbol_set_t *)swif_mem_calloc(allocator, 1, sizeof(swif_full_symbol_set_t));
 
     if (result == NULL) {
         return NULL;
     }
-
-    /* allocate the table of pointers to full_symbol */
-    result->size = FULL_SYMBOL_SET_INITIAL_SIZE;
+    result->allocator = *allocator;
+    result->span = size;
+    for (result->size = 1; result->size < size; result->size <<= 1);
+    size = result->size;
+    result->stride = (size + FULL_SYMBOL_SET_ROW_ALIGN - 1)
+                     & ~(FULL_SYMBOL_SET_ROW_ALIGN - 1);
     result->nmbr_packets = 0;
-
-    swif_full_symbol_t **full_symbol_tab
-      = calloc(result->size, sizeof(swif_full_symbol_t *)); 
-    if (full_symbol_tab == NULL) {
-        free(full_symbol_tab);
+    result->last_symbol_id = SYMBOL_ID_NONE;
+    result->has_last_id = false;
+    result->log2_nb_bit_coef = MAX_LOG2_NB_BIT_COEF; /* GF(256) */
+
+    /* the data matrix is allocated with the first symbols */
+    result->coef_matrix = swif_mem_calloc(allocator, (size_t)size * result->stride, sizeof(uint8_t));
+    result->tmp_coef = swif_mem_calloc(allocator, result->stride, sizeof(uint8_t));
+    result->row_state = swif_mem_calloc(allocator, size, sizeof(uint8_t));
+    result->row_weight = swif_mem_calloc(allocator, size, sizeof(uint32_t));
+    result->nonzero_col_tab = swif_mem_calloc(allocator, size, sizeof(uint32_t));
+    result->data_size_tab = swif_mem_calloc(allocator, size, sizeof(uint32_t));
+    if (result->coef_matrix == NULL || result->tmp_coef == NULL
+        || result->row_state == NULL || result->row_weight == NULL
+        || result->nonzero_col_tab == NULL || result->data_size_tab == NULL) {
+        full_symbol_set_free(result);
         return NULL;
     }
-    result->full_symbol_tab = full_symbol_tab;
-    result->first_symbol_id = SYMBOL_ID_NONE ;
     result->notify_decoded_func = NULL;
+    result->notify_removed_func = NULL;
     result->notify_context = NULL;    
     return result; 
 }
 
+swif_full_symbol_set_t *full_symbol_set_alloc()
+{
+    return full_symbol_set_alloc_with_size(FULL_SYMBOL_SET_DEFAULT_SIZE);
+}
+
 /**
  * @brief Free a full_symbol set
  */
 void full_symbol_set_free(swif_full_symbol_set_t *set)
 {
     assert(set != NULL);
-    assert(set->full_symbol_tab != NULL);
-    for(uint32_t i = 0; i < set->size; i++) {
-        if (set->full_symbol_tab[i] != NULL)
-            full_symbol_free(set->full_symbol_tab[i]);   
-    } 
-    free(set->full_symbol_tab);
-    set->full_symbol_tab = NULL;
-    free(set);
+    swif_allocator_t allocator = set->allocator;
+
+    swif_mem_free(&allocator, set->coef_matrix);
+    swif_mem_free(&allocator, set->data_matrix);
+    swif_mem_free(&allocator, set->tmp_coef);
+    swif_mem_free(&allocator, set->tmp_data);
+    swif_mem_free(&allocator, set->row_state);
+    swif_mem_free(&allocator, set->row_weight);
+    swif_mem_free(&allocator, set->nonzero_col_tab);
+    swif_mem_free(&allocator, set->data_size_tab);
+    swif_mem_free(&allocator, set->pending_coef);
+    swif_mem_free(&allocator, set->pending_data);
+    swif_mem_free(&allocator, set->pending_size_tab);
+    swif_mem_free(&allocator, set->solve_matrix);
+    swif_mem_free(&allocator, set->solve_inverse);
+    swif_mem_free(&allocator, set->solve_col_tab);
+    swif_mem_free(&allocator, set);
+}
+
+/*---------------------------------------------------------------------------*/
+
+static inline uint8_t *full_symbol_set_row_coef
+(swif_full_symbol_set_t *set, uint32_t col)
+{
+    return set->coef_matrix + (size_t)col * set->stride;
+}
+
+static inline uint8_t *full_symbol_set_row_data
+(swif_full_symbol_set_t *set, uint32_t col)
+{
+    return set->data_matrix + (size_t)col * set->data_stride;
+}
+
+static inline uint32_t full_symbol_set_col
+(swif_full_symbol_set_t *set, symbol_id_t symbol_id)
+{
+    return symbol_id & (set->size - 1);
+}
+
+/* source symbol currently associated to a column */
+static inline symbol_id_t full_symbol_set_col_id
+(swif_full_symbol_set_t *set, uint32_t col)
+{
+    return set->last_symbol_id - ((set->last_symbol_id - col) & (set->size - 1));
+}
+
+/* the last `span' ids up to last_symbol_id, modulo 2^32 */
+static inline bool full_symbol_set_includes_id
+(swif_full_symbol_set_t *set, symbol_id_t symbol_id)
+{
+    return (set->has_last_id
+            && (symbol_id_t)(set->last_symbol_id - symbol_id) < set->span);
+}
+
+/**
+ * @brief Return the first nonzero coefficient of coef[from..to-1], or
+ *        NO_COL: 16 (SSE2) or 8 bytes are checked at a time.
+ */
+static uint32_t full_symbol_set_find_nonzero
+(const uint8_t *coef, uint32_t from, uint32_t to)
+{
+    uint32_t i = from;
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= to; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*)(coef + i));
+        uint32_t mask = (~(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(x, zero))) & 0xffff;
+        if (mask != 0) {
+            return i + (uint32_t)__builtin_ctz(mask);
+        }
+    }
+#endif /* __SSE2__ */
+    for (; i + sizeof(uint64_t) <= to; i += sizeof(uint64_t)) {
+        uint64_t w;
+        memcpy(&w, coef + i, sizeof(uint64_t));
+        if (w != 0) {
+            break;
+        }
+    }
+    for (; i < to; i++) {
+        if (coef[i] != 0) {
+            return i;
+        }
+    }
+    return NO_COL;
+}
+
+/* number of nonzero coefficients of coef[0..size-1] */
+static uint32_t full_symbol_set_count_nonzero
+(const uint8_t *coef, uint32_t size)
+{
+    uint32_t count = 0;
+    for (uint32_t col = full_symbol_set_find_nonzero(coef, 0, size);
+         col != NO_COL;
+         col = full_symbol_set_find_nonzero(coef, col + 1, size)) {
+        count++;
+    }
+    return count;
+}
+
+/* make the rows of the data matrix at least data_size long */
+static bool full_symbol_set_grow_data
+(swif_full_symbol_set_t *set, uint32_t data_size)
+{
+    if (data_size <= set->data_stride && set->data_matrix != NULL) {
+        return true;
+    }
+    /* aligned rows, padded with zeros: the aligned kernels apply */
+    uint32_t new_stride = SWIF_SYMBOL_PADDED_SIZE(MAX(data_size, 1));
+    uint8_t *new_matrix = swif_mem_aligned_calloc(&set->allocator, SWIF_SYMBOL_ALIGNMENT,
+                                                  (size_t)set->size * new_stride);
+    uint8_t *new_tmp = swif_mem_aligned_calloc(&set->allocator, SWIF_SYMBOL_ALIGNMENT, new_stride);
+    uint8_t *new_pending = NULL;
+    if (set->block_mode) {
+        new_pending = swif_mem_aligned_calloc(&set->allocator, SWIF_SYMBOL_ALIGNMENT,
+                                              (size_t)set->size * new_stride);
+    }
+    if (new_matrix == NULL || new_tmp == NULL
+        || (set->block_mode && new_pending == NULL)) {
+        swif_mem_free(&set->allocator, new_matrix);
+        swif_mem_free(&set->allocator, new_tmp);
+        swif_mem_free(&set->allocator, new_pending);
+        return false;
+    }
+    for (uint32_t col = 0; col < set->size && set->data_matrix != NULL; col++) {
+        memcpy(new_matrix + (size_t)col * new_stride,
+               full_symbol_set_row_data(set, col), set->data_size_tab[col]);
+    }
+    for (uint32_t i = 0; i < set->nb_pending; i++) {
+        memcpy(new_pending + (size_t)i * new_stride,
+               set->pending_data + (size_t)i * set->data_stride, set->pending_size_tab[i]);
+    }
+    swif_mem_free(&set->allocator, set->data_matrix);
+    swif_mem_free(&set->allocator, set->tmp_data);
+    swif_mem_free(&set->allocator, set->pending_data);
+    set->data_matrix = new_matrix;
+    set->tmp_data = new_tmp;
+    set->pending_data = new_pending;
+    set->data_stride = new_stride;
+    set->kernels = lc_get_kernels(new_stride, set->log2_nb_bit_coef, 1);
+    return true;
+}
+
+/*
+ * data1 += coef * data2 (resp. data1 = coef * data2) over the first size
+ * bytes of aligned rows: with the fixed-size kernels for whole rows,
+ * striped otherwise.
+ */
+static inline void full_symbol_set_data_add_mul
+(swif_full_symbol_set_t *set, uint8_t coef, uint8_t *data2, uint32_t size, uint8_t *data1)
+{
+    size = SWIF_SYMBOL_PADDED_SIZE(size);
+    if (set->kernels != NULL && set->stripe_pool == NULL && size == set->kernels->symbol_size) {
+        set->kernels->add_mul(coef, data2, data1);
+        return;
+    }
+    swif_stripe_add_mul(set->stripe_pool, coef, data2, size, set->log2_nb_bit_coef, data1);
+}
+
+static inline void full_symbol_set_data_mul
+(swif_full_symbol_set_t *set, uint8_t coef, uint8_t *data2, uint32_t size, uint8_t *data1)
+{
+    size = SWIF_SYMBOL_PADDED_SIZE(size);
+    if (set->kernels != NULL && set->stripe_pool == NULL && size == set->kernels->symbol_size) {
+        set->kernels->mul(coef, data2, data1);
+        return;
+    }
+    swif_stripe_mul(set->stripe_pool, coef, data2, size, set->log2_nb_bit_coef, data1);
+}
+
+static void full_symbol_set_remove_row
+(swif_full_symbol_set_t *set, uint32_t col)
+{
+    memset(full_symbol_set_row_coef(set, col), 0, set->stride);
+    set->row_state[col] = ROW_NONE;
+    set->row_weight[col] = 0;
+    set->data_size_tab[col] = 0;
+}
+
+static inline uint8_t *full_symbol_set_pending_coef
+(swif_full_symbol_set_t *set, uint32_t i)
+{
+    return set->pending_coef + (size_t)i * set->stride;
+}
+
+static inline uint8_t *full_symbol_set_pending_data
+(swif_full_symbol_set_t *set, uint32_t i)
+{
+    return set->pending_data + (size_t)i * set->data_stride;
+}
+
+/* row i of the reduced pending system, and its combination of the
+ * pending equations */
+static inline uint8_t *full_symbol_set_solve_row
+(swif_full_symbol_set_t *set, uint32_t i)
+{
+    return set->solve_matrix + (size_t)i * set->stride;
+}
+
+static inline uint8_t *full_symbol_set_solve_comb
+(swif_full_symbol_set_t *set, uint32_t i)
+{
+    return set->solve_inverse + (size_t)i * set->size;
+}
+
+/* oldest source symbol of an equation, as column, or NO_COL */
+static uint32_t full_symbol_set_find_oldest
+(swif_full_symbol_set_t *set, const uint8_t *coef)
+{
+    uint32_t oldest_col = full_symbol_set_col(set, set->last_symbol_id + 1);
+    uint32_t col = full_symbol_set_find_nonzero(coef, oldest_col, set->size);
+    return (col != NO_COL) ? col : full_symbol_set_find_nonzero(coef, 0, oldest_col);
+}
+
+/* pending equation i only, regardless of the reduced system */
+static void full_symbol_set_drop_pending
+(swif_full_symbol_set_t *set, uint32_t i)
+{
+    uint32_t last = --set->nb_pending;
+    if (i != last) {
+        memcpy(full_symbol_set_pending_coef(set, i),
+               full_symbol_set_pending_coef(set, last), set->stride);
+        memcpy(full_symbol_set_pending_data(set, i),
+               full_symbol_set_pending_data(set, last), set->data_stride);
+        set->pending_size_tab[i] = set->pending_size_tab[last];
+    }
+}
+
+/*
+ * Block mode: reduce the pending equation eq by the rows 0..eq-1 of the
+ * reduced system, and make it row eq, with its oldest source symbol as
+ * pivot (removed from the other rows). Only the coefficients are
+ * combined: the data is combined once, when solving. Return false when
+ * the equation is redundant (row eq is then left unused).
+ */
+static bool full_symbol_set_reduce_pending
+(swif_full_symbol_set_t *set, uint32_t eq)
+{
+    uint8_t	l = set->log2_nb_bit_coef;
+    uint8_t	*row = full_symbol_set_solve_row(set, eq);
+    uint8_t	*comb = full_symbol_set_solve_comb(set, eq);
+    uint32_t	*pivot_tab = set->solve_col_tab;
+    uint32_t	i;
+
+    memcpy(row, full_symbol_set_pending_coef(set, eq), set->stride);
+    memset(comb, 0, set->size);
+    comb[eq] = 1;
+    for (i = 0; i < eq; i++) {
+        uint8_t c = row[pivot_tab[i]];
+        if (c != 0) {
+            lc_vector_add_mul(c, full_symbol_set_solve_row(set, i), set->stride, l, row);
+            lc_vector_add_mul(c, full_symbol_set_solve_comb(set, i), eq + 1, l, comb);
+        }
+    }
+    uint32_t pivot = full_symbol_set_find_oldest(set, row);
+    if (pivot == NO_COL) {
+        return false;
+    }
+    uint8_t inv = lc_inv(row[pivot], l);
+    if (inv != 1) {
+        lc_vector_mul(inv, row, set->stride, l, row);
+        lc_vector_mul(inv, comb, eq + 1, l, comb);
+    }
+    for (i = 0; i < eq; i++) {
+        uint8_t *row_i = full_symbol_set_solve_row(set, i);
+        uint8_t c = row_i[pivot];
+        if (c != 0) {
+            lc_vector_add_mul(c, row, set->stride, l, row_i);
+            lc_vector_add_mul(c, comb, eq + 1, l, full_symbol_set_solve_comb(set, i));
+        }
+    }
+    pivot_tab[eq] = pivot;
+    return true;
+}
+
+/*
+ * Block mode: reduce the pending equations again, after some of them
+ * changed or were dropped, dropping the redundant ones.
+ */
+static void full_symbol_set_reduce_all_pending
+(swif_full_symbol_set_t *set)
+{
+    for (uint32_t i = 0; i < set->nb_pending; ) {
+        if (full_symbol_set_reduce_pending(set, i)) {
+            i++;
+        } else {
+            full_symbol_set_drop_pending(set, i);
+        }
+    }
+}
+
+/* remove the pending equations that refer to the source symbol of col */
+/* drop the pending equations that refer to a column, true if there were */
+static bool full_symbol_set_remove_pending
+(swif_full_symbol_set_t *set, uint32_t col)
+{
+    uint32_t nb_pending = set->nb_pending;
+    for (uint32_t i = 0; i < set->nb_pending; ) {
+        if (full_symbol_set_pending_coef(set, i)[col] != 0) {
+            full_symbol_set_drop_pending(set, i);
+        } else {
+            i++;
+        }
+    }
+    if (set->nb_pending == nb_pending) {
+        return false;
+    }
+    full_symbol_set_reduce_all_pending(set);
+    return true;
+}
+
+/* row[col1] += coef * row[col2] (or tmp when col1 is NO_COL) */
+static void full_symbol_set_row_add_scaled
+(swif_full_symbol_set_t *set, uint32_t col1, uint8_t coef, uint32_t col2)
+{
+    uint8_t *coef1 = (col1 == NO_COL) ? set->tmp_coef : full_symbol_set_row_coef(set, col1);
+    uint8_t *data1 = (col1 == NO_COL) ? set->tmp_data : full_symbol_set_row_data(set, col1);
+    uint32_t *size1 = (col1 == NO_COL) ? &set->tmp_data_size : &set->data_size_tab[col1];
+    uint32_t size2 = set->data_size_tab[col2];
+
+    /* coefficients are stored one per byte, whatever the field */
+    lc_vector_add_mul(coef, full_symbol_set_row_coef(set, col2), set->stride,
+                      set->log2_nb_bit_coef, coef1);
+    full_symbol_set_data_add_mul(set, coef, full_symbol_set_row_data(set, col2), size2, data1);
+    *size1 = MAX(*size1, size2);
+}
+
+/*
+ * Remove every reference to the source symbol of a recycled column.
+ * When it is the pivot of an equation, the other equations don't refer to
+ * it. Otherwise (never with SWIF_PIVOT_POLICY_OLDEST_ESI), the first
+ * equation that refers to it is used to remove it from the others, then
+ * dropped: its own pivot becomes an unknown without equation.
+ * Return true if an equation referred to it.
+ */
+static bool full_symbol_set_evict_col
+(swif_full_symbol_set_t *set, uint32_t col)
+{
+    if (set->row_state[col] != ROW_NONE) {
+        full_symbol_set_remove_row(set, col);
+        full_symbol_set_remove_pending(set, col);
+        return true;
+    }
+    uint32_t first = NO_COL;
+    uint8_t inv = 0;
+    for (uint32_t row = 0; row < set->size; row++) {
+        if (set->row_state[row] != ROW_PIVOT) {
+            continue;
+        }
+        uint8_t coef = full_symbol_set_row_coef(set, row)[col];
+        if (coef == 0) {
+            continue;
+        }
+        if (first == NO_COL) {
+            first = row;
+            inv = lc_inv(coef, set->log2_nb_bit_coef);
+        } else {
+            full_symbol_set_row_add_scaled(set, row,
+                lc_mul(coef, inv, set->log2_nb_bit_coef), first);
+            set->row_weight[row] = full_symbol_set_count_nonzero(
+                full_symbol_set_row_coef(set, row), set->size);
+        }
+    }
+    if (first != NO_COL) {
+        full_symbol_set_remove_row(set, first);
+    }
+    return full_symbol_set_remove_pending(set, col) || first != NO_COL;
+}
+
+/* true if an equation, pending or not, refers to a column */
+static bool full_symbol_set_col_is_used
+(swif_full_symbol_set_t *set, uint32_t col)
+{
+    if (set->row_state[col] != ROW_NONE) {
+        return true;
+    }
+    for (uint32_t row = 0; row < set->size; row++) {
+        if (set->row_state[row] == ROW_PIVOT
+            && full_symbol_set_row_coef(set, row)[col] != 0) {
+            return true;
+        }
+    }
+    for (uint32_t i = 0; i < set->nb_pending; i++) {
+        if (full_symbol_set_pending_coef(set, i)[col] != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Make room in the linear system for source symbols up to symbol_id.
+ * notify_removed_func is called for each source symbol that leaves it
+ * while an equation still referred to it.
+ */
+static void full_symbol_set_slide
+(swif_full_symbol_set_t *set, symbol_id_t symbol_id)
+{
+    if (!set->has_last_id) {
+        set->last_symbol_id = symbol_id;
+        set->has_last_id = true;
+        return;
+    }
+    if ((int32_t)(symbol_id - set->last_symbol_id) <= 0) {
+        return;
+    }
+    if (symbol_id - set->last_symbol_id >= set->span) {
+        /* all the columns are recycled */
+        for (uint32_t i = set->span; i > 0 && set->notify_removed_func != NULL; i--) {
+            symbol_id_t old_id = set->last_symbol_id - (i - 1);
+
+            if (full_symbol_set_col_is_used(set, full_symbol_set_col(set, old_id))) {
+                set->notify_removed_func(set, old_id, set->notify_context);
+            }
+        }
+        for (uint32_t col = 0; col < set->size; col++) {
+            if (set->row_state[col] != ROW_NONE)
+                full_symbol_set_remove_row(set, col);
+        }
+        set->nb_pending = 0;
+    } else {
+        /* the ids that leave the last `span' ones, the columns of the
+         * newer ones being free since then */
+        for (symbol_id_t id = set->last_symbol_id + 1; id != symbol_id + 1; id++) {
+            symbol_id_t old_id = id - set->span;
+
+            if (full_symbol_set_evict_col(set, full_symbol_set_col(set, old_id))
+                && set->notify_removed_func != NULL) {
+                set->notify_removed_func(set, old_id, set->notify_context);
+            }
+        }
+    }
+    set->last_symbol_id = symbol_id;
 }
 
 /**
@@ -69,38 +539,309 @@ void full_symbol_set_free(swif_full_symbol_set_t *set)
 void full_symbol_set_dump(swif_full_symbol_set_t *full_symbol_set, FILE *out)
 {
     fprintf(out, "{'size':%u, ", full_symbol_set->size);
-    fprintf(out, "'first_symbol_id':%u, ", full_symbol_set->first_symbol_id);
-    fprintf(out, "'set':{");
+    fprintf(out, "'last_symbol_id':");
+    full_symbol_dump_id(full_symbol_set->last_symbol_id, out);
+    fprintf(out, ", 'set':{");
     bool is_first = true;
-    for (uint32_t i = 0; i < full_symbol_set->size; i++) {
-        swif_full_symbol_t *fs =  full_symbol_set->full_symbol_tab[i];
-        if (fs != NULL) {
-            if (!is_first) {
-                fprintf(out, ",");
-            } else {
-                is_first = false;
-            }
-            fprintf(out, "%u:(%u, ", i,
-                fs->first_nonzero_id-full_symbol_set->first_symbol_id);
-            full_symbol_dump(fs, out);
-            fprintf(out, ")");
+    for (uint32_t col = 0; col < full_symbol_set->size; col++) {
+        if (full_symbol_set->row_state[col] == ROW_NONE) {
+            continue;
+        }
+        if (!is_first) {
+            fprintf(out, ",");
+        } else {
+            is_first = false;
         }
+        fprintf(out, "%u:{'decoded':%u, 'coef_value':[",
+                full_symbol_set_col_id(full_symbol_set, col),
+                full_symbol_set->row_state[col] == ROW_DECODED);
+        for (uint32_t i = 0; i < full_symbol_set->size; i++) {
+            fprintf(out, "%s%u", (i > 0) ? ", " : "",
+                    full_symbol_set_row_coef(full_symbol_set, col)[i]);
+        }
+        fprintf(out, "], 'data_size':%u}", full_symbol_set->data_size_tab[col]);
     }
     fprintf(out, "}");
     fprintf(out, "}\n");
 }
 
+/*---------------------------------------------------------------------------*/
+
+/* callback should not add new symbols to full_symbol_set */
+void full_symbol_set_notify_decoded
+(swif_full_symbol_set_t *set, symbol_id_t decoded_id) 
+{
+    if (set->notify_decoded_func != NULL) {
+        set->notify_decoded_func(set, decoded_id, set->notify_context);
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+
+/* tile (in bytes) of the block mode matrix product: the pending data of a
+ * tile stays in cache while all the missing source symbols are computed */
+#define FULL_SYMBOL_SET_SOLVE_TILE 1024
+
+static bool full_symbol_set_alloc_block(swif_full_symbol_set_t *set)
+{
+    size_t size = set->size;
+
+    set->pending_coef = swif_mem_calloc(&set->allocator, size * set->stride, sizeof(uint8_t));
+    if (set->pending_data == NULL) {
+        set->pending_data = swif_mem_aligned_calloc(&set->allocator, SWIF_SYMBOL_ALIGNMENT,
+                                                    (size_t)size * set->data_stride);
+    }
+    set->pending_size_tab = swif_mem_calloc(&set->allocator, size, sizeof(uint32_t));
+    set->solve_matrix = swif_mem_calloc(&set->allocator, size * set->stride, sizeof(uint8_t));
+    set->solve_inverse = swif_mem_calloc(&set->allocator, size * size, sizeof(uint8_t));
+    set->solve_col_tab = swif_mem_calloc(&set->allocator, size, sizeof(uint32_t));
+    return (set->pending_coef != NULL && set->pending_data != NULL
+            && set->pending_size_tab != NULL && set->solve_matrix != NULL
+            && set->solve_inverse != NULL && set->solve_col_tab != NULL);
+}
+
+bool full_symbol_set_reserve(swif_full_symbol_set_t *set, uint32_t data_size)
+{
+    if (!full_symbol_set_grow_data(set, data_size)) {
+        return false;
+    }
+    if (set->block_mode && set->pending_coef == NULL
+        && !full_symbol_set_alloc_block(set)) {
+        return false;
+    }
+    return true;
+}
+
+/* store the equation in tmp, with only its pivot left, as decoded */
+static void full_symbol_set_store_decoded
+(swif_full_symbol_set_t *set, uint32_t col)
+{
+    uint8_t inv = lc_inv(set->tmp_coef[col], set->log2_nb_bit_coef);
+    uint8_t *coef = full_symbol_set_row_coef(set, col);
+
+    memset(coef, 0, set->stride);
+    coef[col] = 1;
+    full_symbol_set_data_mul(set, inv, set->tmp_data, set->data_stride,
+                             full_symbol_set_row_data(set, col));
+    set->data_size_tab[col] = set->tmp_data_size;
+    set->row_state[col] = ROW_DECODED;
+    set->row_weight[col] = 1;
+}
+
+/*
+ * Block mode: missing[j] = sum_i inv[j][i] . pending_data[i] over bytes
+ * [offset; offset + len), tile by tile (a swif_stripe_fn_t).
+ */
+static void full_symbol_set_solve_range(void *arg, uint32_t offset, uint32_t len)
+{
+    swif_full_symbol_set_t *set = arg;
+    uint32_t *missing = set->solve_col_tab;
+    uint8_t *inv = set->solve_inverse;
+
+    for (uint32_t off = offset; off < offset + len; off += FULL_SYMBOL_SET_SOLVE_TILE) {
+        uint32_t tile = MIN(FULL_SYMBOL_SET_SOLVE_TILE, offset + len - off);
+        for (uint32_t j = 0; j < set->nb_missing; j++) {
+            uint8_t *data = full_symbol_set_row_data(set, missing[j]) + off;
+            for (uint32_t i = 0; i < set->nb_pending; i++) {
+                uint32_t size_i = set->pending_size_tab[i];
+                uint8_t c = inv[j * set->size + i];
+                if (c != 0 && size_i > off) {
+                    lc_vector_add_mul(c, full_symbol_set_pending_data(set, i) + off,
+                                      MIN(tile, size_i - off), set->log2_nb_bit_coef, data);
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Block mode: the pending equations are kept reduced (see
+ * full_symbol_set_reduce_pending()), row i being comb_i . pending. Once
+ * every row only refers to its pivot, i.e. the pending equations cover as
+ * many missing source symbols as there are equations, all of them are
+ * computed with one matrix product over the pending data, where the known
+ * source symbols are already subtracted.
+ */
+static void full_symbol_set_solve(swif_full_symbol_set_t *set)
+{
+    uint32_t	nb_eq = set->nb_pending;
+    uint32_t	*missing = set->solve_col_tab;
+    uint32_t	max_data_size = 0;
+    uint32_t	i, j;
+
+    if (nb_eq == 0) {
+        return;
+    }
+    for (i = 0; i < nb_eq; i++) {
+        const uint8_t *row = full_symbol_set_solve_row(set, i);
+        if (full_symbol_set_find_nonzero(row, 0, missing[i]) != NO_COL
+            || full_symbol_set_find_nonzero(row, missing[i] + 1, set->size) != NO_COL) {
+            return; /* not enough equations yet */
+        }
+        max_data_size = MAX(max_data_size, set->pending_size_tab[i]);
+    }
+
+    for (j = 0; j < nb_eq; j++) {
+        memset(full_symbol_set_row_data(set, missing[j]), 0, set->data_stride);
+    }
+    set->nb_missing = nb_eq;
+    swif_stripe_pool_run(set->stripe_pool, full_symbol_set_solve_range, set, max_data_size);
+    for (j = 0; j < nb_eq; j++) {
+        uint8_t *coef = full_symbol_set_row_coef(set, missing[j]);
+        memset(coef, 0, set->stride);
+        coef[missing[j]] = 1;
+        set->data_size_tab[missing[j]] = max_data_size;
+        set->row_state[missing[j]] = ROW_DECODED;
+        set->row_weight[missing[j]] = 1;
+    }
+    set->nb_pending = 0;
+    for (j = 0; j < nb_eq; j++) {
+        full_symbol_set_notify_decoded(set, full_symbol_set_col_id(set, missing[j]));
+    }
+}
+
+/*
+ * Block mode: add the equation in tmp, already reduced by the decoded
+ * source symbols. It is only kept if it is not a combination of the
+ * pending equations.
+ */
+static uint32_t full_symbol_set_add_block
+(swif_full_symbol_set_t *set, bool single_id)
+{
+    if (set->pending_coef == NULL && !full_symbol_set_alloc_block(set)) {
+        WARNING_PRINT("cannot allocate memory for full_symbol set\n");
+        return ENTRY_INDEX_NONE;
+    }
+    uint32_t col = full_symbol_set_find_nonzero(set->tmp_coef, 0, set->size);
+    if (col == NO_COL) {
+        /* redundant equation */
+        return ENTRY_INDEX_NONE;
+    }
+    if (full_symbol_set_find_nonzero(set->tmp_coef, col + 1, set->size) == NO_COL) {
+        /* a single source symbol left: it is decoded, and can be
+         * subtracted from the pending equations */
+        bool changed = false;
+        full_symbol_set_store_decoded(set, col);
+        if (!single_id) {
+            full_symbol_set_notify_decoded(set, full_symbol_set_col_id(set, col));
+        }
+        for (uint32_t i = 0; i < set->nb_pending; ) {
+            uint8_t *coef = full_symbol_set_pending_coef(set, i);
+            uint8_t c = coef[col];
+            if (c != 0) {
+                changed = true;
+                coef[col] = 0;
+                full_symbol_set_data_add_mul(set, c, full_symbol_set_row_data(set, col),
+                                             set->data_size_tab[col],
+                                             full_symbol_set_pending_data(set, i));
+                set->pending_size_tab[i] = MAX(set->pending_size_tab[i],
+                                               set->data_size_tab[col]);
+                if (full_symbol_set_find_nonzero(coef, 0, set->size) == NO_COL) {
+                    full_symbol_set_drop_pending(set, i);
+                    continue;
+                }
+            }
+            i++;
+        }
+        /* only when the source symbol arrives after a repair symbol that
+         * covers it */
+        if (changed) {
+            full_symbol_set_reduce_all_pending(set);
+        }
+    } else {
+        if (set->nb_pending == set->size) {
+            /* cannot happen: the pending equations are independent, and
+             * solved as soon as they are as many as the missing source
+             * symbols. Drop the one that leaves the system first. */
+            uint32_t oldest = 0, oldest_age = 0;
+            for (uint32_t i = 0; i < set->nb_pending; i++) {
+                uint32_t c = full_symbol_set_find_oldest(set, full_symbol_set_pending_coef(set, i));
+                uint32_t age = (full_symbol_set_col(set, set->last_symbol_id) + set->size - c) % set->size;
+                if (age > oldest_age) {
+                    oldest = i;
+                    oldest_age = age;
+                }
+            }
+            WARNING_PRINT("too many pending equations, dropping the oldest one\n");
+            full_symbol_set_drop_pending(set, oldest);
+            full_symbol_set_reduce_all_pending(set);
+        }
+        uint32_t i = set->nb_pending++;
+        memcpy(full_symbol_set_pending_coef(set, i), set->tmp_coef, set->stride);
+        memcpy(full_symbol_set_pending_data(set, i), set->tmp_data, set->data_stride);
+        set->pending_size_tab[i] = set->tmp_data_size;
+        if (!full_symbol_set_reduce_pending(set, i)) {
+            /* combination of the pending equations */
+            set->nb_pending--;
+            return ENTRY_INDEX_NONE;
+        }
+        col = set->solve_col_tab[i];
+    }
+    full_symbol_set_solve(set);
+    return full_symbol_set_col_id(set, col);
+}
 
 /**
  * @brief Add a full_symbol to a packet set.
  * 
- * Gaussian elimination can occur.
- * Return the pivot [remove_each_pivot associated to the new full_symbol]
- * or SYMBOL_ID_NONE if dependent (e.g. redundant) packet
+ * Gaussian elimination occurs, and the application is notified of the
+ * source symbols decoded by this new equation (except of the source
+ * symbol itself when the full_symbol has only one).
+ * Return the pivot (as source symbol index) associated to the new
+ * full_symbol or ENTRY_INDEX_NONE if dependent (e.g. redundant) packet,
+ * or if it refers to source symbols no longer in the linear system.
  * 
  * The full_symbol is not freed and also reference is not captured.
  */
 
+/* number of equations that refer to the unknown of col, up to limit */
+static uint32_t full_symbol_set_col_count
+(swif_full_symbol_set_t *set, uint32_t col, uint32_t limit)
+{
+    uint32_t count = 0;
+    for (uint32_t row = 0; row < set->size && count < limit; row++) {
+        if (set->row_state[row] == ROW_PIVOT
+            && full_symbol_set_row_coef(set, row)[col] != 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/*
+ * Choose the pivot of the equation in tmp_coef, already reduced by the
+ * known pivots, following set->pivot_policy. Return NO_COL when the
+ * equation is redundant.
+ */
+static uint32_t full_symbol_set_select_pivot(swif_full_symbol_set_t *set)
+{
+    uint32_t oldest_col = full_symbol_set_col(set, set->last_symbol_id + 1);
+    uint32_t pivot = full_symbol_set_find_nonzero(set->tmp_coef, oldest_col, set->size);
+    if (pivot == NO_COL) {
+        pivot = full_symbol_set_find_nonzero(set->tmp_coef, 0, oldest_col);
+    }
+    if (pivot == NO_COL || set->forward_only
+        || set->pivot_policy != SWIF_PIVOT_POLICY_MIN_FILL_IN) {
+        return pivot;
+    }
+    /* Markowitz: the new equation is added to every equation that refers
+     * to its pivot, so pick the unknown with the fewest such equations,
+     * in ESI order so that ties go to the oldest one */
+    uint32_t best_count = full_symbol_set_col_count(set, pivot, UINT32_MAX);
+    for (uint32_t i = 1; i < set->size && best_count > 0; i++) {
+        uint32_t col = (oldest_col + i) % set->size;
+        if (col == pivot || set->tmp_coef[col] == 0) {
+            continue;
+        }
+        uint32_t count = full_symbol_set_col_count(set, col, best_count);
+        if (count < best_count) {
+            pivot = col;
+            best_count = count;
+        }
+    }
+    return pivot;
+}
+
 uint32_t full_symbol_set_add
 (swif_full_symbol_set_t *set, swif_full_symbol_t *full_symbol)
 {
@@ -108,220 +849,221 @@ uint32_t full_symbol_set_add
     if (full_symbol_is_zero(full_symbol)) {
         return ENTRY_INDEX_NONE;
     }
+    return full_symbol_set_add_coefs(set, full_symbol->coef, full_symbol->first_id,
+                                     full_symbol->last_id - full_symbol->first_id + 1,
+                                     full_symbol->data, full_symbol->data_size);
+}
 
-    /* the added symbol is not modified: we first clone it */
-    swif_full_symbol_t *full_symbol_cloned = full_symbol_clone(full_symbol);
-    if (full_symbol_cloned == NULL) {
-        WARNING_PRINT("cannot allocate memory for full_symbol cloning");
+uint32_t full_symbol_set_add_coefs
+(swif_full_symbol_set_t *set, const uint8_t *coef_tab, symbol_id_t first_id,
+ uint32_t nb_id, const uint8_t *data, uint32_t data_size)
+{
+    assert(set != NULL);
+    /* only keep the nonzero part of the equation */
+    uint32_t first = full_symbol_set_find_nonzero(coef_tab, 0, nb_id);
+    if (first == NO_COL) {
         return ENTRY_INDEX_NONE;
     }
-    if (set->first_symbol_id == SYMBOL_ID_NONE) {
-        set->first_symbol_id = full_symbol_cloned->first_nonzero_id;
-    }
-    
-    uint32_t old_size = set->size;
-    symbol_id_t new_i0 = full_symbol_cloned->first_nonzero_id;
-    symbol_id_t set_i0 = set->first_symbol_id;
-
-    /* The added symbol has first nonzero index outside the current set */
-    if (new_i0 < set_i0) {   
-        DEBUG_PRINT("Debugging is enabled. Case: full_symbol_cloned->first_nonzero_id < set->first_symbol_id \n");
-        if (set_i0 - new_i0 < set->size) {
-            memmove(set->full_symbol_tab+(set_i0-new_i0), set->full_symbol_tab, 
-                    sizeof(swif_full_symbol_t *) * (set->size-(set_i0-new_i0)));
-	    memset(set->full_symbol_tab, 0,
-		   sizeof(swif_full_symbol_t *)*(set_i0-new_i0));
-        } else { 
-            if (set_i0 - new_i0 < (set->size * 2)) {
-                set->size *= 2;
-            } else {
-                set->size = set_i0-new_i0 +1;
-            }
-            set->full_symbol_tab = realloc(set->full_symbol_tab, set->size * sizeof(swif_full_symbol_t *));
-            memmove(set->full_symbol_tab + (set_i0-new_i0), set->full_symbol_tab, sizeof(swif_full_symbol_t*) * old_size);
-	    memset(set->full_symbol_tab, 0,
-		   sizeof(swif_full_symbol_t *)*(set_i0-new_i0));
-        }
-        IF_DEBUG(full_symbol_set_dump(set, stdout));
-        if (set->full_symbol_tab == NULL) {
-            WARNING_PRINT("failed to reallocate full_symbol_tab");
-            full_symbol_free(full_symbol_cloned);
-            free(set->full_symbol_tab);
-            return ENTRY_INDEX_NONE;
-        }
-        set->full_symbol_tab[0] = full_symbol_cloned;
-        set->nmbr_packets++;
-        set->first_symbol_id = MIN(set_i0, new_i0); /* actually should be new_i0 */
-        set_i0 = set->first_symbol_id;
-        return new_i0 - set_i0; /* should be 0 */
-    }
-
-    DEBUG_PRINT("Debugging is enabled. Case: full_symbol_cloned->first_nonzero_id > set->first_symbol_id \n");
-    uint32_t idx_pos = new_i0 - set_i0;
-    if (idx_pos < set->size) {
-        if (set->full_symbol_tab[idx_pos] != NULL) {
-            WARNING_PRINT("overwriting one full_symbol in set\n");
-            full_symbol_free(set->full_symbol_tab[idx_pos]);
-        }
-        set->full_symbol_tab[idx_pos] = full_symbol_cloned;
-        set->nmbr_packets++;
-        return idx_pos; 
-    } else if (idx_pos < (set->size *2)) {
-        set->size *= 2;
-    } else { /* new_i0-set_i0 >= set->size*2 */
-        set->size = idx_pos +1; /* hence: new set->size >= old_size *2 + 1 */
-    }
-    assert(idx_pos < set->size);
-
-    /* reallocate memory for the table of pointers in full_symbol */
-    set->full_symbol_tab = realloc(
-        set->full_symbol_tab, set->size * sizeof(swif_full_symbol_t *));
-    memset(set->full_symbol_tab+old_size, 0, sizeof(swif_full_symbol_t*)*(set->size-old_size));
-
-    if (set->full_symbol_tab == NULL) {
-        WARNING_PRINT("failed to reallocate full_symbol_tab");
-        full_symbol_free(full_symbol_cloned);
-        free(set->full_symbol_tab);
+    uint32_t last = nb_id - 1;
+    while (coef_tab[last] == 0) {
+        last--;
+    }
+    coef_tab += first;
+    symbol_id_t last_id = first_id + last;
+    first_id += first;
+    bool single_id = (first == last);
+    if (last_id - first_id >= set->span) {
+        WARNING_PRINT("full_symbol larger than the full_symbol set\n");
+        return ENTRY_INDEX_NONE;
+    }
+    if (!full_symbol_set_grow_data(set, data_size)) {
+        WARNING_PRINT("cannot allocate memory for full_symbol set\n");
+        return ENTRY_INDEX_NONE;
+    }
+    full_symbol_set_slide(set, last_id);
+    if (!full_symbol_set_includes_id(set, first_id)) {
+        /* source symbols already removed from the linear system */
         return ENTRY_INDEX_NONE;
     }
 
-    set->full_symbol_tab[idx_pos] = full_symbol_cloned;
+    /* copy the equation in the dense temporary row, in at most two
+     * pieces as columns wrap around */
+    uint32_t first_col = full_symbol_set_col(set, first_id);
+    uint32_t nb_first = MIN(last_id - first_id + 1, set->size - first_col);
+    memset(set->tmp_coef, 0, set->stride);
+    memcpy(set->tmp_coef + first_col, coef_tab, nb_first);
+    memcpy(set->tmp_coef, coef_tab + nb_first, last_id - first_id + 1 - nb_first);
+    memcpy(set->tmp_data, data, data_size);
+    memset(set->tmp_data + data_size, 0, set->data_stride - data_size);
+    set->tmp_data_size = data_size;
+
+    if (set->forward_only) {
+        /* echelon form: a row only adds newer source symbols, that are
+         * reduced in turn when taken in ESI order */
+        uint32_t oldest_col = full_symbol_set_col(set, set->last_symbol_id + 1);
+        for (uint32_t i = 0; i < set->size; i++) {
+            uint32_t col = (oldest_col + i) % set->size;
+            if (set->tmp_coef[col] != 0 && set->row_state[col] != ROW_NONE) {
+                full_symbol_set_row_add_scaled(set, NO_COL, set->tmp_coef[col], col);
+            }
+        }
+    } else {
+        /* remove the known pivots: pivot rows have no other pivot column,
+         * so this doesn't add any pivot column to the equation */
+        for (uint32_t col = full_symbol_set_find_nonzero(set->tmp_coef, 0, set->size);
+             col != NO_COL;
+             col = full_symbol_set_find_nonzero(set->tmp_coef, col + 1, set->size)) {
+            if (set->row_state[col] != ROW_NONE) {
+                full_symbol_set_row_add_scaled(set, NO_COL, set->tmp_coef[col], col);
+            }
+        }
+    }
     set->nmbr_packets++;
-    return idx_pos;
-}
-
-/*---------------------------------------------------------------------------*/
-swif_full_symbol_t *full_symbol_set_get_pivot
-(swif_full_symbol_set_t *set, symbol_id_t symbol_id)
-{ 
-    IF_DEBUG(full_symbol_set_dump(set, stdout));
-    if (symbol_id >= set->first_symbol_id 
-        && symbol_id < (set->size + set->first_symbol_id) 
-        && set->full_symbol_tab[symbol_id-set->first_symbol_id] ){
-        DEBUG_PRINT("Coef of pivot is equal to : %u \n",
-	    full_symbol_get_coef(set->full_symbol_tab[symbol_id-set->first_symbol_id], symbol_id));
-        return set->full_symbol_tab[symbol_id-set->first_symbol_id];
-    }  
-    DEBUG_PRINT("Pivot of symbol id %u is not found \n", symbol_id);
-    return NULL; 
-}
+    if (set->block_mode) {
+        return full_symbol_set_add_block(set, single_id);
+    }
 
-/*---------------------------------------------------------------------------*/
-swif_full_symbol_t *full_symbol_set_remove_each_pivot
-(swif_full_symbol_set_t *full_symbol_set, swif_full_symbol_t *new_symbol1)
-{   
-    /* only copies of symbol are stored, so first clone it */
-    swif_full_symbol_t *new_symbol = full_symbol_clone(new_symbol1);
-    /* is_zero variable is used to check if all the symbol coefs are zero */
-    bool is_zero = true;
-    full_symbol_adjust_min_max_coef(new_symbol);
-    if (new_symbol->first_nonzero_id == SYMBOL_ID_NONE)
-    {
-        full_symbol_free(new_symbol);
-        return NULL;
+    uint32_t pivot = full_symbol_set_select_pivot(set);
+    if (pivot == NO_COL) {
+        /* redundant equation */
+        return ENTRY_INDEX_NONE;
     }
-    for (uint32_t i = new_symbol->first_nonzero_id ; i <= new_symbol->last_nonzero_id; i++) {
-        uint8_t coef = full_symbol_get_coef(new_symbol, i); 
+    uint8_t inv = lc_inv(set->tmp_coef[pivot], set->log2_nb_bit_coef);
+    if (inv != 1) {
+        lc_vector_mul(inv, set->tmp_coef, set->stride, set->log2_nb_bit_coef, set->tmp_coef);
+        full_symbol_set_data_mul(set, inv, set->tmp_data, set->tmp_data_size, set->tmp_data);
+    }
+    memcpy(full_symbol_set_row_coef(set, pivot), set->tmp_coef, set->stride);
+    memcpy(full_symbol_set_row_data(set, pivot), set->tmp_data, set->data_stride);
+    set->data_size_tab[pivot] = set->tmp_data_size;
+    set->row_state[pivot] = ROW_PIVOT;
+
+    /* the other unknowns of the new row: only their coefficients change
+     * in the rows it is added to, which keeps the row weights up to date
+     * without scanning these rows */
+    uint32_t *nonzero = set->nonzero_col_tab;
+    uint32_t nb_nonzero = 0;
+    for (uint32_t col = full_symbol_set_find_nonzero(set->tmp_coef, 0, set->size);
+         col != NO_COL;
+         col = full_symbol_set_find_nonzero(set->tmp_coef, col + 1, set->size)) {
+        if (col != pivot) {
+            nonzero[nb_nonzero++] = col;
+        }
+    }
+    set->row_weight[pivot] = nb_nonzero + 1;
+    if (set->forward_only) {
+        return full_symbol_set_col_id(set, pivot);
+    }
+
+    /* remove the new pivot from the other rows */
+    for (uint32_t col = 0; col < set->size; col++) {
+        if (col == pivot || set->row_state[col] == ROW_NONE) {
+            continue;
+        }
+        uint8_t *row = full_symbol_set_row_coef(set, col);
+        uint8_t coef = row[pivot];
         if (coef != 0) {
-            swif_full_symbol_t *symbol_pivot = full_symbol_set_get_pivot(full_symbol_set, i);
-            if (symbol_pivot != NULL) {
-                swif_full_symbol_t *symbol1 = symbol_pivot;
-                /* the symbol is not modified: we first clone it */
-                swif_full_symbol_t *symbol1_cloned = full_symbol_clone(symbol1);
-                /* symbol1_cloned is multiplied by the associated coef */
-                full_symbol_scale(symbol1_cloned, coef);
-                swif_full_symbol_t *symbol2 = full_symbol_add(new_symbol, symbol1_cloned);
-                /* After the addition, symbol2 may be null, in this case w eliminate it */
-                if (!full_symbol_is_zero(symbol2)) {
-                    full_symbol_free(new_symbol);
-                    new_symbol =  symbol2;
-                }
-                else
-                {
-                 full_symbol_free(symbol2);
-                }
-                full_symbol_free(symbol1_cloned);
-            } else {
-                is_zero = false; 
+            /* the coefficient of the pivot is cancelled */
+            uint32_t weight = set->row_weight[col] - 1;
+            for (uint32_t k = 0; k < nb_nonzero; k++) {
+                weight -= (row[nonzero[k]] != 0);
+            }
+            full_symbol_set_row_add_scaled(set, col, coef, pivot);
+            for (uint32_t k = 0; k < nb_nonzero; k++) {
+                weight += (row[nonzero[k]] != 0);
+            }
+            set->row_weight[col] = weight;
+            if (set->row_state[col] == ROW_PIVOT && weight == 1) {
+                set->row_state[col] = ROW_DECODED;
+                full_symbol_set_notify_decoded(set, full_symbol_set_col_id(set, col));
             }
         }
     }
-    if (is_zero) {
-        full_symbol_free(new_symbol);
-        return NULL; 
+    symbol_id_t pivot_id = full_symbol_set_col_id(set, pivot);
+    if (nb_nonzero == 0) {
+        set->row_state[pivot] = ROW_DECODED;
+        if (!single_id) {
+            full_symbol_set_notify_decoded(set, pivot_id);
+        }
     }
-    return new_symbol;
+    return pivot_id;
 }
-  
-/*---------------------------------------------------------------------------*/
 
-/* callback should not add new symbols to full_symbol_set */
-void full_symbol_set_notify_decoded
-(swif_full_symbol_set_t *set, symbol_id_t decoded_id) 
+/**
+ * @brief Return the data of the equation whose pivot is symbol_id, and its
+ *        size, or NULL if there is none.
+ */
+uint8_t *full_symbol_set_get_pivot_data
+(swif_full_symbol_set_t *set, symbol_id_t symbol_id, uint32_t *data_size)
 {
-    if (set->notify_decoded_func != NULL) {
-        set->notify_decoded_func(set, decoded_id, set->notify_context);
+    if (!full_symbol_set_includes_id(set, symbol_id)) {
+        return NULL;
     }
+    uint32_t col = full_symbol_set_col(set, symbol_id);
+    if (set->row_state[col] == ROW_NONE) {
+        return NULL;
+    }
+    *data_size = set->data_size_tab[col];
+    return full_symbol_set_row_data(set, col);
 }
 
-/*---------------------------------------------------------------------------*/
-
-uint32_t full_symbol_set_add_as_pivot
-(swif_full_symbol_set_t *full_symbol_set, swif_full_symbol_t *new_symbol) 
+uint32_t full_symbol_set_get_rank(swif_full_symbol_set_t *set)
 {
-    full_symbol_adjust_min_max_coef(new_symbol);
-    if (new_symbol->first_nonzero_id == SYMBOL_ID_NONE) {
-        return ENTRY_INDEX_NONE;
+    uint32_t rank = 0;
+    for (uint32_t col = 0; col < set->size; col++) {
+        rank += (set->row_state[col] != ROW_NONE);
     }
-    full_symbol_scale(new_symbol, gf256_inv(full_symbol_get_coef(new_symbol, new_symbol->first_nonzero_id))); 
-    symbol_id_t first_index = new_symbol->first_nonzero_id; 
+    return rank + set->nb_pending;
+}
 
-    for(uint32_t i = 0 ; i < full_symbol_set->size; i++) {
-        if (full_symbol_set->full_symbol_tab[i]) {
-            swif_full_symbol_t *symbol_cloned = full_symbol_clone(new_symbol);
-            uint8_t coef = full_symbol_get_coef(full_symbol_set->full_symbol_tab[i], first_index); /* XXX: if coef == 0, nothing to do */
-            full_symbol_scale(symbol_cloned, coef);
-            swif_full_symbol_t * symbol2 = full_symbol_add(full_symbol_set->full_symbol_tab[i], symbol_cloned);
-	    bool is_decoded = !full_symbol_has_one_id(full_symbol_set->full_symbol_tab[i]) && full_symbol_has_one_id(symbol2);
-            full_symbol_free(full_symbol_set->full_symbol_tab[i]);
-            full_symbol_set->full_symbol_tab[i] = symbol2;
-            full_symbol_free(symbol_cloned);
-	    if (is_decoded) {
-  	        symbol_id_t si = full_symbol_get_min_symbol_id(symbol2);
-	        assert(full_symbol_get_coef(symbol2, si)  == 1);
-	        full_symbol_set_notify_decoded(full_symbol_set, si);
-	    }
+uint32_t full_symbol_set_combine
+(swif_full_symbol_set_t *set, const uint8_t *weight_tab, uint8_t *coef_tab,
+ symbol_id_t *first_id, uint8_t *data, uint32_t *data_size)
+{
+    assert(!set->block_mode);
+    if (!set->has_last_id) {
+        return 0;
+    }
+    uint32_t oldest_col = full_symbol_set_col(set, set->last_symbol_id + 1);
+    uint32_t i, k = 0;
+
+    memset(set->tmp_coef, 0, set->stride);
+    memset(set->tmp_data, 0, set->data_stride);
+    set->tmp_data_size = 0;
+    for (i = 0; i < set->size; i++) {
+        uint32_t col = (oldest_col + i) % set->size;
+        if (set->row_state[col] != ROW_NONE) {
+            if (weight_tab[k] != 0) {
+                full_symbol_set_row_add_scaled(set, NO_COL, weight_tab[k], col);
+            }
+            k++;
+        }
+    }
+    /* back to ESI order, from the oldest nonzero coefficient */
+    uint32_t first = NO_COL, last = 0;
+    for (i = 0; i < set->size; i++) {
+        if (set->tmp_coef[(oldest_col + i) % set->size] != 0) {
+            first = (first == NO_COL) ? i : first;
+            last = i;
         }
     }
-    IF_DEBUG(full_symbol_dump(new_symbol, stdout));
-    return full_symbol_set_add(full_symbol_set, new_symbol);
+    if (first == NO_COL) {
+        return 0;
+    }
+    for (i = first; i <= last; i++) {
+        coef_tab[i - first] = set->tmp_coef[(oldest_col + i) % set->size];
+    }
+    *first_id = set->last_symbol_id - (set->size - 1) + first;
+    memcpy(data, set->tmp_data, set->tmp_data_size);
+    *data_size = set->tmp_data_size;
+    return last - first + 1;
 }
 
-
 /*---------------------------------------------------------------------------*/
 void full_symbol_add_with_elimination(swif_full_symbol_set_t *full_symbol_set,
 				      swif_full_symbol_t *new_symbol) 
 {
-    swif_full_symbol_t *fss_remove_pivot
-      = full_symbol_set_remove_each_pivot(full_symbol_set, new_symbol);
-    if (fss_remove_pivot) {
-        uint32_t idx = full_symbol_set_add_as_pivot(
-	      full_symbol_set, fss_remove_pivot);
-        full_symbol_free(fss_remove_pivot);
-	if (idx  == ENTRY_INDEX_NONE)
-	{
-	  return;
-        }
-	swif_full_symbol_t* stored_symbol
-	  = full_symbol_set->full_symbol_tab[idx];
-	bool is_decoded = (!full_symbol_has_one_id(new_symbol))
-	  && full_symbol_has_one_id(stored_symbol);
-	if (is_decoded) {
-	    symbol_id_t si = full_symbol_get_min_symbol_id(stored_symbol);
-	    assert(full_symbol_get_coef(stored_symbol, si)  == 1);
-	    full_symbol_set_notify_decoded(full_symbol_set, si);
-	}
-    }
+    full_symbol_set_add(full_symbol_set, new_symbol);
 }
 /*---------------------------------------------------------------------------*/
 /**
@@ -654,6 +1396,17 @@ void full_symbol_dump(swif_full_symbol_t *full_symbol, FILE *out)
  * @param[in]     coef  Coefficient by which the second packet is multiplied
  */
 void full_symbol_scale(swif_full_symbol_t *symbol1, uint8_t coef)
+{
+    full_symbol_scale_in_field(symbol1, coef, MAX_LOG2_NB_BIT_COEF);
+}
+
+/**
+ * @brief Same as full_symbol_scale() in GF(2^(2^log2_nb_bit_coef)): the
+ *        data is processed as packed elements, while the coefficients are
+ *        stored one per byte whatever the field.
+ */
+void full_symbol_scale_in_field(swif_full_symbol_t *symbol1, uint8_t coef,
+                                uint8_t log2_nb_bit_coef)
 {
     assert(symbol1->coef != NULL);
     assert(symbol1->data != NULL);
@@ -661,8 +1414,8 @@ void full_symbol_scale(swif_full_symbol_t *symbol1, uint8_t coef)
         return; /* empty/zero packet */
     }
     assert(symbol1->first_nonzero_id != SYMBOL_ID_NONE && symbol1->last_nonzero_id != SYMBOL_ID_NONE);
-    symbol_mul(symbol1->data, coef, symbol1->data_size, symbol1->data);
-    symbol_mul(symbol1->coef, coef, full_symbol_count_allocated_coef(symbol1), symbol1->coef);
+    lc_vector_mul(coef, symbol1->data, symbol1->data_size, log2_nb_bit_coef, symbol1->data);
+    lc_vector_mul(coef, symbol1->coef, full_symbol_count_allocated_coef(symbol1), log2_nb_bit_coef, symbol1->coef);
     full_symbol_adjust_min_max_coef(symbol1); // because after adjust some coeffs could be 0
 }
 
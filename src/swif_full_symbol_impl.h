@@ -57,13 +57,75 @@ struct s_swif_full_symbol_t {
 
 typedef void (*notify_decoded_func_t)(swif_full_symbol_set_t *set, symbol_id_t symbol_id, void *context);
   
+/* The linear system of a full_symbol set, kept fully reduced:
+ * - the column of source symbol `id' is `id % size', for the `span' source
+ * symbols up to `last_symbol_id' (included), modulo 2^32
+ * - the row `c' of `coef_matrix' (`stride' bytes per row, one coefficient
+ * per byte) and of `data_matrix' (`data_stride' bytes per row) is the
+ * equation whose pivot is in column `c': its oldest source symbol, unless
+ * `pivot_policy' (a swif_pivot_policy_t) chose another one
+ * - `row_state[c]' tells whether there is such an equation, and whether its
+ * source symbol is decoded, and `row_weight[c]' is its number of nonzero
+ * coefficients (1 once decoded), maintained along the row operations.
+ */
 struct s_swif_full_symbol_set_t {
-    uint32_t size; /* size of the table containing pointers to full_symbol */
-    uint32_t first_symbol_id; /* the index of full_symbol_tab */
+    uint32_t size; /* number of columns and rows of the matrix, power of two */
+    uint32_t span; /* number of consecutive source symbols kept, <= size */
+    uint32_t stride; /* size rounded up for row alignment */
+    symbol_id_t last_symbol_id; /* newest source symbol in the system */
+    bool has_last_id; /* false until the first equation */
     uint32_t nmbr_packets;
-    swif_full_symbol_t **full_symbol_tab;
+    uint8_t *coef_matrix;
+    uint8_t *data_matrix;
+    uint32_t data_stride; /* largest symbol added so far */
+    uint32_t *data_size_tab; /* actual data size of each row */
+    uint8_t *row_state;
+    uint32_t *row_weight;
+    uint32_t *nonzero_col_tab; /* unknowns of the new row, but its pivot */
+    uint8_t *tmp_coef; /* equation being added */
+    uint8_t *tmp_data;
+    uint32_t tmp_data_size;
+    uint8_t log2_nb_bit_coef; /* finite field, see swif_linear-code.h */
+    uint8_t pivot_policy;
+
+    /* forward only: new equations are reduced by the previous ones, which
+     * are not reduced by them (no back-substitution). The pivot is always
+     * the oldest source symbol, so the system stays in echelon form, each
+     * row only referring to its pivot and newer source symbols. Used to
+     * recode without decoding, see swif_recoder.h. */
+    bool forward_only;
+
+    /* block mode: the matrix only holds decoded source symbols, and the
+     * other equations, reduced by them, are pending in `pending_coef' and
+     * `pending_data' (same layout) until they can be solved all at once.
+     * Their coefficients are kept in reduced echelon form as they arrive:
+     * row i of `solve_matrix' (`stride' bytes) is the combination of the
+     * pending equations given by row i of `solve_inverse' (`size' bytes),
+     * with its pivot in `solve_col_tab[i]' */
+    bool block_mode;
+    uint32_t nb_pending;
+    uint8_t *pending_coef;
+    uint8_t *pending_data;
+    uint32_t *pending_size_tab;
+    uint8_t *solve_matrix;
+    uint8_t *solve_inverse;
+    uint32_t *solve_col_tab; /* columns of the missing source symbols */
+    uint32_t nb_missing;
+
+    /* allocator of all the memory of the set, see swif_allocator_t */
+    swif_allocator_t allocator;
+
+    /* optional, not owned: threads sharing the payload (data) side of
+     * each operation, see swif_stripe_pool.h */
+    swif_stripe_pool_t *stripe_pool;
+
+    /* kernels specialised for data_stride, NULL if there are none
+     * (see lc_get_kernels()) */
+    const struct symbol_kernels *kernels;
 
     notify_decoded_func_t notify_decoded_func; /* XXX: manually set */
+    notify_decoded_func_t notify_removed_func; /* same, source symbol
+                                                * evicted from the system */
     void                 *notify_context;
 };
 
@@ -72,10 +134,25 @@ struct s_swif_full_symbol_set_t {
     
 /*---------------------------------------------------------------------------*/
 
+/**
+ * @brief Same as full_symbol_set_alloc_with_size(), all the memory of the
+ *        set being allocated with allocator (copied).
+ */
+swif_full_symbol_set_t *full_symbol_set_alloc_with_allocator
+(uint32_t size, const swif_allocator_t *allocator);
+
+/**
+ * @brief Allocate now the memory needed for symbols of up to data_size
+ *        bytes, and for block mode if enabled, so that adding such symbols
+ *        does not allocate anything. Return false if there is no memory.
+ */
+bool full_symbol_set_reserve(swif_full_symbol_set_t *set, uint32_t data_size);
+
 /**
  * @brief Add a full_symbol to a packet set.
  * 
  * Online Gaussian elimination is performed.
+ * Each source symbol decoded is notified through notify_decoded_func.
  * Return the pivot associated to the new full_symbol (as source symbol index)
  * or ENTRY_INDEX_NONE if dependent (e.g. redundant) packet
  * 
@@ -97,6 +174,34 @@ swif_full_symbol_t *full_symbol_alloc
  */
 void full_symbol_set_dump(swif_full_symbol_set_t *full_symbol_set, FILE *out);
 
+/**
+ * @brief Return the data of the equation whose pivot is symbol_id (i.e.
+ *        the decoded source symbol once it is decoded), and its size in
+ *        data_size, or NULL if there is none.
+ */
+uint8_t *full_symbol_set_get_pivot_data
+(swif_full_symbol_set_t *set, symbol_id_t symbol_id, uint32_t *data_size);
+
+/**
+ * @brief Return the number of equations (i.e. the rank) of the set.
+ */
+uint32_t full_symbol_set_get_rank(swif_full_symbol_set_t *set);
+
+/**
+ * @brief Compute the linear combination of the equations of the set whose
+ *        weights are weight_tab, the i-th weight being the one of the
+ *        equation with the i-th oldest pivot (full_symbol_set_get_rank()
+ *        weights). Its nonzero coefficients are written in coef_tab (up
+ *        to `size' of them), the first one being the one of source symbol
+ *        *first_id, and its data in data (*data_size bytes).
+ *        Return the number of coefficients, 0 if the combination is zero.
+ */
+uint32_t full_symbol_set_combine
+(swif_full_symbol_set_t *set, const uint8_t *weight_tab, uint8_t *coef_tab,
+ symbol_id_t *first_id, uint8_t *data, uint32_t *data_size);
+
+void full_symbol_dump_id(symbol_id_t symbol_id, FILE *out);
+
 /**
  * @brief get the size of the data
  */
@@ -137,6 +242,13 @@ bool full_symbol_adjust_min_max_coef(swif_full_symbol_t* symbol);
 void full_symbol_scale
 ( swif_full_symbol_t *symbol1, uint8_t coereef);
 
+/**
+ * @brief Same as full_symbol_scale(), in the finite field
+ *        GF(2^(2^log2_nb_bit_coef)) (see swif_linear-code.h)
+ */
+void full_symbol_scale_in_field
+( swif_full_symbol_t *symbol1, uint8_t coef, uint8_t log2_nb_bit_coef);
+
 
 /**
  * @brief Take a symbol and add another symbol to it, e.g. performs the equivalent of: p3 = p1 + p2
@@ -66,6 +66,10 @@ extern "C" {
 #define MAX(a,b) ((a) > (b) ? (a) : (b))
 #define MIN(a,b) ((a) < (b) ? (a) : (b))
 
+/* fields written by different threads are kept on different cache lines */
+#define SWIF_CACHE_LINE 64
+#define SWIF_ALIGNED __attribute__((aligned(SWIF_CACHE_LINE)))
+
 static inline uint16_t min_except(uint16_t v1, uint16_t v2, uint16_t ignored)
 {
   if (v1 == ignored) 
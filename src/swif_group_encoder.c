@@ -0,0 +1,263 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+/**
+ * Group encoder: one coding window shared by several repair cursors, see
+ * swif_group_encoder.h.
+ */
+
+#include "swif_includes.h"
+#include "swif_rlc_api.h"
+#include "swif_group_encoder.h"
+
+
+/* repair symbol built since the last source symbol was added */
+typedef struct swif_group_repair {
+	esi_t		first;
+	uint32_t	nss;
+	uint16_t	key;
+	uint32_t	size;		/* meaningful bytes */
+	void*		buf;		/* symbol_size bytes, reused */
+} swif_group_repair_t;
+
+struct swif_repair_cursor {
+	swif_group_encoder_t*	group;
+	uint32_t		window_size;
+	uint16_t		next_key;
+	swif_repair_cursor_t*	next;
+};
+
+struct swif_group_encoder {
+	swif_encoder_t*		enc;
+	uint32_t		max_coding_window_size;
+
+	swif_repair_cursor_t*	cursor_list;
+
+	/* repair_tab[0..nb_repairs-1] are valid for the current coding
+	 * window, the next ones (up to repair_tab_size) only keep their
+	 * buffer for later use */
+	swif_group_repair_t*	repair_tab;
+	uint32_t		nb_repairs;
+	uint32_t		repair_tab_size;
+
+	uint64_t		nb_built;
+	uint64_t		nb_shared;
+};
+
+
+swif_group_encoder_t* swif_group_encoder_create (
+                                swif_codepoint_t codepoint,
+                                uint32_t        verbosity,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size)
+{
+    swif_group_encoder_t	*group;
+
+    if ((group = calloc(1, sizeof(swif_group_encoder_t))) == NULL) {
+        fprintf(stderr, "swif_group_encoder_create() failed! No memory\n");
+        return NULL;
+    }
+    group->enc = swif_encoder_create(codepoint, verbosity, symbol_size, max_coding_window_size);
+    if (group->enc == NULL) {
+        free(group);
+        return NULL;
+    }
+    group->max_coding_window_size = max_coding_window_size;
+    return group;
+}
+
+
+swif_status_t   swif_group_encoder_release (swif_group_encoder_t*  group)
+{
+    swif_repair_cursor_t	*cursor;
+    uint32_t			i;
+
+    assert(group);
+    while ((cursor = group->cursor_list) != NULL) {
+        group->cursor_list = cursor->next;
+        free(cursor);
+    }
+    for (i = 0; i < group->repair_tab_size; i++) {
+        free(group->repair_tab[i].buf);
+    }
+    free(group->repair_tab);
+    swif_encoder_release(group->enc);
+    free(group);
+    return SWIF_STATUS_OK;
+}
+
+
+swif_encoder_t* swif_group_encoder_get_encoder (swif_group_encoder_t*  group)
+{
+    return group->enc;
+}
+
+
+swif_status_t   swif_group_encoder_add_source_symbol (
+                                swif_group_encoder_t*   group,
+                                void*                   new_src_symbol_buf,
+                                esi_t                   new_src_symbol_esi)
+{
+    /* the repair symbols already built remain correct for their source
+     * symbols, but the cursors now expect newer ones: only their buffers
+     * are kept */
+    group->nb_repairs = 0;
+    return swif_encoder_add_source_symbol_to_coding_window(group->enc,
+                                                           new_src_symbol_buf,
+                                                           new_src_symbol_esi);
+}
+
+
+swif_repair_cursor_t* swif_group_encoder_add_cursor (
+                                swif_group_encoder_t*   group,
+                                uint32_t                window_size,
+                                uint16_t                first_key)
+{
+    swif_repair_cursor_t	*cursor;
+
+    if (window_size == 0 || window_size > group->max_coding_window_size) {
+        fprintf(stderr, "swif_group_encoder_add_cursor() failed! bad window size %u\n", window_size);
+        return NULL;
+    }
+    if ((cursor = calloc(1, sizeof(swif_repair_cursor_t))) == NULL) {
+        fprintf(stderr, "swif_group_encoder_add_cursor() failed! No memory\n");
+        return NULL;
+    }
+    cursor->group = group;
+    cursor->window_size = window_size;
+    cursor->next_key = first_key;
+    cursor->next = group->cursor_list;
+    group->cursor_list = cursor;
+    return cursor;
+}
+
+
+swif_status_t   swif_group_encoder_remove_cursor (
+                                swif_group_encoder_t*   group,
+                                swif_repair_cursor_t*   cursor)
+{
+    swif_repair_cursor_t	**prev;
+
+    for (prev = &group->cursor_list; *prev != NULL; prev = &(*prev)->next) {
+        if (*prev == cursor) {
+            *prev = cursor->next;
+            free(cursor);
+            return SWIF_STATUS_OK;
+        }
+    }
+    return SWIF_STATUS_ERROR;
+}
+
+
+swif_status_t   swif_repair_cursor_set_window_size (
+                                swif_repair_cursor_t*   cursor,
+                                uint32_t                window_size)
+{
+    if (window_size == 0 || window_size > cursor->group->max_coding_window_size) {
+        return SWIF_STATUS_ERROR;
+    }
+    cursor->window_size = window_size;
+    return SWIF_STATUS_OK;
+}
+
+
+/* repair symbol of the current coding window, built if needed */
+static swif_group_repair_t* swif_group_encoder_get_repair (
+                                swif_group_encoder_t*   group,
+                                esi_t                   first,
+                                uint32_t                nss,
+                                uint16_t                key)
+{
+    swif_group_repair_t	*repair;
+    uint32_t		i;
+
+    for (i = 0; i < group->nb_repairs; i++) {
+        repair = &group->repair_tab[i];
+        if (repair->first == first && repair->nss == nss && repair->key == key) {
+            group->nb_shared++;
+            return repair;
+        }
+    }
+    if (group->nb_repairs == group->repair_tab_size) {
+        uint32_t new_size = MAX(2 * group->repair_tab_size, 4);
+        swif_group_repair_t *new_tab = realloc(group->repair_tab,
+                                               new_size * sizeof(swif_group_repair_t));
+        if (new_tab == NULL) {
+            return NULL;
+        }
+        memset(new_tab + group->repair_tab_size, 0,
+               (new_size - group->repair_tab_size) * sizeof(swif_group_repair_t));
+        group->repair_tab = new_tab;
+        group->repair_tab_size = new_size;
+    }
+    repair = &group->repair_tab[group->nb_repairs];
+    if (swif_encoder_set_repair_window(group->enc, first, nss) != SWIF_STATUS_OK
+        || swif_encoder_generate_coding_coefs(group->enc, key, 0) != SWIF_STATUS_OK
+        || swif_build_repair_symbol(group->enc, &repair->buf) != SWIF_STATUS_OK
+        || swif_encoder_get_parameters(group->enc, swif_ENCODER_GET_PARAM_REPAIR_SYMBOL_SIZE,
+                                       sizeof(uint32_t), &repair->size) != SWIF_STATUS_OK) {
+        return NULL;
+    }
+    repair->first = first;
+    repair->nss = nss;
+    repair->key = key;
+    group->nb_repairs++;
+    group->nb_built++;
+    return repair;
+}
+
+
+swif_status_t   swif_repair_cursor_build_repair_symbol (
+                                swif_repair_cursor_t*   cursor,
+                                void**                  repair_buf,
+                                uint16_t*               key,
+                                esi_t*                  first,
+                                uint32_t*               nss,
+                                uint32_t*               size)
+{
+    swif_group_encoder_t	*group = cursor->group;
+    swif_group_repair_t		*repair = NULL;
+    esi_t			app_rw_first;	/* repair window of the application */
+    uint32_t			app_rw_nss;
+    esi_t			ew_first;
+    esi_t			ew_last;
+    uint32_t			ew_nss;
+    swif_status_t		status = SWIF_STATUS_OK;
+
+    /* the cursor covers the whole coding window whatever the range the
+     * application selected on the shared encoder, restored afterwards */
+    swif_rlc_encoder_get_repair_window(group->enc, &app_rw_first, &app_rw_nss);
+    swif_encoder_set_repair_window(group->enc, 0, 0);
+    if (swif_encoder_get_coding_window_information(group->enc, &ew_first, &ew_last, &ew_nss) != SWIF_STATUS_OK
+        || ew_nss == 0) {
+        status = SWIF_STATUS_FAILURE;
+        goto end;
+    }
+    *nss = MIN(cursor->window_size, ew_nss);
+    *first = ew_last - *nss + 1;
+    *key = cursor->next_key;
+    if ((repair = swif_group_encoder_get_repair(group, *first, *nss, *key)) == NULL) {
+        fprintf(stderr, "swif_repair_cursor_build_repair_symbol() failed!\n");
+        status = SWIF_STATUS_ERROR;
+        goto end;
+    }
+    cursor->next_key++;
+    *repair_buf = repair->buf;
+    *size = repair->size;
+
+end:
+    swif_rlc_encoder_restore_repair_window(group->enc, app_rw_first, app_rw_nss);
+    return status;
+}
+
+
+void            swif_group_encoder_get_stats (
+                                const swif_group_encoder_t*     group,
+                                uint64_t*                       built,
+                                uint64_t*                       shared)
+{
+    *built = group->nb_built;
+    *shared = group->nb_shared;
+}
@@ -0,0 +1,119 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+#ifndef SWIF_GROUP_ENCODER_H
+#define SWIF_GROUP_ENCODER_H
+#include "swif_includes.h"
+
+
+/**
+ * Group encoder, to send the same source flow to several receivers.
+ * A single coding window holds the source symbols, and each receiver
+ * gets a lightweight repair cursor with its own window size (the last
+ * window_size source symbols) and its own sequence of repair keys.
+ * A repair symbol is fully defined by its first ESI, number of source
+ * symbols and repair key: when several cursors ask for the same one
+ * after the same source symbol, it is built once and the same buffer is
+ * returned to all of them.
+ */
+typedef struct swif_group_encoder swif_group_encoder_t;
+typedef struct swif_repair_cursor swif_repair_cursor_t;
+
+
+/**
+ * Create a group encoder. Same parameters as swif_encoder_create(),
+ * max_coding_window_size being the largest window of any cursor.
+ */
+swif_group_encoder_t* swif_group_encoder_create (
+                                swif_codepoint_t codepoint,
+                                uint32_t        verbosity,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size);
+
+/**
+ * Release a group encoder, its cursors and its repair symbols.
+ */
+swif_status_t   swif_group_encoder_release (swif_group_encoder_t*  group);
+
+/**
+ * Return the underlying encoder, e.g. to set its callback functions or
+ * parameters. Source symbols must be added with
+ * swif_group_encoder_add_source_symbol() instead.
+ */
+swif_encoder_t* swif_group_encoder_get_encoder (swif_group_encoder_t*  group);
+
+/**
+ * Add a source symbol to the shared coding window. The repair symbols
+ * returned so far are no longer valid after this call, their buffers
+ * being reused.
+ */
+swif_status_t   swif_group_encoder_add_source_symbol (
+                                swif_group_encoder_t*   group,
+                                void*                   new_src_symbol_buf,
+                                esi_t                   new_src_symbol_esi);
+
+/**
+ * Create a repair cursor for a new receiver.
+ *
+ * @param window_size   (IN) number of most recent source symbols covered
+ *                      by its repair symbols, <= max_coding_window_size.
+ * @param first_key     (IN) repair key of its first repair symbol, the
+ *                      following ones being incremented.
+ * @return              the cursor, or NULL in case of error.
+ */
+swif_repair_cursor_t* swif_group_encoder_add_cursor (
+                                swif_group_encoder_t*   group,
+                                uint32_t                window_size,
+                                uint16_t                first_key);
+
+/**
+ * Release a cursor.
+ */
+swif_status_t   swif_group_encoder_remove_cursor (
+                                swif_group_encoder_t*   group,
+                                swif_repair_cursor_t*   cursor);
+
+/**
+ * Change the window size of a cursor, e.g. to follow the loss pattern
+ * of its receiver.
+ */
+swif_status_t   swif_repair_cursor_set_window_size (
+                                swif_repair_cursor_t*   cursor,
+                                uint32_t                window_size);
+
+/**
+ * Get the next repair symbol of a cursor. The repair window selected on
+ * the shared encoder with swif_encoder_set_repair_window(), if any, is
+ * ignored and kept for the application.
+ *
+ * @param repair_buf    (OUT) the repair symbol (symbol_size bytes). It
+ *                      belongs to the group encoder, may be shared with
+ *                      other cursors, and is valid until the next source
+ *                      symbol is added. It must not be modified.
+ * @param key           (OUT) its repair key.
+ * @param first         (OUT) ESI of its first source symbol.
+ * @param nss           (OUT) number of source symbols it covers.
+ * @param size          (OUT) number of meaningful bytes to send, lower
+ *                      than symbol_size with variable-length symbols.
+ * @return              SWIF_STATUS_FAILURE if the coding window is empty.
+ */
+swif_status_t   swif_repair_cursor_build_repair_symbol (
+                                swif_repair_cursor_t*   cursor,
+                                void**                  repair_buf,
+                                uint16_t*               key,
+                                esi_t*                  first,
+                                uint32_t*               nss,
+                                uint32_t*               size);
+
+/**
+ * Retrieve the number of repair symbols built, and of repair symbols
+ * returned to a cursor without being built again.
+ */
+void            swif_group_encoder_get_stats (
+                                const swif_group_encoder_t*     group,
+                                uint64_t*                       built,
+                                uint64_t*                       shared);
+
+#endif /* SWIF_GROUP_ENCODER_H */
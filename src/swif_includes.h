@@ -15,6 +15,9 @@
 
 #include "swif_general.h"
 #include "swif_api.h"
+#include "swif_allocator.h"
+#include "swif_stripe_pool.h"
+#include "swif_coding_coefficients.h"
 #include "swif_rlc_cb.h"
 #include "swif_linear-code.h"
 #include "swif_prng.h"
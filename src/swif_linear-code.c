@@ -33,58 +33,45 @@
  */
 
 #include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <assert.h>
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
 #include "swif_general.h"
 #include "swif_linear-code.h"
+#include "swif_symbol.h"
 
-/*--------------------------------------------------*/
+#ifndef ASSERT
+#define ASSERT(...) assert(__VA_ARGS__)
+#endif
 
-//#ifdef WITH_GF16
-//#include "table-mul-gf16.c"
-//#endif /* WITH_GF16 */
-//
-//#include "table-mul-gf4.c"
+#ifndef FATAL
+#define FATAL(msg) BEGIN_MACRO \
+  fprintf(stderr, "%s:%d: FATAL: %s\n", __FILE__, __LINE__, (msg)); \
+  abort(); \
+  END_MACRO
+#endif
 
 /*--------------------------------------------------*/
 
-/* With SWiF Codec, always use GF(256) and GF256_MUL_TABLE */
-#define WITH_GF256
-#define WITH_GF256_MUL_TABLE
-
-
-#ifdef WITH_GF256
-
-#ifdef WITH_GF256_MUL_TABLE
+#define WITH_GF16
+#include "swif_table-mul-gf16.c"
 
-#include "swif_table-mul-gf256.c"
-static inline uint8_t gf256_mul(uint8_t a, uint8_t b)
-{ return gf256_mul_table[a][b]; }
+#include "swif_table-mul-gf4.c"
 
-static inline uint8_t gf256_inv(uint8_t a)
-{ return gf256_inv_table[a]; }
-
-#else /* WITH_GF256_MUL_TABLE */
-
-//#include "table-explog-gf256.c"
-///* compute a.b as exp[log[a]+log[b]] */
-//static inline uint8_t gf256_mul(uint8_t a, uint8_t b)
-//{
-//  if ( a == 0 || b == 0)
-//    return 0;
-//
-//  uint16_t log_res = ((uint16_t)gf256_log_table[a])
-//    + ((uint16_t)gf256_log_table[b]);
-//  log_res = (log_res + (log_res >> 8)) & 0xff; /* mod 255 */
-//  return gf256_exp_table[log_res];
-//}
-//
-//static inline uint8_t gf256_inv(uint8_t a)
-//{ return gf256_exp_table[255-gf256_log_table[a]]; }
-
-#endif /* WITH_GF256_MUL_TABLE */
+/*--------------------------------------------------*/
 
-#endif /* WITH_GF256 */
+/* With SWiF Codec, always use GF(256): gf256_mul() and gf256_inv() are
+   the table based functions of swif_symbol.c */
+#define WITH_GF256
 
 /*---------------------------------------------------------------------------*/
 
@@ -119,66 +106,126 @@ void lc_vector_add(uint8_t* data1, uint16_t size1,
 
 #ifdef WITH_GF256
 /* this function also operates correctly if data is exactly equal to result */
-void lc_vector_mul_gf256(uint8_t coef, uint8_t* data, uint16_t size,
-			 uint8_t* result)
+static void lc_vector_mul_gf256(uint8_t coef, uint8_t* data, uint32_t size,
+				uint8_t* result)
 { 
   if (coef == 0) {
     memset(result, 0, size);
     return;
   }
-
-  uint16_t i;
-  for (i=0; i<size; i++)
-    result[i] = gf256_mul(coef, data[i]);
+  symbol_mul(data, coef, size, result);
 }
 #endif /* WITH_GF256 */
 
-//#ifdef WITH_GF16
-///* this function also operates correctly if data is exactly equal to result */
-//void lc_vector_mul_gf16(uint8_t coef, uint8_t* data, uint16_t size,
-//			uint8_t* result)
-//{
-//  ASSERT( coef < 16 );
-//  uint16_t i;
-//  for (i=0; i<size; i++)
-//    result[i] = gf16_mul_table[coef][data[i]];
-//}
-//#endif /* WITH_GF16 */
+#ifdef WITH_GF16
+/*
+  Each byte holds two elements of GF(16). A single 16-entry table `tab',
+  tab[x] = coef.x, is enough for both nibbles: the low nibble is looked up
+  directly and the product of the high nibble, which is at most 15, is
+  shifted back in place. With SSSE3/AVX2 the lookup is one PSHUFB per
+  nibble for 16/32 bytes at a time.
+  When `add' is set, the product is added (xored) to result instead of
+  replacing it. When `aligned' is set, see lc_vector_add_mul_aligned().
+ */
+static inline void lc_vector_mul_gf16_base(uint8_t coef, uint8_t* data,
+					   uint32_t size, uint8_t* result,
+					   int add, int aligned)
+{
+  ASSERT( coef < 16 );
+  const uint8_t* tab = gf16_mul_table[coef];
+  uint32_t i = 0;
+
+#if defined(__AVX2__)
+  const __m256i tab256 = _mm256_broadcastsi128_si256
+    (_mm_loadu_si128((const __m128i*)tab));
+  const __m256i mask256 = _mm256_set1_epi8(0x0f);
+  for (; i+32 <= size; i += 32) {
+    __m256i x = aligned ? _mm256_load_si256((const __m256i*)(data+i))
+                        : _mm256_loadu_si256((const __m256i*)(data+i));
+    __m256i lo = _mm256_shuffle_epi8(tab256, _mm256_and_si256(x, mask256));
+    __m256i hi = _mm256_shuffle_epi8
+      (tab256, _mm256_and_si256(_mm256_srli_epi16(x, 4), mask256));
+    __m256i y = _mm256_or_si256(lo, _mm256_slli_epi16(hi, 4));
+    if (add)
+      y = _mm256_xor_si256(y, aligned ? _mm256_load_si256((const __m256i*)(result+i))
+                                      : _mm256_loadu_si256((const __m256i*)(result+i)));
+    if (aligned)
+      _mm256_store_si256((__m256i*)(result+i), y);
+    else
+      _mm256_storeu_si256((__m256i*)(result+i), y);
+  }
+  if (aligned)
+    return;
+#endif /* __AVX2__ */
+
+#if defined(__SSSE3__)
+  const __m128i tab128 = _mm_loadu_si128((const __m128i*)tab);
+  const __m128i mask128 = _mm_set1_epi8(0x0f);
+  for (; i+16 <= size; i += 16) {
+    __m128i x = aligned ? _mm_load_si128((const __m128i*)(data+i))
+                        : _mm_loadu_si128((const __m128i*)(data+i));
+    __m128i lo = _mm_shuffle_epi8(tab128, _mm_and_si128(x, mask128));
+    __m128i hi = _mm_shuffle_epi8
+      (tab128, _mm_and_si128(_mm_srli_epi16(x, 4), mask128));
+    __m128i y = _mm_or_si128(lo, _mm_slli_epi16(hi, 4));
+    if (add)
+      y = _mm_xor_si128(y, aligned ? _mm_load_si128((const __m128i*)(result+i))
+                                   : _mm_loadu_si128((const __m128i*)(result+i)));
+    if (aligned)
+      _mm_store_si128((__m128i*)(result+i), y);
+    else
+      _mm_storeu_si128((__m128i*)(result+i), y);
+  }
+  if (aligned)
+    return;
+#endif /* __SSSE3__ */
+
+  for (; i<size; i++) {
+    uint8_t y = tab[data[i] & 0x0f] | (uint8_t)(tab[data[i] >> 4] << 4);
+    result[i] = add ? (result[i] ^ y) : y;
+  }
+}
+
+/* this function also operates correctly if data is exactly equal to result */
+static void lc_vector_mul_gf16(uint8_t coef, uint8_t* data, uint32_t size,
+			       uint8_t* result)
+{ lc_vector_mul_gf16_base(coef, data, size, result, 0, 0); }
+#endif /* WITH_GF16 */
+
+/* this function also operates correctly if data is exactly equal to result */
+static void lc_vector_mul_gf4(uint8_t coef, uint8_t* data, uint32_t size,
+			      uint8_t* result)
+{
+  ASSERT( coef < 4 );
+  uint32_t i;
+  for (i=0; i<size; i++)
+    result[i] = gf4_mul_table[coef][data[i]];
+}
 
 /* this function also operates correctly if data is exactly equal to result */
-//void lc_vector_mul_gf4(uint8_t coef, uint8_t* data, uint16_t size,
-//		       uint8_t* result)
-//{
-//  ASSERT( coef < 4 );
-//  uint16_t i;
-//  for (i=0; i<size; i++)
-//    result[i] = gf4_mul_table[coef][data[i]];
-//}
-
-///* this function also operates correctly if data is exactly equal to result */
-//void lc_vector_mul_gf2(uint8_t coef, uint8_t* data, uint16_t size,
-//		       uint8_t* result)
-//{
-//  ASSERT( coef < 2 );
-//  if (coef == 0) {
-//    memset(result, 0, size);
-//  } else {
-//    if (data != result)
-//      memcpy(result, data, size);
-//  }
-//}
+static void lc_vector_mul_gf2(uint8_t coef, uint8_t* data, uint32_t size,
+			      uint8_t* result)
+{
+  ASSERT( coef < 2 );
+  if (coef == 0) {
+    memset(result, 0, size);
+  } else {
+    if (data != result)
+      memcpy(result, data, size);
+  }
+}
 
 /* this function also operates correctly if data is exactly equal to result */
-void lc_vector_mul(uint8_t coef, uint8_t* data, uint16_t size,
+void lc_vector_mul(uint8_t coef, uint8_t* data, uint32_t size,
 		   uint8_t log2_nb_bit_coef, uint8_t* result)
 {
   ASSERT( log2_nb_bit_coef <= MAX_LOG2_NB_BIT_COEF );
   switch(log2_nb_bit_coef) {
   case 0: lc_vector_mul_gf2(coef, data, size, result); break;
   case 1: lc_vector_mul_gf4(coef, data, size, result); break;
-//#ifdef WITH_GF16
-//  case 2: lc_vector_mul_gf16(coef, data, size, result); break;
-//#endif /* WITH_GF16 */
+#ifdef WITH_GF16
+  case 2: lc_vector_mul_gf16(coef, data, size, result); break;
+#endif /* WITH_GF16 */
 #ifdef WITH_GF256
   case 3: lc_vector_mul_gf256(coef, data, size, result); break;
 #endif /* WITH_GF256 */
@@ -186,6 +233,139 @@ void lc_vector_mul(uint8_t coef, uint8_t* data, uint16_t size,
   }
 }
 
+/* result and data must be either equal or disjoint */
+void lc_vector_add_mul(uint8_t coef, uint8_t* data, uint32_t size,
+		       uint8_t log2_nb_bit_coef, uint8_t* result)
+{
+  ASSERT( log2_nb_bit_coef <= MAX_LOG2_NB_BIT_COEF );
+  if (coef == 0)
+    return;
+  if (coef == 1) {
+    symbol_xor(result, data, size);
+    return;
+  }
+  switch(log2_nb_bit_coef) {
+  case 1: {
+    uint32_t i;
+    for (i=0; i<size; i++)
+      result[i] ^= gf4_mul_table[coef][data[i]];
+    break;
+  }
+#ifdef WITH_GF16
+  case 2: lc_vector_mul_gf16_base(coef, data, size, result, 1, 0); break;
+#endif /* WITH_GF16 */
+#ifdef WITH_GF256
+  case 3: symbol_add_scaled(result, coef, data, size); break;
+#endif /* WITH_GF256 */
+  default: FATAL("invalid log2_nb_bit_coef");
+  }
+}
+
+void lc_vector_mul_aligned(uint8_t coef, uint8_t* data, uint32_t size,
+			   uint8_t log2_nb_bit_coef, uint8_t* result)
+{
+  ASSERT( log2_nb_bit_coef <= MAX_LOG2_NB_BIT_COEF );
+  ASSERT( ((uintptr_t)data | (uintptr_t)result | size) % SYMBOL_ALIGNMENT == 0 );
+  switch(log2_nb_bit_coef) {
+#ifdef WITH_GF16
+  case 2:
+    if (coef == 0)
+      memset(result, 0, size);
+    else
+      lc_vector_mul_gf16_base(coef, data, size, result, 0, 1);
+    break;
+#endif /* WITH_GF16 */
+#ifdef WITH_GF256
+  case 3: symbol_mul_aligned(data, coef, size, result); break;
+#endif /* WITH_GF256 */
+  default: lc_vector_mul(coef, data, size, log2_nb_bit_coef, result);
+  }
+}
+
+void lc_vector_add_mul_aligned(uint8_t coef, uint8_t* data, uint32_t size,
+			       uint8_t log2_nb_bit_coef, uint8_t* result)
+{
+  ASSERT( log2_nb_bit_coef <= MAX_LOG2_NB_BIT_COEF );
+  ASSERT( ((uintptr_t)data | (uintptr_t)result | size) % SYMBOL_ALIGNMENT == 0 );
+  if (coef == 0)
+    return;
+  if (coef == 1) {
+    symbol_xor_aligned(result, data, size);
+    return;
+  }
+  switch(log2_nb_bit_coef) {
+#ifdef WITH_GF16
+  case 2: lc_vector_mul_gf16_base(coef, data, size, result, 1, 1); break;
+#endif /* WITH_GF16 */
+#ifdef WITH_GF256
+  case 3: symbol_add_scaled_aligned(result, coef, data, size); break;
+#endif /* WITH_GF256 */
+  default: lc_vector_add_mul(coef, data, size, log2_nb_bit_coef, result);
+  }
+}
+
+/*---------------------------------------------------------------------------*/
+
+#ifdef WITH_GF16
+/* fixed-size GF(16) kernels, as the GF(256) ones of swif_symbol.c */
+#define LC_DEFINE_GF16_KERNELS(size, aligned, name)                         \
+static void lc_add_mul_gf16_##name(uint8_t coef, uint8_t* data,             \
+                                   uint8_t* result)                         \
+{                                                                           \
+  if (coef != 0)                                                            \
+    lc_vector_mul_gf16_base(coef, data, size, result, 1, aligned);          \
+}                                                                           \
+static void lc_mul_gf16_##name(uint8_t coef, uint8_t* data, uint8_t* result) \
+{                                                                           \
+  if (coef == 0)                                                            \
+    memset(result, 0, size);                                                \
+  else                                                                      \
+    lc_vector_mul_gf16_base(coef, data, size, result, 0, aligned);          \
+}
+
+#define LC_GF16_KERNELS(size)		LC_DEFINE_GF16_KERNELS(size, 0, size)
+#define LC_GF16_ALIGNED_KERNELS(size)	LC_DEFINE_GF16_KERNELS(size, 1, aligned_##size)
+SYMBOL_KERNEL_SIZES(LC_GF16_KERNELS)
+SYMBOL_ALIGNED_KERNEL_SIZES(LC_GF16_ALIGNED_KERNELS)
+
+#define LC_GF16_KERNELS_ENTRY(size) \
+  { size, lc_add_mul_gf16_##size, lc_mul_gf16_##size },
+#define LC_GF16_ALIGNED_KERNELS_ENTRY(size) \
+  { size, lc_add_mul_gf16_aligned_##size, lc_mul_gf16_aligned_##size },
+
+static const symbol_kernels_t lc_gf16_kernels_tab[] = {
+  SYMBOL_KERNEL_SIZES(LC_GF16_KERNELS_ENTRY)
+};
+
+static const symbol_kernels_t lc_gf16_aligned_kernels_tab[] = {
+  SYMBOL_ALIGNED_KERNEL_SIZES(LC_GF16_ALIGNED_KERNELS_ENTRY)
+};
+#endif /* WITH_GF16 */
+
+const symbol_kernels_t* lc_get_kernels(uint32_t size, uint8_t log2_nb_bit_coef,
+				       int aligned)
+{
+  ASSERT( log2_nb_bit_coef <= MAX_LOG2_NB_BIT_COEF );
+  switch(log2_nb_bit_coef) {
+#ifdef WITH_GF256
+  case 0: /* the GF(256) kernels do GF(2) as well */
+  case 3: return symbol_get_kernels(size, aligned);
+#endif /* WITH_GF256 */
+#ifdef WITH_GF16
+  case 2: {
+    const symbol_kernels_t* tab = aligned ? lc_gf16_aligned_kernels_tab
+                                          : lc_gf16_kernels_tab;
+    for (uint32_t i = 0; i < sizeof(lc_gf16_kernels_tab)/sizeof(symbol_kernels_t); i++) {
+      if (tab[i].symbol_size == size)
+	return &tab[i];
+    }
+    return NULL;
+  }
+#endif /* WITH_GF16 */
+  default: return NULL;
+  }
+}
+
 /*---------------------------------------------------------------------------*/
 
 typedef uint_fast16_t uf16;
@@ -246,9 +426,9 @@ uint8_t lc_mul(uint8_t x, uint8_t y, uint8_t log2_nb_bit_coef)
   switch(log2_nb_bit_coef) {
   case 0: ASSERT(x < 2 && y < 2); return x&y;
   case 1: ASSERT(x < 4 && y < 4); return gf4_mul_table[x][y];
-//#ifdef WITH_GF16
-//  case 2: ASSERT(x < 16 && y <16); return gf16_mul_table[x][y];
-//#endif /* WITH_GF16 */
+#ifdef WITH_GF16
+  case 2: ASSERT(x < 16 && y <16); return gf16_mul_table[x][y];
+#endif /* WITH_GF16 */
 #ifdef WITH_GF256
   case 3: return gf256_mul(x,y);
 #endif /* WITH_GF256 */
@@ -265,9 +445,9 @@ uint8_t lc_inv(uint8_t x, uint8_t log2_nb_bit_coef)
   switch(log2_nb_bit_coef) {
   case 0: ASSERT(x < 2); return x;
   case 1: ASSERT(x < 4); return gf4_inv_table[x];
-//#ifdef WITH_GF16
-//  case 2: ASSERT(x < 16); return gf16_inv_table[x];
-//#endif /* WITH_GF16 */
+#ifdef WITH_GF16
+  case 2: ASSERT(x < 16); return gf16_inv_table[x];
+#endif /* WITH_GF16 */
 #ifdef WITH_GF256
   case 3: return gf256_inv(x);
 #endif /* WITH_GF256 */
@@ -280,35 +460,5 @@ uint8_t lc_inv(uint8_t x, uint8_t log2_nb_bit_coef)
 
 /*---------------------------------------------------------------------------*/
 
-
-void coded_packet_copy_from(coded_packet_t* dst, coded_packet_t* src)
-{
-    memcpy(dst, src, sizeof(*src));
-}
-
-
-/* p1 pointer MUST be different from p2 pointer */
-static void coded_packet_destructive_linear_combination
-(uint8_t coef1, coded_packet_t* p1_and_result,
- uint8_t coef2, coded_packet_t* p2)
-{
-  ASSERT(p1_and_result != p2);
-  //if (coef1 != 1) // [XXX] uncomment for opt.
-  coded_packet_to_mul(p1_and_result, coef1);
-  //if (coef2 != 1) // [XXX] uncomment for opt.
-  coded_packet_to_mul(p2, coef2);
-  coded_packet_to_add(p1_and_result, p1_and_result, p2);
-}
-
-
-/* p1 += coef2 x p2 ; p1 pointer may be equal to p2 pointer */
-void swif_symbol_add_mult (char* p1, uint8_t coef2, char* p2)
-{
-  coded_packet_t p2_copy;
-  coded_packet_copy_from(&p2_copy, p2);
-  coded_packet_destructive_linear_combination(1, p1, coef2, &p2_copy);
-}
-
-
 /*---------------------------------------------------------------------------*/
 /** @} */
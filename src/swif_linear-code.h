@@ -169,9 +169,49 @@ void lc_vector_add(uint8_t* data1, uint16_t size1,
  *          area disjoint from `data`,
  *          e.g. `lc_vector_mul(c,p,l-1,L,p+1)` gives improper result.
  */
-void lc_vector_mul(uint8_t coef, uint8_t* data, uint16_t size,
+void lc_vector_mul(uint8_t coef, uint8_t* data, uint32_t size,
 		   uint8_t log2_nb_bit_coef, uint8_t* result);
 
+/**
+ * @brief Add to one vector (sequences, arrays) of elements another vector
+ *        multiplied by one given element of the finite field.
+ * @param[in]  coef       Coefficient of the finite field
+ * @param[in]  data       Vector of elements
+ * @param[in]  size       Number of bytes (not elements) in both vectors
+ * @param[in]  log2_nb_bit_coef Defines the finite field, e.g.
+ *                        GF(\f$2^{(2^L)}\f$) where `L = log2_nb_bit_coef`
+ * @param[in,out] result  Vector to which the product is added,
+ *                        e.g. `result[i] += coef x data[i]`
+ * @details In GF(16), each byte holds two elements and the product needs
+ *          a single 16-entry table (one PSHUFB per nibble when SSSE3 or
+ *          AVX2 is available).
+ *          `data` and `result` must be either equal or disjoint.
+ */
+void lc_vector_add_mul(uint8_t coef, uint8_t* data, uint32_t size,
+		       uint8_t log2_nb_bit_coef, uint8_t* result);
+
+/**
+ * @brief Same as lc_vector_mul() and lc_vector_add_mul(), with `data` and
+ *        `result` aligned on SYMBOL_ALIGNMENT bytes and `size` a multiple
+ *        of SYMBOL_ALIGNMENT (see swif_symbol.h): GF(16) and GF(256) then
+ *        use aligned vector loads and stores, without any tail loop.
+ */
+void lc_vector_mul_aligned(uint8_t coef, uint8_t* data, uint32_t size,
+                           uint8_t log2_nb_bit_coef, uint8_t* result);
+
+void lc_vector_add_mul_aligned(uint8_t coef, uint8_t* data, uint32_t size,
+                               uint8_t log2_nb_bit_coef, uint8_t* result);
+
+/**
+ * @brief Return kernels specialised for vectors of exactly `size' bytes
+ *        (see symbol_get_kernels() in swif_symbol.h), NULL if there are
+ *        none for this size and field. With `aligned' set, the kernels
+ *        have the same constraints as lc_vector_add_mul_aligned().
+ */
+const struct symbol_kernels* lc_get_kernels(uint32_t size,
+                                            uint8_t log2_nb_bit_coef,
+                                            int aligned);
+
 /**
  * @brief Set the n-th element of one vector (sequences, arrays)
  *         to one given element of one finite field.
@@ -0,0 +1,404 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+/**
+ * Pipelined encoder, see swif_pipelined_encoder.h.
+ */
+
+#define _GNU_SOURCE	/* nanosleep() */
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include "swif_includes.h"
+#include "swif_pipelined_encoder.h"
+
+
+/* number of coefficient vectors of the cache of the helper */
+#define SWIF_PIPELINED_CC_CACHE_SIZE	16
+
+/* source symbol slot. len is the number of meaningful bytes of buf.
+ * refs counts the snapshots, queued or being processed, whose coding
+ * window starts at this slot */
+typedef struct swif_pipelined_slot {
+	void*			buf;
+	esi_t			esi;
+	uint32_t		len;
+	uint32_t		refs;
+} swif_pipelined_slot_t;
+
+/* coding window of a repair symbol to build, into buf */
+typedef struct swif_pipelined_snapshot {
+	uint32_t		first_pos;
+	esi_t			first_esi;
+	uint32_t		nss;
+	uint32_t		key;
+	void*			buf;
+} swif_pipelined_snapshot_t;
+
+struct swif_pipelined_encoder {
+	/* snapshot ring: snap_tail written by the producer, snap_head by
+	 * the helper */
+	uint32_t		snap_tail SWIF_ALIGNED;
+	uint32_t		snap_head SWIF_ALIGNED;
+	swif_pipelined_snapshot_t* snap_tab;
+	uint32_t		snap_mask;
+
+	/* event ring: out_tail written by the helper, out_head by the
+	 * producer */
+	uint32_t		out_tail SWIF_ALIGNED;
+	uint32_t		out_head SWIF_ALIGNED;
+	swif_engine_event_t*	out_tab;
+	uint32_t		out_mask;
+
+	/* slot ring, a slot position being slot_tab index modulo its size.
+	 * [reclaim_pos; next_pos) are in use, the last nss ones being the
+	 * coding window. Producer only, but for the refs */
+	swif_pipelined_slot_t*	slot_tab SWIF_ALIGNED;
+	uint32_t		slot_mask;
+	uint32_t		reclaim_pos;
+	uint32_t		next_pos;
+	uint32_t		nss;
+	esi_t			next_esi;
+	bool			empty;
+	swif_errno_t		swif_errno;
+
+	uint32_t		verbosity;
+	uint32_t		symbol_size;
+	uint32_t		max_coding_window_size;
+	uint8_t			m;
+	uint8_t			dt;
+	/* set before the first source symbol */
+	bool			variable_length;
+	swif_cc_cache_t*	cc_cache;
+	bool			own_cc_cache;
+
+	/* helper only */
+	uint8_t*		cc_tab SWIF_ALIGNED;
+	pthread_t		thread;
+	bool			started;
+	uint32_t		stop;
+	uint32_t		exited;
+};
+
+
+static uint32_t swif_pipelined_pow2 (uint32_t n)
+{
+    uint32_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+
+/*******************************************************************************
+ * Helper thread
+ */
+
+/* waits while the ring is full */
+static void swif_pipelined_encoder_post (swif_pipelined_encoder_t*   penc,
+                                         const swif_engine_event_t*  ev)
+{
+    uint32_t tail = penc->out_tail;
+
+    while (tail - __atomic_load_n(&penc->out_head, __ATOMIC_ACQUIRE) > penc->out_mask) {
+        sched_yield();
+    }
+    penc->out_tab[tail & penc->out_mask] = *ev;
+    __atomic_store_n(&penc->out_tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+static void swif_pipelined_encoder_build (swif_pipelined_encoder_t*         penc,
+                                          const swif_pipelined_snapshot_t*  snap)
+{
+    swif_engine_event_t	ev = { 0, SWIF_ENGINE_EV_REPAIR, snap->buf, snap->first_esi, snap->nss, snap->key, 0 };
+    uint8_t		l = swif_rlc_log2_nb_bit_coef(penc->m);
+
+    /* same coefficients and additions as swif_rlc_build_repair_symbol() */
+    swif_cc_cache_get_coding_coefficients(penc->cc_cache, (uint16_t)snap->key, penc->cc_tab,
+                                          snap->nss, penc->dt, penc->m);
+    memset(ev.buf, 0, penc->symbol_size);
+    for (uint32_t i = 0; i < snap->nss; i++) {
+        swif_pipelined_slot_t *slot = &penc->slot_tab[(snap->first_pos + i) & penc->slot_mask];
+        lc_vector_add_mul(penc->cc_tab[i], slot->buf, slot->len, l, ev.buf);
+        ev.size = MAX(ev.size, slot->len);
+    }
+    swif_pipelined_encoder_post(penc, &ev);
+    /* the slots may now be reused by the producer */
+    __atomic_sub_fetch(&penc->slot_tab[snap->first_pos & penc->slot_mask].refs, 1, __ATOMIC_RELEASE);
+}
+
+static void* swif_pipelined_encoder_helper_main (void* arg)
+{
+    swif_pipelined_encoder_t	*penc = arg;
+    uint32_t			idle = 0;
+
+    for (;;) {
+        uint32_t head = penc->snap_head;
+        if (head == __atomic_load_n(&penc->snap_tail, __ATOMIC_ACQUIRE)) {
+            /* the ring is only empty for good once stop is seen */
+            if (__atomic_load_n(&penc->stop, __ATOMIC_ACQUIRE)
+                && head == __atomic_load_n(&penc->snap_tail, __ATOMIC_ACQUIRE)) {
+                break;
+            }
+            if (++idle < 64) {
+                sched_yield();
+            } else {
+                struct timespec ts = { 0, 50000 };
+                nanosleep(&ts, NULL);
+            }
+            continue;
+        }
+        idle = 0;
+        swif_pipelined_encoder_build(penc, &penc->snap_tab[head & penc->snap_mask]);
+        __atomic_store_n(&penc->snap_head, head + 1, __ATOMIC_RELEASE);
+    }
+    __atomic_store_n(&penc->exited, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+
+/*******************************************************************************
+ * Producer thread
+ */
+
+swif_pipelined_encoder_t* swif_pipelined_encoder_create (
+                                swif_codepoint_t codepoint,
+                                uint32_t        verbosity,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size,
+                                uint32_t        queue_size)
+{
+    swif_pipelined_encoder_t	*penc;
+    void			*p;
+    uint8_t			m, dt;
+
+    if (!swif_rlc_codepoint_params(codepoint, &m, &dt)) {
+        fprintf(stderr, "swif_pipelined_encoder_create() failed! codepoint %d not supported\n", codepoint);
+        return NULL;
+    }
+    if (max_coding_window_size == 0 || max_coding_window_size > UINT16_MAX
+        || queue_size == 0 || queue_size > (1u << 16)) {
+        fprintf(stderr, "swif_pipelined_encoder_create() failed! bad parameters\n");
+        return NULL;
+    }
+    if (posix_memalign(&p, SWIF_CACHE_LINE, sizeof(swif_pipelined_encoder_t)) != 0) {
+        fprintf(stderr, "swif_pipelined_encoder_create() failed! No memory\n");
+        return NULL;
+    }
+    penc = memset(p, 0, sizeof(swif_pipelined_encoder_t));
+    penc->verbosity = verbosity;
+    penc->symbol_size = symbol_size;
+    penc->max_coding_window_size = max_coding_window_size;
+    penc->m = m;
+    penc->dt = dt;
+    penc->empty = true;
+    queue_size = swif_pipelined_pow2(queue_size);
+    penc->snap_mask = penc->out_mask = queue_size - 1;
+    penc->slot_mask = swif_pipelined_pow2(max_coding_window_size + queue_size) - 1;
+    penc->snap_tab = calloc(queue_size, sizeof(swif_pipelined_snapshot_t));
+    penc->out_tab = calloc(queue_size, sizeof(swif_engine_event_t));
+    penc->slot_tab = calloc(penc->slot_mask + 1, sizeof(swif_pipelined_slot_t));
+    penc->cc_tab = calloc(max_coding_window_size, sizeof(uint8_t));
+    penc->cc_cache = swif_cc_cache_create(SWIF_PIPELINED_CC_CACHE_SIZE, (uint16_t)max_coding_window_size);
+    penc->own_cc_cache = true;
+    if (penc->snap_tab == NULL || penc->out_tab == NULL || penc->slot_tab == NULL || penc->cc_tab == NULL
+        || penc->cc_cache == NULL) {
+        fprintf(stderr, "swif_pipelined_encoder_create() failed! No memory\n");
+        swif_pipelined_encoder_release(penc);
+        return NULL;
+    }
+    if (pthread_create(&penc->thread, NULL, swif_pipelined_encoder_helper_main, penc) != 0) {
+        fprintf(stderr, "swif_pipelined_encoder_create() failed! cannot create the helper\n");
+        swif_pipelined_encoder_release(penc);
+        return NULL;
+    }
+    penc->started = true;
+    return penc;
+}
+
+
+swif_status_t   swif_pipelined_encoder_release (swif_pipelined_encoder_t* penc)
+{
+    assert(penc);
+    __atomic_store_n(&penc->stop, 1, __ATOMIC_RELEASE);
+    /* the helper may wait for room in the event ring */
+    for (;;) {
+        bool exited = !penc->started || __atomic_load_n(&penc->exited, __ATOMIC_ACQUIRE);
+        uint32_t head = penc->out_head;
+        uint32_t tail = __atomic_load_n(&penc->out_tail, __ATOMIC_ACQUIRE);
+        for (; head != tail; head++) {
+            free(penc->out_tab[head & penc->out_mask].buf);
+        }
+        __atomic_store_n(&penc->out_head, head, __ATOMIC_RELEASE);
+        if (exited) {
+            break;
+        }
+        sched_yield();
+    }
+    if (penc->started) {
+        pthread_join(penc->thread, NULL);
+    }
+    free(penc->snap_tab);
+    free(penc->out_tab);
+    free(penc->slot_tab);
+    free(penc->cc_tab);
+    if (penc->own_cc_cache) {
+        swif_cc_cache_release(penc->cc_cache);
+    }
+    free(penc);
+    return SWIF_STATUS_OK;
+}
+
+
+swif_status_t   swif_pipelined_encoder_set_parameters (
+                                swif_pipelined_encoder_t* penc,
+                                uint32_t        type,
+                                uint32_t        length,
+                                void*           value)
+{
+    if (!penc->empty) {
+        fprintf(stderr, "swif_pipelined_encoder_set_parameters() failed! must be set before adding source symbols\n");
+        penc->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+        return SWIF_STATUS_ERROR;
+    }
+    switch (type) {
+    case swif_ENCODER_SET_PARAM_VARIABLE_LENGTH_SYMBOLS:
+        if (length != sizeof(uint32_t)) {
+            break;
+        }
+        penc->variable_length = (*(uint32_t*)value != 0);
+        return SWIF_STATUS_OK;
+
+    case swif_ENCODER_SET_PARAM_CODING_COEFS_CACHE:
+        if (length != sizeof(swif_cc_cache_t*)) {
+            break;
+        }
+        if (penc->own_cc_cache) {
+            swif_cc_cache_release(penc->cc_cache);
+        }
+        penc->cc_cache = *(swif_cc_cache_t**)value;
+        penc->own_cc_cache = false;
+        return SWIF_STATUS_OK;
+    }
+    fprintf(stderr, "swif_pipelined_encoder_set_parameters() failed! unsupported parameter %u\n", type);
+    penc->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+    return SWIF_STATUS_ERROR;
+}
+
+
+swif_errno_t    swif_pipelined_encoder_get_errno (swif_pipelined_encoder_t* penc)
+{
+    return penc->swif_errno;
+}
+
+
+swif_status_t   swif_pipelined_encoder_add_source_symbol (
+                                swif_pipelined_encoder_t* penc,
+                                void*           buf,
+                                esi_t           esi)
+{
+    swif_pipelined_slot_t *slot;
+    uint32_t		len = penc->symbol_size;
+
+    if (!penc->empty && esi != penc->next_esi) {
+        fprintf(stderr, "swif_pipelined_encoder_add_source_symbol() failed! esi (%u) is not the expected value (%u)\n",
+                esi, penc->next_esi);
+        penc->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+        return SWIF_STATUS_ERROR;
+    }
+    if (penc->variable_length
+        && (len = swif_get_symbol_length(buf)) > penc->symbol_size) {
+        fprintf(stderr, "swif_pipelined_encoder_add_source_symbol() failed! length (%u) of esi %u larger than symbol_size\n",
+                len, esi);
+        penc->swif_errno = SWIF_ERRNO_INVALID_SYMBOL_LENGTH;
+        return SWIF_STATUS_ERROR;
+    }
+    if (penc->next_pos - penc->reclaim_pos > penc->slot_mask) {
+        /* wait for poll() to reclaim the oldest slot */
+        return SWIF_STATUS_FAILURE;
+    }
+    slot = &penc->slot_tab[penc->next_pos & penc->slot_mask];
+    slot->buf = buf;
+    slot->esi = esi;
+    slot->len = len;
+    penc->next_pos++;
+    penc->nss = MIN(penc->nss + 1, penc->max_coding_window_size);
+    penc->next_esi = esi + 1;
+    penc->empty = false;
+    if (penc->verbosity > 1) {
+        printf("pipelined encoder: source symbol %u, %u in the coding window\n", esi, penc->nss);
+    }
+    return SWIF_STATUS_OK;
+}
+
+
+swif_status_t   swif_pipelined_encoder_build_repair_symbol (
+                                swif_pipelined_encoder_t* penc,
+                                uint32_t        key,
+                                void*           buf)
+{
+    uint32_t			tail = penc->snap_tail;
+    swif_pipelined_snapshot_t	*snap;
+
+    if (penc->nss == 0) {
+        fprintf(stderr, "swif_pipelined_encoder_build_repair_symbol() failed! empty coding window\n");
+        penc->swif_errno = SWIF_ERRNO_EMPTY_REPAIR_WINDOW;
+        return SWIF_STATUS_ERROR;
+    }
+    if (tail - __atomic_load_n(&penc->snap_head, __ATOMIC_ACQUIRE) > penc->snap_mask) {
+        return SWIF_STATUS_FAILURE;
+    }
+    /* never on the helper thread */
+    if (buf == NULL && (buf = malloc(penc->symbol_size)) == NULL) {
+        fprintf(stderr, "swif_pipelined_encoder_build_repair_symbol() failed! No memory\n");
+        return SWIF_STATUS_ERROR;
+    }
+    snap = &penc->snap_tab[tail & penc->snap_mask];
+    snap->buf = buf;
+    snap->first_pos = penc->next_pos - penc->nss;
+    snap->first_esi = penc->next_esi - penc->nss;
+    snap->nss = penc->nss;
+    snap->key = key;
+    /* pins this slot and, as slots are reclaimed in order, the
+     * following ones */
+    __atomic_add_fetch(&penc->slot_tab[snap->first_pos & penc->slot_mask].refs, 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&penc->snap_tail, tail + 1, __ATOMIC_RELEASE);
+    return SWIF_STATUS_OK;
+}
+
+
+uint32_t        swif_pipelined_encoder_poll (
+                                swif_pipelined_encoder_t* penc,
+                                swif_engine_event_t*    event_tab,
+                                uint32_t                max_events)
+{
+    uint32_t	window_pos = penc->next_pos - penc->nss;
+    uint32_t	n = 0;
+    uint32_t	head, nb;
+
+    while (n < max_events && penc->reclaim_pos != window_pos) {
+        swif_pipelined_slot_t *slot = &penc->slot_tab[penc->reclaim_pos & penc->slot_mask];
+        if (__atomic_load_n(&slot->refs, __ATOMIC_ACQUIRE) != 0) {
+            break;
+        }
+        event_tab[n].flow_id = 0;
+        event_tab[n].type = SWIF_ENGINE_EV_RELEASED;
+        event_tab[n].buf = slot->buf;
+        event_tab[n].esi = slot->esi;
+        event_tab[n].nss = event_tab[n].key = event_tab[n].size = 0;
+        n++;
+        penc->reclaim_pos++;
+    }
+    head = penc->out_head;
+    nb = __atomic_load_n(&penc->out_tail, __ATOMIC_ACQUIRE) - head;
+    nb = MIN(nb, max_events - n);
+    for (uint32_t i = 0; i < nb; i++) {
+        event_tab[n++] = penc->out_tab[(head + i) & penc->out_mask];
+    }
+    __atomic_store_n(&penc->out_head, head + nb, __ATOMIC_RELEASE);
+    return n;
+}
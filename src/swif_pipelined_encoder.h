@@ -0,0 +1,136 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+#ifndef SWIF_PIPELINED_ENCODER_H
+#define SWIF_PIPELINED_ENCODER_H
+#include "swif_includes.h"
+#include "swif_engine.h"
+
+
+/**
+ * Pipelined encoder: repair symbols are built by a helper thread while
+ * the producer thread keeps adding source symbols.
+ * Asking for a repair symbol only takes a snapshot of the coding window
+ * (its first slot and size), in constant time, and queues it to the
+ * helper. The source symbols are kept in a ring of slots larger than the
+ * coding window: a slot that left the coding window is only reclaimed
+ * once no snapshot still being processed starts at or before it (each
+ * slot counts the snapshots starting there), so the producer can move
+ * on without waiting for the helper.
+ *
+ * The encoder is used by a single producer thread, that adds source
+ * symbols, takes snapshots and polls the results, as
+ * swif_engine_event_t events (flow_id is always 0):
+ * - SWIF_ENGINE_EV_REPAIR: a repair symbol, buf (given to
+ *   swif_pipelined_encoder_build_repair_symbol(), or allocated by the
+ *   encoder, and then to be freed by the application), esi (first source
+ *   symbol), nss, key, and size (bytes to send), identical to the one
+ *   built by a swif_encoder_t with the same key;
+ * - SWIF_ENGINE_EV_RELEASED: a source symbol buffer, buf and esi, is
+ *   given back once its slot is reclaimed.
+ */
+typedef struct swif_pipelined_encoder swif_pipelined_encoder_t;
+
+
+/**
+ * Create a pipelined encoder and start its helper thread.
+ *
+ * @param codepoint, verbosity, symbol_size, max_coding_window_size
+ *                      (IN) as in swif_encoder_create().
+ * @param queue_size    (IN) number of snapshots and events in flight
+ *                      (rounded up to a power of 2). As many source
+ *                      symbols as this, beyond the coding window, can be
+ *                      added while the helper lags behind.
+ * @return              the encoder, or NULL in case of error.
+ */
+swif_pipelined_encoder_t* swif_pipelined_encoder_create (
+                                swif_codepoint_t codepoint,
+                                uint32_t        verbosity,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size,
+                                uint32_t        queue_size);
+
+/**
+ * Stop the helper once all the snapshots queued are processed, and
+ * release the encoder. The repair symbols not polled are freed. The
+ * source symbols not given back yet are not returned: the application
+ * frees them.
+ */
+swif_status_t   swif_pipelined_encoder_release (swif_pipelined_encoder_t* penc);
+
+/**
+ * Set a parameter, before the first source symbol is added, as with
+ * swif_encoder_set_parameters(). Supported:
+ * - swif_ENCODER_SET_PARAM_VARIABLE_LENGTH_SYMBOLS;
+ * - swif_ENCODER_SET_PARAM_CODING_COEFS_CACHE, in place of the small
+ *   cache of the encoder. It is used by the helper thread, so no other
+ *   thread may use it, unless only its precomputed table is (see
+ *   swif_coding_coefficients.h).
+ *
+ * @return              SWIF_STATUS_ERROR (see
+ *                      swif_pipelined_encoder_get_errno()) if the
+ *                      parameter is unknown or too late.
+ */
+swif_status_t   swif_pipelined_encoder_set_parameters (
+                                swif_pipelined_encoder_t* penc,
+                                uint32_t        type,
+                                uint32_t        length,
+                                void*           value);
+
+/**
+ * Detailed error type of the last function that returned
+ * SWIF_STATUS_ERROR.
+ */
+swif_errno_t    swif_pipelined_encoder_get_errno (swif_pipelined_encoder_t* penc);
+
+/**
+ * Add a source symbol to the coding window. The buffer is owned by the
+ * encoder until it is given back.
+ *
+ * @return              SWIF_STATUS_FAILURE if no slot is free (poll,
+ *                      then retry), SWIF_STATUS_ERROR if esi does not
+ *                      follow the previous one
+ *                      (SWIF_ERRNO_UNSUPPORTED_PARAMETER) or if the
+ *                      length prefix is too large
+ *                      (SWIF_ERRNO_INVALID_SYMBOL_LENGTH),
+ *                      SWIF_STATUS_OK otherwise.
+ */
+swif_status_t   swif_pipelined_encoder_add_source_symbol (
+                                swif_pipelined_encoder_t* penc,
+                                void*           buf,
+                                esi_t           esi);
+
+/**
+ * Ask for a repair symbol over the current coding window, with the
+ * coding coefficients of key.
+ *
+ * @param buf           (IN) symbol_size bytes for the repair symbol, that
+ *                      come back in the SWIF_ENGINE_EV_REPAIR event, or
+ *                      NULL to let the encoder allocate them. It must
+ *                      be freeable with free(), as the repair symbols not
+ *                      polled are freed by swif_pipelined_encoder_release().
+ * @return              SWIF_STATUS_FAILURE if the snapshot queue is full
+ *                      (poll, then retry), SWIF_STATUS_ERROR if the
+ *                      coding window is empty
+ *                      (SWIF_ERRNO_EMPTY_REPAIR_WINDOW) or there is no
+ *                      memory, SWIF_STATUS_OK otherwise.
+ */
+swif_status_t   swif_pipelined_encoder_build_repair_symbol (
+                                swif_pipelined_encoder_t* penc,
+                                uint32_t        key,
+                                void*           buf);
+
+/**
+ * Reclaim the free slots and retrieve up to max_events events. Call it
+ * again until it returns less than max_events.
+ *
+ * @return              number of events copied to event_tab.
+ */
+uint32_t        swif_pipelined_encoder_poll (
+                                swif_pipelined_encoder_t* penc,
+                                swif_engine_event_t*    event_tab,
+                                uint32_t                max_events);
+
+#endif /* SWIF_PIPELINED_ENCODER_H */
@@ -16,6 +16,12 @@
 
 #include "swif_includes.h"
 
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 static void tinymt32_next_state (tinymt32_t * s);
 static uint32_t tinymt32_temper (tinymt32_t * s);
 
@@ -140,3 +146,172 @@ static uint32_t tinymt32_temper (tinymt32_t * s)
     return t0;
 }
 
+
+/*
+ * Multi-stream tinymt32.
+ */
+
+static void tinymt32_multi_next_state (tinymt32_multi_t * s);
+
+void tinymt32_multi_init (tinymt32_multi_t *	s,
+			  const uint32_t	seed[TINYMT32_MULTI_LANES])
+{
+    const uint32_t    MIN_LOOP = 8;
+    const uint32_t    PRE_LOOP = 8;
+    uint32_t          st[4];
+
+    for (int l = 0; l < TINYMT32_MULTI_LANES; l++) {
+        /* same seeding as tinymt32_init() */
+        st[0] = seed[l];
+        st[1] = TINYMT32_MAT1_PARAM;
+        st[2] = TINYMT32_MAT2_PARAM;
+        st[3] = TINYMT32_TMAT_PARAM;
+        for (int i = 1; i < MIN_LOOP; i++) {
+            st[i & 3] ^= i + UINT32_C(1812433253)
+                * (st[(i - 1) & 3] ^ (st[(i - 1) & 3] >> 30));
+        }
+        for (int i = 0; i < 4; i++) {
+            s->status[i][l] = st[i];
+        }
+    }
+    for (int i = 0; i < PRE_LOOP; i++) {
+        tinymt32_multi_next_state(s);
+    }
+}
+
+#if defined(__AVX2__)
+
+static void tinymt32_multi_next_state (tinymt32_multi_t * s)
+{
+    const __m256i mask = _mm256_set1_epi32(TINYMT32_MASK);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i mat1 = _mm256_set1_epi32(TINYMT32_MAT1_PARAM);
+    const __m256i mat2 = _mm256_set1_epi32(TINYMT32_MAT2_PARAM);
+    __m256i s0 = _mm256_loadu_si256((__m256i *)s->status[0]);
+    __m256i s1 = _mm256_loadu_si256((__m256i *)s->status[1]);
+    __m256i s2 = _mm256_loadu_si256((__m256i *)s->status[2]);
+    __m256i y = _mm256_loadu_si256((__m256i *)s->status[3]);
+    __m256i x, m;
+
+    x = _mm256_xor_si256(_mm256_xor_si256(_mm256_and_si256(s0, mask), s1), s2);
+    x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 1));		/* TINYMT32_SH0 */
+    y = _mm256_xor_si256(y, _mm256_xor_si256(_mm256_srli_epi32(y, 1), x));
+    /* all ones in lanes where y is odd */
+    m = _mm256_sub_epi32(_mm256_setzero_si256(), _mm256_and_si256(y, one));
+    _mm256_storeu_si256((__m256i *)s->status[0], s1);
+    _mm256_storeu_si256((__m256i *)s->status[1],
+        _mm256_xor_si256(s2, _mm256_and_si256(m, mat1)));
+    _mm256_storeu_si256((__m256i *)s->status[2],
+        _mm256_xor_si256(_mm256_xor_si256(x, _mm256_slli_epi32(y, 10)),	/* TINYMT32_SH1 */
+                         _mm256_and_si256(m, mat2)));
+    _mm256_storeu_si256((__m256i *)s->status[3], y);
+}
+
+void tinymt32_multi_generate_uint32 (tinymt32_multi_t *	s,
+				     uint32_t		r[TINYMT32_MULTI_LANES])
+{
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i tmat = _mm256_set1_epi32(TINYMT32_TMAT_PARAM);
+    __m256i t0, t1;
+
+    tinymt32_multi_next_state(s);
+    t0 = _mm256_loadu_si256((__m256i *)s->status[3]);
+    t1 = _mm256_add_epi32(_mm256_loadu_si256((__m256i *)s->status[0]),
+            _mm256_srli_epi32(_mm256_loadu_si256((__m256i *)s->status[2]), 8));	/* TINYMT32_SH8 */
+    t0 = _mm256_xor_si256(t0, t1);
+    t1 = _mm256_sub_epi32(_mm256_setzero_si256(), _mm256_and_si256(t1, one));
+    t0 = _mm256_xor_si256(t0, _mm256_and_si256(t1, tmat));
+    _mm256_storeu_si256((__m256i *)r, t0);
+}
+
+#elif defined(__SSE2__)
+
+static void tinymt32_multi_next_state (tinymt32_multi_t * s)
+{
+    const __m128i mask = _mm_set1_epi32(TINYMT32_MASK);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i mat1 = _mm_set1_epi32(TINYMT32_MAT1_PARAM);
+    const __m128i mat2 = _mm_set1_epi32(TINYMT32_MAT2_PARAM);
+
+    for (int l = 0; l < TINYMT32_MULTI_LANES; l += 4) {
+        __m128i s0 = _mm_loadu_si128((__m128i *)&s->status[0][l]);
+        __m128i s1 = _mm_loadu_si128((__m128i *)&s->status[1][l]);
+        __m128i s2 = _mm_loadu_si128((__m128i *)&s->status[2][l]);
+        __m128i y = _mm_loadu_si128((__m128i *)&s->status[3][l]);
+        __m128i x, m;
+
+        x = _mm_xor_si128(_mm_xor_si128(_mm_and_si128(s0, mask), s1), s2);
+        x = _mm_xor_si128(x, _mm_slli_epi32(x, 1));		/* TINYMT32_SH0 */
+        y = _mm_xor_si128(y, _mm_xor_si128(_mm_srli_epi32(y, 1), x));
+        /* all ones in lanes where y is odd */
+        m = _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(y, one));
+        _mm_storeu_si128((__m128i *)&s->status[0][l], s1);
+        _mm_storeu_si128((__m128i *)&s->status[1][l],
+            _mm_xor_si128(s2, _mm_and_si128(m, mat1)));
+        _mm_storeu_si128((__m128i *)&s->status[2][l],
+            _mm_xor_si128(_mm_xor_si128(x, _mm_slli_epi32(y, 10)),	/* TINYMT32_SH1 */
+                          _mm_and_si128(m, mat2)));
+        _mm_storeu_si128((__m128i *)&s->status[3][l], y);
+    }
+}
+
+void tinymt32_multi_generate_uint32 (tinymt32_multi_t *	s,
+				     uint32_t		r[TINYMT32_MULTI_LANES])
+{
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i tmat = _mm_set1_epi32(TINYMT32_TMAT_PARAM);
+
+    tinymt32_multi_next_state(s);
+    for (int l = 0; l < TINYMT32_MULTI_LANES; l += 4) {
+        __m128i t0, t1;
+
+        t0 = _mm_loadu_si128((__m128i *)&s->status[3][l]);
+        t1 = _mm_add_epi32(_mm_loadu_si128((__m128i *)&s->status[0][l]),
+                _mm_srli_epi32(_mm_loadu_si128((__m128i *)&s->status[2][l]), 8));	/* TINYMT32_SH8 */
+        t0 = _mm_xor_si128(t0, t1);
+        t1 = _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(t1, one));
+        t0 = _mm_xor_si128(t0, _mm_and_si128(t1, tmat));
+        _mm_storeu_si128((__m128i *)&r[l], t0);
+    }
+}
+
+#else /* portable version */
+
+static void tinymt32_multi_next_state (tinymt32_multi_t * s)
+{
+    for (int l = 0; l < TINYMT32_MULTI_LANES; l++) {
+        uint32_t x;
+        uint32_t y;
+        uint32_t m;
+
+        y = s->status[3][l];
+        x = (s->status[0][l] & TINYMT32_MASK)
+            ^ s->status[1][l]
+            ^ s->status[2][l];
+        x ^= (x << TINYMT32_SH0);
+        y ^= (y >> TINYMT32_SH0) ^ x;
+        /* all ones if y is odd, without branch (unsigned arithmetic) */
+        m = UINT32_C(0) - (y & 1);
+        s->status[0][l] = s->status[1][l];
+        s->status[1][l] = s->status[2][l] ^ (m & TINYMT32_MAT1_PARAM);
+        s->status[2][l] = x ^ (y << TINYMT32_SH1) ^ (m & TINYMT32_MAT2_PARAM);
+        s->status[3][l] = y;
+    }
+}
+
+void tinymt32_multi_generate_uint32 (tinymt32_multi_t *	s,
+				     uint32_t		r[TINYMT32_MULTI_LANES])
+{
+    tinymt32_multi_next_state(s);
+    for (int l = 0; l < TINYMT32_MULTI_LANES; l++) {
+        uint32_t t0, t1;
+
+        t0 = s->status[3][l];
+        t1 = s->status[0][l] + (s->status[2][l] >> TINYMT32_SH8);
+        t0 ^= t1;
+        t0 ^= (UINT32_C(0) - (t1 & 1)) & TINYMT32_TMAT_PARAM;
+        r[l] = t0;
+    }
+}
+
+#endif
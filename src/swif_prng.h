@@ -72,3 +72,40 @@ static inline uint32_t tinymt32_rand256(tinymt32_t *s)
     return (tinymt32_generate_uint32(s) & 0xFF);
 }
 
+
+
+/**
+ * Multi-stream tinymt32: TINYMT32_MULTI_LANES independent generators
+ * stepped together, each lane producing exactly the same sequence as
+ * the scalar tinymt32 initialized with the same seed.
+ *
+ * The state is stored as a structure of arrays, so that a step is a
+ * few vector operations on status[0..3]. The implementation uses AVX2
+ * (one register per word) or SSE2 (two registers per word) when the
+ * compiler targets them, and a branch-free portable loop otherwise.
+ */
+#define TINYMT32_MULTI_LANES	8
+
+typedef struct {
+    uint32_t status[4][TINYMT32_MULTI_LANES];
+} tinymt32_multi_t;
+
+
+/**
+ * This function initializes the TINYMT32_MULTI_LANES internal states,
+ * lane i with seed[i].
+ * @param s	pointer to multi-stream tinymt internal state.
+ * @param seed	table of TINYMT32_MULTI_LANES 32-bit unsigned seeds.
+ */
+void tinymt32_multi_init (tinymt32_multi_t *	s,
+			  const uint32_t	seed[TINYMT32_MULTI_LANES]);
+
+
+/**
+ * This function outputs one 32-bit unsigned integer per lane.
+ * @param s	pointer to multi-stream tinymt internal state.
+ * @param r	table of TINYMT32_MULTI_LANES entries, filled with the
+ *		next output of each lane.
+ */
+void tinymt32_multi_generate_uint32 (tinymt32_multi_t *	s,
+				     uint32_t		r[TINYMT32_MULTI_LANES]);
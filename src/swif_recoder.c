@@ -0,0 +1,177 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+/**
+ * Recoder: random linear combinations of the equations received by a
+ * relay, see swif_recoder.h.
+ */
+
+#include "swif_includes.h"
+#include "swif_recoder.h"
+
+
+struct swif_recoder {
+	uint32_t		verbosity;
+	uint32_t		symbol_size;
+	uint32_t		max_linear_system_size;
+
+	/* finite field GF(2^^m) (1, 4 or 8) */
+	uint8_t			m;
+
+	/* linear system in echelon form (forward_only) */
+	swif_full_symbol_set_t*	symbol_set;
+
+	/* one byte per coefficient, when the codepoint format packs them
+	 * (GF(2^^4)), and weights of the next combination */
+	uint8_t*		coef_tab;
+	uint8_t*		weight_tab;
+};
+
+
+swif_recoder_t* swif_recoder_create (
+                                swif_codepoint_t codepoint,
+                                uint32_t        verbosity,
+                                uint32_t        symbol_size,
+                                uint32_t        max_linear_system_size)
+{
+    swif_recoder_t	*rec;
+    uint8_t		m, dt;
+
+    if (!swif_rlc_codepoint_params(codepoint, &m, &dt)) {
+        fprintf(stderr, "swif_recoder_create() failed! codepoint %d not supported\n", codepoint);
+        return NULL;
+    }
+    if (max_linear_system_size == 0) {
+        fprintf(stderr, "swif_recoder_create() failed! bad linear system size\n");
+        return NULL;
+    }
+    if ((rec = calloc(1, sizeof(swif_recoder_t))) == NULL) {
+        fprintf(stderr, "swif_recoder_create() failed! No memory\n");
+        return NULL;
+    }
+    rec->verbosity = verbosity;
+    rec->symbol_size = symbol_size;
+    rec->max_linear_system_size = max_linear_system_size;
+    rec->m = m;
+    rec->symbol_set = full_symbol_set_alloc_with_size(max_linear_system_size);
+    rec->coef_tab = calloc(max_linear_system_size, sizeof(uint8_t));
+    rec->weight_tab = calloc(max_linear_system_size, sizeof(uint8_t));
+    if (rec->symbol_set == NULL || rec->coef_tab == NULL || rec->weight_tab == NULL) {
+        fprintf(stderr, "swif_recoder_create() failed! No memory\n");
+        swif_recoder_release(rec);
+        return NULL;
+    }
+    rec->symbol_set->log2_nb_bit_coef = swif_rlc_log2_nb_bit_coef(m);
+    rec->symbol_set->forward_only = true;
+    return rec;
+}
+
+
+swif_status_t   swif_recoder_release (swif_recoder_t*  rec)
+{
+    assert(rec);
+    if (rec->symbol_set != NULL) {
+        full_symbol_set_free(rec->symbol_set);
+    }
+    free(rec->coef_tab);
+    free(rec->weight_tab);
+    free(rec);
+    return SWIF_STATUS_OK;
+}
+
+
+swif_status_t   swif_recoder_add_source_symbol (
+                                swif_recoder_t* rec,
+                                void*           new_symbol_buf,
+                                esi_t           new_symbol_esi)
+{
+    static const uint8_t one = 1;
+
+    if (rec->verbosity > 1) {
+        printf("recoder: source symbol %u\n", new_symbol_esi);
+    }
+    full_symbol_set_add_coefs(rec->symbol_set, &one, new_symbol_esi, 1,
+                              new_symbol_buf, rec->symbol_size);
+    return SWIF_STATUS_OK;
+}
+
+
+swif_status_t   swif_recoder_add_repair_symbol (
+                                swif_recoder_t* rec,
+                                void*           new_symbol_buf,
+                                esi_t           first_id,
+                                void*           coefs_tab,
+                                uint32_t        nb_coefs)
+{
+    const uint8_t	*coef_tab = coefs_tab;
+
+    if (nb_coefs > rec->max_linear_system_size) {
+        fprintf(stderr, "swif_recoder_add_repair_symbol() failed! too many coefficients (%u)\n", nb_coefs);
+        return SWIF_STATUS_ERROR;
+    }
+    if (rec->m == 4) {
+        /* two coefficients per byte */
+        uint16_t size = (nb_coefs + 1) / 2;
+        for (uint32_t i = 0; i < nb_coefs; i++) {
+            rec->coef_tab[i] = lc_vector_get(coefs_tab, size, 2, i);
+        }
+        coef_tab = rec->coef_tab;
+    }
+    if (rec->verbosity > 1) {
+        printf("recoder: repair symbol %u..%u\n", first_id, first_id + nb_coefs - 1);
+    }
+    full_symbol_set_add_coefs(rec->symbol_set, coef_tab, first_id, nb_coefs,
+                              new_symbol_buf, rec->symbol_size);
+    return SWIF_STATUS_OK;
+}
+
+
+uint32_t        swif_recoder_get_rank (swif_recoder_t* rec)
+{
+    return full_symbol_set_get_rank(rec->symbol_set);
+}
+
+
+swif_status_t   swif_recoder_build_repair_symbol (
+                                swif_recoder_t* rec,
+                                uint32_t        key,
+                                void*           repair_buf,
+                                void*           coefs_tab,
+                                esi_t*          first_id,
+                                uint32_t*       nb_coefs)
+{
+    uint32_t	rank = full_symbol_set_get_rank(rec->symbol_set);
+    uint32_t	data_size = 0;
+    bool	all_zero = true;
+    tinymt32_t	s;
+
+    if (rank == 0) {
+        return SWIF_STATUS_FAILURE;
+    }
+    tinymt32_init(&s, key);
+    for (uint32_t i = 0; i < rank; i++) {
+        uint32_t r = tinymt32_generate_uint32(&s);
+        rec->weight_tab[i] = (rec->m == 1) ? (r & 0x1) : (rec->m == 4) ? (r & 0xF) : (r & 0xFF);
+        all_zero = all_zero && (rec->weight_tab[i] == 0);
+    }
+    if (all_zero) {
+        rec->weight_tab[rank - 1] = 1;
+    }
+    /* the equations being independent, the combination is not zero. The
+     * coefficients are written in place, unless they must be packed */
+    *nb_coefs = full_symbol_set_combine(rec->symbol_set, rec->weight_tab,
+                                        (rec->m == 4) ? rec->coef_tab : coefs_tab,
+                                        first_id, repair_buf, &data_size);
+    assert(*nb_coefs > 0);
+    memset((uint8_t*)repair_buf + data_size, 0, rec->symbol_size - data_size);
+    if (rec->m == 4) {
+        uint16_t size = (*nb_coefs + 1) / 2;
+        memset(coefs_tab, 0, size);
+        for (uint32_t i = 0; i < *nb_coefs; i++) {
+            lc_vector_set(coefs_tab, size, 2, i, rec->coef_tab[i]);
+        }
+    }
+    return SWIF_STATUS_OK;
+}
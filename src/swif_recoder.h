@@ -0,0 +1,103 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+#ifndef SWIF_RECODER_H
+#define SWIF_RECODER_H
+#include "swif_includes.h"
+
+
+/**
+ * Recoder, for in-network re-encoding at a relay.
+ * The source and repair symbols received are kept with their coding
+ * coefficients in a linear system of bounded size, only reduced enough
+ * to drop the non-innovative ones (no back-substitution, so no
+ * decoding). New repair symbols are random linear combinations of what
+ * is held, with the matching coefficients: they are sent downstream with
+ * these coefficients, that a decoder gives to
+ * swif_decoder_set_coding_coefs_tab().
+ * Coefficient tables use the codepoint format of
+ * swif_*_coding_coefs_tab() (e.g. two coefficients per byte with
+ * SWIF_CODEPOINT_RLC_GF_16_CODEC).
+ */
+typedef struct swif_recoder swif_recoder_t;
+
+
+/**
+ * Create a recoder.
+ *
+ * @param codepoint     (IN) the code of the flow, one of the RLC ones.
+ * @param verbosity     (IN) 0 is the minimum verbosity.
+ * @param symbol_size   (IN) size (in bytes) of any source or repair symbol.
+ * @param max_linear_system_size
+ *                      (IN) number of most recent source symbols the
+ *                      recoder keeps equations for, which should be
+ *                      larger than the upstream max_coding_window_size.
+ * @return              the recoder, or NULL in case of error.
+ */
+swif_recoder_t* swif_recoder_create (
+                                swif_codepoint_t codepoint,
+                                uint32_t        verbosity,
+                                uint32_t        symbol_size,
+                                uint32_t        max_linear_system_size);
+
+/**
+ * Release a recoder.
+ */
+swif_status_t   swif_recoder_release (swif_recoder_t*  rec);
+
+/**
+ * Submit a source symbol received by the relay. It is copied.
+ */
+swif_status_t   swif_recoder_add_source_symbol (
+                                swif_recoder_t* rec,
+                                void*           new_symbol_buf,
+                                esi_t           new_symbol_esi);
+
+/**
+ * Submit a repair symbol received by the relay, with its coefficients.
+ * Both are copied.
+ *
+ * @param first_id      (IN) ESI of the source symbol of the first
+ *                      coefficient.
+ * @param coefs_tab     (IN) coefficients of source symbols first_id to
+ *                      first_id + nb_coefs - 1.
+ */
+swif_status_t   swif_recoder_add_repair_symbol (
+                                swif_recoder_t* rec,
+                                void*           new_symbol_buf,
+                                esi_t           first_id,
+                                void*           coefs_tab,
+                                uint32_t        nb_coefs);
+
+/**
+ * Return the number of independent equations held, i.e. the maximum
+ * number of innovative repair symbols the recoder can build now.
+ */
+uint32_t        swif_recoder_get_rank (swif_recoder_t* rec);
+
+/**
+ * Build a new repair symbol, combining all the equations held with
+ * weights drawn from a PRNG seeded with key.
+ *
+ * @param key           (IN) seed of the combination weights.
+ * @param repair_buf    (OUT) buffer of symbol_size bytes, where the
+ *                      repair symbol is written.
+ * @param coefs_tab     (OUT) table of max_linear_system_size coefficients
+ *                      (in the codepoint format) where the coefficients
+ *                      of the repair symbol are written.
+ * @param first_id      (OUT) ESI of the source symbol of the first
+ *                      coefficient.
+ * @param nb_coefs      (OUT) number of coefficients.
+ * @return              SWIF_STATUS_FAILURE if there is nothing to recode.
+ */
+swif_status_t   swif_recoder_build_repair_symbol (
+                                swif_recoder_t* rec,
+                                uint32_t        key,
+                                void*           repair_buf,
+                                void*           coefs_tab,
+                                esi_t*          first_id,
+                                uint32_t*       nb_coefs);
+
+#endif /* SWIF_RECODER_H */
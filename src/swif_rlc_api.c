@@ -3,6 +3,7 @@
 #include "swif_coding_coefficients.h"
 #include "swif_full_symbol_impl.c"
 
+
 /*******************************************************************************
  * Encoder functions
  */
@@ -15,11 +16,15 @@ swif_status_t   swif_rlc_encoder_release (swif_encoder_t*        enc)
 {
 	assert(enc);
     swif_encoder_rlc_cb_t *rlc_enc = (swif_encoder_rlc_cb_t *) enc;
-    if (rlc_enc->cc_tab)
-        free(rlc_enc->cc_tab);
-    if (rlc_enc->ew_tab)
-        free(rlc_enc->ew_tab);
-    free(enc);
+    /* the allocator is part of the control block */
+    swif_allocator_t allocator = rlc_enc->allocator;
+
+    swif_mem_free(&allocator, rlc_enc->cc_tab);
+    swif_mem_free(&allocator, rlc_enc->packed_cc_tab);
+    swif_mem_free(&allocator, rlc_enc->ew_tab);
+    swif_mem_free(&allocator, rlc_enc->ew_len_tab);
+    swif_mem_free(&allocator, rlc_enc->layer_cc_tab);
+    swif_mem_free(&allocator, enc);
 	return SWIF_STATUS_OK;
 }
 
@@ -46,6 +51,24 @@ swif_status_t   swif_rlc_encoder_set_callback_functions (
 }
 
 
+/**
+ * Select the fixed-size kernels of the symbols processed, if any: none
+ * with variable-length symbols.
+ */
+static void swif_rlc_encoder_select_kernels (swif_encoder_rlc_cb_t* enc)
+{
+    uint8_t	l = swif_rlc_log2_nb_bit_coef(enc->m);
+
+    if (enc->variable_length) {
+        enc->kernels = NULL;
+    } else if (enc->aligned_symbols) {
+        enc->kernels = lc_get_kernels(enc->padded_symbol_size, l, 1);
+    } else {
+        enc->kernels = lc_get_kernels(enc->symbol_size, l, 0);
+    }
+}
+
+
 /**
  * This function sets one or more FEC codec specific parameters,
  * using a type/length/value approach for maximum flexibility.
@@ -56,8 +79,101 @@ swif_status_t   swif_rlc_encoder_set_parameters  (
                                 uint32_t        length,
                                 void*           value)
 {
-// NOT YET
-	return SWIF_STATUS_OK;
+    swif_encoder_rlc_cb_t *rlc_enc = (swif_encoder_rlc_cb_t *) enc;
+
+    switch (type) {
+    case swif_ENCODER_SET_PARAM_VARIABLE_LENGTH_SYMBOLS:
+        if (value == NULL || length != sizeof(uint32_t) || rlc_enc->ew_ss_nb > 0
+            || (rlc_enc->aligned_symbols && *(uint32_t*)value != 0)) {
+            fprintf(stderr, "swif_rlc_encoder_set_parameters() failed! variable length mode must be set before adding source symbols, without aligned symbols\n");
+            enc->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        rlc_enc->variable_length = (*(uint32_t*)value != 0);
+        swif_rlc_encoder_select_kernels(rlc_enc);
+        if (rlc_enc->variable_length && rlc_enc->ew_len_tab == NULL) {
+            rlc_enc->ew_len_tab = swif_mem_calloc(&rlc_enc->allocator, rlc_enc->max_coding_window_size,
+                                                   sizeof(uint32_t));
+            if (rlc_enc->ew_len_tab == NULL) {
+                fprintf(stderr, "swif_rlc_encoder_set_parameters() failed! No memory\n");
+                return SWIF_STATUS_ERROR;
+            }
+        }
+        return SWIF_STATUS_OK;
+
+    case swif_ENCODER_SET_PARAM_ALIGNED_SYMBOLS:
+        if (value == NULL || length != sizeof(uint32_t) || rlc_enc->ew_ss_nb > 0
+            || (rlc_enc->variable_length && *(uint32_t*)value != 0)) {
+            fprintf(stderr, "swif_rlc_encoder_set_parameters() failed! aligned symbols must be set before adding source symbols, without variable length mode\n");
+            enc->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        rlc_enc->aligned_symbols = (*(uint32_t*)value != 0);
+        swif_rlc_encoder_select_kernels(rlc_enc);
+        return SWIF_STATUS_OK;
+
+    case swif_ENCODER_SET_PARAM_RLC_DENSITY_THRESHOLD:
+        if (value == NULL || length != sizeof(uint32_t) || *(uint32_t*)value > 15) {
+            enc->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        rlc_enc->dt = (uint8_t) *(uint32_t*)value;
+        return SWIF_STATUS_OK;
+
+    case swif_ENCODER_SET_PARAM_CODING_COEFS_CACHE:
+        if (value == NULL || length != sizeof(swif_cc_cache_t*)) {
+            enc->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        rlc_enc->cc_cache = *(swif_cc_cache_t**)value;
+        return SWIF_STATUS_OK;
+
+    case swif_ENCODER_SET_PARAM_STRIPE_POOL:
+        if (value == NULL || length != sizeof(swif_stripe_pool_t*)) {
+            enc->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        rlc_enc->stripe_pool = *(swif_stripe_pool_t**)value;
+        return SWIF_STATUS_OK;
+
+
+    case swif_ENCODER_SET_PARAM_LAYERS: {
+        uint32_t nb_layers = length / sizeof(swif_encoder_layer_t);
+        swif_encoder_layer_t *layer_tab = (swif_encoder_layer_t*)value;
+
+        if (length % sizeof(swif_encoder_layer_t) != 0
+            || nb_layers > SWIF_MAX_ENCODER_LAYERS
+            || (nb_layers > 0 && value == NULL)) {
+            enc->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        for (uint32_t i = 0; i < nb_layers; i++) {
+            if (layer_tab[i].window_size == 0
+                || layer_tab[i].window_size > rlc_enc->max_coding_window_size) {
+                fprintf(stderr, "swif_rlc_encoder_set_parameters() failed! layer %u larger than the coding window\n", i);
+                enc->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+                return SWIF_STATUS_ERROR;
+            }
+        }
+        if (nb_layers > 0 && rlc_enc->layer_cc_tab == NULL) {
+            rlc_enc->layer_cc_tab = swif_mem_alloc(&rlc_enc->allocator,
+                                                   (size_t)SWIF_MAX_ENCODER_LAYERS
+                                                   * rlc_enc->max_coding_window_size);
+            if (rlc_enc->layer_cc_tab == NULL) {
+                fprintf(stderr, "swif_rlc_encoder_set_parameters() failed! No memory\n");
+                return SWIF_STATUS_ERROR;
+            }
+        }
+        memcpy(rlc_enc->layer_tab, layer_tab, length);
+        memset(rlc_enc->layer_repair_size_tab, 0, sizeof(rlc_enc->layer_repair_size_tab));
+        rlc_enc->nb_layers = nb_layers;
+        return SWIF_STATUS_OK;
+    }
+
+    default:
+        enc->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+        return SWIF_STATUS_ERROR;
+    }
 }
 
 /**
@@ -70,8 +186,131 @@ swif_status_t   swif_rlc_encoder_get_parameters  (
                                 uint32_t        length,
                                 void*           value)
 {
-// NOT YET
-	return SWIF_STATUS_OK;
+    swif_encoder_rlc_cb_t *rlc_enc = (swif_encoder_rlc_cb_t *) enc;
+
+    switch (type) {
+    case swif_ENCODER_GET_PARAM_REPAIR_SYMBOL_SIZE:
+        if (value == NULL || length != sizeof(uint32_t)) {
+            enc->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        *(uint32_t*)value = rlc_enc->repair_symbol_size;
+        return SWIF_STATUS_OK;
+
+    case swif_ENCODER_GET_PARAM_DUE_LAYERS: {
+        uint32_t mask = 0;
+
+        if (value == NULL || length != sizeof(uint32_t)) {
+            enc->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        for (uint32_t i = 0; i < rlc_enc->nb_layers && rlc_enc->nb_added > 0; i++) {
+            uint32_t period = rlc_enc->layer_tab[i].repair_period;
+            if (period != 0 && rlc_enc->nb_added % period == 0) {
+                mask |= 1u << i;
+            }
+        }
+        *(uint32_t*)value = mask;
+        return SWIF_STATUS_OK;
+    }
+
+    case swif_ENCODER_GET_PARAM_LAYER_REPAIR_SYMBOL_SIZES:
+        if (value == NULL || length % sizeof(uint32_t) != 0
+            || length / sizeof(uint32_t) > rlc_enc->nb_layers) {
+            enc->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        memcpy(value, rlc_enc->layer_repair_size_tab, length);
+        return SWIF_STATUS_OK;
+
+
+    default:
+        enc->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+        return SWIF_STATUS_ERROR;
+    }
+}
+
+
+/* buffer from swif_symbol_buffer_alloc(), as far as can be checked */
+static inline bool swif_rlc_is_aligned (const void* buf)
+{
+    return ((uintptr_t)buf % SWIF_SYMBOL_ALIGNMENT) == 0;
+}
+
+
+/**
+ * Position (from ew_left) and number of the source symbols of the coding
+ * window covered by the next repair symbol, see rw_first and rw_nss.
+ * Returns SWIF_STATUS_FAILURE (SWIF_ERRNO_EMPTY_REPAIR_WINDOW) if the
+ * whole range selected by set_repair_window() has left the coding window.
+ */
+static swif_status_t swif_rlc_encoder_repair_window (swif_encoder_rlc_cb_t*	enc,
+						      uint32_t*			offset,
+						      uint32_t*			nss)
+{
+    esi_t	ew_first = enc->ew_esi_right - enc->ew_ss_nb + 1;
+    int32_t	lo;		/* range bounds relative to ew_first, as ESI */
+    int32_t	hi;		/* differences to remain correct on wrapping */
+    uint32_t	end;
+
+    *offset = 0;
+    *nss = enc->ew_ss_nb;
+    if (enc->rw_nss == 0) {
+        return SWIF_STATUS_OK;
+    }
+    lo = (int32_t)(enc->rw_first - ew_first);
+    hi = (int32_t)(enc->rw_first + enc->rw_nss - 1 - ew_first);
+    *offset = (lo > 0) ? (uint32_t)lo : 0;
+    end = (hi < 0) ? 0 : MIN((uint32_t)hi + 1, enc->ew_ss_nb);
+    *nss = (end > *offset) ? end - *offset : 0;
+    if (*nss == 0) {
+        /* the whole range has left the coding window */
+        *offset = 0;
+        enc->generic_encoder.swif_errno = SWIF_ERRNO_EMPTY_REPAIR_WINDOW;
+        return SWIF_STATUS_FAILURE;
+    }
+    return SWIF_STATUS_OK;
+}
+
+
+/**
+ * Add the source symbols of the repair window, over bytes [offset;
+ * offset + size) of the repair symbol being built (a swif_stripe_fn_t).
+ */
+static void swif_rlc_build_repair_range (void*		arg,
+					 uint32_t	offset,
+					 uint32_t	size)
+{
+    swif_encoder_rlc_cb_t* enc = (swif_encoder_rlc_cb_t*) arg;
+    uint8_t	l = swif_rlc_log2_nb_bit_coef(enc->m);
+    uint32_t	i;
+    uint32_t	idx;
+    uint32_t	len;
+
+    if (enc->kernels != NULL && offset == 0 && size == enc->kernels->symbol_size) {
+        /* whole symbols, of a size with its own kernels */
+        for (i = 0; i < enc->build_nss; i++) {
+            idx = (enc->ew_left + enc->build_offset + i) % enc->max_coding_window_size;
+            enc->kernels->add_mul(enc->cc_tab[i], enc->ew_tab[idx], enc->build_buf);
+        }
+        return;
+    }
+    for (i = 0; i < enc->build_nss; i++) {
+        /* cc_tab[i] is the coefficient of the i-th source symbol of the
+         * repair window, whose buffer is at index idx of the ew_tab ring */
+        idx = (enc->ew_left + enc->build_offset + i) % enc->max_coding_window_size;
+        if (enc->aligned_symbols) {
+            /* offset and size are multiples of SWIF_SYMBOL_ALIGNMENT */
+            lc_vector_add_mul_aligned(enc->cc_tab[i], (uint8_t*)enc->ew_tab[idx] + offset,
+                                      size, l, enc->build_buf + offset);
+            continue;
+        }
+        len = (enc->variable_length) ? enc->ew_len_tab[idx] : enc->symbol_size;
+        if (len > offset) {
+            lc_vector_add_mul(enc->cc_tab[i], (uint8_t*)enc->ew_tab[idx] + offset,
+                              MIN(len - offset, size), l, enc->build_buf + offset);
+        }
+    }
 }
 
 
@@ -84,26 +323,134 @@ swif_status_t   swif_rlc_build_repair_symbol (
 {
     swif_encoder_rlc_cb_t* enc = (swif_encoder_rlc_cb_t*) generic_encoder;
     uint32_t	i;
-
+    uint32_t	idx;
+    uint32_t	len;
+    uint32_t	max_len = 0;
+    uint32_t	offset;
+    uint32_t	nss;
+    uint32_t	size = (enc->aligned_symbols) ? enc->padded_symbol_size : enc->symbol_size;
+
+    if (swif_rlc_encoder_repair_window(enc, &offset, &nss) != SWIF_STATUS_OK) {
+        return SWIF_STATUS_FAILURE;
+    }
     if (*new_buf == 0)
     {
-        if ((*new_buf = calloc(1, enc->symbol_size)) == NULL) {
+        *new_buf = (enc->aligned_symbols)
+                   ? swif_mem_aligned_calloc(&enc->allocator, SWIF_SYMBOL_ALIGNMENT, size)
+                   : swif_mem_calloc(&enc->allocator, 1, size);
+        if (*new_buf == NULL) {
             fprintf(stderr, "swif_rlc_build_repair_symbol failed! No memory\n");
             return SWIF_STATUS_ERROR;
         }
     }
     else
     {
-        memset(*new_buf,0,enc->symbol_size);
+        if (enc->aligned_symbols && !swif_rlc_is_aligned(*new_buf)) {
+            fprintf(stderr, "swif_rlc_build_repair_symbol failed! misaligned repair symbol buffer\n");
+            generic_encoder->swif_errno = SWIF_ERRNO_MISALIGNED_SYMBOL_BUFFER;
+            return SWIF_STATUS_ERROR;
+        }
+        memset(*new_buf,0,size);
     }
 
     DEBUG_PRINT("\nbuild-repair: \n");
-    for (i = enc->ew_left; i < enc->ew_ss_nb; i++) {
-        uint32_t idx = i % enc->max_coding_window_size;
-        DEBUG_PRINT(" +%u.P[%u->%u]", enc->cc_tab[idx], i, idx);
-        symbol_add_scaled(*new_buf, enc->cc_tab[idx], enc->ew_tab[idx], enc->symbol_size);
+    for (i = 0; i < nss; i++) {
+        idx = (enc->ew_left + offset + i) % enc->max_coding_window_size;
+        len = (enc->variable_length) ? enc->ew_len_tab[idx] : enc->symbol_size;
+        DEBUG_PRINT(" +%u.P[%u->%u]", enc->cc_tab[i], i, idx);
+        max_len = MAX(max_len, len);
     }
     DEBUG_PRINT("\n");
+    enc->build_offset = offset;
+    enc->build_nss = nss;
+    enc->build_buf = *new_buf;
+    swif_stripe_pool_run(enc->stripe_pool, swif_rlc_build_repair_range, enc,
+                         (enc->variable_length) ? max_len : size);
+    /* bytes after the longest source symbol are zero, don't send them */
+    enc->repair_symbol_size = (enc->variable_length) ? max_len : enc->symbol_size;
+    return SWIF_STATUS_OK;
+}
+
+
+/**
+ * Create one repair symbol for each selected layer in a single pass.
+ * The source symbols are visited from the oldest one of the largest
+ * selected layer, and each one is added to all the repair symbols of the
+ * layers that cover it while it is still in cache.
+ */
+swif_status_t   swif_rlc_build_layer_repair_symbols (
+                                swif_encoder_t* generic_encoder,
+                                uint32_t        layer_mask,
+                                const uint32_t* key_tab,
+                                void**          new_buf_tab)
+{
+    swif_encoder_rlc_cb_t* enc = (swif_encoder_rlc_cb_t*) generic_encoder;
+    uint32_t	nss_tab[SWIF_MAX_ENCODER_LAYERS];
+    uint32_t	max_nss = 0;
+    uint32_t	pos;		/* position in the coding window */
+    uint32_t	idx;
+    uint32_t	len;
+    uint32_t	l;
+    uint8_t	gf = swif_rlc_log2_nb_bit_coef(enc->m);
+    uint32_t	size = (enc->aligned_symbols) ? enc->padded_symbol_size : enc->symbol_size;
+
+    if (layer_mask >> enc->nb_layers != 0) {
+        fprintf(stderr, "swif_rlc_build_layer_repair_symbols() failed! unknown layer in mask 0x%x\n", layer_mask);
+        generic_encoder->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+        return SWIF_STATUS_ERROR;
+    }
+    for (l = 0; l < enc->nb_layers; l++) {
+        if ((layer_mask & (1u << l)) == 0) {
+            continue;
+        }
+        if (new_buf_tab[l] == NULL) {
+            new_buf_tab[l] = (enc->aligned_symbols)
+                             ? swif_mem_aligned_calloc(&enc->allocator, SWIF_SYMBOL_ALIGNMENT, size)
+                             : swif_mem_calloc(&enc->allocator, 1, size);
+            if (new_buf_tab[l] == NULL) {
+                fprintf(stderr, "swif_rlc_build_layer_repair_symbols failed! No memory\n");
+                return SWIF_STATUS_ERROR;
+            }
+        } else {
+            if (enc->aligned_symbols && !swif_rlc_is_aligned(new_buf_tab[l])) {
+                fprintf(stderr, "swif_rlc_build_layer_repair_symbols failed! misaligned repair symbol buffer for layer %u\n", l);
+                generic_encoder->swif_errno = SWIF_ERRNO_MISALIGNED_SYMBOL_BUFFER;
+                return SWIF_STATUS_ERROR;
+            }
+            memset(new_buf_tab[l], 0, size);
+        }
+        nss_tab[l] = MIN(enc->layer_tab[l].window_size, enc->ew_ss_nb);
+        max_nss = MAX(max_nss, nss_tab[l]);
+        swif_cc_cache_get_coding_coefficients (enc->cc_cache,
+            (uint16_t)key_tab[l], enc->layer_cc_tab + (size_t)l * enc->max_coding_window_size,
+            nss_tab[l], enc->dt, enc->m);
+        enc->layer_repair_size_tab[l] = 0;
+    }
+    for (pos = enc->ew_ss_nb - max_nss; pos < enc->ew_ss_nb; pos++) {
+        idx = (enc->ew_left + pos) % enc->max_coding_window_size;
+        len = (enc->variable_length) ? enc->ew_len_tab[idx] : size;
+        for (l = 0; l < enc->nb_layers; l++) {
+            /* layer l covers the last nss_tab[l] positions */
+            if ((layer_mask & (1u << l)) == 0 || pos < enc->ew_ss_nb - nss_tab[l]) {
+                continue;
+            }
+            uint8_t coef = enc->layer_cc_tab[(size_t)l * enc->max_coding_window_size
+                                             + pos - (enc->ew_ss_nb - nss_tab[l])];
+            if (enc->kernels != NULL) {
+                enc->kernels->add_mul(coef, enc->ew_tab[idx], new_buf_tab[l]);
+            } else if (enc->aligned_symbols) {
+                lc_vector_add_mul_aligned(coef, enc->ew_tab[idx], len, gf, new_buf_tab[l]);
+            } else {
+                lc_vector_add_mul(coef, enc->ew_tab[idx], len, gf, new_buf_tab[l]);
+            }
+            enc->layer_repair_size_tab[l] = MAX(enc->layer_repair_size_tab[l], len);
+        }
+    }
+    for (l = 0; l < enc->nb_layers && !enc->variable_length; l++) {
+        if (layer_mask & (1u << l)) {
+            enc->layer_repair_size_tab[l] = enc->symbol_size;
+        }
+    }
     return SWIF_STATUS_OK;
 }
 
@@ -120,11 +467,13 @@ swif_status_t   swif_rlc_decoder_release (swif_decoder_t*        dec)
 {
 	assert(dec);
     swif_decoder_rlc_cb_t *rlc_dec = (swif_decoder_rlc_cb_t *) dec;
-    if (rlc_dec->coef_tab)
-        free(rlc_dec->coef_tab);
+    /* the allocator is part of the control block */
+    swif_allocator_t allocator = rlc_dec->allocator;
+
+    swif_mem_free(&allocator, rlc_dec->coef_tab);
     if (rlc_dec->symbol_set)
         full_symbol_set_free(rlc_dec->symbol_set);
-    free(rlc_dec);
+    swif_mem_free(&allocator, rlc_dec);
 	return SWIF_STATUS_OK;
 }
 
@@ -138,15 +487,54 @@ static void rlc_decoder_notify_decoded(
 			   void* dec)
 {
     swif_decoder_rlc_cb_t *rlc_dec = (swif_decoder_rlc_cb_t *) dec;
-    printf("notify decoded: %u\n", decoded_id);
-	swif_full_symbol_t *full_symbol = full_symbol_set_get_pivot(
-        rlc_dec->symbol_set,
-		decoded_id);
+    void	*new_symbol_buf = NULL;
+    uint8_t	*data;
+    uint32_t	size = 0;
+
+    DEBUG_PRINT("notify decoded: %u\n", decoded_id);
+    data = full_symbol_set_get_pivot_data(rlc_dec->symbol_set, decoded_id, &size);
+    if (rlc_dec->decoded_source_symbol_callback == NULL || data == NULL)
+        return;
+
+    /* the symbol stored in the linear system is owned by the codec, so give
+     * the application its own copy, in a buffer it may provide */
+    if (rlc_dec->decodable_source_symbol_callback != NULL) {
+        new_symbol_buf = rlc_dec->decodable_source_symbol_callback(
+            rlc_dec->context_4_callback, (esi_t)decoded_id);
+    }
+    if (new_symbol_buf == NULL
+        && (new_symbol_buf = swif_mem_alloc(&rlc_dec->allocator, rlc_dec->symbol_size)) == NULL) {
+        fprintf(stderr, "rlc_decoder_notify_decoded() failed! No memory\n");
+        return;
+    }
+    /* with variable-length symbols, the decoded data can be shorter than
+     * symbol_size: the remaining bytes are zero */
+    size = MIN(size, rlc_dec->symbol_size);
+    memcpy(new_symbol_buf, data, size);
+    memset((uint8_t*)new_symbol_buf + size, 0, rlc_dec->symbol_size - size);
 
-	rlc_dec->decoded_source_symbol_callback(
+    rlc_dec->decoded_source_symbol_callback(
         rlc_dec->context_4_callback,
-		full_symbol->data,
-		(esi_t)decoded_id); // XXX: esi_t is different from symbol_id_t
+        new_symbol_buf,
+        (esi_t)decoded_id); // XXX: esi_t is different from symbol_id_t
+}
+
+
+/**
+ * Internal function: map the removed callback function of full_symbol
+ * to the one of swif_rlc_decoder,
+ **/
+static void rlc_decoder_notify_removed(
+			   swif_full_symbol_set_t *set,
+			   symbol_id_t removed_id,
+			   void* dec)
+{
+    swif_decoder_rlc_cb_t *rlc_dec = (swif_decoder_rlc_cb_t *) dec;
+
+    if (rlc_dec->source_symbol_removed_from_linear_system_callback != NULL) {
+        rlc_dec->source_symbol_removed_from_linear_system_callback(
+            rlc_dec->context_4_callback, (esi_t)removed_id);
+    }
 }
 
 
@@ -170,13 +558,15 @@ swif_status_t   swif_rlc_decoder_set_callback_functions (
                                         esi_t   esi),
                 void*        context_4_callback)
 {
-// NOT YET
     swif_decoder_rlc_cb_t *rlc_dec = (swif_decoder_rlc_cb_t *) dec;
-    rlc_dec->symbol_set->notify_context = context_4_callback ;
     rlc_dec->context_4_callback = context_4_callback;
+    rlc_dec->source_symbol_removed_from_linear_system_callback =
+				source_symbol_removed_from_linear_system_callback;
+    rlc_dec->decodable_source_symbol_callback = decodable_source_symbol_callback;
     rlc_dec->decoded_source_symbol_callback = decoded_source_symbol_callback;
 	assert(rlc_dec->symbol_set != NULL);
 	rlc_dec->symbol_set->notify_decoded_func = rlc_decoder_notify_decoded;
+	rlc_dec->symbol_set->notify_removed_func = rlc_decoder_notify_removed;
 	rlc_dec->symbol_set->notify_context = (void*)rlc_dec;	
 	return SWIF_STATUS_OK;
 }
@@ -192,8 +582,79 @@ swif_status_t   swif_rlc_decoder_set_parameters  (
                                 uint32_t        length,
                                 void*           value)
 {
-// NOT YET
-	return SWIF_STATUS_OK;
+    swif_decoder_rlc_cb_t *rlc_dec = (swif_decoder_rlc_cb_t *) dec;
+
+    if (type == swif_DECODER_SET_PARAM_CODING_COEFS_CACHE) {
+        if (value == NULL || length != sizeof(swif_cc_cache_t*)) {
+            dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        rlc_dec->cc_cache = *(swif_cc_cache_t**)value;
+        return SWIF_STATUS_OK;
+    }
+    if (type == swif_DECODER_SET_PARAM_STRIPE_POOL) {
+        if (value == NULL || length != sizeof(swif_stripe_pool_t*)) {
+            dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        rlc_dec->symbol_set->stripe_pool = *(swif_stripe_pool_t**)value;
+        return SWIF_STATUS_OK;
+    }
+    if (value == NULL || length != sizeof(uint32_t)) {
+        dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+        return SWIF_STATUS_ERROR;
+    }
+    switch (type) {
+    case swif_DECODER_SET_PARAM_VARIABLE_LENGTH_SYMBOLS:
+        if (rlc_dec->symbol_set->nmbr_packets > 0) {
+            fprintf(stderr, "swif_rlc_decoder_set_parameters() failed! variable length mode must be set before decoding\n");
+            dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        rlc_dec->variable_length = (*(uint32_t*)value != 0);
+        return SWIF_STATUS_OK;
+
+    case swif_DECODER_SET_PARAM_BLOCK_DECODING:
+        if (rlc_dec->symbol_set->nmbr_packets > 0) {
+            fprintf(stderr, "swif_rlc_decoder_set_parameters() failed! block decoding must be set before decoding\n");
+            dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        rlc_dec->symbol_set->block_mode = (*(uint32_t*)value != 0);
+        if (!full_symbol_set_reserve(rlc_dec->symbol_set, rlc_dec->symbol_size)) {
+            fprintf(stderr, "swif_rlc_decoder_set_parameters() failed! No memory\n");
+            return SWIF_STATUS_ERROR;
+        }
+        return SWIF_STATUS_OK;
+
+    case swif_DECODER_SET_PARAM_PIVOT_POLICY:
+        if (*(uint32_t*)value > SWIF_PIVOT_POLICY_MIN_FILL_IN) {
+            dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        rlc_dec->symbol_set->pivot_policy = (uint8_t)*(uint32_t*)value;
+        return SWIF_STATUS_OK;
+
+    case swif_DECODER_SET_PARAM_RLC_DENSITY_THRESHOLD:
+        if (*(uint32_t*)value > 15) {
+            dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        rlc_dec->dt = (uint8_t) *(uint32_t*)value;
+        return SWIF_STATUS_OK;
+
+    case swif_DECODER_SET_PARAM_REPAIR_SYMBOL_SIZE:
+        if (*(uint32_t*)value > rlc_dec->symbol_size) {
+            dec->swif_errno = SWIF_ERRNO_INVALID_SYMBOL_LENGTH;
+            return SWIF_STATUS_ERROR;
+        }
+        rlc_dec->repair_symbol_size = *(uint32_t*)value;
+        return SWIF_STATUS_OK;
+
+    default:
+        dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+        return SWIF_STATUS_ERROR;
+    }
 }
 
 
@@ -223,13 +684,25 @@ swif_status_t   swif_rlc_decoder_decode_with_new_source_symbol (
                                 esi_t           new_symbol_esi)
 {
         swif_decoder_rlc_cb_t *rlc_dec = (swif_decoder_rlc_cb_t *) dec;
+        uint32_t symbol_size = rlc_dec->symbol_size;
+
+        if (rlc_dec->variable_length) {
+                /* only the length-prefixed bytes enter the linear system */
+                symbol_size = swif_get_symbol_length(new_symbol_buf);
+                if (symbol_size > rlc_dec->symbol_size) {
+                        fprintf(stderr, "swif_rlc_decoder_decode_with_new_source_symbol() failed! bad length prefix (%u)\n",
+                                symbol_size);
+                        dec->swif_errno = SWIF_ERRNO_INVALID_SYMBOL_LENGTH;
+                        return SWIF_STATUS_ERROR;
+                }
+        }
+        static const uint8_t one = 1;
 
-        swif_full_symbol_t *full_symbol = full_symbol_create_from_source(
-                 new_symbol_esi, new_symbol_buf, rlc_dec->symbol_size);
-        full_symbol_dump(full_symbol,stdout);
-        full_symbol_add_with_elimination(rlc_dec->symbol_set, full_symbol);
-        
-        full_symbol_free(full_symbol);
+        if (rlc_dec->verbosity > 1)
+                printf("source symbol %u (%u bytes)\n", new_symbol_esi, symbol_size);
+        /* a source symbol is the equation 1.esi, used in place */
+        full_symbol_set_add_coefs(rlc_dec->symbol_set, &one, new_symbol_esi, 1,
+                                  new_symbol_buf, symbol_size);
         
         //fprintf(stderr, "[XXX] not checking if too many stored symbols\n");
 	return SWIF_STATUS_OK;
@@ -247,12 +720,19 @@ swif_status_t   swif_rlc_decoder_decode_with_new_repair_symbol (
 {
        
     swif_decoder_rlc_cb_t *rlc_dec = (swif_decoder_rlc_cb_t *) dec;
-	//XXX;
-	swif_full_symbol_t *full_symbol = NULL;
-	full_symbol = full_symbol_create(rlc_dec->coef_tab, rlc_dec->first_id, rlc_dec->nb_id,new_symbol_buf,  rlc_dec->symbol_size);
-	full_symbol_add_with_elimination(rlc_dec->symbol_set, full_symbol);
+    const uint8_t *coef_tab = rlc_dec->coef_tab;
+    uint32_t nb_id = rlc_dec->nb_id;
 
-	full_symbol_free(full_symbol);
+    if (rlc_dec->ext_coef_tab != NULL) {
+        coef_tab = rlc_dec->ext_coef_tab;
+        nb_id = MIN(nb_id, rlc_dec->ext_nb_coefs);
+        rlc_dec->ext_coef_tab = NULL;
+    }
+    if (nb_id > 0) {
+        /* the coefficients and the repair symbol are read in place */
+        full_symbol_set_add_coefs(rlc_dec->symbol_set, coef_tab, rlc_dec->first_id,
+                                  nb_id, new_symbol_buf, rlc_dec->repair_symbol_size);
+    }
     //fprintf(stderr, "[XXX] not checking if too many stored symbols\n");
 	return SWIF_STATUS_OK;
 }
@@ -280,20 +760,14 @@ swif_status_t   swif_rlc_encoder_reset_coding_window (swif_encoder_t*  enc)
 
 swif_status_t   swif_rlc_decoder_reset_coding_window (swif_decoder_t*  dec)
 {
-// NOT YET
     swif_decoder_rlc_cb_t *rlc_dec = (swif_decoder_rlc_cb_t *) dec;
-    
-    
-    if (rlc_dec->coef_tab == NULL) {
-        /* free the structure in case of problem */
-        uint8_t *coef
-        = (uint8_t *)calloc(rlc_dec->symbol_size , sizeof(uint8_t));
-        rlc_dec->coef_tab = coef;
-    }
-    
-    memset(rlc_dec->coef_tab, 0, rlc_dec->symbol_size);
+
+    /* coef_tab holds one coefficient per source symbol of the window */
+    memset(rlc_dec->coef_tab, 0, rlc_dec->max_coding_window_size);
+    rlc_dec->ext_coef_tab = NULL;
     rlc_dec->first_id = SYMBOL_ID_NONE ; 
     rlc_dec->nb_id = 0 ; 
+    rlc_dec->repair_symbol_size = rlc_dec->symbol_size;
 	return SWIF_STATUS_OK;
 }
 
@@ -308,7 +782,23 @@ swif_status_t   swif_rlc_encoder_add_source_symbol_to_coding_window (
                                 esi_t           new_src_symbol_esi)
 {
     swif_encoder_rlc_cb_t	*enc = (swif_encoder_rlc_cb_t *) generic_enc;
-
+    uint32_t			len = 0;
+
+    if (enc->variable_length) {
+        len = swif_get_symbol_length(new_src_symbol_buf);
+        if (len > enc->symbol_size) {
+            fprintf(stderr, "swif_rlc_encoder_add_source_symbol_to_coding_window() failed! bad length prefix (%u) for esi %u\n",
+		len, new_src_symbol_esi);
+            generic_enc->swif_errno = SWIF_ERRNO_INVALID_SYMBOL_LENGTH;
+            return SWIF_STATUS_ERROR;
+        }
+    }
+    if (enc->aligned_symbols && !swif_rlc_is_aligned(new_src_symbol_buf)) {
+        fprintf(stderr, "swif_rlc_encoder_add_source_symbol_to_coding_window() failed! misaligned buffer for esi %u\n",
+		new_src_symbol_esi);
+        generic_enc->swif_errno = SWIF_ERRNO_MISALIGNED_SYMBOL_BUFFER;
+        return SWIF_STATUS_ERROR;
+    }
     if ((enc->ew_esi_right != INVALID_ESI) && (new_src_symbol_esi != enc->ew_esi_right + 1)) {
         fprintf(stderr, "swif_rlc_encoder_add_source_symbol_to_coding_window() failed! new_src_symbol_esi (%u) is not the expected value (%u)\n",
 		new_src_symbol_esi, enc->ew_esi_right + 1);
@@ -334,7 +824,11 @@ swif_status_t   swif_rlc_encoder_add_source_symbol_to_coding_window (
         enc->ew_esi_right = new_src_symbol_esi;
         enc->ew_ss_nb++;
     }
-  
+    enc->nb_added++;
+    /* in any case the new source symbol is now at index ew_right */
+    if (enc->variable_length) {
+        enc->ew_len_tab[enc->ew_right] = len;
+    }
     return SWIF_STATUS_OK;
 }
 
@@ -346,8 +840,8 @@ swif_status_t   swif_rlc_decoder_add_source_symbol_to_coding_window (
 // NOT YET
     swif_decoder_rlc_cb_t *rlc_dec = (swif_decoder_rlc_cb_t *) dec;
 
-    if (rlc_dec->first_id == SYMBOL_ID_NONE) {
-        assert(rlc_dec->nb_id == 0);
+    if (rlc_dec->nb_id == 0) {
+        /* SYMBOL_ID_NONE is also a valid esi once they wrap around */
         rlc_dec->first_id = new_src_symbol_esi ;
     }
     if ((new_src_symbol_esi - rlc_dec->first_id) <= rlc_dec->max_coding_window_size) {
@@ -393,14 +887,66 @@ swif_status_t   swif_rlc_encoder_get_coding_window_information (
                                 uint32_t*       nss)
 {
     swif_encoder_rlc_cb_t* enc = (swif_encoder_rlc_cb_t*) generic_encoder;
+    uint32_t	offset;
 
-    *first = enc->ew_esi_right - enc->ew_ss_nb + 1;
-    *last = enc->ew_esi_right;
-    *nss = enc->ew_ss_nb;
+    if (swif_rlc_encoder_repair_window(enc, &offset, nss) != SWIF_STATUS_OK) {
+        return SWIF_STATUS_FAILURE;
+    }
+    *first = enc->ew_esi_right - enc->ew_ss_nb + 1 + offset;
+    *last = *first + *nss - 1;
     return SWIF_STATUS_OK;
 }
 
 
+/**
+ * Restrict the next repair symbols to a contiguous sub-range of the
+ * coding window.
+ */
+swif_status_t   swif_rlc_encoder_set_repair_window (
+                                swif_encoder_t* generic_encoder,
+                                esi_t           first,
+                                uint32_t        nss)
+{
+    swif_encoder_rlc_cb_t* enc = (swif_encoder_rlc_cb_t*) generic_encoder;
+    esi_t	ew_first = enc->ew_esi_right - enc->ew_ss_nb + 1;
+
+    if (nss != 0 && (first - ew_first >= enc->ew_ss_nb
+                     || nss > enc->max_coding_window_size)) {
+        fprintf(stderr, "swif_rlc_encoder_set_repair_window() failed! range [%u; +%u] not in the coding window\n",
+                first, nss);
+        generic_encoder->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+        return SWIF_STATUS_ERROR;
+    }
+    enc->rw_first = first;
+    enc->rw_nss = nss;
+    return SWIF_STATUS_OK;
+}
+
+
+void            swif_rlc_encoder_get_repair_window (
+                                swif_encoder_t* generic_encoder,
+                                esi_t*          first,
+                                uint32_t*       nss)
+{
+    swif_encoder_rlc_cb_t* enc = (swif_encoder_rlc_cb_t*) generic_encoder;
+
+    *first = enc->rw_first;
+    *nss = enc->rw_nss;
+}
+
+
+void            swif_rlc_encoder_restore_repair_window (
+                                swif_encoder_t* generic_encoder,
+                                esi_t           first,
+                                uint32_t        nss)
+{
+    swif_encoder_rlc_cb_t* enc = (swif_encoder_rlc_cb_t*) generic_encoder;
+
+    enc->rw_first = first;
+    enc->rw_nss = nss;
+}
+
+
 /*******************************************************************************
  * Coding Coefficients Functions at an Encoder and Decoder
  */
@@ -419,8 +965,29 @@ swif_status_t   swif_rlc_encoder_set_coding_coefs_tab (
                                 uint32_t        nb_coefs_in_tab)
 {
     swif_encoder_rlc_cb_t *rlc_enc = (swif_encoder_rlc_cb_t *) enc;
-    assert(nb_coefs_in_tab <= rlc_enc->max_coding_window_size);
-    memcpy(rlc_enc->cc_tab, coding_coefs_tab, nb_coefs_in_tab*sizeof(uint8_t));
+    if (nb_coefs_in_tab > rlc_enc->max_coding_window_size) {
+        fprintf(stderr, "swif_rlc_encoder_set_coding_coefs_tab() failed! nb_coefs_in_tab (%u) > max_coding_window_size (%u)\n",
+                nb_coefs_in_tab, rlc_enc->max_coding_window_size);
+        enc->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+        return SWIF_STATUS_ERROR;
+    }
+    if (rlc_enc->cc_tab == NULL) {
+        rlc_enc->cc_tab = (uint8_t*) swif_mem_alloc(&rlc_enc->allocator,
+            rlc_enc->max_coding_window_size*sizeof(uint8_t));
+        if (rlc_enc->cc_tab == NULL) {
+            fprintf(stderr, "swif_rlc_encoder_set_coding_coefs_tab() failed! No memory\n");
+            return SWIF_STATUS_ERROR;
+        }
+    }
+    if (rlc_enc->m == 4) {
+        /* two coefficients per byte */
+        uint16_t size = (nb_coefs_in_tab + 1) / 2;
+        for (uint32_t i = 0; i < nb_coefs_in_tab; i++) {
+            rlc_enc->cc_tab[i] = lc_vector_get(coding_coefs_tab, size, 2, i);
+        }
+    } else {
+        memcpy(rlc_enc->cc_tab, coding_coefs_tab, nb_coefs_in_tab*sizeof(uint8_t));
+    }
 	return SWIF_STATUS_OK;
 }
 
@@ -430,7 +997,34 @@ swif_status_t   swif_rlc_decoder_set_coding_coefs_tab (
                                 void*           coding_coefs_tab,
                                 uint32_t        nb_coefs_in_tab)
 {
-// NOT YET
+    swif_decoder_rlc_cb_t *rlc_dec = (swif_decoder_rlc_cb_t *) dec;
+    rlc_dec->ext_coef_tab = NULL;
+    /* nb_coefs_in_tab comes from the received packet */
+    if (nb_coefs_in_tab > rlc_dec->max_coding_window_size) {
+        fprintf(stderr, "swif_rlc_decoder_set_coding_coefs_tab() failed! nb_coefs_in_tab (%u) > max_coding_window_size (%u)\n",
+                nb_coefs_in_tab, rlc_dec->max_coding_window_size);
+        dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+        return SWIF_STATUS_ERROR;
+    }
+    if (rlc_dec->m == 4) {
+        /* two coefficients per byte */
+        if (rlc_dec->coef_tab == NULL) {
+            rlc_dec->coef_tab = (uint8_t*) swif_mem_alloc(&rlc_dec->allocator,
+                rlc_dec->max_coding_window_size*sizeof(uint8_t));
+            if (rlc_dec->coef_tab == NULL) {
+                fprintf(stderr, "swif_rlc_decoder_set_coding_coefs_tab() failed! No memory\n");
+                return SWIF_STATUS_ERROR;
+            }
+        }
+        uint16_t size = (nb_coefs_in_tab + 1) / 2;
+        for (uint32_t i = 0; i < nb_coefs_in_tab; i++) {
+            rlc_dec->coef_tab[i] = lc_vector_get(coding_coefs_tab, size, 2, i);
+        }
+    } else {
+        /* one coefficient per byte: borrow the caller's table */
+        rlc_dec->ext_coef_tab = coding_coefs_tab;
+        rlc_dec->ext_nb_coefs = nb_coefs_in_tab;
+    }
 	return SWIF_STATUS_OK;
 }
 
@@ -455,8 +1049,7 @@ swif_status_t   swif_rlc_encoder_generate_coding_coefs (
         swif_encoder_rlc_cb_t *rlc_enc = (swif_encoder_rlc_cb_t *) enc;
         
         if (rlc_enc->cc_tab == NULL) {
-                /* XXX: need to use allocation functions */
-                rlc_enc->cc_tab = (uint8_t*) malloc(
+                rlc_enc->cc_tab = (uint8_t*) swif_mem_alloc(&rlc_enc->allocator,
                     rlc_enc->max_coding_window_size*sizeof(uint8_t) );
                 if (rlc_enc->cc_tab == NULL) {
                         fprintf(stderr, "Error, swif_rlc_encoder_generate_"
@@ -465,12 +1058,16 @@ swif_status_t   swif_rlc_encoder_generate_coding_coefs (
                 }
         }
 
-        assert(rlc_enc->ew_ss_nb <= rlc_enc->max_coding_window_size);
-        swif_rlc_generate_coding_coefficients (
+        uint32_t offset, nss;
+        if (swif_rlc_encoder_repair_window(rlc_enc, &offset, &nss) != SWIF_STATUS_OK) {
+                return SWIF_STATUS_FAILURE;
+        }
+        assert(nss <= rlc_enc->max_coding_window_size);
+        swif_cc_cache_get_coding_coefficients (rlc_enc->cc_cache,
             (uint16_t)key, rlc_enc->cc_tab,
-            rlc_enc->ew_ss_nb, /* upper bound: enc->max_window_size */
-            15 /* density dt [0-15] XXX dt=1*/,
-            8 /*=m - GF(2^^m) */);
+            nss, /* upper bound: enc->max_window_size */
+            rlc_enc->dt /* density dt [0-15] */,
+            rlc_enc->m /* GF(2^^m) */);
        
 	return SWIF_STATUS_OK;
 }
@@ -486,8 +1083,7 @@ swif_status_t   swif_rlc_decoder_generate_coding_coefs (
         DEBUG_PRINT("generate coding coefs: ");
         swif_decoder_rlc_cb_t *rlc_dec = (swif_decoder_rlc_cb_t *) dec; 
         if (rlc_dec->coef_tab == NULL) {
-                /* XXX: need to use allocation functions */
-                rlc_dec->coef_tab = (uint8_t*) malloc(
+                rlc_dec->coef_tab = (uint8_t*) swif_mem_alloc(&rlc_dec->allocator,
                     rlc_dec->max_coding_window_size*sizeof(uint8_t) );
                 if (rlc_dec->coef_tab == NULL) {
                         fprintf(stderr, "Error, swif_rlc_decoder_generate_"
@@ -497,11 +1093,12 @@ swif_status_t   swif_rlc_decoder_generate_coding_coefs (
         }
 
         assert(rlc_dec->nb_id <= rlc_dec->max_coding_window_size);
-        swif_rlc_generate_coding_coefficients (
+        rlc_dec->ext_coef_tab = NULL;
+        swif_cc_cache_get_coding_coefficients (rlc_dec->cc_cache,
             (uint16_t)key, rlc_dec->coef_tab,
             rlc_dec->nb_id, /* upper bound: enc->max_window_size */
-            15 /* density dt [0-15] XXX dt=1*/  ,
-            8 /*=m - GF(2^^m) */);
+            rlc_dec->dt /* density dt [0-15] */,
+            rlc_dec->m /* GF(2^^m) */);
         DEBUG_DUMP(rlc_dec->coef_tab, rlc_dec->nb_id);
     	return SWIF_STATUS_OK;
 }
@@ -519,7 +1116,29 @@ swif_status_t   swif_rlc_encoder_get_coding_coefs_tab (
                                 void**          coding_coefs_tab,
                                 uint32_t*       nb_coefs_in_tab)
 {
-// NOT YET
+    swif_encoder_rlc_cb_t *rlc_enc = (swif_encoder_rlc_cb_t *) enc;
+    uint32_t	offset;
+
+    if (swif_rlc_encoder_repair_window(rlc_enc, &offset, nb_coefs_in_tab) != SWIF_STATUS_OK) {
+        return SWIF_STATUS_FAILURE;
+    }
+    if (rlc_enc->m != 4) {
+        *coding_coefs_tab = rlc_enc->cc_tab;
+        return SWIF_STATUS_OK;
+    }
+    /* two coefficients per byte */
+    if (rlc_enc->packed_cc_tab == NULL
+        && (rlc_enc->packed_cc_tab = swif_mem_alloc(&rlc_enc->allocator,
+                                                    (rlc_enc->max_coding_window_size + 1) / 2)) == NULL) {
+        fprintf(stderr, "swif_rlc_encoder_get_coding_coefs_tab failed! No memory\n");
+        return SWIF_STATUS_ERROR;
+    }
+    uint16_t size = (*nb_coefs_in_tab + 1) / 2;
+    memset(rlc_enc->packed_cc_tab, 0, size);
+    for (uint32_t i = 0; i < *nb_coefs_in_tab; i++) {
+        lc_vector_set(rlc_enc->packed_cc_tab, size, 2, i, rlc_enc->cc_tab[i]);
+    }
+    *coding_coefs_tab = rlc_enc->packed_cc_tab;
 	return SWIF_STATUS_OK;
 }
 
@@ -536,25 +1155,58 @@ swif_encoder_t* swif_rlc_encoder_create (swif_codepoint_t codepoint,
                                          uint32_t        verbosity,
                                          uint32_t        symbol_size,
                                          uint32_t        max_coding_window_size)
+{
+    return swif_rlc_encoder_create_with_allocator(codepoint, verbosity, symbol_size,
+                                                  max_coding_window_size, NULL);
+}
+
+
+swif_encoder_t* swif_rlc_encoder_create_with_allocator (
+                                swif_codepoint_t codepoint,
+                                uint32_t        verbosity,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size,
+                                const swif_allocator_t* allocator)
 {
     swif_encoder_rlc_cb_t*	enc;
 
+    if (allocator == NULL) {
+        allocator = &swif_default_allocator;
+    }
     /* initialize the encoder */
-    assert(codepoint == SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC);
-    if ((enc = calloc(1,sizeof(swif_encoder_rlc_cb_t))) == NULL){
+    assert(codepoint == SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC
+           || codepoint == SWIF_CODEPOINT_RLC_GF_2_CODEC
+           || codepoint == SWIF_CODEPOINT_RLC_GF_16_CODEC);
+    if ((enc = swif_mem_calloc(allocator, 1, sizeof(swif_encoder_rlc_cb_t))) == NULL){
         fprintf(stderr, "swif_encoder_create() failed! No memory \n");
         return NULL;
     }
+    enc->allocator = *allocator;
     enc->generic_encoder.codepoint = codepoint;
+    swif_rlc_codepoint_params(codepoint, &enc->m, &enc->dt);
+    enc->verbosity = verbosity;
     enc->symbol_size = symbol_size;
+    enc->padded_symbol_size = SWIF_SYMBOL_PADDED_SIZE(symbol_size);
+    swif_rlc_encoder_select_kernels(enc);
+    enc->repair_symbol_size = symbol_size;
     enc->max_coding_window_size = max_coding_window_size;
-    if ((enc->cc_tab = calloc(max_coding_window_size, sizeof(uint8_t))) == NULL){
+    if ((enc->cc_tab = swif_mem_calloc(allocator, max_coding_window_size, sizeof(uint8_t))) == NULL){
         fprintf(stderr, "swif_encoder_create cc_tab failed! No memory \n");
+        swif_rlc_encoder_release((swif_encoder_t*)enc);
         return NULL;
     }
 
-    if ((enc->ew_tab = calloc(max_coding_window_size, sizeof(uintptr_t))) == NULL){
+    if ((enc->ew_tab = swif_mem_calloc(allocator, max_coding_window_size, sizeof(uintptr_t))) == NULL){
         fprintf(stderr, "swif_encoder_create ew_tab failed! No memory \n");
+        swif_rlc_encoder_release((swif_encoder_t*)enc);
+        return NULL;
+    }
+    /* GF(2^^4) coefficients are given to the application packed, see
+     * swif_rlc_encoder_get_coding_coefs_tab() */
+    if (enc->m == 4
+        && (enc->packed_cc_tab = swif_mem_calloc(allocator, (max_coding_window_size + 1) / 2, 1)) == NULL) {
+        fprintf(stderr, "swif_encoder_create packed_cc_tab failed! No memory \n");
+        swif_rlc_encoder_release((swif_encoder_t*)enc);
         return NULL;
     }
     enc->ew_right = enc->ew_left = 0;
@@ -575,6 +1227,8 @@ swif_encoder_t* swif_rlc_encoder_create (swif_codepoint_t codepoint,
     enc->generic_encoder.set_coding_coefs_tab		= swif_rlc_encoder_set_coding_coefs_tab;
     enc->generic_encoder.generate_coding_coefs		= swif_rlc_encoder_generate_coding_coefs;
     enc->generic_encoder.get_coding_coefs_tab		= swif_rlc_encoder_get_coding_coefs_tab;
+    enc->generic_encoder.set_repair_window		= swif_rlc_encoder_set_repair_window;
+    enc->generic_encoder.build_layer_repair_symbols	= swif_rlc_build_layer_repair_symbols;
     return (swif_encoder_t *) enc;
 }
 
@@ -588,20 +1242,61 @@ swif_decoder_t* swif_rlc_decoder_create (
                                 uint32_t        symbol_size,
                                 uint32_t        max_coding_window_size,
                                 uint32_t        max_linear_system_size)
+{
+    return swif_rlc_decoder_create_with_allocator(codepoint, verbosity, symbol_size,
+                                                  max_coding_window_size,
+                                                  max_linear_system_size, NULL);
+}
+
+
+swif_decoder_t* swif_rlc_decoder_create_with_allocator (
+                                swif_codepoint_t codepoint,
+                                uint32_t        verbosity,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size,
+                                uint32_t        max_linear_system_size,
+                                const swif_allocator_t* allocator)
 {
     swif_decoder_rlc_cb_t*	dec;
 
+    if (allocator == NULL) {
+        allocator = &swif_default_allocator;
+    }
     /* initialize the decoder */
-    assert(codepoint == SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC);
-    if ((dec = calloc(1,sizeof(swif_decoder_rlc_cb_t))) == NULL) {
+    assert(codepoint == SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC
+           || codepoint == SWIF_CODEPOINT_RLC_GF_16_CODEC);
+    if ((dec = swif_mem_calloc(allocator, 1, sizeof(swif_decoder_rlc_cb_t))) == NULL) {
         fprintf(stderr, "swif_decoder_create() failed! No memory \n");
         return NULL;
     }
+    dec->allocator = *allocator;
     dec->generic_decoder.codepoint = codepoint;
+    dec->verbosity = verbosity;
+    swif_rlc_codepoint_params(codepoint, &dec->m, &dec->dt);
     dec->symbol_size = symbol_size;
+    dec->repair_symbol_size = symbol_size;
     dec->max_coding_window_size = max_coding_window_size;
     dec->max_linear_system_size = max_linear_system_size;
-    dec->symbol_set = full_symbol_set_alloc();
+    /* the linear system covers the largest of the two windows */
+    if ((dec->symbol_set = full_symbol_set_alloc_with_allocator(
+             MAX(max_linear_system_size, max_coding_window_size), allocator)) == NULL) {
+        fprintf(stderr, "swif_decoder_create symbol_set failed! No memory \n");
+        swif_rlc_decoder_release((swif_decoder_t*)dec);
+        return NULL;
+    }
+    /* all the symbol memory now, none while decoding */
+    dec->symbol_set->log2_nb_bit_coef = swif_rlc_log2_nb_bit_coef(dec->m);
+    if (!full_symbol_set_reserve(dec->symbol_set, symbol_size)) {
+        fprintf(stderr, "swif_decoder_create symbol_set failed! No memory \n");
+        swif_rlc_decoder_release((swif_decoder_t*)dec);
+        return NULL;
+    }
+    if ((dec->coef_tab = swif_mem_calloc(allocator, max_coding_window_size, sizeof(uint8_t))) == NULL) {
+        fprintf(stderr, "swif_decoder_create coef_tab failed! No memory \n");
+        swif_rlc_decoder_release((swif_decoder_t*)dec);
+        return NULL;
+    }
+    dec->first_id = SYMBOL_ID_NONE;
 #if 0
     dec->ew_right = dec->ew_left = 0;
     dec->ew_esi_right = INVALID_ESI;
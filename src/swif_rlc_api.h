@@ -56,6 +56,16 @@ swif_status_t   swif_rlc_build_repair_symbol (
                                 void**           new_buf);
 
 
+/**
+ * Create one repair symbol for each selected layer in a single pass.
+ */
+swif_status_t   swif_rlc_build_layer_repair_symbols (
+                                swif_encoder_t* generic_encoder,
+                                uint32_t        layer_mask,
+                                const uint32_t* key_tab,
+                                void**          new_buf_tab);
+
+
 /*******************************************************************************
  * Decoder functions
  */
@@ -185,6 +195,32 @@ swif_status_t   swif_rlc_encoder_get_coding_window_information (
                                 uint32_t*       nss);
 
 
+/**
+ * Restrict the next repair symbols to a contiguous sub-range of the
+ * coding window.
+ */
+swif_status_t   swif_rlc_encoder_set_repair_window (
+                                swif_encoder_t* generic_encoder,
+                                esi_t           first,
+                                uint32_t        nss);
+
+/**
+ * Save the range selected by swif_rlc_encoder_set_repair_window() ({0, 0}
+ * if none), and restore it after building repair symbols of another
+ * range, e.g. in the group encoder. The restored range is not checked
+ * again: it may have partly left the coding window in the meantime.
+ */
+void            swif_rlc_encoder_get_repair_window (
+                                swif_encoder_t* generic_encoder,
+                                esi_t*          first,
+                                uint32_t*       nss);
+
+void            swif_rlc_encoder_restore_repair_window (
+                                swif_encoder_t* generic_encoder,
+                                esi_t           first,
+                                uint32_t        nss);
+
+
 /*******************************************************************************
  * Coding Coefficients Functions at an Encoder and Decoder
  */
@@ -256,6 +292,16 @@ swif_encoder_t* swif_rlc_encoder_create (swif_codepoint_t codepoint,
                                          uint32_t        symbol_size,
                                          uint32_t        max_coding_window_size);
 
+/**
+ * Same, with the allocator of the encoder (NULL for the default one).
+ **/
+swif_encoder_t* swif_rlc_encoder_create_with_allocator (
+                                swif_codepoint_t codepoint,
+                                uint32_t        verbosity,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size,
+                                const swif_allocator_t* allocator);
+
 
 /**
  * Create and initialize a decoder, providing only key parameters.
@@ -266,4 +312,15 @@ swif_decoder_t* swif_rlc_decoder_create (
                                 uint32_t        symbol_size,
                                 uint32_t        max_coding_window_size,
                                 uint32_t        max_linear_system_size);
+
+/**
+ * Same, with the allocator of the decoder (NULL for the default one).
+ */
+swif_decoder_t* swif_rlc_decoder_create_with_allocator (
+                                swif_codepoint_t codepoint,
+                                uint32_t        verbosity,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size,
+                                uint32_t        max_linear_system_size,
+                                const swif_allocator_t* allocator);
 #endif
@@ -5,6 +5,42 @@
 
 #include "swif_full_symbol.h"
 
+/**
+ * Finite field GF(2^^m) (m = 1, 4 or 8) and default density threshold of
+ * the coding coefficients of an RLC codepoint. Returns false if the
+ * codepoint is not an RLC one.
+ */
+static inline bool swif_rlc_codepoint_params (swif_codepoint_t	codepoint,
+					      uint8_t*		m,
+					      uint8_t*		dt)
+{
+	switch (codepoint) {
+	case SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC:
+		*m = 8;
+		*dt = 15;
+		return true;
+	case SWIF_CODEPOINT_RLC_GF_16_CODEC:
+		*m = 4;
+		*dt = 15;
+		return true;
+	case SWIF_CODEPOINT_RLC_GF_2_CODEC:
+		/* with dt=15 all GF(2) coefficients would be 1 */
+		*m = 1;
+		*dt = 7;
+		return true;
+	default:
+		return false;
+	}
+}
+
+/**
+ * Finite field GF(2^^m) as the `log2_nb_bit_coef' of swif_linear-code.h.
+ */
+static inline uint8_t swif_rlc_log2_nb_bit_coef (uint8_t m)
+{
+	return (m == 1) ? 0 : ((m == 4) ? 2 : 3);
+}
+
 /**
  * Control block for an RLC encoder.
  * Encoder structure that contains whatever is needed for encoding.
@@ -26,8 +62,17 @@ typedef struct swif_encoder_rlc_cb {
 	/* exact size (in bytes) of any source or repair symbol */
 	uint32_t		symbol_size;
 
+	/* finite field GF(2^^m) (1, 4 or 8) and density threshold (0 to 15)
+	 * of the coding coefficients */
+	uint8_t			m;
+	uint8_t			dt;
+
 	/* coding coefficients table. To be initialized before building a new repair symbol */
 	uint8_t*		cc_tab;
+
+	/* cc_tab packed two coefficients per byte, as returned by
+	 * get_coding_coefs_tab() with GF(2^^4). Allocated on first use. */
+	uint8_t*		packed_cc_tab;
 	
 	/* pointer to the table containing source symbols */
 	void**			ew_tab;
@@ -48,6 +93,59 @@ typedef struct swif_encoder_rlc_cb {
 	*/
 	uint32_t 		ew_ss_nb;
 
+	/* true if source symbols are length-prefixed (see
+	 * SWIF_LENGTH_PREFIX_SIZE), false if they are all symbol_size long */
+	bool			variable_length;
+
+	/* meaningful size (in bytes) of each source symbol, at the same
+	 * index as in ew_tab. Only allocated with variable_length. */
+	uint32_t*		ew_len_tab;
+
+	/* all the symbol buffers come from swif_symbol_buffer_alloc(), see
+	 * swif_ENCODER_SET_PARAM_ALIGNED_SYMBOLS: symbols are processed over
+	 * padded_symbol_size bytes with the aligned kernels */
+	bool			aligned_symbols;
+	uint32_t		padded_symbol_size;
+
+	/* meaningful size (in bytes) of the last repair symbol built */
+	uint32_t		repair_symbol_size;
+
+	/* sub-range of the coding window covered by the next repair
+	 * symbols, see swif_encoder_set_repair_window(). rw_nss == 0 means
+	 * the whole coding window. */
+	esi_t			rw_first;
+	uint32_t		rw_nss;
+
+	/* nested coding windows, see swif_ENCODER_SET_PARAM_LAYERS, with
+	 * the coding coefficients of each one (max_coding_window_size
+	 * per layer) and the size of their last repair symbol */
+	uint32_t		nb_layers;
+	swif_encoder_layer_t	layer_tab[SWIF_MAX_ENCODER_LAYERS];
+	uint8_t*		layer_cc_tab;
+	uint32_t		layer_repair_size_tab[SWIF_MAX_ENCODER_LAYERS];
+
+	/* number of source symbols added so far, for the layer periods */
+	uint32_t		nb_added;
+
+	/* optional coding coefficients cache, not owned by the encoder */
+	swif_cc_cache_t*	cc_cache;
+
+	/* allocator of all the memory of the encoder, see swif_allocator_t */
+	swif_allocator_t	allocator;
+
+	/* optional stripe pool, not owned by the encoder */
+	swif_stripe_pool_t*	stripe_pool;
+
+	/* kernels specialised for the symbol size, NULL if there are none
+	 * (see lc_get_kernels()). Whole symbols only. */
+	const struct symbol_kernels*	kernels;
+
+	/* repair window of the repair symbol being built, and its buffer,
+	 * for swif_rlc_build_repair_range() */
+	uint32_t		build_offset;
+	uint32_t		build_nss;
+	uint8_t*		build_buf;
+
 	void (*source_symbol_removed_from_coding_window_callback) (
                                         void*   context,
                                         esi_t   old_symbol_esi);
@@ -85,18 +183,42 @@ typedef struct swif_decoder_rlc_cb {
 	/* exact size (in bytes) of any source or repair symbol */
 	uint32_t		symbol_size;
 
+	/* finite field GF(2^^m) (4 or 8) and density threshold (0 to 15)
+	 * of the coding coefficients */
+	uint8_t			m;
+	uint8_t			dt;
+
 	/* set of packets being decoded through gaussian elimination */
         swif_full_symbol_set_t *symbol_set;
 
 	/* coding coefficients table. To be initialized before building a new repair symbol */
 	uint8_t*		coef_tab;
+	/* coefficients provided by set_coding_coefs_tab(), used in place
+	 * of coef_tab without any copy. Only borrowed until the repair
+	 * symbol is submitted, or the coding window is reset. */
+	const uint8_t*		ext_coef_tab;
+	uint32_t		ext_nb_coefs;
 	/* the index of the first source symbol (included) */
 	uint32_t 		first_id;
 	/** number of symbols currently in the encoding window 
 	* useful to differentiate the state of the buffer
 	*/
 	uint32_t 		nb_id;
-        
+
+	/* true if source symbols are length-prefixed (see
+	 * SWIF_LENGTH_PREFIX_SIZE), false if they are all symbol_size long */
+	bool			variable_length;
+
+	/* size (in bytes) of the repair symbol under preparation, as
+	 * received. Reset to symbol_size with the coding window. */
+	uint32_t		repair_symbol_size;
+
+	/* optional coding coefficients cache, not owned by the decoder */
+	swif_cc_cache_t*	cc_cache;
+
+	/* allocator of all the memory of the decoder, see swif_allocator_t */
+	swif_allocator_t	allocator;
+
 	void (*source_symbol_removed_from_linear_system_callback) (
 					void*   context,
 					esi_t   old_symbol_esi);
@@ -113,3 +235,119 @@ typedef struct swif_decoder_rlc_cb {
 	
 	/* add whatever may be needed hereafter... */
 } swif_decoder_rlc_cb_t;
+
+
+/**
+ * Control block for an RLC GF(2) decoder.
+ * Coefficients being bits, each equation of the linear system is stored
+ * as a bitset (one bit per column, i.e. per source symbol) and a symbol,
+ * and elimination only uses 64-bit XORs on both. The linear system is
+ * kept fully reduced: each row has a pivot column that is zero in all
+ * other rows, so a row with a single bit set is a decoded source symbol.
+ * The column of source symbol esi is esi % nb_cols, so that columns are
+ * recycled as the window slides, without moving any data, nb_cols being
+ * a power of two so that this still holds when the esi wraps around.
+ * The first field of this structure is the generic swif decoder.
+ */
+typedef struct swif_decoder_rlc_gf2_cb {
+	/* generic part of any control block. MUST be first in structure */
+	swif_decoder_t		generic_decoder;
+
+	/* desired verbosity: 0 is the minimum verbosity, the maximum
+	 * level being implementation specific. */
+	uint32_t		verbosity;
+
+	/* maximum number of source symbols used for any repair symbol */
+	uint32_t		max_coding_window_size;
+
+	/* maximum number of source symbols kept in the linear system */
+	uint32_t		max_linear_system_size;
+
+	/* exact size (in bytes) of any source or repair symbol */
+	uint32_t		symbol_size;
+
+	/* density threshold (0 to 15) of the coding coefficients */
+	uint8_t			dt;
+
+	/* true if source symbols are length-prefixed (see
+	 * SWIF_LENGTH_PREFIX_SIZE), false if they are all symbol_size long */
+	bool			variable_length;
+
+	/* size (in bytes) of the repair symbol under preparation, as
+	 * received. Reset to symbol_size with the coding window. */
+	uint32_t		repair_symbol_size;
+
+	/* optional coding coefficients cache, not owned by the decoder */
+	swif_cc_cache_t*	cc_cache;
+
+	/* allocator of all the memory of the decoder, see swif_allocator_t */
+	swif_allocator_t	allocator;
+
+	/* optional stripe pool, not owned by the decoder */
+	swif_stripe_pool_t*	stripe_pool;
+
+	/* kernels specialised for data_stride, NULL if there are none */
+	const struct symbol_kernels*	kernels;
+
+	/* coding window of the repair symbol under preparation: esi of
+	 * the first source symbol, number of source symbols, and their
+	 * coefficients (0 or 1, one byte each) */
+	esi_t			first_id;
+	uint32_t		nb_id;
+	uint8_t*		coef_tab;
+
+	/* coefficients provided by set_coding_coefs_tab(), borrowed without
+	 * any copy until the repair symbol is submitted */
+	const uint8_t*		ext_coef_tab;
+	uint32_t		ext_nb_coefs;
+
+	/* number of columns (power of two, at least 64) and of 64-bit words
+	 * per row */
+	uint32_t		nb_cols;
+	uint32_t		nb_words;
+
+	/* most recent esi seen, if has_last_id (INVALID_ESI is also a valid
+	 * esi). Only source symbols in [last_id - nb_cols + 1; last_id]
+	 * (modulo 2^32) are in the linear system */
+	esi_t			last_id;
+	bool			has_last_id;
+
+	/* rows: nb_cols bitsets of nb_words words, and nb_cols symbols,
+	 * aligned and zero-padded to data_stride (see swif_symbol_buffer_alloc) */
+	uint64_t*		row_coef_tab;
+	uint8_t*		row_data_tab;
+	uint32_t		data_stride;
+
+	/* row whose pivot is a given column (GF2_NO_ROW if none), and bitset
+	 * of these pivot columns */
+	uint32_t*		pivot_row_tab;
+	uint64_t*		pivot_mask;
+
+	/* pivot column of each row in use */
+	uint32_t*		row_pivot_tab;
+
+	/* bitset of the columns whose source symbol is already known by
+	 * the application (received or decoded) */
+	uint64_t*		known_mask;
+
+	/* stack of unused rows */
+	uint32_t*		free_row_tab;
+	uint32_t		nb_free_rows;
+
+	/* equation being added to the system */
+	uint64_t*		tmp_coef;
+	uint8_t*		tmp_data;
+
+	void (*source_symbol_removed_from_linear_system_callback) (
+					void*   context,
+					esi_t   old_symbol_esi);
+	void* (*decodable_source_symbol_callback) (
+					void    *context,
+					esi_t   esi);
+	void* (*decoded_source_symbol_callback) (
+					void    *context,
+					void    *new_symbol_buf,
+					esi_t   esi);
+
+	void*			context_4_callback;
+} swif_decoder_rlc_gf2_cb_t;
@@ -0,0 +1,123 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+#ifndef SWIF_RLC_FAST_H
+#define SWIF_RLC_FAST_H
+#include "swif_api.h"
+#include "swif_rlc_api.h"
+#include "swif_rlc_gf2_decoder.h"
+
+
+/**
+ * Direct (devirtualised) fast path of the RLC codec.
+ * The swif_*() functions of swif_api.h call the codec through the
+ * function pointers of swif_encoder_t and swif_decoder_t, i.e. one
+ * indirect call per symbol operation, that the compiler can't inline.
+ * These static inline functions are the same operations, for the
+ * encoders and decoders of the SWIF_CODEPOINT_RLC_* codepoints (that is
+ * any swif_encoder_create() or swif_decoder_create() instance), with
+ * direct calls to the RLC implementation instead. Only the decoder
+ * selects its implementation, with a well predicted branch on the
+ * codepoint.
+ * With the library built with WITH_LTO=1 (see src/Makefile) and the
+ * application linked with -flto, these calls can be inlined into the
+ * application. Instances created otherwise (e.g. with swif_engine.h) keep
+ * using swif_api.h.
+ */
+
+static inline swif_status_t swif_fast_encoder_add_source_symbol_to_coding_window (
+                                swif_encoder_t* enc,
+                                void*           new_src_symbol_buf,
+                                esi_t           new_src_symbol_esi)
+{
+    return swif_rlc_encoder_add_source_symbol_to_coding_window(enc, new_src_symbol_buf,
+                                                               new_src_symbol_esi);
+}
+
+static inline swif_status_t swif_fast_encoder_remove_source_symbol_from_coding_window (
+                                swif_encoder_t* enc,
+                                esi_t           old_src_symbol_esi)
+{
+    return swif_rlc_encoder_remove_source_symbol_from_coding_window(enc, old_src_symbol_esi);
+}
+
+static inline swif_status_t swif_fast_encoder_generate_coding_coefs (
+                                swif_encoder_t* enc,
+                                uint32_t        key,
+                                uint32_t        add_param)
+{
+    return swif_rlc_encoder_generate_coding_coefs(enc, key, add_param);
+}
+
+static inline swif_status_t swif_fast_build_repair_symbol (
+                                swif_encoder_t* enc,
+                                void**          new_buf)
+{
+    return swif_rlc_build_repair_symbol(enc, new_buf);
+}
+
+static inline swif_status_t swif_fast_encoder_get_coding_window_information (
+                                swif_encoder_t* enc,
+                                esi_t*          first,
+                                esi_t*          last,
+                                uint32_t*       nss)
+{
+    return swif_rlc_encoder_get_coding_window_information(enc, first, last, nss);
+}
+
+
+static inline swif_status_t swif_fast_decoder_decode_with_new_source_symbol (
+                                swif_decoder_t* dec,
+                                void* const     new_symbol_buf,
+                                esi_t           new_symbol_esi)
+{
+    if (dec->codepoint == SWIF_CODEPOINT_RLC_GF_2_CODEC) {
+        return swif_rlc_gf2_decoder_decode_with_new_source_symbol(dec, new_symbol_buf, new_symbol_esi);
+    }
+    return swif_rlc_decoder_decode_with_new_source_symbol(dec, new_symbol_buf, new_symbol_esi);
+}
+
+static inline swif_status_t swif_fast_decoder_decode_with_new_repair_symbol (
+                                swif_decoder_t* dec,
+                                void* const     new_symbol_buf,
+                                esi_t           new_src_symbol_esi)
+{
+    if (dec->codepoint == SWIF_CODEPOINT_RLC_GF_2_CODEC) {
+        return swif_rlc_gf2_decoder_decode_with_new_repair_symbol(dec, new_symbol_buf, new_src_symbol_esi);
+    }
+    return swif_rlc_decoder_decode_with_new_repair_symbol(dec, new_symbol_buf, new_src_symbol_esi);
+}
+
+static inline swif_status_t swif_fast_decoder_reset_coding_window (
+                                swif_decoder_t* dec)
+{
+    if (dec->codepoint == SWIF_CODEPOINT_RLC_GF_2_CODEC) {
+        return swif_rlc_gf2_decoder_reset_coding_window(dec);
+    }
+    return swif_rlc_decoder_reset_coding_window(dec);
+}
+
+static inline swif_status_t swif_fast_decoder_add_source_symbol_to_coding_window (
+                                swif_decoder_t* dec,
+                                esi_t           new_src_symbol_esi)
+{
+    if (dec->codepoint == SWIF_CODEPOINT_RLC_GF_2_CODEC) {
+        return swif_rlc_gf2_decoder_add_source_symbol_to_coding_window(dec, new_src_symbol_esi);
+    }
+    return swif_rlc_decoder_add_source_symbol_to_coding_window(dec, new_src_symbol_esi);
+}
+
+static inline swif_status_t swif_fast_decoder_generate_coding_coefs (
+                                swif_decoder_t* dec,
+                                uint32_t        key,
+                                uint32_t        add_param)
+{
+    if (dec->codepoint == SWIF_CODEPOINT_RLC_GF_2_CODEC) {
+        return swif_rlc_gf2_decoder_generate_coding_coefs(dec, key, add_param);
+    }
+    return swif_rlc_decoder_generate_coding_coefs(dec, key, add_param);
+}
+
+#endif /* SWIF_RLC_FAST_H */
@@ -0,0 +1,654 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+/**
+ * RLC decoder over GF(2): see swif_decoder_rlc_gf2_cb_t.
+ */
+
+#include "swif_includes.h"
+#include "swif_rlc_gf2_decoder.h"
+
+#define GF2_NO_ROW		((uint32_t)-1)
+#define GF2_NO_COL		((uint32_t)-1)
+
+#define BIT_WORD(col)	((col) >> 6)
+#define BIT_MASK(col)	(UINT64_C(1) << ((col) & 63))
+
+
+/*******************************************************************************
+ * Bitset and linear system helpers
+ */
+
+static inline uint32_t gf2_ctz (uint64_t w)
+{
+#if defined(__GNUC__)
+    return (uint32_t)__builtin_ctzll(w);
+#else
+    uint32_t n = 0;
+    while ((w & 1) == 0) {
+        w >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+static inline uint32_t gf2_popcount (uint64_t w)
+{
+#if defined(__GNUC__)
+    return (uint32_t)__builtin_popcountll(w);
+#else
+    uint32_t n = 0;
+    for (; w != 0; w &= w - 1)
+        n++;
+    return n;
+#endif
+}
+
+static inline uint64_t* gf2_row_coef (swif_decoder_rlc_gf2_cb_t* dec, uint32_t row)
+{
+    return dec->row_coef_tab + (size_t)row * dec->nb_words;
+}
+
+static inline uint8_t* gf2_row_data (swif_decoder_rlc_gf2_cb_t* dec, uint32_t row)
+{
+    return dec->row_data_tab + (size_t)row * dec->data_stride;
+}
+
+/* data1 += data2, over aligned rows */
+static inline void gf2_xor (swif_decoder_rlc_gf2_cb_t* dec, uint8_t* data1, uint8_t* data2)
+{
+    if (dec->kernels != NULL && dec->stripe_pool == NULL) {
+        dec->kernels->add_mul(1, data2, data1);
+    } else {
+        swif_stripe_xor(dec->stripe_pool, data1, data2, dec->data_stride);
+    }
+}
+
+/* nb_cols is a power of two, so that consecutive esi stay in consecutive
+ * columns when the esi wraps around 2^32 */
+static inline uint32_t gf2_col (swif_decoder_rlc_gf2_cb_t* dec, esi_t esi)
+{
+    return esi & (dec->nb_cols - 1);
+}
+
+/* esi of the source symbol currently associated to a column */
+static inline esi_t gf2_col_esi (swif_decoder_rlc_gf2_cb_t* dec, uint32_t col)
+{
+    return dec->last_id - ((dec->last_id - col) & (dec->nb_cols - 1));
+}
+
+/* esi are compared through their difference with last_id, modulo 2^32 */
+static inline bool gf2_in_system (swif_decoder_rlc_gf2_cb_t* dec, esi_t esi)
+{
+    return (dec->has_last_id && (esi_t)(dec->last_id - esi) < dec->nb_cols);
+}
+
+/* first bit set at or after column from, GF2_NO_COL if none */
+static uint32_t gf2_find_first_set (const uint64_t* bits, uint32_t nb_words, uint32_t from)
+{
+    uint32_t w = BIT_WORD(from);
+    uint64_t m = bits[w] & (~UINT64_C(0) << (from & 63));
+
+    for (;;) {
+        if (m != 0)
+            return (w << 6) + gf2_ctz(m);
+        if (++w == nb_words)
+            return GF2_NO_COL;
+        m = bits[w];
+    }
+}
+
+static void gf2_remove_row (swif_decoder_rlc_gf2_cb_t* dec, uint32_t row)
+{
+    uint32_t col = dec->row_pivot_tab[row];
+
+    dec->pivot_row_tab[col] = GF2_NO_ROW;
+    dec->pivot_mask[BIT_WORD(col)] &= ~BIT_MASK(col);
+    dec->free_row_tab[dec->nb_free_rows++] = row;
+}
+
+/*
+ * This column is about to be reused: remove every reference to its
+ * current source symbol, as the GF(2^m) decoder does. When it is the pivot
+ * of an equation, the other equations don't refer to it. Otherwise, the
+ * first equation that refers to it is used to remove it from the others,
+ * then dropped: its own pivot becomes an unknown without equation.
+ * Must be called before last_id is updated.
+ */
+static void gf2_evict (swif_decoder_rlc_gf2_cb_t* dec, uint32_t col)
+{
+    uint32_t	nb_words = dec->nb_words;
+    uint32_t	first = GF2_NO_ROW;
+    uint64_t	*first_coef = NULL;
+
+    if (dec->pivot_mask[BIT_WORD(col)] & BIT_MASK(col)) {
+        first = dec->pivot_row_tab[col];
+    } else {
+        for (uint32_t w = 0; w < nb_words; w++) {
+            for (uint64_t m = dec->pivot_mask[w]; m != 0; m &= m - 1) {
+                uint32_t	row = dec->pivot_row_tab[(w << 6) + gf2_ctz(m)];
+                uint64_t	*coef = gf2_row_coef(dec, row);
+
+                if ((coef[BIT_WORD(col)] & BIT_MASK(col)) == 0) {
+                    continue;
+                }
+                if (first == GF2_NO_ROW) {
+                    first = row;
+                    first_coef = coef;
+                } else {
+                    for (uint32_t i = 0; i < nb_words; i++) {
+                        coef[i] ^= first_coef[i];
+                    }
+                    gf2_xor(dec, gf2_row_data(dec, row), gf2_row_data(dec, first));
+                }
+            }
+        }
+    }
+    if (first != GF2_NO_ROW) {
+        gf2_remove_row(dec, first);
+    }
+    dec->known_mask[BIT_WORD(col)] &= ~BIT_MASK(col);
+    if (first != GF2_NO_ROW && dec->source_symbol_removed_from_linear_system_callback != NULL) {
+        dec->source_symbol_removed_from_linear_system_callback(dec->context_4_callback,
+                                                                gf2_col_esi(dec, col));
+    }
+}
+
+/*
+ * Make room in the linear system for source symbols up to new_esi.
+ */
+static void gf2_slide (swif_decoder_rlc_gf2_cb_t* dec, esi_t new_esi)
+{
+    esi_t	esi;
+    uint32_t	col;
+
+    if (!dec->has_last_id) {
+        dec->last_id = new_esi;
+        dec->has_last_id = true;
+        return;
+    }
+    if ((int32_t)(new_esi - dec->last_id) <= 0) {
+        return;
+    }
+    if (new_esi - dec->last_id >= dec->nb_cols) {
+        /* all the columns are recycled, oldest source symbol first */
+        for (col = 0; col < dec->nb_cols; col++) {
+            gf2_evict(dec, gf2_col(dec, dec->last_id + 1 + col));
+        }
+    } else {
+        for (esi = dec->last_id + 1; esi != new_esi + 1; esi++) {
+            gf2_evict(dec, gf2_col(dec, esi));
+        }
+    }
+    dec->last_id = new_esi;
+}
+
+static void gf2_notify_decoded (swif_decoder_rlc_gf2_cb_t* dec, uint32_t row)
+{
+    uint32_t	col = dec->row_pivot_tab[row];
+    esi_t	esi;
+    void	*new_symbol_buf = NULL;
+
+    if (dec->known_mask[BIT_WORD(col)] & BIT_MASK(col)) {
+        return;
+    }
+    dec->known_mask[BIT_WORD(col)] |= BIT_MASK(col);
+    if (dec->decoded_source_symbol_callback == NULL) {
+        return;
+    }
+    esi = gf2_col_esi(dec, col);
+    if (dec->decodable_source_symbol_callback != NULL) {
+        new_symbol_buf = dec->decodable_source_symbol_callback(dec->context_4_callback, esi);
+    }
+    if (new_symbol_buf == NULL
+        && (new_symbol_buf = swif_mem_alloc(&dec->allocator, dec->symbol_size)) == NULL) {
+        fprintf(stderr, "gf2_notify_decoded() failed! No memory\n");
+        return;
+    }
+    /* symbols are zero-padded up to symbol_size in the linear system */
+    memcpy(new_symbol_buf, gf2_row_data(dec, row), dec->symbol_size);
+    dec->decoded_source_symbol_callback(dec->context_4_callback, new_symbol_buf, esi);
+}
+
+static void gf2_check_decoded (swif_decoder_rlc_gf2_cb_t* dec, uint32_t row)
+{
+    uint64_t	*coef = gf2_row_coef(dec, row);
+    uint32_t	weight = 0;
+
+    for (uint32_t w = 0; w < dec->nb_words && weight <= 1; w++) {
+        weight += gf2_popcount(coef[w]);
+    }
+    if (weight == 1) {
+        gf2_notify_decoded(dec, row);
+    }
+}
+
+/*
+ * Add the equation in tmp_coef/tmp_data to the linear system, keeping it
+ * fully reduced. All its source symbols must be in the linear system.
+ */
+static void gf2_add_equation (swif_decoder_rlc_gf2_cb_t* dec)
+{
+    uint32_t	nb_words = dec->nb_words;
+    uint64_t	*coef;
+    uint32_t	col;
+    uint32_t	row;
+
+    /* remove the known pivots: pivot rows have no other pivot column,
+     * so this doesn't add any pivot column to the equation */
+    for (uint32_t w = 0; w < nb_words; w++) {
+        for (uint64_t m = dec->tmp_coef[w] & dec->pivot_mask[w]; m != 0; m &= m - 1) {
+            row = dec->pivot_row_tab[(w << 6) + gf2_ctz(m)];
+            coef = gf2_row_coef(dec, row);
+            for (uint32_t i = 0; i < nb_words; i++) {
+                dec->tmp_coef[i] ^= coef[i];
+            }
+            gf2_xor(dec, dec->tmp_data, gf2_row_data(dec, row));
+        }
+    }
+    /* the pivot is the oldest source symbol left in the equation */
+    col = gf2_find_first_set(dec->tmp_coef, nb_words, gf2_col(dec, dec->last_id + 1));
+    if (col == GF2_NO_COL) {
+        col = gf2_find_first_set(dec->tmp_coef, nb_words, 0);
+    }
+    if (col == GF2_NO_COL) {
+        /* redundant equation */
+        return;
+    }
+    /* there is at least one column without pivot, hence a free row */
+    assert(dec->nb_free_rows > 0);
+    row = dec->free_row_tab[--dec->nb_free_rows];
+    memcpy(gf2_row_coef(dec, row), dec->tmp_coef, nb_words * sizeof(uint64_t));
+    memcpy(gf2_row_data(dec, row), dec->tmp_data, dec->data_stride);
+
+    /* remove the new pivot from the other rows */
+    coef = gf2_row_coef(dec, row);
+    for (uint32_t w = 0; w < nb_words; w++) {
+        for (uint64_t m = dec->pivot_mask[w]; m != 0; m &= m - 1) {
+            uint32_t	other = dec->pivot_row_tab[(w << 6) + gf2_ctz(m)];
+            uint64_t	*other_coef = gf2_row_coef(dec, other);
+
+            if (other_coef[BIT_WORD(col)] & BIT_MASK(col)) {
+                for (uint32_t i = 0; i < nb_words; i++) {
+                    other_coef[i] ^= coef[i];
+                }
+                gf2_xor(dec, gf2_row_data(dec, other), gf2_row_data(dec, row));
+                gf2_check_decoded(dec, other);
+            }
+        }
+    }
+    dec->row_pivot_tab[row] = col;
+    dec->pivot_row_tab[col] = row;
+    dec->pivot_mask[BIT_WORD(col)] |= BIT_MASK(col);
+    gf2_check_decoded(dec, row);
+}
+
+
+/*******************************************************************************
+ * Decoder functions
+ */
+
+
+swif_status_t   swif_rlc_gf2_decoder_release (swif_decoder_t*        generic_dec)
+{
+    swif_decoder_rlc_gf2_cb_t *dec = (swif_decoder_rlc_gf2_cb_t *) generic_dec;
+
+    assert(dec);
+    /* the allocator is part of the control block */
+    swif_allocator_t allocator = dec->allocator;
+
+    swif_mem_free(&allocator, dec->coef_tab);
+    swif_mem_free(&allocator, dec->row_coef_tab);
+    swif_mem_free(&allocator, dec->row_data_tab);
+    swif_mem_free(&allocator, dec->pivot_row_tab);
+    swif_mem_free(&allocator, dec->pivot_mask);
+    swif_mem_free(&allocator, dec->row_pivot_tab);
+    swif_mem_free(&allocator, dec->known_mask);
+    swif_mem_free(&allocator, dec->free_row_tab);
+    swif_mem_free(&allocator, dec->tmp_coef);
+    swif_mem_free(&allocator, dec->tmp_data);
+    swif_mem_free(&allocator, dec);
+    return SWIF_STATUS_OK;
+}
+
+
+static swif_status_t   swif_rlc_gf2_decoder_set_callback_functions (
+                swif_decoder_t*  generic_dec,
+                void (*source_symbol_removed_from_linear_system_callback) (
+                                        void*   context,
+                                        esi_t   old_symbol_esi),
+                void* (*decodable_source_symbol_callback) (
+                                        void    *context,
+                                        esi_t   esi),
+                void* (*decoded_source_symbol_callback) (
+                                        void    *context,
+                                        void    *new_symbol_buf,
+                                        esi_t   esi),
+                void*        context_4_callback)
+{
+    swif_decoder_rlc_gf2_cb_t *dec = (swif_decoder_rlc_gf2_cb_t *) generic_dec;
+
+    dec->context_4_callback = context_4_callback;
+    dec->source_symbol_removed_from_linear_system_callback =
+				source_symbol_removed_from_linear_system_callback;
+    dec->decodable_source_symbol_callback = decodable_source_symbol_callback;
+    dec->decoded_source_symbol_callback = decoded_source_symbol_callback;
+    return SWIF_STATUS_OK;
+}
+
+
+static swif_status_t   swif_rlc_gf2_decoder_set_parameters  (
+                                swif_decoder_t* generic_dec,
+                                uint32_t        type,
+                                uint32_t        length,
+                                void*           value)
+{
+    swif_decoder_rlc_gf2_cb_t *dec = (swif_decoder_rlc_gf2_cb_t *) generic_dec;
+
+    if (type == swif_DECODER_SET_PARAM_CODING_COEFS_CACHE) {
+        if (value == NULL || length != sizeof(swif_cc_cache_t*)) {
+            generic_dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        dec->cc_cache = *(swif_cc_cache_t**)value;
+        return SWIF_STATUS_OK;
+    }
+    if (type == swif_DECODER_SET_PARAM_STRIPE_POOL) {
+        if (value == NULL || length != sizeof(swif_stripe_pool_t*)) {
+            generic_dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        dec->stripe_pool = *(swif_stripe_pool_t**)value;
+        return SWIF_STATUS_OK;
+    }
+    if (value == NULL || length != sizeof(uint32_t)) {
+        generic_dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+        return SWIF_STATUS_ERROR;
+    }
+    switch (type) {
+    case swif_DECODER_SET_PARAM_RLC_DENSITY_THRESHOLD:
+        if (*(uint32_t*)value > 15) {
+            generic_dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        dec->dt = (uint8_t) *(uint32_t*)value;
+        return SWIF_STATUS_OK;
+
+    case swif_DECODER_SET_PARAM_VARIABLE_LENGTH_SYMBOLS:
+        if (dec->has_last_id) {
+            fprintf(stderr, "swif_rlc_gf2_decoder_set_parameters() failed! variable length mode must be set before decoding\n");
+            generic_dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+            return SWIF_STATUS_ERROR;
+        }
+        dec->variable_length = (*(uint32_t*)value != 0);
+        return SWIF_STATUS_OK;
+
+    case swif_DECODER_SET_PARAM_REPAIR_SYMBOL_SIZE:
+        if (*(uint32_t*)value > dec->symbol_size) {
+            generic_dec->swif_errno = SWIF_ERRNO_INVALID_SYMBOL_LENGTH;
+            return SWIF_STATUS_ERROR;
+        }
+        dec->repair_symbol_size = *(uint32_t*)value;
+        return SWIF_STATUS_OK;
+
+    default:
+        generic_dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+        return SWIF_STATUS_ERROR;
+    }
+}
+
+
+/* there is no parameter to get (see swif_DECODER_GET_PARAM_DECODER_STATISTICS) */
+static swif_status_t   swif_rlc_gf2_decoder_get_parameters  (
+                                swif_decoder_t* generic_dec,
+                                uint32_t        type,
+                                uint32_t        length,
+                                void*           value)
+{
+    generic_dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+    return SWIF_STATUS_ERROR;
+}
+
+
+swif_status_t   swif_rlc_gf2_decoder_decode_with_new_source_symbol (
+                                swif_decoder_t* generic_dec,
+                                void* const     new_symbol_buf,
+                                esi_t           new_symbol_esi)
+{
+    swif_decoder_rlc_gf2_cb_t *dec = (swif_decoder_rlc_gf2_cb_t *) generic_dec;
+    uint32_t	size = dec->symbol_size;
+    uint32_t	col;
+
+    if (dec->variable_length) {
+        size = swif_get_symbol_length(new_symbol_buf);
+        if (size > dec->symbol_size) {
+            fprintf(stderr, "swif_rlc_gf2_decoder_decode_with_new_source_symbol() failed! bad length prefix (%u)\n",
+                    size);
+            generic_dec->swif_errno = SWIF_ERRNO_INVALID_SYMBOL_LENGTH;
+            return SWIF_STATUS_ERROR;
+        }
+    }
+    gf2_slide(dec, new_symbol_esi);
+    col = gf2_col(dec, new_symbol_esi);
+    if (!gf2_in_system(dec, new_symbol_esi)
+        || (dec->known_mask[BIT_WORD(col)] & BIT_MASK(col))) {
+        /* too old, or already known */
+        return SWIF_STATUS_OK;
+    }
+    dec->known_mask[BIT_WORD(col)] |= BIT_MASK(col);
+    memset(dec->tmp_coef, 0, dec->nb_words * sizeof(uint64_t));
+    dec->tmp_coef[BIT_WORD(col)] = BIT_MASK(col);
+    memcpy(dec->tmp_data, new_symbol_buf, size);
+    memset(dec->tmp_data + size, 0, dec->data_stride - size);
+    gf2_add_equation(dec);
+    return SWIF_STATUS_OK;
+}
+
+
+swif_status_t   swif_rlc_gf2_decoder_decode_with_new_repair_symbol (
+                                swif_decoder_t* generic_dec,
+                                void* const     new_symbol_buf,
+                                esi_t           new_symbol_esi)
+{
+    swif_decoder_rlc_gf2_cb_t *dec = (swif_decoder_rlc_gf2_cb_t *) generic_dec;
+    const uint8_t *coef_tab = dec->coef_tab;
+    uint32_t	nb_id = dec->nb_id;
+    uint32_t	col;
+
+    if (dec->ext_coef_tab != NULL) {
+        coef_tab = dec->ext_coef_tab;
+        nb_id = MIN(nb_id, dec->ext_nb_coefs);
+        dec->ext_coef_tab = NULL;
+    }
+    if (nb_id == 0) {
+        return SWIF_STATUS_OK;
+    }
+    gf2_slide(dec, dec->first_id + dec->nb_id - 1);
+    if (!gf2_in_system(dec, dec->first_id)) {
+        /* too old */
+        return SWIF_STATUS_OK;
+    }
+    memset(dec->tmp_coef, 0, dec->nb_words * sizeof(uint64_t));
+    for (uint32_t i = 0; i < nb_id; i++) {
+        if (coef_tab[i] != 0) {
+            col = gf2_col(dec, dec->first_id + i);
+            dec->tmp_coef[BIT_WORD(col)] |= BIT_MASK(col);
+        }
+    }
+    memcpy(dec->tmp_data, new_symbol_buf, dec->repair_symbol_size);
+    memset(dec->tmp_data + dec->repair_symbol_size, 0, dec->data_stride - dec->repair_symbol_size);
+    gf2_add_equation(dec);
+    return SWIF_STATUS_OK;
+}
+
+
+swif_status_t   swif_rlc_gf2_decoder_reset_coding_window (swif_decoder_t*  generic_dec)
+{
+    swif_decoder_rlc_gf2_cb_t *dec = (swif_decoder_rlc_gf2_cb_t *) generic_dec;
+
+    dec->first_id = INVALID_ESI;
+    dec->nb_id = 0;
+    dec->ext_coef_tab = NULL;
+    dec->repair_symbol_size = dec->symbol_size;
+    return SWIF_STATUS_OK;
+}
+
+
+swif_status_t   swif_rlc_gf2_decoder_add_source_symbol_to_coding_window (
+                                swif_decoder_t* generic_dec,
+                                esi_t           new_src_symbol_esi)
+{
+    swif_decoder_rlc_gf2_cb_t *dec = (swif_decoder_rlc_gf2_cb_t *) generic_dec;
+
+    if (dec->nb_id == 0) {
+        dec->first_id = new_src_symbol_esi;
+    }
+    if (new_src_symbol_esi != dec->first_id + dec->nb_id
+        || dec->nb_id == dec->max_coding_window_size) {
+        fprintf(stderr, "swif_rlc_gf2_decoder_add_source_symbol_to_coding_window() failed! esi %u not expected\n",
+                new_src_symbol_esi);
+        return SWIF_STATUS_ERROR;
+    }
+    dec->nb_id++;
+    return SWIF_STATUS_OK;
+}
+
+
+/*
+ * Only the first or the last source symbol can be removed, the coding
+ * window being contiguous. The coefficients already generated, if any,
+ * remain those of the other source symbols.
+ */
+static swif_status_t   swif_rlc_gf2_decoder_remove_source_symbol_from_coding_window (
+                                swif_decoder_t* generic_dec,
+                                esi_t           old_src_symbol_esi)
+{
+    swif_decoder_rlc_gf2_cb_t *dec = (swif_decoder_rlc_gf2_cb_t *) generic_dec;
+
+    if (dec->nb_id > 0 && old_src_symbol_esi == dec->first_id) {
+        memmove(dec->coef_tab, dec->coef_tab + 1, dec->nb_id - 1);
+        dec->first_id++;
+        dec->nb_id--;
+    } else if (dec->nb_id > 0 && old_src_symbol_esi == dec->first_id + dec->nb_id - 1) {
+        dec->nb_id--;
+    } else {
+        fprintf(stderr, "swif_rlc_gf2_decoder_remove_source_symbol_from_coding_window() failed! esi %u is not at an end of the coding window\n",
+                old_src_symbol_esi);
+        generic_dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+        return SWIF_STATUS_ERROR;
+    }
+    if (dec->nb_id == 0) {
+        dec->first_id = INVALID_ESI;
+    }
+    return SWIF_STATUS_OK;
+}
+
+
+static swif_status_t   swif_rlc_gf2_decoder_set_coding_coefs_tab (
+                                swif_decoder_t* generic_dec,
+                                void*           coding_coefs_tab,
+                                uint32_t        nb_coefs_in_tab)
+{
+    swif_decoder_rlc_gf2_cb_t *dec = (swif_decoder_rlc_gf2_cb_t *) generic_dec;
+
+    if (nb_coefs_in_tab > dec->max_coding_window_size) {
+        generic_dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+        return SWIF_STATUS_ERROR;
+    }
+    /* borrowed until the repair symbol is submitted */
+    dec->ext_coef_tab = coding_coefs_tab;
+    dec->ext_nb_coefs = nb_coefs_in_tab;
+    return SWIF_STATUS_OK;
+}
+
+
+swif_status_t   swif_rlc_gf2_decoder_generate_coding_coefs (
+                                swif_decoder_t* generic_dec,
+                                uint32_t        key,
+                                uint32_t        add_param)
+{
+    swif_decoder_rlc_gf2_cb_t *dec = (swif_decoder_rlc_gf2_cb_t *) generic_dec;
+
+    assert(dec->nb_id <= dec->max_coding_window_size);
+    dec->ext_coef_tab = NULL;
+    if (swif_cc_cache_get_coding_coefficients(dec->cc_cache, (uint16_t)key,
+                dec->coef_tab, dec->nb_id, dec->dt, 1 /* GF(2) */) != 0) {
+        generic_dec->swif_errno = SWIF_ERRNO_UNSUPPORTED_PARAMETER;
+        return SWIF_STATUS_ERROR;
+    }
+    return SWIF_STATUS_OK;
+}
+
+
+swif_decoder_t* swif_rlc_gf2_decoder_create (
+                                swif_codepoint_t codepoint,
+                                uint32_t        verbosity,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size,
+                                uint32_t        max_linear_system_size,
+                                const swif_allocator_t* allocator)
+{
+    swif_decoder_rlc_gf2_cb_t*	dec;
+    uint32_t			nb_cols;
+
+    if (allocator == NULL) {
+        allocator = &swif_default_allocator;
+    }
+    assert(codepoint == SWIF_CODEPOINT_RLC_GF_2_CODEC);
+    if ((dec = swif_mem_calloc(allocator, 1, sizeof(swif_decoder_rlc_gf2_cb_t))) == NULL) {
+        fprintf(stderr, "swif_decoder_create() failed! No memory \n");
+        return NULL;
+    }
+    dec->allocator = *allocator;
+    dec->generic_decoder.codepoint = codepoint;
+    dec->verbosity = verbosity;
+    dec->symbol_size = symbol_size;
+    dec->repair_symbol_size = symbol_size;
+    dec->data_stride = SWIF_SYMBOL_PADDED_SIZE(symbol_size);
+    dec->kernels = lc_get_kernels(dec->data_stride, 0, 1);
+    dec->max_coding_window_size = max_coding_window_size;
+    dec->max_linear_system_size = max_linear_system_size;
+    dec->dt = 7;
+    dec->first_id = INVALID_ESI;
+    dec->last_id = INVALID_ESI;
+
+    /* at least a window, in a power of two (see gf2_col()) of at least
+     * one 64-bit word per row */
+    for (nb_cols = 64; nb_cols < MAX(max_linear_system_size, max_coding_window_size); nb_cols <<= 1);
+    dec->nb_cols = nb_cols;
+    dec->nb_words = nb_cols / 64;
+    if ((dec->coef_tab = swif_mem_calloc(allocator, max_coding_window_size, sizeof(uint8_t))) == NULL
+        || (dec->row_coef_tab = swif_mem_calloc(allocator, (size_t)nb_cols * dec->nb_words, sizeof(uint64_t))) == NULL
+        || (dec->row_data_tab = swif_mem_aligned_calloc(allocator, SWIF_SYMBOL_ALIGNMENT, (size_t)nb_cols * dec->data_stride)) == NULL
+        || (dec->pivot_row_tab = swif_mem_alloc(allocator, nb_cols * sizeof(uint32_t))) == NULL
+        || (dec->pivot_mask = swif_mem_calloc(allocator, dec->nb_words, sizeof(uint64_t))) == NULL
+        || (dec->row_pivot_tab = swif_mem_calloc(allocator, nb_cols, sizeof(uint32_t))) == NULL
+        || (dec->known_mask = swif_mem_calloc(allocator, dec->nb_words, sizeof(uint64_t))) == NULL
+        || (dec->free_row_tab = swif_mem_alloc(allocator, nb_cols * sizeof(uint32_t))) == NULL
+        || (dec->tmp_coef = swif_mem_calloc(allocator, dec->nb_words, sizeof(uint64_t))) == NULL
+        || (dec->tmp_data = swif_mem_aligned_calloc(allocator, SWIF_SYMBOL_ALIGNMENT, dec->data_stride)) == NULL) {
+        fprintf(stderr, "swif_decoder_create() failed! No memory \n");
+        swif_rlc_gf2_decoder_release((swif_decoder_t *) dec);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < nb_cols; i++) {
+        dec->pivot_row_tab[i] = GF2_NO_ROW;
+        dec->free_row_tab[i] = nb_cols - 1 - i;
+    }
+    dec->nb_free_rows = nb_cols;
+
+    dec->generic_decoder.set_callback_functions		= swif_rlc_gf2_decoder_set_callback_functions;
+    dec->generic_decoder.set_parameters			= swif_rlc_gf2_decoder_set_parameters;
+    dec->generic_decoder.get_parameters			= swif_rlc_gf2_decoder_get_parameters;
+    dec->generic_decoder.decode_with_new_source_symbol	= swif_rlc_gf2_decoder_decode_with_new_source_symbol;
+    dec->generic_decoder.decode_with_new_repair_symbol	= swif_rlc_gf2_decoder_decode_with_new_repair_symbol;
+    dec->generic_decoder.reset_coding_window		= swif_rlc_gf2_decoder_reset_coding_window;
+    dec->generic_decoder.add_source_symbol_to_coding_window	= swif_rlc_gf2_decoder_add_source_symbol_to_coding_window;
+    dec->generic_decoder.remove_source_symbol_from_coding_window	= swif_rlc_gf2_decoder_remove_source_symbol_from_coding_window;
+    dec->generic_decoder.set_coding_coefs_tab		= swif_rlc_gf2_decoder_set_coding_coefs_tab;
+    dec->generic_decoder.generate_coding_coefs		= swif_rlc_gf2_decoder_generate_coding_coefs;
+    return (swif_decoder_t *) dec;
+}
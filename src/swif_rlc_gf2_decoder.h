@@ -0,0 +1,63 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+#ifndef SWIF_RLC_GF2_DECODER_H
+#define SWIF_RLC_GF2_DECODER_H
+#include "swif_includes.h"
+
+
+/**
+ * RLC decoder for SWIF_CODEPOINT_RLC_GF_2_CODEC.
+ * The encoder is the generic RLC encoder (see swif_rlc_api.h), that
+ * only XORs source symbols with GF(2) coefficients.
+ * All the other decoder functions are reached through the generic
+ * swif_decoder_*() API, or swif_rlc_fast.h.
+ */
+
+
+/**
+ * Create and initialize a decoder, providing only key parameters, and its
+ * allocator (NULL for the default one).
+ */
+swif_decoder_t* swif_rlc_gf2_decoder_create (
+                                swif_codepoint_t codepoint,
+                                uint32_t        verbosity,
+                                uint32_t        symbol_size,
+                                uint32_t        max_coding_window_size,
+                                uint32_t        max_linear_system_size,
+                                const swif_allocator_t* allocator);
+
+
+/**
+ * Release a decoder and its associated ressources.
+ **/
+swif_status_t   swif_rlc_gf2_decoder_release (swif_decoder_t*        dec);
+
+
+/**
+ * Per-symbol functions, also reached directly from swif_rlc_fast.h.
+ */
+swif_status_t   swif_rlc_gf2_decoder_decode_with_new_source_symbol (
+                                swif_decoder_t* dec,
+                                void* const     new_symbol_buf,
+                                esi_t           new_symbol_esi);
+
+swif_status_t   swif_rlc_gf2_decoder_decode_with_new_repair_symbol (
+                                swif_decoder_t* dec,
+                                void* const     new_symbol_buf,
+                                esi_t           new_symbol_esi);
+
+swif_status_t   swif_rlc_gf2_decoder_reset_coding_window (swif_decoder_t*  dec);
+
+swif_status_t   swif_rlc_gf2_decoder_add_source_symbol_to_coding_window (
+                                swif_decoder_t* dec,
+                                esi_t           new_src_symbol_esi);
+
+swif_status_t   swif_rlc_gf2_decoder_generate_coding_coefs (
+                                swif_decoder_t* dec,
+                                uint32_t        key,
+                                uint32_t        add_param);
+
+#endif /* SWIF_RLC_GF2_DECODER_H */
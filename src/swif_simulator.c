@@ -0,0 +1,298 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+/**
+ * Monte Carlo simulator, see swif_simulator.h.
+ */
+
+#define _GNU_SOURCE	/* clock_gettime(), sysconf() */
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "swif_includes.h"
+#include "swif_simulator.h"
+
+
+/* one session, run by one thread */
+typedef struct swif_sim_thread {
+	const swif_sim_params_t* params;
+	uint32_t		index;
+	uint32_t		nb_threads;
+	uint32_t		nb_source;
+	uint32_t		ls_size;
+	/* source and decoded symbols by esi, modulo nb_bufs */
+	uint32_t		nb_bufs;
+	uint8_t*		src_tab;
+	uint8_t*		decoded_tab;
+	uint8_t*		repair_buf;
+	uint8_t*		check_buf;
+	esi_t			last_esi;	/* last source symbol sent */
+	uint64_t		delay_sum;
+	swif_status_t		status;
+	pthread_t		thread;
+	swif_sim_results_t	results;
+} swif_sim_thread_t;
+
+
+static uint64_t swif_sim_clock_ns (clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/* content of a source symbol, a function of its esi */
+static void swif_sim_fill (uint8_t* buf, uint32_t size, esi_t esi)
+{
+    uint64_t x = ((uint64_t)esi << 32) ^ 0x9E3779B97F4A7C15ULL;
+    uint32_t i = 0;
+
+    for (; i + 8 <= size; i += 8) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        memcpy(buf + i, &x, 8);
+    }
+    x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    for (; i < size; i++) {
+        buf[i] = (uint8_t)(x >> (8 * (i & 7)));
+    }
+}
+
+
+static void* swif_sim_decodable_callback (void* context, esi_t esi)
+{
+    swif_sim_thread_t *t = context;
+    return t->decoded_tab + (size_t)(esi % t->nb_bufs) * t->params->symbol_size;
+}
+
+static void swif_sim_decoded_callback (void* context, void* new_symbol_buf, esi_t esi)
+{
+    swif_sim_thread_t	*t = context;
+    uint32_t		delay = t->last_esi - esi;
+
+    t->results.nb_recovered++;
+    t->results.delay_hist[MIN(delay, SWIF_SIM_DELAY_HIST_SIZE - 1)]++;
+    t->delay_sum += delay;
+    t->results.delay_max = MAX(t->results.delay_max, delay);
+    if (t->params->check) {
+        swif_sim_fill(t->check_buf, t->params->symbol_size, esi);
+        if (memcmp(t->check_buf, new_symbol_buf, t->params->symbol_size) != 0) {
+            t->results.nb_bad++;
+        }
+    }
+}
+
+
+static swif_status_t swif_sim_session (swif_sim_thread_t*  t,
+                                       swif_channel_t*     channel)
+{
+    const swif_sim_params_t	*p = t->params;
+    swif_sim_results_t		*r = &t->results;
+    swif_encoder_t		*enc = NULL;
+    swif_decoder_t		*dec = NULL;
+    swif_status_t		status = SWIF_STATUS_ERROR;
+    double			credit = 0;
+    uint32_t			key = 0;
+
+    if ((enc = swif_encoder_create(p->codepoint, 0, p->symbol_size, p->max_coding_window_size)) == NULL
+        || (dec = swif_decoder_create(p->codepoint, 0, p->symbol_size, p->max_coding_window_size,
+                                      t->ls_size)) == NULL) {
+        fprintf(stderr, "swif_sim_run() failed! cannot create the codec\n");
+        goto end;
+    }
+    if (p->dt >= 0) {
+        uint32_t dt = (uint32_t)p->dt;
+        if (swif_encoder_set_parameters(enc, swif_ENCODER_SET_PARAM_RLC_DENSITY_THRESHOLD, sizeof(dt), &dt) != SWIF_STATUS_OK
+            || swif_decoder_set_parameters(dec, swif_DECODER_SET_PARAM_RLC_DENSITY_THRESHOLD, sizeof(dt), &dt) != SWIF_STATUS_OK) {
+            fprintf(stderr, "swif_sim_run() failed! bad density threshold %d\n", p->dt);
+            goto end;
+        }
+    }
+    if (swif_decoder_set_callback_functions(dec, NULL, swif_sim_decodable_callback,
+                                            swif_sim_decoded_callback, t) != SWIF_STATUS_OK) {
+        goto end;
+    }
+    for (esi_t esi = 0; esi < t->nb_source; esi++) {
+        uint8_t *src = t->src_tab + (size_t)(esi % t->nb_bufs) * p->symbol_size;
+
+        swif_sim_fill(src, p->symbol_size, esi);
+        t->last_esi = esi;
+        swif_encoder_add_source_symbol_to_coding_window(enc, src, esi);
+        r->nb_source++;
+        if (swif_channel_is_lost(channel)) {
+            r->nb_source_lost++;
+        } else {
+            swif_decoder_decode_with_new_source_symbol(dec, src, esi);
+        }
+        for (credit += p->repair_ratio; credit >= 1; credit -= 1) {
+            void	*buf = t->repair_buf;
+            esi_t	first, last;
+            uint32_t	nss;
+
+            swif_encoder_generate_coding_coefs(enc, key, 0);
+            swif_build_repair_symbol(enc, &buf);
+            swif_encoder_get_coding_window_information(enc, &first, &last, &nss);
+            r->nb_repair++;
+            if (swif_channel_is_lost(channel)) {
+                r->nb_repair_lost++;
+            } else {
+                swif_decoder_reset_coding_window(dec);
+                for (esi_t i = first; i < first + nss; i++) {
+                    swif_decoder_add_source_symbol_to_coding_window(dec, i);
+                }
+                swif_decoder_generate_coding_coefs(dec, key, 0);
+                swif_decoder_decode_with_new_repair_symbol(dec, t->repair_buf, first);
+            }
+            key++;
+        }
+    }
+    status = SWIF_STATUS_OK;
+
+end:
+    if (enc != NULL) {
+        swif_encoder_release(enc);
+    }
+    if (dec != NULL) {
+        swif_decoder_release(dec);
+    }
+    return status;
+}
+
+
+static void* swif_sim_thread_main (void* arg)
+{
+    swif_sim_thread_t		*t = arg;
+    const swif_sim_params_t	*p = t->params;
+    swif_channel_params_t	channel_params = p->channel;
+    swif_channel_t		*channel;
+    uint64_t			cpu_start = swif_sim_clock_ns(CLOCK_THREAD_CPUTIME_ID);
+
+    t->status = SWIF_STATUS_ERROR;
+    /* each thread replays its own part of a trace */
+    if (channel_params.model == SWIF_CHANNEL_TRACE) {
+        channel_params.trace_offset += (uint32_t)((uint64_t)channel_params.trace_len * t->index / t->nb_threads);
+    }
+    t->src_tab = malloc((size_t)t->nb_bufs * p->symbol_size);
+    t->decoded_tab = malloc((size_t)t->nb_bufs * p->symbol_size);
+    t->repair_buf = malloc(p->symbol_size);
+    t->check_buf = malloc(p->symbol_size);
+    if (t->src_tab == NULL || t->decoded_tab == NULL || t->repair_buf == NULL || t->check_buf == NULL) {
+        fprintf(stderr, "swif_sim_run() failed! No memory\n");
+    } else if ((channel = swif_channel_create(&channel_params, p->seed + t->index)) != NULL) {
+        t->status = swif_sim_session(t, channel);
+        swif_channel_release(channel);
+    }
+    free(t->src_tab);
+    free(t->decoded_tab);
+    free(t->repair_buf);
+    free(t->check_buf);
+    t->results.cpu_ns = swif_sim_clock_ns(CLOCK_THREAD_CPUTIME_ID) - cpu_start;
+    return NULL;
+}
+
+
+swif_status_t swif_sim_run (const swif_sim_params_t*  params,
+                            swif_sim_results_t*       results)
+{
+    swif_sim_thread_t	*thread_tab;
+    uint32_t		nb_threads = params->nb_threads;
+    uint32_t		ls_size = params->max_linear_system_size;
+    uint64_t		wall_start, delay_sum = 0;
+    swif_status_t	status = SWIF_STATUS_OK;
+    uint32_t		i;
+
+    if (nb_threads == 0) {
+        long nb_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        nb_threads = (nb_cpus > 0) ? (uint32_t)nb_cpus : 1;
+    }
+    nb_threads = (uint32_t)MIN((uint64_t)nb_threads, params->nb_source);
+    if (ls_size == 0) {
+        ls_size = 4 * params->max_coding_window_size;
+    }
+    if (params->symbol_size == 0 || params->max_coding_window_size == 0
+        || ls_size < params->max_coding_window_size || params->dt > 15
+        || params->nb_source == 0 || params->nb_source / nb_threads >= UINT32_MAX
+        || !(params->repair_ratio >= 0)
+        || swif_channel_get_mean_loss_rate(&params->channel) < 0) {
+        fprintf(stderr, "swif_sim_run() failed! bad parameters\n");
+        return SWIF_STATUS_ERROR;
+    }
+    if ((thread_tab = calloc(nb_threads, sizeof(swif_sim_thread_t))) == NULL) {
+        fprintf(stderr, "swif_sim_run() failed! No memory\n");
+        return SWIF_STATUS_ERROR;
+    }
+    wall_start = swif_sim_clock_ns(CLOCK_MONOTONIC);
+    for (i = 0; i < nb_threads; i++) {
+        swif_sim_thread_t *t = &thread_tab[i];
+        t->params = params;
+        t->index = i;
+        t->nb_threads = nb_threads;
+        t->nb_source = (uint32_t)(params->nb_source / nb_threads + (i < params->nb_source % nb_threads));
+        t->ls_size = ls_size;
+        /* the decoder may decode any of the last ls_size source symbols */
+        t->nb_bufs = 2 * ls_size;
+        if (pthread_create(&t->thread, NULL, swif_sim_thread_main, t) != 0) {
+            fprintf(stderr, "swif_sim_run() failed! cannot create thread %u\n", i);
+            status = SWIF_STATUS_ERROR;
+            break;
+        }
+    }
+    nb_threads = i;
+    memset(results, 0, sizeof(*results));
+    for (i = 0; i < nb_threads; i++) {
+        swif_sim_thread_t	*t = &thread_tab[i];
+        swif_sim_results_t	*r = &t->results;
+
+        pthread_join(t->thread, NULL);
+        if (t->status != SWIF_STATUS_OK) {
+            status = SWIF_STATUS_ERROR;
+        }
+        results->nb_source += r->nb_source;
+        results->nb_repair += r->nb_repair;
+        results->nb_source_lost += r->nb_source_lost;
+        results->nb_repair_lost += r->nb_repair_lost;
+        results->nb_recovered += r->nb_recovered;
+        results->nb_bad += r->nb_bad;
+        for (uint32_t d = 0; d < SWIF_SIM_DELAY_HIST_SIZE; d++) {
+            results->delay_hist[d] += r->delay_hist[d];
+        }
+        results->delay_max = MAX(results->delay_max, r->delay_max);
+        delay_sum += t->delay_sum;
+        results->cpu_ns += r->cpu_ns;
+    }
+    results->wall_ns = swif_sim_clock_ns(CLOCK_MONOTONIC) - wall_start;
+    results->nb_threads = nb_threads;
+    if (results->nb_source > 0) {
+        results->residual_loss = (double)(results->nb_source_lost - MIN(results->nb_source_lost, results->nb_recovered))
+                                 / results->nb_source;
+    }
+    if (results->nb_recovered > 0) {
+        results->delay_mean = (double)delay_sum / results->nb_recovered;
+    }
+    free(thread_tab);
+    return status;
+}
+
+
+uint32_t swif_sim_get_delay_percentile (const swif_sim_results_t*  results,
+                                        double                     p)
+{
+    uint64_t	rank, sum = 0;
+    uint32_t	d;
+
+    if (results->nb_recovered == 0) {
+        return 0;
+    }
+    /* smallest delay such that at least p% of the delays are lower or equal */
+    rank = (uint64_t)(p / 100 * results->nb_recovered + 0.5);
+    rank = MAX(rank, 1);
+    for (d = 0; d < SWIF_SIM_DELAY_HIST_SIZE - 1; d++) {
+        sum += results->delay_hist[d];
+        if (sum >= rank) {
+            break;
+        }
+    }
+    return (d < SWIF_SIM_DELAY_HIST_SIZE - 1) ? d : results->delay_max;
+}
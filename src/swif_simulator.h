@@ -0,0 +1,87 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+#ifndef SWIF_SIMULATOR_H
+#define SWIF_SIMULATOR_H
+
+#include <stdint.h>
+#include "swif_api.h"
+#include "swif_channel.h"
+
+
+/**
+ * Monte Carlo simulator: runs the actual encoder and decoder through a
+ * loss channel (see swif_channel.h), and measures what the codec does
+ * rather than estimating it.
+ * The encoder adds each source symbol to its coding window and builds
+ * repair_ratio repair symbols per source symbol on average (evenly
+ * spread), over its current coding window. Every packet, source or
+ * repair, goes through the channel, and the decoder gets those that are
+ * not lost, the way a receiver gets them (coding window and key of each
+ * repair symbol).
+ * The nb_source source symbols are split over nb_threads threads, each
+ * one running its own session (encoder, channel and decoder, the channel
+ * of thread i being seeded with seed + i) without any synchronization,
+ * and the results are summed.
+ */
+
+/* decoding delays of SWIF_SIM_DELAY_HIST_SIZE - 1 or more source symbols
+ * are counted in the last entry of the histogram */
+#define SWIF_SIM_DELAY_HIST_SIZE	4096
+
+typedef struct swif_sim_params {
+	swif_codepoint_t	codepoint;
+	uint32_t		symbol_size;
+	uint32_t		max_coding_window_size;
+	uint32_t		max_linear_system_size;	/* 0: 4 * max_coding_window_size */
+	int32_t			dt;			/* density threshold, < 0: codec default */
+	double			repair_ratio;		/* repair symbols per source symbol */
+	uint64_t		nb_source;		/* in total */
+	swif_channel_params_t	channel;
+	uint64_t		seed;
+	uint32_t		nb_threads;		/* 0: one per online CPU */
+	bool			check;			/* compare each decoded symbol with the source */
+} swif_sim_params_t;
+
+typedef struct swif_sim_results {
+	uint32_t	nb_threads;
+	uint64_t	nb_source;
+	uint64_t	nb_repair;
+	uint64_t	nb_source_lost;
+	uint64_t	nb_repair_lost;
+	uint64_t	nb_recovered;		/* lost source symbols decoded */
+	uint64_t	nb_bad;			/* decoded but different (with check) */
+	double		residual_loss;		/* (nb_source_lost - nb_recovered) / nb_source */
+	/* decoding delay of the recovered source symbols: number of source
+	 * symbols sent after it when it is decoded */
+	uint64_t	delay_hist[SWIF_SIM_DELAY_HIST_SIZE];
+	double		delay_mean;
+	uint32_t	delay_max;
+	/* cost: CPU time of the threads (codec, channel and the generation of
+	 * the source symbols), and elapsed time */
+	uint64_t	cpu_ns;
+	uint64_t	wall_ns;
+} swif_sim_results_t;
+
+
+/**
+ * Run a simulation.
+ *
+ * @param params        (IN) the simulation.
+ * @param results       (OUT) its results.
+ * @return              SWIF_STATUS_OK, or SWIF_STATUS_ERROR with bad
+ *                      parameters or if a session cannot be created.
+ */
+swif_status_t   swif_sim_run (const swif_sim_params_t*  params,
+                              swif_sim_results_t*       results);
+
+/**
+ * Return the p-th percentile (p in [0; 100]) of the decoding delay of the
+ * recovered source symbols, 0 if there are none.
+ */
+uint32_t        swif_sim_get_delay_percentile (const swif_sim_results_t*  results,
+                                               double                     p);
+
+#endif /* SWIF_SIMULATOR_H */
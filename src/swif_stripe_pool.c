@@ -0,0 +1,280 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+/**
+ * Stripe pool, see swif_stripe_pool.h.
+ */
+
+#define _GNU_SOURCE	/* posix_memalign() */
+#include <pthread.h>
+#include <sched.h>
+
+#include "swif_includes.h"
+
+
+/* spins of an idle thread before it sleeps: operations on large symbols
+ * come in bursts (e.g. the additions of one repair symbol) */
+#define SWIF_STRIPE_SPINS	20000
+
+typedef struct swif_stripe_worker {
+	swif_stripe_pool_t*	pool;
+	uint32_t		index;		/* stripe index, from 1 */
+	pthread_t		thread;
+} swif_stripe_worker_t;
+
+struct swif_stripe_pool {
+	/* current operation, published by gen */
+	swif_stripe_fn_t	fn;
+	void*			arg;
+	uint32_t		size;
+	uint32_t		stripe_size;
+	uint32_t		nb_stripes;
+	bool			stop;
+
+	uint32_t		gen SWIF_ALIGNED;
+	/* workers done with the current operation */
+	uint32_t		nb_done SWIF_ALIGNED;
+
+	/* sleeping workers */
+	pthread_mutex_t		mutex SWIF_ALIGNED;
+	pthread_cond_t		cond;
+	uint32_t		nb_sleeping;
+
+	uint32_t		nb_threads;
+	uint32_t		min_stripe_size;
+	uint32_t		nb_started;
+	swif_stripe_worker_t*	worker_tab;
+};
+
+
+static void* swif_stripe_worker_main (void* arg)
+{
+    swif_stripe_worker_t	*w = arg;
+    swif_stripe_pool_t		*pool = w->pool;
+    uint32_t			gen = 0;
+
+    for (;;) {
+        uint32_t spins = 0;
+        while (__atomic_load_n(&pool->gen, __ATOMIC_ACQUIRE) == gen) {
+            if (++spins < SWIF_STRIPE_SPINS) {
+                continue;
+            }
+            pthread_mutex_lock(&pool->mutex);
+            pool->nb_sleeping++;
+            while (__atomic_load_n(&pool->gen, __ATOMIC_ACQUIRE) == gen) {
+                pthread_cond_wait(&pool->cond, &pool->mutex);
+            }
+            pool->nb_sleeping--;
+            pthread_mutex_unlock(&pool->mutex);
+        }
+        gen++;
+        if (pool->stop) {
+            return NULL;
+        }
+        if (w->index < pool->nb_stripes) {
+            uint32_t offset = w->index * pool->stripe_size;
+            pool->fn(pool->arg, offset, MIN(pool->stripe_size, pool->size - offset));
+        }
+        /* all the workers answer, so that none of them still reads the
+         * operation when the next one is published */
+        __atomic_add_fetch(&pool->nb_done, 1, __ATOMIC_RELEASE);
+    }
+}
+
+
+/* publish the operation set in pool, and wake the sleeping workers */
+static void swif_stripe_pool_publish (swif_stripe_pool_t*  pool)
+{
+    __atomic_store_n(&pool->nb_done, 0, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&pool->gen, 1, __ATOMIC_RELEASE);
+    pthread_mutex_lock(&pool->mutex);
+    if (pool->nb_sleeping > 0) {
+        pthread_cond_broadcast(&pool->cond);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+
+swif_stripe_pool_t* swif_stripe_pool_create (uint32_t  nb_threads,
+                                             uint32_t  min_stripe_size)
+{
+    swif_stripe_pool_t	*pool;
+    void		*p;
+
+    if (nb_threads == 0 || nb_threads > 256 || min_stripe_size == 0) {
+        fprintf(stderr, "swif_stripe_pool_create() failed! bad parameters\n");
+        return NULL;
+    }
+    if (posix_memalign(&p, SWIF_CACHE_LINE, sizeof(swif_stripe_pool_t)) != 0) {
+        fprintf(stderr, "swif_stripe_pool_create() failed! No memory\n");
+        return NULL;
+    }
+    pool = memset(p, 0, sizeof(swif_stripe_pool_t));
+    pool->nb_threads = nb_threads;
+    /* whole cache lines per stripe */
+    pool->min_stripe_size = (min_stripe_size + SWIF_CACHE_LINE - 1) & ~(SWIF_CACHE_LINE - 1);
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->cond, NULL);
+    if ((pool->worker_tab = calloc(nb_threads, sizeof(swif_stripe_worker_t))) == NULL) {
+        fprintf(stderr, "swif_stripe_pool_create() failed! No memory\n");
+        swif_stripe_pool_release(pool);
+        return NULL;
+    }
+    for (uint32_t i = 1; i < nb_threads; i++) {
+        swif_stripe_worker_t *w = &pool->worker_tab[i];
+        w->pool = pool;
+        w->index = i;
+        if (pthread_create(&w->thread, NULL, swif_stripe_worker_main, w) != 0) {
+            fprintf(stderr, "swif_stripe_pool_create() failed! cannot create thread %u\n", i);
+            swif_stripe_pool_release(pool);
+            return NULL;
+        }
+        pool->nb_started++;
+    }
+    return pool;
+}
+
+
+void swif_stripe_pool_release (swif_stripe_pool_t*  pool)
+{
+    if (pool == NULL) {
+        return;
+    }
+    pool->stop = true;
+    swif_stripe_pool_publish(pool);
+    for (uint32_t i = 1; i <= pool->nb_started; i++) {
+        pthread_join(pool->worker_tab[i].thread, NULL);
+    }
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->cond);
+    free(pool->worker_tab);
+    free(pool);
+}
+
+
+void swif_stripe_pool_run (swif_stripe_pool_t*  pool,
+                           swif_stripe_fn_t     fn,
+                           void*                arg,
+                           uint32_t             size)
+{
+    uint32_t nb_stripes;
+
+    if (pool == NULL || pool->nb_threads == 1 || size < 2 * pool->min_stripe_size) {
+        fn(arg, 0, size);
+        return;
+    }
+    nb_stripes = MIN(pool->nb_threads, size / pool->min_stripe_size);
+    pool->fn = fn;
+    pool->arg = arg;
+    pool->size = size;
+    pool->stripe_size = ((size + nb_stripes - 1) / nb_stripes + SWIF_CACHE_LINE - 1) & ~(SWIF_CACHE_LINE - 1);
+    pool->nb_stripes = (size + pool->stripe_size - 1) / pool->stripe_size;
+    swif_stripe_pool_publish(pool);
+    fn(arg, 0, MIN(pool->stripe_size, size));
+    while (__atomic_load_n(&pool->nb_done, __ATOMIC_ACQUIRE) < pool->nb_threads - 1) {
+        /* a few microseconds at most */
+    }
+}
+
+
+/*******************************************************************************
+ * Single operations
+ */
+
+typedef struct swif_stripe_op {
+	uint8_t			coef;
+	uint8_t*		data;
+	uint8_t*		result;
+	uint8_t			l;
+	bool			aligned;
+} swif_stripe_op_t;
+
+/* stripes start on cache lines: aligned, if the whole range is */
+static inline bool swif_stripe_is_aligned (const void* data, const void* result, uint32_t size)
+{
+    return (((uintptr_t)data | (uintptr_t)result | size) % SYMBOL_ALIGNMENT) == 0;
+}
+
+static void swif_stripe_add_mul_range (void* arg, uint32_t offset, uint32_t size)
+{
+    swif_stripe_op_t *op = arg;
+    if (op->aligned) {
+        lc_vector_add_mul_aligned(op->coef, op->data + offset, size, op->l, op->result + offset);
+    } else {
+        lc_vector_add_mul(op->coef, op->data + offset, size, op->l, op->result + offset);
+    }
+}
+
+static void swif_stripe_mul_range (void* arg, uint32_t offset, uint32_t size)
+{
+    swif_stripe_op_t *op = arg;
+    if (op->aligned) {
+        lc_vector_mul_aligned(op->coef, op->data + offset, size, op->l, op->result + offset);
+    } else {
+        lc_vector_mul(op->coef, op->data + offset, size, op->l, op->result + offset);
+    }
+}
+
+static void swif_stripe_xor_range (void* arg, uint32_t offset, uint32_t size)
+{
+    swif_stripe_op_t *op = arg;
+    if (op->aligned) {
+        symbol_xor_aligned(op->result + offset, op->data + offset, size);
+    } else {
+        symbol_xor(op->result + offset, op->data + offset, size);
+    }
+}
+
+
+void swif_stripe_add_mul (swif_stripe_pool_t*  pool,
+                          uint8_t              coef,
+                          uint8_t*             data,
+                          uint32_t             size,
+                          uint8_t              log2_nb_bit_coef,
+                          uint8_t*             result)
+{
+    swif_stripe_op_t op = { coef, data, result, log2_nb_bit_coef,
+                            swif_stripe_is_aligned(data, result, size) };
+
+    if (pool == NULL) {
+        swif_stripe_add_mul_range(&op, 0, size);
+        return;
+    }
+    swif_stripe_pool_run(pool, swif_stripe_add_mul_range, &op, size);
+}
+
+
+void swif_stripe_mul (swif_stripe_pool_t*  pool,
+                      uint8_t              coef,
+                      uint8_t*             data,
+                      uint32_t             size,
+                      uint8_t              log2_nb_bit_coef,
+                      uint8_t*             result)
+{
+    swif_stripe_op_t op = { coef, data, result, log2_nb_bit_coef,
+                            swif_stripe_is_aligned(data, result, size) };
+
+    if (pool == NULL) {
+        swif_stripe_mul_range(&op, 0, size);
+        return;
+    }
+    swif_stripe_pool_run(pool, swif_stripe_mul_range, &op, size);
+}
+
+
+void swif_stripe_xor (swif_stripe_pool_t*  pool,
+                      void*                symbol1,
+                      const void*          symbol2,
+                      uint32_t             size)
+{
+    swif_stripe_op_t op = { 0, (uint8_t*)symbol2, symbol1, 0,
+                            swif_stripe_is_aligned(symbol2, symbol1, size) };
+
+    if (pool == NULL) {
+        swif_stripe_xor_range(&op, 0, size);
+        return;
+    }
+    swif_stripe_pool_run(pool, swif_stripe_xor_range, &op, size);
+}
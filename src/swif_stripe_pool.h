@@ -0,0 +1,85 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+#ifndef SWIF_STRIPE_POOL_H
+#define SWIF_STRIPE_POOL_H
+
+#include <stdint.h>
+
+
+/**
+ * Stripe pool: a small pool of threads that share the payload work of a
+ * codec on large symbols (e.g. several KB).
+ * Each operation over a byte range (e.g. p1 += coef * p2 over the
+ * symbols) is split into contiguous stripes, one per thread, the calling
+ * thread taking the first one, and returns once all the stripes are done
+ * (one barrier per operation). The coefficient side stays on the calling
+ * thread.
+ * A pool is given to an encoder or decoder with
+ * swif_ENCODER_SET_PARAM_STRIPE_POOL (resp. swif_DECODER_SET_PARAM_STRIPE_POOL).
+ * It runs one operation at a time: the codec instances that share it must
+ * be used by the same thread.
+ */
+typedef struct swif_stripe_pool swif_stripe_pool_t;
+
+/* work on bytes [offset; offset + size) of the range */
+typedef void (*swif_stripe_fn_t) (void* arg, uint32_t offset, uint32_t size);
+
+
+/**
+ * Create a pool.
+ *
+ * @param nb_threads    (IN) number of stripes of an operation, the calling
+ *                      thread included (so nb_threads - 1 threads are
+ *                      created).
+ * @param min_stripe_size
+ *                      (IN) ranges are split in stripes of at least this
+ *                      size (in bytes), smaller ranges being processed by
+ *                      the calling thread alone.
+ * @return              the pool, or NULL in case of error.
+ */
+swif_stripe_pool_t* swif_stripe_pool_create (uint32_t  nb_threads,
+                                             uint32_t  min_stripe_size);
+
+/**
+ * Stop the threads and release the pool.
+ */
+void swif_stripe_pool_release (swif_stripe_pool_t*  pool);
+
+/**
+ * Run fn over [0; size), split in stripes, and wait for all of them.
+ * With a NULL pool, fn(arg, 0, size) is simply called.
+ */
+void swif_stripe_pool_run (swif_stripe_pool_t*  pool,
+                           swif_stripe_fn_t     fn,
+                           void*                arg,
+                           uint32_t             size);
+
+/**
+ * Striped lc_vector_add_mul() and lc_vector_mul() (see swif_linear-code.h)
+ * and symbol_xor() (see swif_symbol.h). Each is a single operation, with
+ * a NULL pool as well. The *_aligned kernels are used when data, result
+ * and size are all multiples of SYMBOL_ALIGNMENT.
+ */
+void swif_stripe_add_mul (swif_stripe_pool_t*  pool,
+                          uint8_t              coef,
+                          uint8_t*             data,
+                          uint32_t             size,
+                          uint8_t              log2_nb_bit_coef,
+                          uint8_t*             result);
+
+void swif_stripe_mul (swif_stripe_pool_t*  pool,
+                      uint8_t              coef,
+                      uint8_t*             data,
+                      uint32_t             size,
+                      uint8_t              log2_nb_bit_coef,
+                      uint8_t*             result);
+
+void swif_stripe_xor (swif_stripe_pool_t*  pool,
+                      void*                symbol1,
+                      const void*          symbol2,
+                      uint32_t             size);
+
+#endif /* SWIF_STRIPE_POOL_H */
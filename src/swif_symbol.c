@@ -6,6 +6,13 @@
 /*---------------------------------------------------------------------------*/
 
 #include <assert.h>
+#include <string.h>
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 #include "swif_symbol.h"
 
 /*---------------------------------------------------------------------------*/
@@ -31,6 +38,141 @@ uint8_t gf256_div(uint8_t a, uint8_t b)
 
 /*---------------------------------------------------------------------------*/
 
+/**
+ * @brief Split-nibble multiplication: coef.x = coef.(x & 0x0f) + coef.(x & 0xf0),
+ *        i.e. two 16-entry table lookups per byte, one PSHUFB each with
+ *        SSSE3/AVX2. Performs result = coef * data, or result += coef * data
+ *        when `add' is set. data and result must be equal or disjoint.
+ *        With `aligned' set (a constant in each caller, so that this is
+ *        compiled once per case), data and result are aligned on
+ *        SYMBOL_ALIGNMENT bytes and symbol_size is a multiple of it: aligned
+ *        loads and stores, and no tail loop.
+ */
+static inline void symbol_mul_base
+(uint8_t *result, uint8_t coef, const uint8_t *data, uint32_t symbol_size, int add,
+ int aligned)
+{
+    const uint8_t *mul = gf256_mul_table[coef];
+    uint32_t i = 0;
+
+#if defined(__SSSE3__)
+    uint8_t tab_lo[16], tab_hi[16];
+    for (uint32_t x = 0; x < 16; x++) {
+        tab_lo[x] = mul[x];
+        tab_hi[x] = mul[x << 4];
+    }
+#if defined(__AVX2__)
+    const __m256i lo256 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)tab_lo));
+    const __m256i hi256 = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)tab_hi));
+    const __m256i mask256 = _mm256_set1_epi8(0x0f);
+    for (; i + 32 <= symbol_size; i += 32) {
+        __m256i x = aligned ? _mm256_load_si256((const __m256i*)(data + i))
+                            : _mm256_loadu_si256((const __m256i*)(data + i));
+        __m256i y = _mm256_xor_si256(
+            _mm256_shuffle_epi8(lo256, _mm256_and_si256(x, mask256)),
+            _mm256_shuffle_epi8(hi256, _mm256_and_si256(_mm256_srli_epi16(x, 4), mask256)));
+        if (add)
+            y = _mm256_xor_si256(y, aligned ? _mm256_load_si256((const __m256i*)(result + i))
+                                            : _mm256_loadu_si256((const __m256i*)(result + i)));
+        if (aligned)
+            _mm256_store_si256((__m256i*)(result + i), y);
+        else
+            _mm256_storeu_si256((__m256i*)(result + i), y);
+    }
+    if (aligned)
+        return;
+#endif /* __AVX2__ */
+    const __m128i lo128 = _mm_loadu_si128((const __m128i*)tab_lo);
+    const __m128i hi128 = _mm_loadu_si128((const __m128i*)tab_hi);
+    const __m128i mask128 = _mm_set1_epi8(0x0f);
+    for (; i + 16 <= symbol_size; i += 16) {
+        __m128i x = aligned ? _mm_load_si128((const __m128i*)(data + i))
+                            : _mm_loadu_si128((const __m128i*)(data + i));
+        __m128i y = _mm_xor_si128(
+            _mm_shuffle_epi8(lo128, _mm_and_si128(x, mask128)),
+            _mm_shuffle_epi8(hi128, _mm_and_si128(_mm_srli_epi16(x, 4), mask128)));
+        if (add)
+            y = _mm_xor_si128(y, aligned ? _mm_load_si128((const __m128i*)(result + i))
+                                         : _mm_loadu_si128((const __m128i*)(result + i)));
+        if (aligned)
+            _mm_store_si128((__m128i*)(result + i), y);
+        else
+            _mm_storeu_si128((__m128i*)(result + i), y);
+    }
+    if (aligned)
+        return;
+#endif /* __SSSE3__ */
+
+    for (; i < symbol_size; i++) {
+        result[i] = add ? (result[i] ^ mul[data[i]]) : mul[data[i]];
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+
+/**
+ * @brief Add (xor) a symbol to another one, in place: symbol1 += symbol2.
+ *        With `aligned' set, see symbol_mul_base().
+ */
+static inline void symbol_xor_base
+(void *symbol1, const void *symbol2, uint32_t symbol_size, int aligned)
+{
+    uint8_t *data1 = (uint8_t *) symbol1;
+    const uint8_t *data2 = (const uint8_t *) symbol2;
+    uint32_t i = 0;
+
+    if (aligned) {
+        uint64_t w1[SYMBOL_ALIGNMENT / sizeof(uint64_t)];
+        uint64_t w2[SYMBOL_ALIGNMENT / sizeof(uint64_t)];
+
+        data1 = (uint8_t *) __builtin_assume_aligned(symbol1, SYMBOL_ALIGNMENT);
+        data2 = (const uint8_t *) __builtin_assume_aligned(symbol2, SYMBOL_ALIGNMENT);
+        /* one SYMBOL_ALIGNMENT block at a time, no tail (the memcpy are
+         * plain loads and stores) */
+        for (; i < symbol_size; i += SYMBOL_ALIGNMENT) {
+            memcpy(w1, data1 + i, SYMBOL_ALIGNMENT);
+            memcpy(w2, data2 + i, SYMBOL_ALIGNMENT);
+            for (uint32_t k = 0; k < SYMBOL_ALIGNMENT / sizeof(uint64_t); k++) {
+                w1[k] ^= w2[k];
+            }
+            memcpy(data1 + i, w1, SYMBOL_ALIGNMENT);
+        }
+        return;
+    }
+    /* memcpy keeps this correct for unaligned buffers, and compiles to
+     * plain (vectorizable) loads and stores */
+    for (; i + sizeof(uint64_t) <= symbol_size; i += sizeof(uint64_t)) {
+        uint64_t w1, w2;
+        memcpy(&w1, data1 + i, sizeof(uint64_t));
+        memcpy(&w2, data2 + i, sizeof(uint64_t));
+        w1 ^= w2;
+        memcpy(data1 + i, &w1, sizeof(uint64_t));
+    }
+    for (; i < symbol_size; i++) {
+        data1[i] ^= data2[i];
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+
+/**
+ * @brief Add (xor) a symbol to another one, in place, 64 bits at a time:
+ *        performs the equivalent of: symbol1 += symbol2
+ * @param[in,out] symbol1  First symbol (to which symbol2 will be added)
+ * @param[in]     symbol2  Second symbol
+ */
+void symbol_xor
+(void *symbol1, const void *symbol2, uint32_t symbol_size)
+{
+    symbol_xor_base(symbol1, symbol2, symbol_size, 0);
+}
+
+void symbol_xor_aligned
+(void *symbol1, const void *symbol2, uint32_t symbol_size)
+{
+    symbol_xor_base(symbol1, symbol2, symbol_size, 1);
+}
+
 /**
  * @brief Take a symbol and add another symbol multiplied by a 
  *        coefficient, e.g. performs the equivalent of: p1 += coef * p2
@@ -44,9 +186,27 @@ void symbol_add_scaled
 {
     uint8_t *data1 = (uint8_t *) symbol1;
     uint8_t *data2 = (uint8_t *) symbol2;
-    for (uint32_t i=0; i<symbol_size; i++) {
-        data1[i] ^= gf256_mul(coef, data2[i]);
+    if (coef == 0) {
+        return;
+    }
+    if (coef == 1) {
+        symbol_xor(symbol1, symbol2, symbol_size);
+        return;
+    }
+    symbol_mul_base(data1, coef, data2, symbol_size, 1, 0);
+}
+
+void symbol_add_scaled_aligned
+(void *symbol1, uint8_t coef, void *symbol2, uint32_t symbol_size)
+{
+    if (coef == 0) {
+        return;
     }
+    if (coef == 1) {
+        symbol_xor_aligned(symbol1, symbol2, symbol_size);
+        return;
+    }
+    symbol_mul_base((uint8_t *) symbol1, coef, (const uint8_t *) symbol2, symbol_size, 1, 1);
 }
 
 /**
@@ -94,10 +254,17 @@ void symbol_mul
 	memset(result, 0, symbol_size);
 	return;
     }
-    uint8_t *data = (uint8_t *) symbol1;
-    for (uint32_t i=0; i<symbol_size; i++) {
-        result[i] = gf256_mul(coeff, data[i]);
+    symbol_mul_base(result, coeff, (const uint8_t *) symbol1, symbol_size, 0, 0);
+}
+
+void symbol_mul_aligned
+(void *symbol1, uint8_t coeff, uint32_t symbol_size, uint8_t* result)
+{
+    if (coeff == 0) {
+	memset(result, 0, symbol_size);
+	return;
     }
+    symbol_mul_base(result, coeff, (const uint8_t *) symbol1, symbol_size, 0, 1);
 }
 
 /**
@@ -117,3 +284,67 @@ void symbol_div
     }
 }
 /*---------------------------------------------------------------------------*/
+
+/*
+ * Fixed-size kernels: the same operations with symbol_size a compile-time
+ * constant, so that the compiler drops the trip count logic and the tail
+ * loops, and unrolls the vector loops. One set per size of
+ * SYMBOL_KERNEL_SIZES (any buffer) and of SYMBOL_ALIGNED_KERNEL_SIZES
+ * (aligned buffers, see SYMBOL_ALIGNMENT).
+ */
+#define SYMBOL_DEFINE_KERNELS(size, aligned, name)                          \
+static void symbol_add_mul_##name (uint8_t coef, uint8_t *data,            \
+                                   uint8_t *result)                        \
+{                                                                          \
+    if (coef == 0) {                                                       \
+        return;                                                            \
+    }                                                                      \
+    if (coef == 1) {                                                       \
+        symbol_xor_base(result, data, size, aligned);                      \
+        return;                                                            \
+    }                                                                      \
+    symbol_mul_base(result, coef, data, size, 1, aligned);                 \
+}                                                                          \
+static void symbol_mul_##name (uint8_t coef, uint8_t *data,                \
+                               uint8_t *result)                            \
+{                                                                          \
+    if (coef == 0) {                                                       \
+        memset(result, 0, size);                                           \
+        return;                                                            \
+    }                                                                      \
+    symbol_mul_base(result, coef, data, size, 0, aligned);                 \
+}
+
+#define SYMBOL_KERNELS(size)		SYMBOL_DEFINE_KERNELS(size, 0, size)
+#define SYMBOL_ALIGNED_KERNELS(size)	SYMBOL_DEFINE_KERNELS(size, 1, aligned_##size)
+SYMBOL_KERNEL_SIZES(SYMBOL_KERNELS)
+SYMBOL_ALIGNED_KERNEL_SIZES(SYMBOL_ALIGNED_KERNELS)
+
+#define SYMBOL_KERNELS_ENTRY(size)	{ size, symbol_add_mul_##size, symbol_mul_##size },
+#define SYMBOL_ALIGNED_KERNELS_ENTRY(size)	\
+	{ size, symbol_add_mul_aligned_##size, symbol_mul_aligned_##size },
+
+static const symbol_kernels_t symbol_kernels_tab[] = {
+    SYMBOL_KERNEL_SIZES(SYMBOL_KERNELS_ENTRY)
+};
+
+static const symbol_kernels_t symbol_aligned_kernels_tab[] = {
+    SYMBOL_ALIGNED_KERNEL_SIZES(SYMBOL_ALIGNED_KERNELS_ENTRY)
+};
+
+const symbol_kernels_t* symbol_get_kernels
+(uint32_t symbol_size, int aligned)
+{
+    const symbol_kernels_t *tab = aligned ? symbol_aligned_kernels_tab : symbol_kernels_tab;
+    uint32_t nb = aligned ? sizeof(symbol_aligned_kernels_tab) / sizeof(symbol_kernels_t)
+                          : sizeof(symbol_kernels_tab) / sizeof(symbol_kernels_t);
+
+    for (uint32_t i = 0; i < nb; i++) {
+        if (tab[i].symbol_size == symbol_size) {
+            return &tab[i];
+        }
+    }
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
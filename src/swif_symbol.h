@@ -55,6 +55,32 @@ uint8_t gf256_mul(uint8_t a, uint8_t b);
   
 /*---------------------------------------------------------------------------*/
 
+/* The *_aligned() variants below require symbols aligned on SYMBOL_ALIGNMENT
+   bytes, and a symbol_size that is a multiple of SYMBOL_ALIGNMENT (i.e. of
+   any vector size): they have no tail loop (see swif_symbol_buffer_alloc()) */
+#define SYMBOL_ALIGNMENT 64
+
+/*---------------------------------------------------------------------------*/
+/*
+ * Operations in GF(2)
+ */
+
+/**
+ * @brief Add (xor) a symbol to another one, in place, 64 bits at a time:
+ *        performs the equivalent of: symbol1 += symbol2
+ *        This is also symbol_add_scaled() with coefficient 1, i.e. the
+ *        only operation needed with GF(2) coefficients.
+ * @param[in,out] symbol1  First symbol (to which symbol2 will be added)
+ * @param[in]     symbol2  Second symbol
+ */
+void symbol_xor
+(void *symbol1, const void *symbol2, uint32_t symbol_size);
+
+void symbol_xor_aligned
+(void *symbol1, const void *symbol2, uint32_t symbol_size);
+
+/*---------------------------------------------------------------------------*/
+
 /* invariant: the functions below work with NULL pointers to symbol
    iff symbol_size is 0 (as they will not actually dereference the pointer) */
 
@@ -69,6 +95,9 @@ uint8_t gf256_mul(uint8_t a, uint8_t b);
 void symbol_add_scaled
 (void *symbol1, uint8_t coef, void *symbol2, uint32_t symbol_size);
 
+void symbol_add_scaled_aligned
+(void *symbol1, uint8_t coef, void *symbol2, uint32_t symbol_size);
+
 
 /**
  * @brief Take a symbol and add another symbol to it,
@@ -102,6 +131,9 @@ void symbol_sub
 void symbol_mul
 (void *symbol1, uint8_t coeff, uint32_t symbol_size, uint8_t* result);
 
+void symbol_mul_aligned
+(void *symbol1, uint8_t coeff, uint32_t symbol_size, uint8_t* result);
+
 
 /**
  * @brief Take a symbol and divide it by a coefficient, 
@@ -114,6 +146,37 @@ void symbol_mul
 void symbol_div
 (void *symbol1, uint32_t symbol_size, uint8_t coeff, uint8_t* result);
 
+/*---------------------------------------------------------------------------*/
+
+/* symbol sizes with compile-time specialised kernels: common MTU-derived
+   sizes, and the same ones padded to SYMBOL_ALIGNMENT for aligned buffers */
+#define SYMBOL_KERNEL_SIZES(X) \
+	X(64) X(128) X(256) X(1024) X(1280) X(1400) X(1500) X(4096)
+#define SYMBOL_ALIGNED_KERNEL_SIZES(X) \
+	X(64) X(128) X(256) X(1024) X(1280) X(1408) X(1536) X(4096)
+
+/**
+ * @brief Operations over symbols of exactly symbol_size bytes, with this
+ *        size known at compile time: no trip count logic nor tail loop.
+ *        add_mul() performs result += coef * data and mul()
+ *        result = coef * data, as lc_vector_add_mul() and lc_vector_mul()
+ *        in GF(256). As 0 and 1 are handled as in GF(2), they are the
+ *        GF(2) kernels as well.
+ */
+typedef struct symbol_kernels {
+	uint32_t	symbol_size;
+	void		(*add_mul) (uint8_t coef, uint8_t *data, uint8_t *result);
+	void		(*mul) (uint8_t coef, uint8_t *data, uint8_t *result);
+} symbol_kernels_t;
+
+/**
+ * @brief Return the kernels of symbol_size, NULL if this size has none.
+ *        With `aligned' set, the buffers must be aligned on SYMBOL_ALIGNMENT
+ *        bytes (symbol_size being one of SYMBOL_ALIGNED_KERNEL_SIZES).
+ */
+const symbol_kernels_t* symbol_get_kernels
+(uint32_t symbol_size, int aligned);
+
 
 /*---------------------------------------------------------------------------*/
 
@@ -0,0 +1,15 @@
+/**
+ * SWiF Codec: an open-source sliding window FEC codec in C
+ * https://github.com/irtf-nwcrg/swif-codec
+ */
+
+/*
+ * Unity build (make WITH_UNITY=1): the whole library as a single
+ * translation unit, so that the compiler can inline across modules
+ * (e.g. the symbol kernels into the RLC codec) without LTO.
+ * The modules are those of SRCS in the Makefile, which generates
+ * swif_unity_srcs.h.
+ */
+#define _GNU_SOURCE	/* before any system header, see swif_engine.c */
+
+#include "swif_unity_srcs.h"
@@ -0,0 +1,157 @@
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "../src/swif_api.h"
+
+#define SYMBOL_SIZE	1024
+#define WINDOW_SIZE	10
+#define NB_SOURCE	200
+
+/* memory of a tenant */
+typedef struct {
+    uint32_t	nb_alloc;
+    int32_t	nb_live;
+} tenant_t;
+
+static void *tenant_alloc(void *context, size_t size) {
+    tenant_t *t = context;
+    t->nb_alloc++;
+    t->nb_live++;
+    return malloc(size);
+}
+
+static void *tenant_aligned_alloc(void *context, size_t alignment, size_t size) {
+    tenant_t *t = context;
+    void *p;
+    if (posix_memalign(&p, alignment, size) != 0)
+        return NULL;
+    t->nb_alloc++;
+    t->nb_live++;
+    return p;
+}
+
+static void tenant_free(void *context, void *ptr) {
+    tenant_t *t = context;
+    t->nb_live--;
+    free(ptr);
+}
+
+static tenant_t		dec_tenant;
+static swif_allocator_t	dec_allocator = { tenant_alloc, tenant_aligned_alloc, tenant_free, &dec_tenant };
+static uint8_t		src[NB_SOURCE][SYMBOL_SIZE];
+static uint32_t		nb_decoded;
+static uint32_t		nb_bad;
+
+static void decoded_callback(void *context, void *new_symbol_buf, esi_t esi) {
+    if (esi >= NB_SOURCE || memcmp(new_symbol_buf, src[esi], SYMBOL_SIZE) != 0)
+        nb_bad++;
+    nb_decoded++;
+    /* allocated by the decoder, with its allocator */
+    dec_allocator.free_func(dec_allocator.context, new_symbol_buf);
+}
+
+static void run_with_allocator(swif_codepoint_t codepoint, uint32_t block_mode) {
+    tenant_t enc_tenant = { 0, 0 };
+    swif_allocator_t enc_allocator = { tenant_alloc, tenant_aligned_alloc, tenant_free, &enc_tenant };
+    swif_encoder_t *enc;
+    swif_decoder_t *dec;
+    uint32_t nb_lost = 0;
+
+    memset(&dec_tenant, 0, sizeof(dec_tenant));
+    nb_decoded = nb_bad = 0;
+    enc = swif_encoder_create_with_allocator(codepoint, 0, SYMBOL_SIZE, WINDOW_SIZE, &enc_allocator);
+    dec = swif_decoder_create_with_allocator(codepoint, 0, SYMBOL_SIZE, WINDOW_SIZE, 4 * WINDOW_SIZE, &dec_allocator);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(enc)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(dec)
+    CU_ASSERT(enc_tenant.nb_alloc > 0)
+    CU_ASSERT(dec_tenant.nb_alloc > 0)
+    if (block_mode) {
+        CU_ASSERT_EQUAL(swif_decoder_set_parameters(dec, swif_DECODER_SET_PARAM_BLOCK_DECODING, sizeof(block_mode), &block_mode), SWIF_STATUS_OK)
+    }
+    CU_ASSERT_EQUAL(swif_decoder_set_callback_functions(dec, NULL, NULL, decoded_callback, NULL), SWIF_STATUS_OK)
+    srand(2);
+    for (esi_t esi = 0; esi < NB_SOURCE; esi++) {
+        for (uint32_t i = 0; i < SYMBOL_SIZE; i++)
+            src[esi][i] = (uint8_t)rand();
+        swif_encoder_add_source_symbol_to_coding_window(enc, src[esi], esi);
+        if (rand() % 5 == 0) {
+            nb_lost++;
+        } else {
+            swif_decoder_decode_with_new_source_symbol(dec, src[esi], esi);
+        }
+        if (esi % 3 == 2) {
+            void *repair = NULL;
+            esi_t first, last;
+            uint32_t nss;
+            swif_encoder_generate_coding_coefs(enc, esi, 0);
+            CU_ASSERT_EQUAL(swif_build_repair_symbol(enc, &repair), SWIF_STATUS_OK)
+            swif_encoder_get_coding_window_information(enc, &first, &last, &nss);
+            swif_decoder_reset_coding_window(dec);
+            for (esi_t e = first; e <= last; e++)
+                swif_decoder_add_source_symbol_to_coding_window(dec, e);
+            swif_decoder_generate_coding_coefs(dec, esi, 0);
+            swif_decoder_decode_with_new_repair_symbol(dec, repair, first);
+            /* built in a new buffer, with the encoder allocator */
+            enc_allocator.free_func(enc_allocator.context, repair);
+        }
+    }
+    CU_ASSERT(nb_lost > 0 && nb_decoded > 0)
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    swif_encoder_release(enc);
+    swif_decoder_release(dec);
+    /* everything went back to its tenant */
+    CU_ASSERT_EQUAL(enc_tenant.nb_live, 0)
+    CU_ASSERT_EQUAL(dec_tenant.nb_live, 0)
+}
+
+void test_swif_allocator(void) {
+    run_with_allocator(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 0);
+    run_with_allocator(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 1);
+    run_with_allocator(SWIF_CODEPOINT_RLC_GF_16_CODEC, 0);
+    run_with_allocator(SWIF_CODEPOINT_RLC_GF_2_CODEC, 0);
+}
+
+void test_swif_allocator_incomplete(void) {
+    swif_allocator_t allocator = { tenant_alloc, NULL, tenant_free, &dec_tenant };
+
+    CU_ASSERT_PTR_NULL(swif_encoder_create_with_allocator(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 0, SYMBOL_SIZE, WINDOW_SIZE, &allocator))
+    CU_ASSERT_PTR_NULL(swif_decoder_create_with_allocator(SWIF_CODEPOINT_RLC_GF_2_CODEC, 0, SYMBOL_SIZE, WINDOW_SIZE, WINDOW_SIZE, &allocator))
+}
+
+
+/* The main() function for setting up and running the tests.
+ * Returns a CUE_SUCCESS on successful running, another
+ * CUnit error code on failure.
+ */
+int main()
+{
+
+    CU_pSuite pSuite = NULL;
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Suite_1", NULL, NULL);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "test of codecs with an allocator", test_swif_allocator)) ||
+        (NULL == CU_add_test(pSuite, "test of an incomplete allocator", test_swif_allocator_incomplete)))
+    {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -22,6 +22,8 @@ bool get_coding_window_information;
 bool set_coding_coefs_tab;
 bool get_coding_coefs_tab;
 bool generate_coding_coefs;
+bool set_repair_window;
+bool build_layer_repair_symbols;
 
 
 void store_args(int count, ...) {
@@ -165,6 +167,27 @@ swif_status_t   dummy_encoder_get_coding_coefs_tab (
 }
 
 
+swif_status_t   dummy_encoder_set_repair_window (
+        swif_encoder_t* enc,
+        esi_t           first,
+        uint32_t        nss)
+{
+    store_args(3, enc, first, nss);
+    set_repair_window = true;
+    return ARBITRARY_UINT32;
+}
+
+swif_status_t   dummy_build_layer_repair_symbols (
+        swif_encoder_t* enc,
+        uint32_t        layer_mask,
+        const uint32_t* key_tab,
+        void**          new_buf_tab)
+{
+    store_args(4, enc, layer_mask, key_tab, new_buf_tab);
+    build_layer_repair_symbols = true;
+    return ARBITRARY_UINT32;
+}
+
 
 int init_test(void)
 {
@@ -182,6 +205,8 @@ int init_test(void)
     dummy_encoder.add_source_symbol_to_coding_window = dummy_encoder_add_source_symbol_to_coding_window;
     dummy_encoder.build_repair_symbol = dummy_build_repair_symbol;
     dummy_encoder.reset_coding_window = dummy_encoder_reset_coding_window;
+    dummy_encoder.set_repair_window = dummy_encoder_set_repair_window;
+    dummy_encoder.build_layer_repair_symbols = dummy_build_layer_repair_symbols;
 
 
     set_callback_functions = false;
@@ -195,6 +220,8 @@ int init_test(void)
     set_coding_coefs_tab = false;
     get_coding_coefs_tab = false;
     generate_coding_coefs = false;
+    set_repair_window = false;
+    build_layer_repair_symbols = false;
 
 }
 
@@ -303,6 +330,24 @@ void test_reset_coding_window(void)
     CU_ASSERT_EQUAL(ret, ARBITRARY_UINT32);
 }
 
+void test_set_repair_window(void)
+{
+    init_test();
+    swif_status_t ret = swif_encoder_set_repair_window(&dummy_encoder, ARBITRARY_UINT32, ARBITRARY_UINT32+1);
+    check_correct_args(3, &dummy_encoder, ARBITRARY_UINT32, ARBITRARY_UINT32+1);
+    CU_ASSERT_TRUE(set_repair_window);
+    CU_ASSERT_EQUAL(ret, ARBITRARY_UINT32);
+}
+
+void test_build_layer_repair_symbols(void)
+{
+    init_test();
+    swif_status_t ret = swif_build_layer_repair_symbols(&dummy_encoder, ARBITRARY_UINT32, ARBITRARY_PTR, ARBITRARY_PTR+1);
+    check_correct_args(4, &dummy_encoder, ARBITRARY_UINT32, ARBITRARY_PTR, ARBITRARY_PTR+1);
+    CU_ASSERT_TRUE(build_layer_repair_symbols);
+    CU_ASSERT_EQUAL(ret, ARBITRARY_UINT32);
+}
+
 
 
 
@@ -338,7 +383,9 @@ int main()
         (NULL == CU_add_test(pSuite, "test of remove_source_symbol_from_coding_window()", test_remove_source_symbol_from_coding_window)) ||
         (NULL == CU_add_test(pSuite, "test of add_source_symbol_to_coding_window()", test_add_source_symbol_to_coding_window)) ||
         (NULL == CU_add_test(pSuite, "test of build_repair_symbol()", test_build_repair_symbol)) ||
-        (NULL == CU_add_test(pSuite, "test of reset_coding_window()", test_reset_coding_window)))
+        (NULL == CU_add_test(pSuite, "test of reset_coding_window()", test_reset_coding_window)) ||
+        (NULL == CU_add_test(pSuite, "test of set_repair_window()", test_set_repair_window)) ||
+        (NULL == CU_add_test(pSuite, "test of build_layer_repair_symbols()", test_build_layer_repair_symbols)))
     {
         CU_cleanup_registry();
         return CU_get_error();
@@ -0,0 +1,163 @@
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <poll.h>
+#include "../src/swif_api.h"
+#include "../src/swif_async_decoder.h"
+
+#define QUEUE_SIZE	32	/* small, so that the I/O thread sees a full ring */
+#define SYMBOL_SIZE	256
+#define WINDOW_SIZE	16
+#define NB_SOURCE	1000
+
+static uint8_t	src[NB_SOURCE][SYMBOL_SIZE];
+static bool	available[NB_SOURCE];
+
+static uint32_t	nb_submitted;	/* buffers given to the decoder */
+static uint32_t	nb_released;	/* and returned */
+static uint32_t	nb_decoded;
+static uint32_t	nb_errors;
+static uint32_t	nb_bad;
+
+static void handle_events(swif_async_decoder_t *adec) {
+    swif_engine_event_t ev[8];
+    uint32_t n, i;
+
+    do {
+        n = swif_async_decoder_poll(adec, ev, 8);
+        for (i = 0; i < n; i++) {
+            switch (ev[i].type) {
+            case SWIF_ENGINE_EV_DECODED:
+                if (ev[i].esi >= NB_SOURCE || memcmp(ev[i].buf, src[ev[i].esi], SYMBOL_SIZE) != 0) {
+                    nb_bad++;
+                } else if (!available[ev[i].esi]) {
+                    available[ev[i].esi] = true;
+                    nb_decoded++;
+                }
+                free(ev[i].buf);
+                break;
+            case SWIF_ENGINE_EV_ERROR:
+                nb_errors++;
+                /* fall through */
+            case SWIF_ENGINE_EV_RELEASED:
+                nb_released++;
+                free(ev[i].buf);
+                break;
+            default:
+                nb_bad++;
+            }
+        }
+    } while (n == 8);
+}
+
+static void *copy_of(const void *buf) {
+    void *copy = malloc(SYMBOL_SIZE);
+    memcpy(copy, buf, SYMBOL_SIZE);
+    return copy;
+}
+
+/* the I/O thread never decodes: it only waits for room in the ring */
+static void submit(swif_async_decoder_t *adec, void *buf, esi_t esi, uint32_t nss, bool repair) {
+    nb_submitted++;
+    while ((repair ? swif_async_decoder_submit_repair_symbol(adec, buf, esi, nss, esi + nss)
+                   : swif_async_decoder_submit_source_symbol(adec, buf, esi)) == SWIF_STATUS_FAILURE) {
+        handle_events(adec);
+    }
+}
+
+void test_swif_async_decoder(void) {
+    swif_async_decoder_t *adec = swif_async_decoder_create(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 0,
+                                                           SYMBOL_SIZE, WINDOW_SIZE, 4 * WINDOW_SIZE, QUEUE_SIZE);
+    swif_encoder_t *enc = swif_encoder_create(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 0, SYMBOL_SIZE, WINDOW_SIZE);
+    uint32_t nb_lost = 0;
+    CU_ASSERT_PTR_NOT_NULL_FATAL(adec)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(enc)
+    srand(1);
+    for (esi_t esi = 0; esi < NB_SOURCE; esi++) {
+        for (uint32_t i = 0; i < SYMBOL_SIZE; i++)
+            src[esi][i] = (uint8_t)rand();
+        swif_encoder_add_source_symbol_to_coding_window(enc, src[esi], esi);
+        /* bursts of losses */
+        if ((esi / 50) % 4 == 3 && esi % 50 < 6) {
+            nb_lost++;
+        } else {
+            available[esi] = true;
+            submit(adec, copy_of(src[esi]), esi, 0, false);
+        }
+        if (esi % 3 == 2) {
+            void *repair = NULL;
+            esi_t first, last;
+            uint32_t nss;
+            swif_encoder_get_coding_window_information(enc, &first, &last, &nss);
+            swif_encoder_generate_coding_coefs(enc, first + nss, 0);
+            swif_build_repair_symbol(enc, &repair);
+            submit(adec, repair, first, nss, true);
+        }
+        handle_events(adec);
+    }
+    /* unknown symbols in the repair symbol: returned with an error */
+    submit(adec, copy_of(src[0]), NB_SOURCE - WINDOW_SIZE, 8 * WINDOW_SIZE, true);
+    while (nb_released < nb_submitted) {
+        int fd = swif_async_decoder_get_event_fd(adec);
+        if (fd >= 0) {
+            struct pollfd pfd = { fd, POLLIN, 0 };
+            CU_ASSERT(poll(&pfd, 1, 5000) == 1)
+        }
+        handle_events(adec);
+    }
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_errors, 1)
+    CU_ASSERT(nb_lost > 0 && nb_decoded == nb_lost)
+    swif_encoder_release(enc);
+    CU_ASSERT_EQUAL(swif_async_decoder_release(adec), SWIF_STATUS_OK)
+}
+
+void test_swif_async_decoder_create(void) {
+    swif_async_decoder_t *adec;
+
+    CU_ASSERT_PTR_NULL(swif_async_decoder_create(SWIF_CODEPOINT_NULL, 0, SYMBOL_SIZE, WINDOW_SIZE, WINDOW_SIZE, QUEUE_SIZE))
+    CU_ASSERT_PTR_NULL(swif_async_decoder_create(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 0, SYMBOL_SIZE, WINDOW_SIZE, WINDOW_SIZE, 0))
+    adec = swif_async_decoder_create(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 0, SYMBOL_SIZE, WINDOW_SIZE, WINDOW_SIZE, 1);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(adec)
+    /* events not polled are discarded */
+    CU_ASSERT_EQUAL(swif_async_decoder_submit_source_symbol(adec, src[0], 0), SWIF_STATUS_OK)
+    CU_ASSERT_EQUAL(swif_async_decoder_release(adec), SWIF_STATUS_OK)
+}
+
+
+/* The main() function for setting up and running the tests.
+ * Returns a CUE_SUCCESS on successful running, another
+ * CUnit error code on failure.
+ */
+int main()
+{
+
+    CU_pSuite pSuite = NULL;
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Suite_1", NULL, NULL);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "test of the asynchronous decoder", test_swif_async_decoder)) ||
+        (NULL == CU_add_test(pSuite, "test of asynchronous decoder creation", test_swif_async_decoder_create)))
+    {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,146 @@
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+#include "../src/swif_channel.h"
+
+#define NB_PACKETS	200000
+
+/* proportion of losses over NB_PACKETS, and mean length of the bursts */
+static double run_channel(swif_channel_t *channel, double *mean_burst) {
+    uint32_t nb_lost = 0, nb_bursts = 0;
+    bool prev = false;
+    for (uint32_t i = 0; i < NB_PACKETS; i++) {
+        bool lost = swif_channel_is_lost(channel);
+        nb_lost += lost;
+        nb_bursts += (lost && !prev);
+        prev = lost;
+    }
+    *mean_burst = (nb_bursts > 0) ? (double)nb_lost / nb_bursts : 0;
+    return (double)nb_lost / NB_PACKETS;
+}
+
+void test_swif_channel_bernoulli(void) {
+    swif_channel_params_t params = { .model = SWIF_CHANNEL_BERNOULLI, .loss_rate = 0.1 };
+    swif_channel_t *c1 = swif_channel_create(&params, 1);
+    swif_channel_t *c2 = swif_channel_create(&params, 1);
+    double burst, rate;
+    uint32_t nb_diff = 0;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(c1)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(c2)
+    /* same seed, same losses */
+    for (uint32_t i = 0; i < 1000; i++)
+        nb_diff += (swif_channel_is_lost(c1) != swif_channel_is_lost(c2));
+    CU_ASSERT_EQUAL(nb_diff, 0)
+    rate = run_channel(c1, &burst);
+    CU_ASSERT(fabs(rate - 0.1) < 0.005)
+    CU_ASSERT(fabs(burst - 1 / 0.9) < 0.05)
+    CU_ASSERT_EQUAL(swif_channel_get_mean_loss_rate(&params), 0.1)
+    swif_channel_release(c1);
+    swif_channel_release(c2);
+
+    params.loss_rate = 0;
+    c1 = swif_channel_create(&params, 2);
+    CU_ASSERT_EQUAL(run_channel(c1, &burst), 0)
+    swif_channel_release(c1);
+    params.loss_rate = 1;
+    c1 = swif_channel_create(&params, 3);
+    CU_ASSERT_EQUAL(run_channel(c1, &burst), 1)
+    swif_channel_release(c1);
+    params.loss_rate = 1.5;
+    CU_ASSERT_PTR_NULL(swif_channel_create(&params, 4))
+}
+
+void test_swif_channel_gilbert_elliott(void) {
+    /* Gilbert model: bursts of 1 / 0.25 = 4 packets, 0.02 / (0.02 + 0.25) lost */
+    swif_channel_params_t params = { .model = SWIF_CHANNEL_GILBERT_ELLIOTT,
+        .p_good_to_bad = 0.02, .p_bad_to_good = 0.25, .loss_good = 0, .loss_bad = 1 };
+    swif_channel_t *c = swif_channel_create(&params, 5);
+    double mean = swif_channel_get_mean_loss_rate(&params);
+    double burst, rate;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(c)
+    CU_ASSERT(fabs(mean - 0.02 / 0.27) < 1e-9)
+    rate = run_channel(c, &burst);
+    CU_ASSERT(fabs(rate - mean) < 0.01)
+    CU_ASSERT(fabs(burst - 4) < 0.3)
+    swif_channel_release(c);
+    params.p_bad_to_good = -0.1;
+    CU_ASSERT_PTR_NULL(swif_channel_create(&params, 6))
+}
+
+void test_swif_channel_trace(void) {
+    static const uint8_t trace[] = { 0, 1, 1, 0, 0 };
+    swif_channel_params_t params = { .model = SWIF_CHANNEL_TRACE, .trace = trace,
+        .trace_len = sizeof(trace), .trace_offset = 6 };
+    const char *path = "/tmp/swif_channel_test.trace";
+    swif_channel_t *c = swif_channel_create(&params, 0);
+    uint8_t *loaded = NULL;
+    uint32_t len = 0, nb_diff = 0;
+    FILE *f;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(c)
+    CU_ASSERT_EQUAL(swif_channel_get_mean_loss_rate(&params), 0.4)
+    /* from entry 6 % 5 = 1, cyclically */
+    for (uint32_t i = 0; i < 3 * sizeof(trace); i++)
+        nb_diff += (swif_channel_is_lost(c) != (trace[(i + 1) % sizeof(trace)] != 0));
+    CU_ASSERT_EQUAL(nb_diff, 0)
+    swif_channel_release(c);
+
+    f = fopen(path, "w");
+    CU_ASSERT_PTR_NOT_NULL_FATAL(f)
+    fprintf(f, "0 1\n1,0\n0\n");
+    fclose(f);
+    CU_ASSERT_EQUAL(swif_channel_load_trace(path, &loaded, &len), SWIF_STATUS_OK)
+    CU_ASSERT_EQUAL(len, sizeof(trace))
+    if (loaded != NULL && len == sizeof(trace))
+        CU_ASSERT(memcmp(loaded, trace, len) == 0)
+    free(loaded);
+    f = fopen(path, "w");
+    fprintf(f, "\n");
+    fclose(f);
+    CU_ASSERT_EQUAL(swif_channel_load_trace(path, &loaded, &len), SWIF_STATUS_ERROR)
+    remove(path);
+    params.trace_len = 0;
+    CU_ASSERT_PTR_NULL(swif_channel_create(&params, 0))
+}
+
+
+/* The main() function for setting up and running the tests.
+ * Returns a CUE_SUCCESS on successful running, another
+ * CUnit error code on failure.
+ */
+int main()
+{
+
+    CU_pSuite pSuite = NULL;
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Suite_1", NULL, NULL);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "test of the Bernoulli channel", test_swif_channel_bernoulli)) ||
+        (NULL == CU_add_test(pSuite, "test of the Gilbert-Elliott channel", test_swif_channel_gilbert_elliott)) ||
+        (NULL == CU_add_test(pSuite, "test of trace replay", test_swif_channel_trace)))
+    {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
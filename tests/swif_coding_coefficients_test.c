@@ -0,0 +1,203 @@
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../src/swif_coding_coefficients.h"
+#include "../src/swif_prng.h"
+
+#define MAX_CC_NB	64
+
+/* a cached vector must be identical to a freshly generated one */
+static void check_same_coefs(swif_cc_cache_t *cache, uint16_t key, uint16_t cc_nb, uint8_t dt, uint8_t m) {
+    uint8_t ref[MAX_CC_NB + 1];
+    uint8_t cc[MAX_CC_NB + 1];
+    memset(ref, 0xAA, sizeof(ref));
+    memset(cc, 0xAA, sizeof(cc));
+    CU_ASSERT_EQUAL(swif_rlc_generate_coding_coefficients(key, ref, cc_nb, dt, m), 0)
+    CU_ASSERT_EQUAL(swif_cc_cache_get_coding_coefficients(cache, key, cc, cc_nb, dt, m), 0)
+    CU_ASSERT_EQUAL(memcmp(ref, cc, sizeof(cc)), 0)
+}
+
+void test_swif_cc_cache_lru(void) {
+    uint64_t hits, misses;
+    swif_cc_cache_t *cache = swif_cc_cache_create(4, MAX_CC_NB);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(cache)
+
+    check_same_coefs(cache, 1, 10, 15, 8);
+    check_same_coefs(cache, 1, 10, 15, 8);
+    /* shorter vector, served from the same entry */
+    check_same_coefs(cache, 1, 5, 15, 8);
+    swif_cc_cache_get_stats(cache, &hits, &misses);
+    CU_ASSERT_EQUAL(hits, 2)
+    CU_ASSERT_EQUAL(misses, 1)
+
+    /* longer vector, still served from the same entry */
+    check_same_coefs(cache, 1, 20, 15, 8);
+    check_same_coefs(cache, 1, MAX_CC_NB, 15, 8);
+    /* same key, other density or field: different entries */
+    check_same_coefs(cache, 1, 20, 7, 8);
+    check_same_coefs(cache, 1, 20, 7, 1);
+    swif_cc_cache_get_stats(cache, &hits, &misses);
+    CU_ASSERT_EQUAL(hits, 4)
+    CU_ASSERT_EQUAL(misses, 3)
+
+    /* key 1/dt 15/m 8 is now the least recently used, evict it */
+    check_same_coefs(cache, 2, 20, 15, 8);
+    check_same_coefs(cache, 3, 20, 15, 8);
+    check_same_coefs(cache, 1, 20, 15, 8);
+    swif_cc_cache_get_stats(cache, &hits, &misses);
+    CU_ASSERT_EQUAL(hits, 4)
+    CU_ASSERT_EQUAL(misses, 6)
+
+    /* too long for the cache */
+    uint8_t cc[MAX_CC_NB + 1];
+    CU_ASSERT_EQUAL(swif_cc_cache_get_coding_coefficients(cache, 1, cc, MAX_CC_NB + 1, 15, 8), 0)
+    /* bad parameters are still reported */
+    CU_ASSERT_NOT_EQUAL(swif_cc_cache_get_coding_coefficients(cache, 1, cc, 10, 16, 8), 0)
+    CU_ASSERT_NOT_EQUAL(swif_cc_cache_get_coding_coefficients(cache, 1, cc, 10, 15, 2), 0)
+    swif_cc_cache_release(cache);
+}
+
+/* a growing coding window only misses the first time for a given key */
+void test_swif_cc_cache_growing_window(void) {
+    uint64_t hits, misses;
+    swif_cc_cache_t *cache = swif_cc_cache_create(4, MAX_CC_NB);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(cache)
+    for (uint16_t cc_nb = 1; cc_nb <= MAX_CC_NB; cc_nb++) {
+        check_same_coefs(cache, 42, cc_nb, 7, 4);
+    }
+    swif_cc_cache_get_stats(cache, &hits, &misses);
+    CU_ASSERT_EQUAL(hits, MAX_CC_NB - 1)
+    CU_ASSERT_EQUAL(misses, 1)
+    swif_cc_cache_release(cache);
+}
+
+void test_swif_cc_cache_many_keys(void) {
+    swif_cc_cache_t *cache = swif_cc_cache_create(16, MAX_CC_NB);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(cache)
+    for (uint32_t i = 0; i < 1000; i++) {
+        check_same_coefs(cache, (uint16_t)((i * 7) % 40), 1 + (i % MAX_CC_NB), 15, 8);
+    }
+    swif_cc_cache_release(cache);
+}
+
+/* empty vectors (e.g. an empty coding window) mixed with normal ones, until
+ * all the entries get recycled several times */
+void test_swif_cc_cache_zero_length(void) {
+    uint64_t hits, misses;
+    swif_cc_cache_t *cache = swif_cc_cache_create(4, MAX_CC_NB);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(cache)
+    for (uint32_t i = 0; i < 200; i++) {
+        uint16_t key = (uint16_t)(i % 11);
+        check_same_coefs(cache, key, (i % 3 == 0) ? 0 : 1 + (i % 17), 15, 8);
+        check_same_coefs(cache, key, 0, 7, 4);
+    }
+    /* empty vectors do not use the cache */
+    swif_cc_cache_get_stats(cache, &hits, &misses);
+    CU_ASSERT_EQUAL(hits + misses, 200 - 67)
+    swif_cc_cache_release(cache);
+}
+
+void test_swif_cc_cache_precomputed(void) {
+    uint64_t hits, misses;
+    swif_cc_cache_t *cache = swif_cc_cache_create(0, 16);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(cache)
+    CU_ASSERT_EQUAL(swif_cc_cache_precompute_all_keys(cache, 15, 8), 0)
+    check_same_coefs(cache, 0, 16, 15, 8);
+    check_same_coefs(cache, 12345, 3, 15, 8);
+    check_same_coefs(cache, 65535, 16, 15, 8);
+    /* not precomputed, generated */
+    check_same_coefs(cache, 12345, 16, 3, 8);
+    swif_cc_cache_get_stats(cache, &hits, &misses);
+    CU_ASSERT_EQUAL(hits, 3)
+    CU_ASSERT_EQUAL(misses, 1)
+    swif_cc_cache_release(cache);
+}
+
+void test_tinymt32_multi(void) {
+    tinymt32_t s;
+    tinymt32_multi_t ms;
+    uint32_t seed[TINYMT32_MULTI_LANES];
+    uint32_t r[TINYMT32_MULTI_LANES];
+    uint32_t ref[TINYMT32_MULTI_LANES][100];
+    for (int l = 0; l < TINYMT32_MULTI_LANES; l++) {
+        seed[l] = (l == 0) ? 0 : 0xFFFFFFFFu / l;
+        tinymt32_init(&s, seed[l]);
+        for (int i = 0; i < 100; i++)
+            ref[l][i] = tinymt32_generate_uint32(&s);
+    }
+    tinymt32_multi_init(&ms, seed);
+    bool same = true;
+    for (int i = 0; i < 100; i++) {
+        tinymt32_multi_generate_uint32(&ms, r);
+        for (int l = 0; l < TINYMT32_MULTI_LANES; l++)
+            same &= (r[l] == ref[l][i]);
+    }
+    CU_ASSERT_TRUE(same)
+}
+
+void test_swif_rlc_generate_coding_coefficients_multi(void) {
+    const uint8_t dt_tab[] = { 15, 7, 0 };
+    const uint8_t m_tab[] = { 8, 4, 1 };
+    const uint32_t nb_keys = 2 * TINYMT32_MULTI_LANES + 3;	/* one partial batch */
+    uint16_t key_tab[nb_keys];
+    uint8_t cc[nb_keys][MAX_CC_NB];
+    uint8_t *cc_tab_tab[nb_keys];
+    uint8_t ref[MAX_CC_NB];
+
+    for (uint32_t k = 0; k < nb_keys; k++) {
+        key_tab[k] = (uint16_t)(k * 3119);
+        cc_tab_tab[k] = cc[k];
+    }
+    for (int d = 0; d < sizeof(dt_tab); d++) {
+        for (int mi = 0; mi < sizeof(m_tab); mi++) {
+            CU_ASSERT_EQUAL(swif_rlc_generate_coding_coefficients_multi(key_tab, cc_tab_tab, MAX_CC_NB, nb_keys, dt_tab[d], m_tab[mi]), 0)
+            for (uint32_t k = 0; k < nb_keys; k++) {
+                swif_rlc_generate_coding_coefficients(key_tab[k], ref, MAX_CC_NB, dt_tab[d], m_tab[mi]);
+                CU_ASSERT_EQUAL(memcmp(ref, cc[k], MAX_CC_NB), 0)
+            }
+        }
+    }
+    CU_ASSERT_NOT_EQUAL(swif_rlc_generate_coding_coefficients_multi(key_tab, cc_tab_tab, MAX_CC_NB, nb_keys, 16, 8), 0)
+}
+
+
+/* The main() function for setting up and running the tests.
+ * Returns a CUE_SUCCESS on successful running, another
+ * CUnit error code on failure.
+ */
+int main()
+{
+
+    CU_pSuite pSuite = NULL;
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Suite_1", NULL, NULL);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "test of the coding coefficients LRU cache", test_swif_cc_cache_lru)) ||
+        (NULL == CU_add_test(pSuite, "test of the coding coefficients cache with a growing window", test_swif_cc_cache_growing_window)) ||
+        (NULL == CU_add_test(pSuite, "test of the coding coefficients cache with many keys", test_swif_cc_cache_many_keys)) ||
+        (NULL == CU_add_test(pSuite, "test of the coding coefficients cache with empty vectors", test_swif_cc_cache_zero_length)) ||
+        (NULL == CU_add_test(pSuite, "test of the coding coefficients precomputed table", test_swif_cc_cache_precomputed)) ||
+        (NULL == CU_add_test(pSuite, "test of tinymt32_multi against tinymt32", test_tinymt32_multi)) ||
+        (NULL == CU_add_test(pSuite, "test of swif_rlc_generate_coding_coefficients_multi ()", test_swif_rlc_generate_coding_coefficients_multi)))
+    {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
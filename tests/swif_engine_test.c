@@ -0,0 +1,226 @@
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "../src/swif_api.h"
+#include "../src/swif_engine.h"
+
+#define NB_WORKERS	4
+#define QUEUE_SIZE	64	/* small, so that producers see full queues */
+#define NB_FLOWS	24
+#define SYMBOL_SIZE	64
+#define WINDOW_SIZE	10
+#define NB_SOURCE	200
+#define NB_REPAIRS	(NB_SOURCE / 2)
+
+static uint8_t	src[NB_FLOWS][NB_SOURCE][SYMBOL_SIZE];
+static uint8_t	ref_repair[NB_FLOWS][NB_REPAIRS][SYMBOL_SIZE];
+static uint32_t	nb_ref_repairs[NB_FLOWS];
+static uint32_t	nb_repairs[NB_FLOWS];
+static bool	available[NB_FLOWS][NB_SOURCE];
+
+static uint32_t	nb_submitted;	/* buffers given to the engine */
+static uint32_t	nb_released;	/* and returned */
+static uint32_t	nb_decoded;
+static uint32_t	nb_errors;
+static uint32_t	nb_bad;
+
+static void handle_events(swif_engine_t *engine) {
+    swif_engine_event_t ev[32];
+    uint32_t n, i, w;
+
+    for (w = 0; w < swif_engine_get_nb_workers(engine); w++) {
+        while ((n = swif_engine_poll(engine, w, ev, 32)) > 0) {
+            for (i = 0; i < n; i++) {
+                uint64_t f = ev[i].flow_id;
+                /* each flow only comes back through its own worker */
+                if (f < NB_FLOWS && swif_engine_get_worker_index(engine, f) != w)
+                    nb_bad++;
+                switch (ev[i].type) {
+                case SWIF_ENGINE_EV_DECODED:
+                    if (f >= NB_FLOWS || ev[i].esi >= NB_SOURCE
+                        || memcmp(ev[i].buf, src[f][ev[i].esi], SYMBOL_SIZE) != 0) {
+                        nb_bad++;
+                    } else if (!available[f][ev[i].esi]) {
+                        available[f][ev[i].esi] = true;
+                        nb_decoded++;
+                    }
+                    free(ev[i].buf);
+                    break;
+                case SWIF_ENGINE_EV_REPAIR:
+                    if (f >= NB_FLOWS || nb_repairs[f] >= nb_ref_repairs[f]
+                        || memcmp(ev[i].buf, ref_repair[f][nb_repairs[f]], SYMBOL_SIZE) != 0) {
+                        nb_bad++;
+                    }
+                    nb_repairs[f]++;
+                    free(ev[i].buf);
+                    break;
+                case SWIF_ENGINE_EV_ERROR:
+                    nb_errors++;
+                    /* the buffer is returned anyway */
+                    /* fall through */
+                case SWIF_ENGINE_EV_RELEASED:
+                    if (ev[i].buf != NULL) {
+                        nb_released++;
+                        free(ev[i].buf);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+}
+
+static void *copy_of(const void *buf) {
+    void *copy = malloc(SYMBOL_SIZE);
+    memcpy(copy, buf, SYMBOL_SIZE);
+    nb_submitted++;
+    return copy;
+}
+
+/* retry while the input queue of the flow's worker is full (call is
+ * evaluated again) */
+#define SUBMIT(engine, call) \
+    while ((call) == SWIF_STATUS_FAILURE) handle_events(engine)
+
+static void reset_counters(void) {
+    memset(available, 0, sizeof(available));
+    memset(nb_ref_repairs, 0, sizeof(nb_ref_repairs));
+    memset(nb_repairs, 0, sizeof(nb_repairs));
+    nb_submitted = nb_released = nb_decoded = nb_errors = nb_bad = 0;
+}
+
+void test_swif_engine_decoders(void) {
+    swif_engine_t *engine = swif_engine_create(NB_WORKERS, QUEUE_SIZE, false);
+    swif_encoder_t *enc[NB_FLOWS];
+    uint32_t nb_lost = 0;
+    uint64_t f;
+    CU_ASSERT_PTR_NOT_NULL_FATAL(engine)
+    CU_ASSERT_EQUAL(swif_engine_get_nb_workers(engine), NB_WORKERS)
+    reset_counters();
+    srand(1);
+    for (f = 0; f < NB_FLOWS; f++) {
+        enc[f] = swif_encoder_create(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 0, SYMBOL_SIZE, WINDOW_SIZE);
+        SUBMIT(engine, swif_engine_create_decoder(engine, f, SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC,
+                                                  SYMBOL_SIZE, WINDOW_SIZE, 2 * WINDOW_SIZE));
+    }
+    /* flows are interleaved, as on a gateway */
+    for (esi_t esi = 0; esi < NB_SOURCE; esi++) {
+        for (f = 0; f < NB_FLOWS; f++) {
+            for (uint32_t i = 0; i < SYMBOL_SIZE; i++)
+                src[f][esi][i] = (uint8_t)rand();
+            swif_encoder_add_source_symbol_to_coding_window(enc[f], src[f][esi], esi);
+            if (rand() % 10 == 0) {
+                nb_lost++;
+            } else {
+                void *buf = copy_of(src[f][esi]);
+                available[f][esi] = true;
+                SUBMIT(engine, swif_engine_submit_source_symbol(engine, f, buf, esi));
+            }
+            if (esi % 2 == 1) {
+                void *repair = NULL;
+                esi_t first, last;
+                uint32_t nss;
+                swif_encoder_generate_coding_coefs(enc[f], esi, 0);
+                swif_build_repair_symbol(enc[f], &repair);
+                swif_encoder_get_coding_window_information(enc[f], &first, &last, &nss);
+                nb_submitted++;
+                SUBMIT(engine, swif_engine_submit_repair_symbol(engine, f, repair, first, nss, esi));
+            }
+        }
+        handle_events(engine);
+    }
+    /* unknown flow: the buffer comes back with an error */
+    void *buf = copy_of(src[0][0]);
+    SUBMIT(engine, swif_engine_submit_source_symbol(engine, NB_FLOWS + 1, buf, 0));
+    for (f = 0; f < NB_FLOWS; f++) {
+        SUBMIT(engine, swif_engine_release_session(engine, f));
+        swif_encoder_release(enc[f]);
+    }
+    while (nb_released < nb_submitted)
+        handle_events(engine);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_errors, 1)
+    CU_ASSERT(nb_decoded > 0 && 10 * nb_decoded >= 9 * nb_lost)
+    CU_ASSERT_EQUAL(swif_engine_release(engine), SWIF_STATUS_OK)
+}
+
+void test_swif_engine_encoders(void) {
+    swif_engine_t *engine = swif_engine_create(NB_WORKERS, QUEUE_SIZE, true);
+    swif_encoder_t *enc[NB_FLOWS];
+    uint64_t f;
+    CU_ASSERT_PTR_NOT_NULL_FATAL(engine)
+    reset_counters();
+    for (f = 0; f < NB_FLOWS; f++) {
+        enc[f] = swif_encoder_create(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 0, SYMBOL_SIZE, WINDOW_SIZE);
+        SUBMIT(engine, swif_engine_create_encoder(engine, f, SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC,
+                                                  SYMBOL_SIZE, WINDOW_SIZE));
+    }
+    for (esi_t esi = 0; esi < NB_SOURCE; esi++) {
+        for (f = 0; f < NB_FLOWS; f++) {
+            void *buf = copy_of(src[f][esi]);
+            SUBMIT(engine, swif_engine_submit_source_symbol(engine, f, buf, esi));
+            swif_encoder_add_source_symbol_to_coding_window(enc[f], src[f][esi], esi);
+            if (esi % 2 == 1) {
+                /* expected repair symbol, from a local encoder */
+                void *repair = NULL;
+                swif_encoder_generate_coding_coefs(enc[f], esi, 0);
+                swif_build_repair_symbol(enc[f], &repair);
+                memcpy(ref_repair[f][nb_ref_repairs[f]++], repair, SYMBOL_SIZE);
+                free(repair);
+                SUBMIT(engine, swif_engine_build_repair_symbol(engine, f, esi));
+            }
+        }
+        handle_events(engine);
+    }
+    /* an encoder returns the source symbols of its coding window */
+    for (f = 0; f < NB_FLOWS; f++) {
+        SUBMIT(engine, swif_engine_release_session(engine, f));
+        swif_encoder_release(enc[f]);
+    }
+    while (nb_released < nb_submitted)
+        handle_events(engine);
+    for (f = 0; f < NB_FLOWS; f++) {
+        CU_ASSERT_EQUAL(nb_repairs[f], NB_REPAIRS)
+    }
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_errors, 0)
+    CU_ASSERT_EQUAL(swif_engine_release(engine), SWIF_STATUS_OK)
+}
+
+
+/* The main() function for setting up and running the tests.
+ * Returns a CUE_SUCCESS on successful running, another
+ * CUnit error code on failure.
+ */
+int main()
+{
+
+    CU_pSuite pSuite = NULL;
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Suite_1", NULL, NULL);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "test of decoder sessions in an engine", test_swif_engine_decoders)) ||
+        (NULL == CU_add_test(pSuite, "test of encoder sessions in an engine", test_swif_engine_encoders)))
+    {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
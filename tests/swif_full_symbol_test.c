@@ -0,0 +1,264 @@
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "../src/swif_includes.h"
+
+#define SET_SIZE	48	/* not a power of two: the columns wrap around */
+#define WINDOW_SIZE	16
+#define MAX_DATA_SIZE	100
+#define NB_SOURCE	1000
+
+static uint8_t	src[NB_SOURCE][MAX_DATA_SIZE];
+static uint32_t	src_size[NB_SOURCE];
+static bool	lost[NB_SOURCE];
+static bool	decoded[NB_SOURCE];
+static uint32_t	nb_decoded;
+static uint32_t	nb_bad;
+
+static void notify_decoded(swif_full_symbol_set_t *set, symbol_id_t symbol_id, void *context) {
+    uint32_t data_size = 0;
+    uint8_t *data = full_symbol_set_get_pivot_data(set, symbol_id, &data_size);
+
+    /* decoded once, as sent, and zero-padded */
+    if (symbol_id >= NB_SOURCE || !lost[symbol_id] || decoded[symbol_id] || data == NULL
+        || data_size < src_size[symbol_id]
+        || memcmp(data, src[symbol_id], src_size[symbol_id]) != 0) {
+        nb_bad++;
+        return;
+    }
+    for (uint32_t i = src_size[symbol_id]; i < data_size; i++) {
+        if (data[i] != 0) {
+            nb_bad++;
+            return;
+        }
+    }
+    decoded[symbol_id] = true;
+    nb_decoded++;
+}
+
+/* the row weights maintained along the eliminations are the actual ones */
+static void check_row_weights(swif_full_symbol_set_t *set) {
+    for (uint32_t col = 0; col < set->size; col++) {
+        const uint8_t *coef = set->coef_matrix + (size_t)col * set->stride;
+        uint32_t weight = 0;
+        for (uint32_t i = 0; i < set->size; i++)
+            weight += (coef[i] != 0);
+        CU_ASSERT_EQUAL(set->row_weight[col], weight)
+    }
+}
+
+/*
+ * Send NB_SOURCE source symbols of random sizes and one repair symbol,
+ * over the last WINDOW_SIZE source symbols, after each source symbol
+ * with (esi % repair_period) == 0. The source symbols with
+ * is_lost(esi) are not added to the set. In block mode, the repair
+ * symbols are pending until they can be solved all at once.
+ * Returns the number of source symbols lost.
+ */
+static uint32_t run_round_trip(uint8_t l, uint32_t pivot_policy, bool block_mode,
+                               uint32_t repair_period, bool (*is_lost)(esi_t)) {
+    swif_full_symbol_set_t *set = full_symbol_set_alloc_with_size(SET_SIZE);
+    uint8_t coef[WINDOW_SIZE];
+    uint8_t repair[MAX_DATA_SIZE];
+    uint32_t nb_lost = 0;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(set)
+    set->log2_nb_bit_coef = l;
+    set->pivot_policy = pivot_policy;
+    set->block_mode = block_mode;
+    set->notify_decoded_func = notify_decoded;
+    memset(decoded, 0, sizeof(decoded));
+    nb_decoded = nb_bad = 0;
+    srand(1);
+    for (esi_t esi = 0; esi < NB_SOURCE; esi++) {
+        src_size[esi] = 1 + rand() % MAX_DATA_SIZE;
+        for (uint32_t i = 0; i < src_size[esi]; i++)
+            src[esi][i] = (uint8_t)rand();
+        lost[esi] = is_lost(esi);
+        if (lost[esi]) {
+            nb_lost++;
+        } else {
+            uint8_t one = 1;
+            full_symbol_set_add_coefs(set, &one, esi, 1, src[esi], src_size[esi]);
+        }
+        if (esi % repair_period == 0) {
+            esi_t first = (esi + 1 >= WINDOW_SIZE) ? esi + 1 - WINDOW_SIZE : 0;
+            uint32_t nb_id = esi - first + 1;
+            uint32_t size = 0;
+            memset(repair, 0, sizeof(repair));
+            for (uint32_t i = 0; i < nb_id; i++) {
+                coef[i] = (uint8_t)(1 + rand() % ((1 << (1 << l)) - 1));
+                lc_vector_add_mul(coef[i], src[first + i], src_size[first + i], l, repair);
+                size = MAX(size, src_size[first + i]);
+            }
+            full_symbol_set_add_coefs(set, coef, first, nb_id, repair, size);
+        }
+        check_row_weights(set);
+    }
+    full_symbol_set_free(set);
+    return nb_lost;
+}
+
+/* bursts of 4 source symbols every 40 */
+static bool burst_loss(esi_t esi) {
+    return esi % 40 >= 10 && esi % 40 < 14;
+}
+
+/* isolated losses, every 3 source symbols */
+static bool interleaved_loss(esi_t esi) {
+    return esi % 3 == 1;
+}
+
+void test_full_symbol_set_burst_loss(void) {
+    uint32_t nb_lost = run_round_trip(3, SWIF_PIVOT_POLICY_OLDEST_ESI, false, 2, burst_loss);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_decoded, nb_lost)
+    nb_lost = run_round_trip(2, SWIF_PIVOT_POLICY_OLDEST_ESI, false, 2, burst_loss);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_decoded, nb_lost)
+}
+
+void test_full_symbol_set_interleaved_loss(void) {
+    uint32_t nb_lost = run_round_trip(3, SWIF_PIVOT_POLICY_OLDEST_ESI, false, 1, interleaved_loss);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_decoded, nb_lost)
+}
+
+void test_full_symbol_set_min_fill_in(void) {
+    uint32_t nb_lost = run_round_trip(3, SWIF_PIVOT_POLICY_MIN_FILL_IN, false, 2, burst_loss);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_decoded, nb_lost)
+}
+
+void test_full_symbol_set_block_burst_loss(void) {
+    uint32_t nb_lost = run_round_trip(3, SWIF_PIVOT_POLICY_OLDEST_ESI, true, 2, burst_loss);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_decoded, nb_lost)
+    nb_lost = run_round_trip(2, SWIF_PIVOT_POLICY_OLDEST_ESI, true, 2, burst_loss);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_decoded, nb_lost)
+}
+
+void test_full_symbol_set_block_interleaved_loss(void) {
+    uint32_t nb_lost = run_round_trip(3, SWIF_PIVOT_POLICY_OLDEST_ESI, true, 1, interleaved_loss);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_decoded, nb_lost)
+}
+
+/*
+ * Block mode, with fewer independent equations than missing source
+ * symbols: redundant ones are not kept, nothing is decoded until the
+ * system has full rank, and a source symbol received late is subtracted
+ * from the pending equations.
+ */
+void test_full_symbol_set_block_rank_deficient(void) {
+    swif_full_symbol_set_t *set = full_symbol_set_alloc_with_size(SET_SIZE);
+    uint8_t coef[4][4] = { { 1, 2, 3, 4 }, { 5, 6, 7, 8 }, { 0 }, { 9, 10, 11, 12 } };
+    uint8_t data[4][MAX_DATA_SIZE];
+    uint8_t one = 1;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(set)
+    set->log2_nb_bit_coef = 3;
+    set->block_mode = true;
+    set->notify_decoded_func = notify_decoded;
+    memset(decoded, 0, sizeof(decoded));
+    memset(lost, 0, sizeof(lost));
+    nb_decoded = nb_bad = 0;
+    srand(2);
+    for (esi_t esi = 0; esi < 4; esi++) {
+        src_size[esi] = MAX_DATA_SIZE;
+        for (uint32_t i = 0; i < MAX_DATA_SIZE; i++)
+            src[esi][i] = (uint8_t)rand();
+        lost[esi] = true;
+    }
+    /* coef[2] = coef[0] + 3 . coef[1] */
+    for (uint32_t j = 0; j < 4; j++)
+        coef[2][j] = coef[0][j] ^ gf256_mul(3, coef[1][j]);
+    for (uint32_t k = 0; k < 4; k++) {
+        memset(data[k], 0, MAX_DATA_SIZE);
+        for (uint32_t j = 0; j < 4; j++)
+            lc_vector_add_mul(coef[k][j], src[j], MAX_DATA_SIZE, 3, data[k]);
+    }
+    CU_ASSERT_NOT_EQUAL(full_symbol_set_add_coefs(set, coef[0], 0, 4, data[0], MAX_DATA_SIZE), ENTRY_INDEX_NONE)
+    CU_ASSERT_NOT_EQUAL(full_symbol_set_add_coefs(set, coef[1], 0, 4, data[1], MAX_DATA_SIZE), ENTRY_INDEX_NONE)
+    CU_ASSERT_EQUAL(full_symbol_set_add_coefs(set, coef[2], 0, 4, data[2], MAX_DATA_SIZE), ENTRY_INDEX_NONE)
+    CU_ASSERT_EQUAL(set->nb_pending, 2)
+    CU_ASSERT_EQUAL(full_symbol_set_get_rank(set), 2)
+    CU_ASSERT_EQUAL(nb_decoded, 0)
+    /* source symbol 1 arrives late: 0, 2 and 3 remain, with 2 equations */
+    lost[1] = false;
+    CU_ASSERT_NOT_EQUAL(full_symbol_set_add_coefs(set, &one, 1, 1, src[1], MAX_DATA_SIZE), ENTRY_INDEX_NONE)
+    CU_ASSERT_EQUAL(set->nb_pending, 2)
+    CU_ASSERT_EQUAL(full_symbol_set_get_rank(set), 3)
+    CU_ASSERT_EQUAL(nb_decoded, 0)
+    CU_ASSERT_NOT_EQUAL(full_symbol_set_add_coefs(set, coef[3], 0, 4, data[3], MAX_DATA_SIZE), ENTRY_INDEX_NONE)
+    CU_ASSERT_EQUAL(set->nb_pending, 0)
+    CU_ASSERT_EQUAL(full_symbol_set_get_rank(set), 4)
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_decoded, 3)
+    check_row_weights(set);
+    full_symbol_set_free(set);
+}
+
+/* an equation that is a combination of the previous ones adds nothing */
+void test_full_symbol_set_redundant(void) {
+    swif_full_symbol_set_t *set = full_symbol_set_alloc_with_size(SET_SIZE);
+    uint8_t coef1[3] = { 1, 2, 3 };
+    uint8_t coef2[3] = { 4, 5, 6 };
+    uint8_t coef3[3];
+    uint8_t data1[8] = { 1 }, data2[8] = { 2 }, data3[8];
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(set)
+    CU_ASSERT_NOT_EQUAL(full_symbol_set_add_coefs(set, coef1, 10, 3, data1, 8), ENTRY_INDEX_NONE)
+    CU_ASSERT_NOT_EQUAL(full_symbol_set_add_coefs(set, coef2, 10, 3, data2, 8), ENTRY_INDEX_NONE)
+    for (uint32_t i = 0; i < 3; i++)
+        coef3[i] = coef1[i] ^ gf256_mul(7, coef2[i]);
+    for (uint32_t i = 0; i < 8; i++)
+        data3[i] = data1[i] ^ gf256_mul(7, data2[i]);
+    CU_ASSERT_EQUAL(full_symbol_set_add_coefs(set, coef3, 10, 3, data3, 8), ENTRY_INDEX_NONE)
+    CU_ASSERT_EQUAL(full_symbol_set_add_coefs(set, coef1, 10, 3, data1, 8), ENTRY_INDEX_NONE)
+    CU_ASSERT_EQUAL(full_symbol_set_get_rank(set), 2)
+    check_row_weights(set);
+    full_symbol_set_free(set);
+}
+
+/* The main() function for setting up and running the tests.
+ * Returns a CUE_SUCCESS on successful running, another
+ * CUnit error code on failure.
+ */
+int main()
+{
+    CU_pSuite pSuite = NULL;
+
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Suite_1", NULL, NULL);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "test of the full symbol set with burst losses", test_full_symbol_set_burst_loss)) ||
+        (NULL == CU_add_test(pSuite, "test of the full symbol set with interleaved losses", test_full_symbol_set_interleaved_loss)) ||
+        (NULL == CU_add_test(pSuite, "test of the full symbol set with minimum fill-in pivoting", test_full_symbol_set_min_fill_in)) ||
+        (NULL == CU_add_test(pSuite, "test of the full symbol set with redundant equations", test_full_symbol_set_redundant)) ||
+        (NULL == CU_add_test(pSuite, "test of block mode with burst losses", test_full_symbol_set_block_burst_loss)) ||
+        (NULL == CU_add_test(pSuite, "test of block mode with interleaved losses", test_full_symbol_set_block_interleaved_loss)) ||
+        (NULL == CU_add_test(pSuite, "test of block mode with a rank deficient system", test_full_symbol_set_block_rank_deficient)))
+    {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
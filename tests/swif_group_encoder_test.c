@@ -0,0 +1,174 @@
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "../src/swif_api.h"
+#include "../src/swif_group_encoder.h"
+
+#define VERBOSITY	0
+#define SYMBOL_SIZE	512
+#define WINDOW_SIZE	16
+
+static uint8_t	src[2 * WINDOW_SIZE][SYMBOL_SIZE];
+
+void test_swif_group_encoder_shared_repair(void) {
+    swif_group_encoder_t *group = swif_group_encoder_create(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC,
+                                                            VERBOSITY, SYMBOL_SIZE, WINDOW_SIZE);
+    swif_encoder_t *ref = swif_encoder_create(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC,
+                                              VERBOSITY, SYMBOL_SIZE, WINDOW_SIZE);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(group)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(ref)
+    swif_repair_cursor_t *a = swif_group_encoder_add_cursor(group, WINDOW_SIZE, 100);
+    swif_repair_cursor_t *b = swif_group_encoder_add_cursor(group, WINDOW_SIZE, 100);
+    swif_repair_cursor_t *c = swif_group_encoder_add_cursor(group, 4, 100);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(c)
+    CU_ASSERT_PTR_NULL(swif_group_encoder_add_cursor(group, WINDOW_SIZE + 1, 0))
+
+    void *buf_a, *buf_b, *buf_c, *ref_buf = NULL;
+    uint16_t key;
+    esi_t first, ref_first, ref_last;
+    uint32_t nss, ref_nss, size;
+    uint64_t built, shared;
+
+    CU_ASSERT_EQUAL(swif_repair_cursor_build_repair_symbol(a, &buf_a, &key, &first, &nss, &size), SWIF_STATUS_FAILURE)
+    for (esi_t esi = 0; esi < 2 * WINDOW_SIZE; esi++) {
+        for (int i = 0; i < SYMBOL_SIZE; i++)
+            src[esi][i] = (uint8_t)rand();
+        CU_ASSERT_EQUAL(swif_group_encoder_add_source_symbol(group, src[esi], esi), SWIF_STATUS_OK)
+        swif_encoder_add_source_symbol_to_coding_window(ref, src[esi], esi);
+
+        CU_ASSERT_EQUAL(swif_repair_cursor_build_repair_symbol(a, &buf_a, &key, &first, &nss, &size), SWIF_STATUS_OK)
+        CU_ASSERT_EQUAL(swif_repair_cursor_build_repair_symbol(b, &buf_b, &key, &first, &nss, &size), SWIF_STATUS_OK)
+        /* same window and key: built once */
+        CU_ASSERT_PTR_EQUAL(buf_a, buf_b)
+        /* identical to the repair symbol of a standalone encoder */
+        swif_encoder_generate_coding_coefs(ref, key, 0);
+        swif_build_repair_symbol(ref, &ref_buf);
+        swif_encoder_get_coding_window_information(ref, &ref_first, &ref_last, &ref_nss);
+        CU_ASSERT_EQUAL(first, ref_first)
+        CU_ASSERT_EQUAL(nss, ref_nss)
+        CU_ASSERT_EQUAL(size, SYMBOL_SIZE)
+        CU_ASSERT_EQUAL(memcmp(buf_a, ref_buf, SYMBOL_SIZE), 0)
+
+        CU_ASSERT_EQUAL(swif_repair_cursor_build_repair_symbol(c, &buf_c, &key, &first, &nss, &size), SWIF_STATUS_OK)
+        CU_ASSERT_EQUAL(nss, (esi + 1 < 4) ? esi + 1 : 4)
+        CU_ASSERT_EQUAL(first, esi + 1 - nss)
+        if (nss < ref_nss) {
+            CU_ASSERT_PTR_NOT_EQUAL(buf_a, buf_c)
+        }
+    }
+    swif_group_encoder_get_stats(group, &built, &shared);
+    /* b always shares the repair of a, c only while the coding window
+     * holds less than 4 source symbols */
+    CU_ASSERT_EQUAL(shared, 2 * WINDOW_SIZE + 4)
+    CU_ASSERT_EQUAL(built + shared, 3 * 2 * WINDOW_SIZE)
+
+    CU_ASSERT_EQUAL(swif_group_encoder_remove_cursor(group, b), SWIF_STATUS_OK)
+    CU_ASSERT_EQUAL(swif_group_encoder_remove_cursor(group, b), SWIF_STATUS_ERROR)
+    free(ref_buf);
+    swif_encoder_release(ref);
+    CU_ASSERT_EQUAL(swif_group_encoder_release(group), SWIF_STATUS_OK)
+}
+
+
+/*
+ * With variable-length symbols, the cursors return the number of bytes to
+ * send, and leave the repair window selected by the application on the
+ * shared encoder untouched.
+ */
+void test_swif_group_encoder_variable_length(void) {
+    swif_group_encoder_t *group = swif_group_encoder_create(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC,
+                                                            VERBOSITY, SYMBOL_SIZE, WINDOW_SIZE);
+    swif_encoder_t *ref = swif_encoder_create(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC,
+                                              VERBOSITY, SYMBOL_SIZE, WINDOW_SIZE);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(group)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(ref)
+    swif_encoder_t *enc = swif_group_encoder_get_encoder(group);
+    swif_repair_cursor_t *a = swif_group_encoder_add_cursor(group, WINDOW_SIZE, 0);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(a)
+    uint32_t one = 1;
+    CU_ASSERT_EQUAL(swif_encoder_set_parameters(enc, swif_ENCODER_SET_PARAM_VARIABLE_LENGTH_SYMBOLS,
+                                                sizeof(one), &one), SWIF_STATUS_OK)
+    CU_ASSERT_EQUAL(swif_encoder_set_parameters(ref, swif_ENCODER_SET_PARAM_VARIABLE_LENGTH_SYMBOLS,
+                                                sizeof(one), &one), SWIF_STATUS_OK)
+
+    void *buf_a, *ref_buf = NULL;
+    uint16_t key;
+    esi_t first, last;
+    uint32_t nss, size, ref_size;
+
+    for (esi_t esi = 0; esi < 2 * WINDOW_SIZE; esi++) {
+        uint32_t len = rand() % 100;
+        memset(src[esi], 0, SYMBOL_SIZE);
+        swif_set_symbol_length_prefix(src[esi], (uint16_t)len);
+        for (uint32_t i = 0; i < len; i++)
+            src[esi][SWIF_LENGTH_PREFIX_SIZE + i] = (uint8_t)rand();
+        CU_ASSERT_EQUAL(swif_group_encoder_add_source_symbol(group, src[esi], esi), SWIF_STATUS_OK)
+        swif_encoder_add_source_symbol_to_coding_window(ref, src[esi], esi);
+        if (esi == 4) {
+            /* the application only repairs the first source symbols */
+            CU_ASSERT_EQUAL(swif_encoder_set_repair_window(enc, 0, 2), SWIF_STATUS_OK)
+        }
+
+        CU_ASSERT_EQUAL(swif_repair_cursor_build_repair_symbol(a, &buf_a, &key, &first, &nss, &size), SWIF_STATUS_OK)
+        swif_encoder_generate_coding_coefs(ref, key, 0);
+        swif_build_repair_symbol(ref, &ref_buf);
+        swif_encoder_get_parameters(ref, swif_ENCODER_GET_PARAM_REPAIR_SYMBOL_SIZE, sizeof(ref_size), &ref_size);
+        CU_ASSERT_EQUAL(size, ref_size)
+        CU_ASSERT(size < SYMBOL_SIZE)
+        CU_ASSERT_EQUAL(memcmp(buf_a, ref_buf, size), 0)
+
+        if (esi < 4) {
+            CU_ASSERT_EQUAL(swif_encoder_get_coding_window_information(enc, &first, &last, &nss), SWIF_STATUS_OK)
+            CU_ASSERT_EQUAL(first, 0)
+            CU_ASSERT_EQUAL(last, esi)
+        } else {
+            /* still restricted, until this range has left the coding window */
+            CU_ASSERT_EQUAL(swif_encoder_get_coding_window_information(enc, &first, &last, &nss),
+                            (esi <= WINDOW_SIZE) ? SWIF_STATUS_OK : SWIF_STATUS_FAILURE)
+            if (esi <= WINDOW_SIZE) {
+                CU_ASSERT_EQUAL(last, 1)
+            }
+        }
+    }
+    free(ref_buf);
+    swif_encoder_release(ref);
+    CU_ASSERT_EQUAL(swif_group_encoder_release(group), SWIF_STATUS_OK)
+}
+
+
+/* The main() function for setting up and running the tests.
+ * Returns a CUE_SUCCESS on successful running, another
+ * CUnit error code on failure.
+ */
+int main()
+{
+
+    CU_pSuite pSuite = NULL;
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Suite_1", NULL, NULL);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "test of repair symbols shared by several cursors", test_swif_group_encoder_shared_repair)) ||
+        (NULL == CU_add_test(pSuite, "test of the repair size and of the repair window of the application", test_swif_group_encoder_variable_length)))
+    {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,170 @@
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include "../src/swif_linear-code.h"
+#include "../src/swif_symbol.h"
+#include "../src/swif_coding_coefficients.h"
+
+#define MAX_SIZE	100
+
+/* element by element reference of lc_vector_mul() and lc_vector_add_mul() */
+static void check_vector_mul(uint8_t coef, uint32_t size, uint8_t l) {
+    uint8_t data[MAX_SIZE];
+    uint8_t ref_mul[MAX_SIZE];
+    uint8_t ref_add_mul[MAX_SIZE];
+    uint8_t result[MAX_SIZE];
+    uint16_t nb_coef = (uint16_t)((size * 8) >> l);
+
+    for (uint32_t i = 0; i < size; i++) {
+        data[i] = (uint8_t)rand();
+        ref_add_mul[i] = (uint8_t)rand();
+    }
+    memset(ref_mul, 0, size);
+    for (uint16_t i = 0; i < nb_coef; i++) {
+        uint8_t x = lc_mul(coef, lc_vector_get(data, size, l, i), l);
+        lc_vector_set(ref_mul, size, l, i, x);
+    }
+    lc_vector_mul(coef, data, size, l, result);
+    CU_ASSERT_EQUAL(memcmp(result, ref_mul, size), 0)
+
+    memcpy(result, ref_add_mul, size);
+    for (uint32_t i = 0; i < size; i++)
+        ref_add_mul[i] ^= ref_mul[i];
+    lc_vector_add_mul(coef, data, size, l, result);
+    CU_ASSERT_EQUAL(memcmp(result, ref_add_mul, size), 0)
+
+    /* in place */
+    lc_vector_mul(coef, data, size, l, data);
+    CU_ASSERT_EQUAL(memcmp(data, ref_mul, size), 0)
+}
+
+void test_lc_vector_mul(void) {
+    for (uint8_t l = 0; l <= MAX_LOG2_NB_BIT_COEF; l++) {
+        for (uint32_t coef = 0; coef < (1u << (1 << l)); coef += (l == 3) ? 37 : 1) {
+            for (uint32_t size = 0; size <= MAX_SIZE; size += 7)
+                check_vector_mul((uint8_t)coef, size, l);
+        }
+    }
+}
+
+/* the fixed-size kernels compute the same as lc_vector_*() */
+static void check_kernels(uint32_t size, uint8_t l, int aligned) {
+    const symbol_kernels_t *k = lc_get_kernels(size, l, aligned);
+    uint8_t *data = NULL, *result = NULL, *ref = NULL;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(k)
+    CU_ASSERT_EQUAL(k->symbol_size, size)
+    CU_ASSERT_EQUAL_FATAL(posix_memalign((void **)&data, SYMBOL_ALIGNMENT, size), 0)
+    CU_ASSERT_EQUAL_FATAL(posix_memalign((void **)&result, SYMBOL_ALIGNMENT, size), 0)
+    CU_ASSERT_EQUAL_FATAL(posix_memalign((void **)&ref, SYMBOL_ALIGNMENT, size), 0)
+    for (uint32_t coef = 0; coef < (1u << (1 << l)); coef += (l == 3) ? 51 : 1) {
+        for (uint32_t i = 0; i < size; i++) {
+            data[i] = (uint8_t)rand();
+            result[i] = ref[i] = (uint8_t)rand();
+        }
+        k->add_mul((uint8_t)coef, data, result);
+        lc_vector_add_mul((uint8_t)coef, data, size, l, ref);
+        CU_ASSERT_EQUAL(memcmp(result, ref, size), 0)
+        k->mul((uint8_t)coef, data, result);
+        lc_vector_mul((uint8_t)coef, data, size, l, ref);
+        CU_ASSERT_EQUAL(memcmp(result, ref, size), 0)
+    }
+    free(data);
+    free(result);
+    free(ref);
+}
+
+#define CHECK_KERNELS(size)	check_kernels(size, l, 0);
+#define CHECK_ALIGNED_KERNELS(size)	check_kernels(size, l, 1);
+
+void test_lc_get_kernels(void) {
+    uint8_t l_tab[] = { 0, 2, 3 };
+    for (uint32_t k = 0; k < sizeof(l_tab); k++) {
+        uint8_t l = l_tab[k];
+        SYMBOL_KERNEL_SIZES(CHECK_KERNELS)
+        SYMBOL_ALIGNED_KERNEL_SIZES(CHECK_ALIGNED_KERNELS)
+        CU_ASSERT_PTR_NULL(lc_get_kernels(1000, l, 0))
+        CU_ASSERT_PTR_NULL(lc_get_kernels(1400, l, 1))
+    }
+    /* GF(4) has none */
+    CU_ASSERT_PTR_NULL(lc_get_kernels(1024, 1, 0))
+}
+
+void test_lc_inv(void) {
+    for (uint8_t l = 0; l <= MAX_LOG2_NB_BIT_COEF; l++) {
+        for (uint32_t x = 1; x < (1u << (1 << l)); x++)
+            CU_ASSERT_EQUAL(lc_mul((uint8_t)x, lc_inv((uint8_t)x, l), l), 1)
+    }
+}
+
+void test_lc_vector_set_get_gf16(void) {
+    uint8_t data[2] = { 0, 0 };
+    lc_vector_set(data, 2, 2, 0, 0x3);
+    lc_vector_set(data, 2, 2, 1, 0xa);
+    lc_vector_set(data, 2, 2, 2, 0xf);
+    CU_ASSERT_EQUAL(data[0], 0xa3)
+    CU_ASSERT_EQUAL(data[1], 0x0f)
+    CU_ASSERT_EQUAL(lc_vector_get(data, 2, 2, 1), 0xa)
+    CU_ASSERT_EQUAL(lc_vector_get(data, 2, 2, 3), 0)
+}
+
+void test_swif_rlc_generate_coding_coefficients_gf16(void) {
+    uint8_t cc[MAX_SIZE];
+    bool ok = true;
+    uint32_t nb_zero = 0;
+
+    for (uint16_t key = 0; key < 100; key++) {
+        CU_ASSERT_EQUAL(swif_rlc_generate_coding_coefficients(key, cc, MAX_SIZE, 15, 4), 0)
+        for (uint32_t i = 0; i < MAX_SIZE; i++)
+            ok &= (cc[i] >= 1 && cc[i] <= 15);
+        CU_ASSERT_EQUAL(swif_rlc_generate_coding_coefficients(key, cc, MAX_SIZE, 7, 4), 0)
+        for (uint32_t i = 0; i < MAX_SIZE; i++) {
+            ok &= (cc[i] <= 15);
+            nb_zero += (cc[i] == 0);
+        }
+    }
+    CU_ASSERT_TRUE(ok)
+    /* about half of the coefficients are 0 with dt=7 */
+    CU_ASSERT_TRUE(nb_zero > 100 * MAX_SIZE / 3 && nb_zero < 2 * 100 * MAX_SIZE / 3)
+}
+
+
+/* The main() function for setting up and running the tests.
+ * Returns a CUE_SUCCESS on successful running, another
+ * CUnit error code on failure.
+ */
+int main()
+{
+
+    CU_pSuite pSuite = NULL;
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Suite_1", NULL, NULL);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "test of lc_vector_mul() and lc_vector_add_mul()", test_lc_vector_mul)) ||
+        (NULL == CU_add_test(pSuite, "test of lc_get_kernels()", test_lc_get_kernels)) ||
+        (NULL == CU_add_test(pSuite, "test of lc_inv()", test_lc_inv)) ||
+        (NULL == CU_add_test(pSuite, "test of lc_vector_set()/lc_vector_get() in GF(16)", test_lc_vector_set_get_gf16)) ||
+        (NULL == CU_add_test(pSuite, "test of GF(16) coding coefficients", test_swif_rlc_generate_coding_coefficients_gf16)))
+    {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,196 @@
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "../src/swif_api.h"
+#include "../src/swif_pipelined_encoder.h"
+
+#define QUEUE_SIZE	8	/* small, so that the producer sees full rings */
+#define SYMBOL_SIZE	512
+#define WINDOW_SIZE	20
+#define NB_SOURCE	600
+#define NB_REPAIRS	(NB_SOURCE / 2)
+
+static uint8_t	src[NB_SOURCE][SYMBOL_SIZE];
+static uint8_t	ref_repair[NB_REPAIRS][SYMBOL_SIZE];
+static uint32_t	ref_size[NB_REPAIRS];
+static uint32_t	nb_repairs;
+static esi_t	next_released;
+static void*	buf_tab[NB_SOURCE];
+static uint32_t	nb_bad;
+
+static void handle_events(swif_pipelined_encoder_t *penc) {
+    swif_engine_event_t ev[4];
+    uint32_t n, i;
+
+    do {
+        n = swif_pipelined_encoder_poll(penc, ev, 4);
+        for (i = 0; i < n; i++) {
+            switch (ev[i].type) {
+            case SWIF_ENGINE_EV_REPAIR:
+                /* in order, each over the coding window of its snapshot */
+                if (nb_repairs >= NB_REPAIRS || ev[i].key != 2 * nb_repairs + 1
+                    || ev[i].esi + ev[i].nss != ev[i].key + 1
+                    || ev[i].size != ref_size[nb_repairs]
+                    || memcmp(ev[i].buf, ref_repair[nb_repairs], SYMBOL_SIZE) != 0) {
+                    nb_bad++;
+                }
+                nb_repairs++;
+                free(ev[i].buf);
+                break;
+            case SWIF_ENGINE_EV_RELEASED:
+                /* in order, once out of the coding window */
+                if (ev[i].esi != next_released || ev[i].buf != buf_tab[ev[i].esi]) {
+                    nb_bad++;
+                }
+                next_released++;
+                free(ev[i].buf);
+                break;
+            default:
+                nb_bad++;
+            }
+        }
+    } while (n == 4);
+}
+
+/*
+ * Half of the repair symbols are built into a buffer given by the
+ * application. With variable_length, the source symbols are
+ * length-prefixed, and mostly short.
+ */
+static void run_pipeline(swif_codepoint_t codepoint, bool variable_length) {
+    swif_pipelined_encoder_t *penc = swif_pipelined_encoder_create(codepoint, 0, SYMBOL_SIZE, WINDOW_SIZE, QUEUE_SIZE);
+    swif_encoder_t *enc = swif_encoder_create(codepoint, 0, SYMBOL_SIZE, WINDOW_SIZE);
+    uint32_t one = 1;
+    uint32_t nb_expected = 0;
+    CU_ASSERT_PTR_NOT_NULL_FATAL(penc)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(enc)
+    if (variable_length) {
+        CU_ASSERT_EQUAL(swif_pipelined_encoder_set_parameters(penc, swif_ENCODER_SET_PARAM_VARIABLE_LENGTH_SYMBOLS,
+                                                              sizeof(one), &one), SWIF_STATUS_OK)
+        CU_ASSERT_EQUAL(swif_encoder_set_parameters(enc, swif_ENCODER_SET_PARAM_VARIABLE_LENGTH_SYMBOLS,
+                                                    sizeof(one), &one), SWIF_STATUS_OK)
+    }
+    nb_repairs = nb_bad = 0;
+    next_released = 0;
+    srand(1);
+    for (esi_t esi = 0; esi < NB_SOURCE; esi++) {
+        for (uint32_t i = 0; i < SYMBOL_SIZE; i++)
+            src[esi][i] = (uint8_t)rand();
+        if (variable_length) {
+            uint32_t len = (rand() % 10 == 0) ? SYMBOL_SIZE - SWIF_LENGTH_PREFIX_SIZE : rand() % 50;
+            swif_set_symbol_length_prefix(src[esi], (uint16_t)len);
+            memset(src[esi] + SWIF_LENGTH_PREFIX_SIZE + len, 0, SYMBOL_SIZE - SWIF_LENGTH_PREFIX_SIZE - len);
+        }
+        buf_tab[esi] = malloc(SYMBOL_SIZE);
+        memcpy(buf_tab[esi], src[esi], SYMBOL_SIZE);
+        while (swif_pipelined_encoder_add_source_symbol(penc, buf_tab[esi], esi) == SWIF_STATUS_FAILURE)
+            handle_events(penc);
+        swif_encoder_add_source_symbol_to_coding_window(enc, src[esi], esi);
+        if (esi % 2 == 1) {
+            /* expected repair symbol, from a local encoder */
+            void *repair = NULL;
+            swif_encoder_generate_coding_coefs(enc, esi, 0);
+            swif_build_repair_symbol(enc, &repair);
+            swif_encoder_get_parameters(enc, swif_ENCODER_GET_PARAM_REPAIR_SYMBOL_SIZE,
+                                        sizeof(ref_size[nb_expected]), &ref_size[nb_expected]);
+            memcpy(ref_repair[nb_expected], repair, SYMBOL_SIZE);
+            free(repair);
+            repair = (nb_expected++ % 2 == 0) ? malloc(SYMBOL_SIZE) : NULL;
+            while (swif_pipelined_encoder_build_repair_symbol(penc, esi, repair) == SWIF_STATUS_FAILURE)
+                handle_events(penc);
+        }
+        if (esi % 7 == 0)
+            handle_events(penc);
+    }
+    while (nb_repairs < NB_REPAIRS || next_released < NB_SOURCE - WINDOW_SIZE)
+        handle_events(penc);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_repairs, NB_REPAIRS)
+    /* the coding window is never given back */
+    CU_ASSERT_EQUAL(next_released, NB_SOURCE - WINDOW_SIZE)
+    CU_ASSERT_EQUAL(swif_pipelined_encoder_release(penc), SWIF_STATUS_OK)
+    for (esi_t esi = next_released; esi < NB_SOURCE; esi++)
+        free(buf_tab[esi]);
+    swif_encoder_release(enc);
+}
+
+void test_swif_pipelined_encoder(void) {
+    run_pipeline(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, false);
+    run_pipeline(SWIF_CODEPOINT_RLC_GF_16_CODEC, false);
+    run_pipeline(SWIF_CODEPOINT_RLC_GF_2_CODEC, false);
+}
+
+void test_swif_pipelined_encoder_variable_length(void) {
+    run_pipeline(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, true);
+    run_pipeline(SWIF_CODEPOINT_RLC_GF_16_CODEC, true);
+    run_pipeline(SWIF_CODEPOINT_RLC_GF_2_CODEC, true);
+}
+
+void test_swif_pipelined_encoder_errors(void) {
+    swif_pipelined_encoder_t *penc;
+    uint32_t one = 1;
+
+    CU_ASSERT_PTR_NULL(swif_pipelined_encoder_create(SWIF_CODEPOINT_NULL, 0, SYMBOL_SIZE, WINDOW_SIZE, QUEUE_SIZE))
+    CU_ASSERT_PTR_NULL(swif_pipelined_encoder_create(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 0, SYMBOL_SIZE, 0, QUEUE_SIZE))
+    penc = swif_pipelined_encoder_create(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 0, SYMBOL_SIZE, WINDOW_SIZE, QUEUE_SIZE);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(penc)
+    /* nothing to encode */
+    CU_ASSERT_EQUAL(swif_pipelined_encoder_build_repair_symbol(penc, 1, NULL), SWIF_STATUS_ERROR)
+    CU_ASSERT_EQUAL(swif_pipelined_encoder_get_errno(penc), SWIF_ERRNO_EMPTY_REPAIR_WINDOW)
+    CU_ASSERT_EQUAL(swif_pipelined_encoder_set_parameters(penc, swif_ENCODER_SET_PARAM_LAYERS, 0, NULL), SWIF_STATUS_ERROR)
+    CU_ASSERT_EQUAL(swif_pipelined_encoder_get_errno(penc), SWIF_ERRNO_UNSUPPORTED_PARAMETER)
+    CU_ASSERT_EQUAL(swif_pipelined_encoder_add_source_symbol(penc, src[5], 5), SWIF_STATUS_OK)
+    CU_ASSERT_EQUAL(swif_pipelined_encoder_add_source_symbol(penc, src[7], 7), SWIF_STATUS_ERROR)
+    /* the repair symbol not polled is freed */
+    CU_ASSERT_EQUAL(swif_pipelined_encoder_build_repair_symbol(penc, 1, NULL), SWIF_STATUS_OK)
+    CU_ASSERT_EQUAL(swif_pipelined_encoder_release(penc), SWIF_STATUS_OK)
+
+    /* length prefix beyond symbol_size */
+    penc = swif_pipelined_encoder_create(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 0, SYMBOL_SIZE, WINDOW_SIZE, QUEUE_SIZE);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(penc)
+    CU_ASSERT_EQUAL(swif_pipelined_encoder_set_parameters(penc, swif_ENCODER_SET_PARAM_VARIABLE_LENGTH_SYMBOLS,
+                                                          sizeof(one), &one), SWIF_STATUS_OK)
+    swif_set_symbol_length_prefix(src[0], SYMBOL_SIZE - 1);
+    CU_ASSERT_EQUAL(swif_pipelined_encoder_add_source_symbol(penc, src[0], 0), SWIF_STATUS_ERROR)
+    CU_ASSERT_EQUAL(swif_pipelined_encoder_get_errno(penc), SWIF_ERRNO_INVALID_SYMBOL_LENGTH)
+    CU_ASSERT_EQUAL(swif_pipelined_encoder_release(penc), SWIF_STATUS_OK)
+}
+
+
+/* The main() function for setting up and running the tests.
+ * Returns a CUE_SUCCESS on successful running, another
+ * CUnit error code on failure.
+ */
+int main()
+{
+
+    CU_pSuite pSuite = NULL;
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Suite_1", NULL, NULL);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "test of the pipelined encoder", test_swif_pipelined_encoder)) ||
+        (NULL == CU_add_test(pSuite, "test of the pipelined encoder with variable-length symbols", test_swif_pipelined_encoder_variable_length)) ||
+        (NULL == CU_add_test(pSuite, "test of pipelined encoder errors", test_swif_pipelined_encoder_errors)))
+    {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
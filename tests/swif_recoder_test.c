@@ -0,0 +1,168 @@
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "../src/swif_api.h"
+#include "../src/swif_recoder.h"
+
+#define VERBOSITY	0
+#define SYMBOL_SIZE	256
+#define WINDOW_SIZE	12
+#define NB_SOURCE	300
+
+static uint8_t	src[NB_SOURCE][SYMBOL_SIZE];
+static bool	received[NB_SOURCE];
+static uint32_t	nb_decoded;
+static uint32_t	nb_bad;
+
+static void decoded_callback(void *context, void *new_symbol_buf, esi_t esi) {
+    if (esi >= NB_SOURCE || memcmp(new_symbol_buf, src[esi], SYMBOL_SIZE) != 0) {
+        nb_bad++;
+    } else if (!received[esi]) {
+        received[esi] = true;
+        nb_decoded++;
+    }
+    free(new_symbol_buf);
+}
+
+/*
+ * encoder -> 20% losses -> relay (recoder) -> 20% losses -> decoder.
+ * The relay forwards the source symbols it gets, and sends a recoded
+ * repair symbol after each one instead of the upstream ones, received
+ * every 2 source symbols.
+ * Returns the number of source symbols lost on the way.
+ */
+static uint32_t run_relay(swif_codepoint_t codepoint) {
+    uint32_t nb_lost = 0;
+    swif_encoder_t *enc = swif_encoder_create(codepoint, VERBOSITY, SYMBOL_SIZE, WINDOW_SIZE);
+    swif_recoder_t *rec = swif_recoder_create(codepoint, VERBOSITY, SYMBOL_SIZE, 2 * WINDOW_SIZE);
+    swif_decoder_t *dec = swif_decoder_create(codepoint, VERBOSITY, SYMBOL_SIZE, 2 * WINDOW_SIZE, 4 * WINDOW_SIZE);
+    uint8_t repair[SYMBOL_SIZE];
+    uint8_t coefs[2 * WINDOW_SIZE];
+    CU_ASSERT_PTR_NOT_NULL_FATAL(enc)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(rec)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(dec)
+    CU_ASSERT_EQUAL(swif_decoder_set_callback_functions(dec, NULL, NULL, decoded_callback, NULL), SWIF_STATUS_OK)
+    srand(1);
+    memset(received, 0, sizeof(received));
+    nb_decoded = nb_bad = 0;
+    for (esi_t esi = 0; esi < NB_SOURCE; esi++) {
+        esi_t first;
+        uint32_t nb_coefs;
+        for (uint32_t i = 0; i < SYMBOL_SIZE; i++)
+            src[esi][i] = (uint8_t)rand();
+        swif_encoder_add_source_symbol_to_coding_window(enc, src[esi], esi);
+        if (rand() % 5 != 0) {
+            swif_recoder_add_source_symbol(rec, src[esi], esi);
+            if (rand() % 5 != 0) {
+                received[esi] = true;
+                swif_decoder_decode_with_new_source_symbol(dec, src[esi], esi);
+            }
+        }
+        if (!received[esi])
+            nb_lost++;
+        if (esi % 2 == 1) {
+            /* upstream repair symbol */
+            void *up = NULL, *up_coefs;
+            esi_t last;
+            uint32_t nss;
+            swif_encoder_generate_coding_coefs(enc, esi, 0);
+            CU_ASSERT_EQUAL(swif_build_repair_symbol(enc, &up), SWIF_STATUS_OK)
+            swif_encoder_get_coding_window_information(enc, &first, &last, &nss);
+            swif_encoder_get_coding_coefs_tab(enc, &up_coefs, &nb_coefs);
+            if (rand() % 5 != 0) {
+                CU_ASSERT_EQUAL(swif_recoder_add_repair_symbol(rec, up, first, up_coefs, nb_coefs), SWIF_STATUS_OK)
+            }
+            free(up);
+        }
+        /* downstream recoded repair symbol */
+        if (swif_recoder_build_repair_symbol(rec, esi, repair, coefs, &first, &nb_coefs) == SWIF_STATUS_OK
+            && rand() % 5 != 0) {
+            CU_ASSERT(nb_coefs > 0 && nb_coefs <= 2 * WINDOW_SIZE)
+            swif_decoder_reset_coding_window(dec);
+            for (esi_t e = first; e < first + nb_coefs; e++)
+                swif_decoder_add_source_symbol_to_coding_window(dec, e);
+            swif_decoder_set_coding_coefs_tab(dec, coefs, nb_coefs);
+            swif_decoder_decode_with_new_repair_symbol(dec, repair, first);
+        }
+    }
+    swif_encoder_release(enc);
+    swif_recoder_release(rec);
+    swif_decoder_release(dec);
+    return nb_lost;
+}
+
+void test_swif_recoder_relay(void) {
+    uint32_t nb_lost = run_relay(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    /* most losses, on either link, are recovered */
+    CU_ASSERT(nb_decoded > 0 && 10 * nb_decoded >= 9 * nb_lost)
+    nb_lost = run_relay(SWIF_CODEPOINT_RLC_GF_16_CODEC);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT(nb_decoded > 0 && 10 * nb_decoded >= 9 * nb_lost)
+    nb_lost = run_relay(SWIF_CODEPOINT_RLC_GF_2_CODEC);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT(nb_decoded > 0)
+}
+
+void test_swif_recoder_rank(void) {
+    swif_recoder_t *rec = swif_recoder_create(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC,
+                                              VERBOSITY, SYMBOL_SIZE, WINDOW_SIZE);
+    uint8_t repair[SYMBOL_SIZE];
+    uint8_t coefs[WINDOW_SIZE];
+    esi_t first;
+    uint32_t nb_coefs;
+    CU_ASSERT_PTR_NOT_NULL_FATAL(rec)
+    CU_ASSERT_PTR_NULL(swif_recoder_create(SWIF_CODEPOINT_NULL, VERBOSITY, SYMBOL_SIZE, WINDOW_SIZE))
+    CU_ASSERT_EQUAL(swif_recoder_build_repair_symbol(rec, 1, repair, coefs, &first, &nb_coefs), SWIF_STATUS_FAILURE)
+    for (esi_t esi = 0; esi < 4; esi++)
+        swif_recoder_add_source_symbol(rec, src[esi], esi);
+    CU_ASSERT_EQUAL(swif_recoder_get_rank(rec), 4)
+    /* a combination of what is held is not innovative */
+    CU_ASSERT_EQUAL(swif_recoder_build_repair_symbol(rec, 1, repair, coefs, &first, &nb_coefs), SWIF_STATUS_OK)
+    CU_ASSERT(first + nb_coefs <= 4)
+    swif_recoder_add_repair_symbol(rec, repair, first, coefs, nb_coefs);
+    swif_recoder_add_source_symbol(rec, src[2], 2);
+    CU_ASSERT_EQUAL(swif_recoder_get_rank(rec), 4)
+    /* old source symbols leave the linear system */
+    swif_recoder_add_source_symbol(rec, src[WINDOW_SIZE + 1], WINDOW_SIZE + 1);
+    CU_ASSERT_EQUAL(swif_recoder_get_rank(rec), 3)
+    swif_recoder_release(rec);
+}
+
+
+/* The main() function for setting up and running the tests.
+ * Returns a CUE_SUCCESS on successful running, another
+ * CUnit error code on failure.
+ */
+int main()
+{
+
+    CU_pSuite pSuite = NULL;
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Suite_1", NULL, NULL);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "test of recoding at a relay", test_swif_recoder_relay)) ||
+        (NULL == CU_add_test(pSuite, "test of the recoder rank", test_swif_recoder_rank)))
+    {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,295 @@
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "../src/swif_api.h"
+
+#define VERBOSITY	0
+#define SYMBOL_SIZE	256
+#define WINDOW_SIZE	16
+#define NB_SOURCE	400
+
+static uint8_t	src[NB_SOURCE][SYMBOL_SIZE];
+static bool	received[NB_SOURCE];
+static uint32_t	nb_decoded;
+static uint32_t	nb_bad;
+static esi_t	first_esi;	/* esi of src[0] */
+static uint32_t	nb_removed;
+static esi_t	last_removed;
+static uint32_t	nb_bad_removed;
+
+/* source symbols leave the linear system in esi order */
+static void removed_callback(void *context, esi_t esi) {
+    if (nb_removed > 0 && (int32_t)(esi - last_removed) <= 0) {
+        nb_bad_removed++;
+    }
+    last_removed = esi;
+    nb_removed++;
+}
+
+static void decoded_callback(void *context, void *new_symbol_buf, esi_t esi) {
+    esi -= first_esi;
+    if (esi >= NB_SOURCE || memcmp(new_symbol_buf, src[esi], SYMBOL_SIZE) != 0) {
+        nb_bad++;
+    } else if (!received[esi]) {
+        received[esi] = true;
+        nb_decoded++;
+    }
+    free(new_symbol_buf);
+}
+
+/*
+ * Send NB_SOURCE source symbols, one repair symbol every 2 source symbols,
+ * and lose bursts of 4 source symbols every 40. With short_nss, one repair
+ * symbol out of two only covers the last short_nss source symbols. With
+ * explicit_coefs, the encoder coefficients are passed to the decoder as is
+ * instead of being generated again from the repair key. The esi of the
+ * first source symbol is first_esi.
+ * Returns the number of source symbols lost.
+ */
+static uint32_t run_burst_loss(swif_codepoint_t codepoint, uint32_t block_decoding,
+                               uint32_t pivot_policy, uint32_t short_nss,
+                               bool explicit_coefs) {
+    uint32_t nb_lost = 0;
+    swif_encoder_t *enc = swif_encoder_create(codepoint, VERBOSITY, SYMBOL_SIZE, WINDOW_SIZE);
+    swif_decoder_t *dec = swif_decoder_create(codepoint, VERBOSITY, SYMBOL_SIZE, WINDOW_SIZE, 4 * WINDOW_SIZE);
+    CU_ASSERT_PTR_NOT_NULL_FATAL(enc)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(dec)
+    CU_ASSERT_EQUAL(swif_decoder_set_callback_functions(dec, removed_callback, NULL, decoded_callback, NULL), SWIF_STATUS_OK)
+    if (codepoint != SWIF_CODEPOINT_RLC_GF_2_CODEC) {
+        CU_ASSERT_EQUAL(swif_decoder_set_parameters(dec, swif_DECODER_SET_PARAM_BLOCK_DECODING,
+                                                    sizeof(uint32_t), &block_decoding), SWIF_STATUS_OK)
+        CU_ASSERT_EQUAL(swif_decoder_set_parameters(dec, swif_DECODER_SET_PARAM_PIVOT_POLICY,
+                                                    sizeof(uint32_t), &pivot_policy), SWIF_STATUS_OK)
+    }
+    srand(1);
+    memset(received, 0, sizeof(received));
+    nb_decoded = nb_bad = 0;
+    nb_removed = nb_bad_removed = 0;
+    for (esi_t esi = 0; esi < NB_SOURCE; esi++) {
+        for (uint32_t i = 0; i < SYMBOL_SIZE; i++)
+            src[esi][i] = (uint8_t)rand();
+        swif_encoder_add_source_symbol_to_coding_window(enc, src[esi], first_esi + esi);
+        if (esi % 40 >= 10 && esi % 40 < 14) {
+            nb_lost++;
+        } else {
+            received[esi] = true;
+            swif_decoder_decode_with_new_source_symbol(dec, src[esi], first_esi + esi);
+        }
+        if (esi % 2 == 1) {
+            void *repair = NULL;
+            esi_t first, last;
+            uint32_t nss;
+            if (short_nss > 0) {
+                esi_t short_first = first_esi + ((esi + 1 >= short_nss) ? esi + 1 - short_nss : 0);
+                CU_ASSERT_EQUAL(swif_encoder_set_repair_window(enc, short_first,
+                                    (esi % 4 == 1) ? short_nss : 0), SWIF_STATUS_OK)
+            }
+            swif_encoder_generate_coding_coefs(enc, esi, 0);
+            CU_ASSERT_EQUAL(swif_build_repair_symbol(enc, &repair), SWIF_STATUS_OK)
+            swif_encoder_get_coding_window_information(enc, &first, &last, &nss);
+            if (short_nss > 0 && esi % 4 == 1) {
+                CU_ASSERT_EQUAL(last, first_esi + esi)
+                CU_ASSERT_EQUAL(nss, (esi + 1 < short_nss) ? esi + 1 : short_nss)
+            }
+            swif_decoder_reset_coding_window(dec);
+            for (esi_t e = first; e != last + 1; e++)
+                swif_decoder_add_source_symbol_to_coding_window(dec, e);
+            if (explicit_coefs) {
+                void *coefs;
+                uint32_t nb_coefs;
+                CU_ASSERT_EQUAL(swif_encoder_get_coding_coefs_tab(enc, &coefs, &nb_coefs), SWIF_STATUS_OK)
+                CU_ASSERT_EQUAL(nb_coefs, nss)
+                swif_decoder_set_coding_coefs_tab(dec, coefs, nb_coefs);
+            } else {
+                swif_decoder_generate_coding_coefs(dec, esi, 0);
+            }
+            swif_decoder_decode_with_new_repair_symbol(dec, repair, first);
+            free(repair);
+        }
+    }
+    /* once set, the decoding mode can no longer be changed (GF(2): never set) */
+    CU_ASSERT_NOT_EQUAL(swif_decoder_set_parameters(dec, swif_DECODER_SET_PARAM_BLOCK_DECODING,
+                                                    sizeof(uint32_t), &block_decoding), SWIF_STATUS_OK)
+    swif_encoder_release(enc);
+    swif_decoder_release(dec);
+    return nb_lost;
+}
+
+void test_swif_rlc_decoder_incremental(void) {
+    uint32_t nb_lost = run_burst_loss(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 0, SWIF_PIVOT_POLICY_OLDEST_ESI, 0, false);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_decoded, nb_lost)
+}
+
+void test_swif_rlc_decoder_block(void) {
+    uint32_t nb_lost = run_burst_loss(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 1, SWIF_PIVOT_POLICY_OLDEST_ESI, 0, false);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_decoded, nb_lost)
+}
+
+void test_swif_rlc_decoder_gf16(void) {
+    uint32_t nb_lost = run_burst_loss(SWIF_CODEPOINT_RLC_GF_16_CODEC, 0, SWIF_PIVOT_POLICY_OLDEST_ESI, 0, false);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_decoded, nb_lost)
+    nb_lost = run_burst_loss(SWIF_CODEPOINT_RLC_GF_16_CODEC, 1, SWIF_PIVOT_POLICY_OLDEST_ESI, 0, false);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_decoded, nb_lost)
+}
+
+void test_swif_rlc_decoder_min_fill_in(void) {
+    uint32_t nb_lost = run_burst_loss(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 0,
+                                      SWIF_PIVOT_POLICY_MIN_FILL_IN, 0, false);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_decoded, nb_lost)
+}
+
+void test_swif_rlc_decoder_explicit_coefs(void) {
+    uint32_t nb_lost = run_burst_loss(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 0,
+                                      SWIF_PIVOT_POLICY_OLDEST_ESI, 0, true);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_decoded, nb_lost)
+    nb_lost = run_burst_loss(SWIF_CODEPOINT_RLC_GF_16_CODEC, 1, SWIF_PIVOT_POLICY_OLDEST_ESI, 0, true);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_decoded, nb_lost)
+}
+
+/* the number of coefficients comes from the packet: too many is an error */
+void test_swif_rlc_decoder_explicit_coefs_too_many(void) {
+    swif_codepoint_t codepoint_tab[] = { SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC,
+                                         SWIF_CODEPOINT_RLC_GF_16_CODEC,
+                                         SWIF_CODEPOINT_RLC_GF_2_CODEC };
+    uint8_t coefs[WINDOW_SIZE + 1];
+    memset(coefs, 1, sizeof(coefs));
+    for (uint32_t i = 0; i < sizeof(codepoint_tab) / sizeof(codepoint_tab[0]); i++) {
+        swif_decoder_t *dec = swif_decoder_create(codepoint_tab[i], VERBOSITY, SYMBOL_SIZE, WINDOW_SIZE, 4 * WINDOW_SIZE);
+        CU_ASSERT_PTR_NOT_NULL_FATAL(dec)
+        CU_ASSERT_EQUAL(swif_decoder_set_coding_coefs_tab(dec, coefs, WINDOW_SIZE + 1), SWIF_STATUS_ERROR)
+        CU_ASSERT_EQUAL(dec->swif_errno, SWIF_ERRNO_UNSUPPORTED_PARAMETER)
+        CU_ASSERT_EQUAL(swif_decoder_set_coding_coefs_tab(dec, coefs, WINDOW_SIZE), SWIF_STATUS_OK)
+        swif_decoder_release(dec);
+    }
+}
+
+/* GF(2), also across the esi wrap around */
+void test_swif_rlc_decoder_gf2(void) {
+    uint32_t nb_lost = run_burst_loss(SWIF_CODEPOINT_RLC_GF_2_CODEC, 0, SWIF_PIVOT_POLICY_OLDEST_ESI, 0, false);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_decoded, nb_lost)
+    first_esi = (esi_t)(0 - NB_SOURCE / 2);
+    nb_lost = run_burst_loss(SWIF_CODEPOINT_RLC_GF_2_CODEC, 0, SWIF_PIVOT_POLICY_OLDEST_ESI, 0, false);
+    first_esi = 0;
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_decoded, nb_lost)
+}
+
+/* GF(256) and GF(16), incremental and block decoding, across the esi wrap
+ * around */
+void test_swif_rlc_decoder_esi_wrap(void) {
+    swif_codepoint_t codepoint_tab[] = { SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC,
+                                         SWIF_CODEPOINT_RLC_GF_16_CODEC };
+    first_esi = (esi_t)(0 - NB_SOURCE / 2);
+    for (uint32_t i = 0; i < sizeof(codepoint_tab) / sizeof(codepoint_tab[0]); i++) {
+        for (uint32_t block_decoding = 0; block_decoding <= 1; block_decoding++) {
+            uint32_t nb_lost = run_burst_loss(codepoint_tab[i], block_decoding,
+                                              SWIF_PIVOT_POLICY_OLDEST_ESI, 0, false);
+            CU_ASSERT_EQUAL(nb_bad, 0)
+            CU_ASSERT_EQUAL(nb_decoded, nb_lost)
+        }
+    }
+    first_esi = 0;
+}
+
+/* GF(2): the coding window under preparation can lose either end */
+void test_swif_rlc_decoder_gf2_remove_source_symbol(void) {
+    swif_decoder_t *dec = swif_decoder_create(SWIF_CODEPOINT_RLC_GF_2_CODEC, VERBOSITY, SYMBOL_SIZE, WINDOW_SIZE, 4 * WINDOW_SIZE);
+    uint32_t value;
+    CU_ASSERT_PTR_NOT_NULL_FATAL(dec)
+    CU_ASSERT_EQUAL(swif_decoder_get_parameters(dec, swif_DECODER_GET_PARAM_DECODER_STATISTICS,
+                                                sizeof(value), &value), SWIF_STATUS_ERROR)
+    CU_ASSERT_EQUAL(dec->swif_errno, SWIF_ERRNO_UNSUPPORTED_PARAMETER)
+    swif_decoder_reset_coding_window(dec);
+    for (esi_t e = 10; e < 15; e++)
+        CU_ASSERT_EQUAL(swif_decoder_add_source_symbol_to_coding_window(dec, e), SWIF_STATUS_OK)
+    CU_ASSERT_EQUAL(swif_decoder_remove_source_symbol_from_coding_window(dec, 12), SWIF_STATUS_ERROR)
+    CU_ASSERT_EQUAL(swif_decoder_remove_source_symbol_from_coding_window(dec, 10), SWIF_STATUS_OK)
+    CU_ASSERT_EQUAL(swif_decoder_remove_source_symbol_from_coding_window(dec, 14), SWIF_STATUS_OK)
+    /* now 11 to 13 */
+    CU_ASSERT_EQUAL(swif_decoder_add_source_symbol_to_coding_window(dec, 15), SWIF_STATUS_ERROR)
+    CU_ASSERT_EQUAL(swif_decoder_add_source_symbol_to_coding_window(dec, 14), SWIF_STATUS_OK)
+    for (esi_t e = 11; e < 15; e++)
+        CU_ASSERT_EQUAL(swif_decoder_remove_source_symbol_from_coding_window(dec, e), SWIF_STATUS_OK)
+    CU_ASSERT_EQUAL(swif_decoder_remove_source_symbol_from_coding_window(dec, 14), SWIF_STATUS_ERROR)
+    /* empty again: any esi can start it */
+    CU_ASSERT_EQUAL(swif_decoder_add_source_symbol_to_coding_window(dec, 100), SWIF_STATUS_OK)
+    swif_decoder_release(dec);
+}
+
+/* all the codecs report the source symbols that leave the linear system */
+void test_swif_rlc_decoder_removed_callback(void) {
+    swif_codepoint_t codepoint_tab[] = { SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC,
+                                         SWIF_CODEPOINT_RLC_GF_16_CODEC,
+                                         SWIF_CODEPOINT_RLC_GF_2_CODEC };
+    for (uint32_t i = 0; i < sizeof(codepoint_tab) / sizeof(codepoint_tab[0]); i++) {
+        for (uint32_t block_decoding = 0; block_decoding <= 1; block_decoding++) {
+            run_burst_loss(codepoint_tab[i], block_decoding, SWIF_PIVOT_POLICY_OLDEST_ESI, 0, false);
+            /* each one is referred to by its own equation at least */
+            CU_ASSERT_EQUAL(nb_removed, NB_SOURCE - 4 * WINDOW_SIZE)
+            CU_ASSERT_EQUAL(last_removed, NB_SOURCE - 4 * WINDOW_SIZE - 1)
+            CU_ASSERT_EQUAL(nb_bad_removed, 0)
+        }
+    }
+}
+
+void test_swif_rlc_decoder_short_repair_window(void) {
+    uint32_t nb_lost = run_burst_loss(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 0,
+                                      SWIF_PIVOT_POLICY_OLDEST_ESI, 6, false);
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT_EQUAL(nb_decoded, nb_lost)
+}
+
+
+/* The main() function for setting up and running the tests.
+ * Returns a CUE_SUCCESS on successful running, another
+ * CUnit error code on failure.
+ */
+int main()
+{
+
+    CU_pSuite pSuite = NULL;
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Suite_1", NULL, NULL);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "test of incremental decoding with burst losses", test_swif_rlc_decoder_incremental)) ||
+        (NULL == CU_add_test(pSuite, "test of block decoding with burst losses", test_swif_rlc_decoder_block)) ||
+        (NULL == CU_add_test(pSuite, "test of GF(16) decoding with burst losses", test_swif_rlc_decoder_gf16)) ||
+        (NULL == CU_add_test(pSuite, "test of GF(2) decoding with burst losses", test_swif_rlc_decoder_gf2)) ||
+        (NULL == CU_add_test(pSuite, "test of decoding across the esi wrap around", test_swif_rlc_decoder_esi_wrap)) ||
+        (NULL == CU_add_test(pSuite, "test of GF(2) coding window removals", test_swif_rlc_decoder_gf2_remove_source_symbol)) ||
+        (NULL == CU_add_test(pSuite, "test of the removed source symbol callback", test_swif_rlc_decoder_removed_callback)) ||
+        (NULL == CU_add_test(pSuite, "test of minimum fill-in pivoting with burst losses", test_swif_rlc_decoder_min_fill_in)) ||
+        (NULL == CU_add_test(pSuite, "test of decoding with short repair windows", test_swif_rlc_decoder_short_repair_window)) ||
+        (NULL == CU_add_test(pSuite, "test of decoding with explicit coding coefficients", test_swif_rlc_decoder_explicit_coefs)) ||
+        (NULL == CU_add_test(pSuite, "test of too many explicit coding coefficients", test_swif_rlc_decoder_explicit_coefs_too_many)))
+    {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
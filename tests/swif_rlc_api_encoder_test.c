@@ -105,6 +105,108 @@ void test_swif_rlc_encoder_set_coding_coefs_tab_partial_array() {
     release_test_encoder(enc);
 }
 
+void test_swif_rlc_encoder_set_coding_coefs_tab_too_large_array() {
+    swif_encoder_rlc_cb_t *enc = get_test_encoder();
+    uint8_t old_coefs[max_coding_window_size];
+    uint8_t coefs[max_coding_window_size + 1];
+    for (int i = 0  ; i < max_coding_window_size ; i++) {
+        old_coefs[i] = enc->cc_tab[i];
+    }
+    generate_coefs(coefs, max_coding_window_size + 1);
+    CU_ASSERT_EQUAL(swif_encoder_set_coding_coefs_tab((swif_encoder_t *) enc, coefs, max_coding_window_size+1), SWIF_STATUS_ERROR)
+    CU_ASSERT_EQUAL(((swif_encoder_t *) enc)->swif_errno, SWIF_ERRNO_UNSUPPORTED_PARAMETER)
+    // verify that it didn't change anything
+    for (int i = 0  ; i < max_coding_window_size ; i++)
+        CU_ASSERT_EQUAL(enc->cc_tab[i], old_coefs[i])
+    release_test_encoder(enc);
+}
+
+void test_swif_rlc_encoder_layers() {
+    swif_encoder_rlc_cb_t *enc = get_test_encoder();
+    swif_encoder_layer_t layers[2] = { { 3, 1 }, { max_coding_window_size, 4 } };
+    uint8_t src[max_coding_window_size + 2][SYMBOL_SIZE];
+    uint32_t key_tab[2] = { 11, 22 };
+    void *layer_buf[2] = { NULL, NULL };
+    void *buf = NULL;
+    uint32_t due;
+
+    CU_ASSERT_EQUAL(swif_encoder_set_parameters((swif_encoder_t *) enc, swif_ENCODER_SET_PARAM_LAYERS,
+                                                sizeof(layers), layers), SWIF_STATUS_OK)
+    for (esi_t esi = 0; esi < max_coding_window_size + 2; esi++) {
+        for (int i = 0; i < SYMBOL_SIZE; i++)
+            src[esi][i] = (uint8_t)(esi * 7 + i);
+        swif_encoder_add_source_symbol_to_coding_window((swif_encoder_t *) enc, src[esi], esi);
+        CU_ASSERT_EQUAL(swif_encoder_get_parameters((swif_encoder_t *) enc, swif_ENCODER_GET_PARAM_DUE_LAYERS,
+                                                    sizeof(due), &due), SWIF_STATUS_OK)
+        CU_ASSERT_EQUAL(due, ((esi + 1) % 4 == 0) ? 3 : 1)
+    }
+    /* each layer repair symbol is the one of a single window covering
+     * the same source symbols */
+    CU_ASSERT_EQUAL(swif_build_layer_repair_symbols((swif_encoder_t *) enc, 3, key_tab, layer_buf), SWIF_STATUS_OK)
+    for (int l = 0; l < 2; l++) {
+        esi_t last = max_coding_window_size + 1;
+        swif_encoder_set_repair_window((swif_encoder_t *) enc, last + 1 - layers[l].window_size, layers[l].window_size);
+        swif_encoder_generate_coding_coefs((swif_encoder_t *) enc, key_tab[l], 0);
+        swif_build_repair_symbol((swif_encoder_t *) enc, &buf);
+        CU_ASSERT_EQUAL(memcmp(buf, layer_buf[l], SYMBOL_SIZE), 0)
+        free(layer_buf[l]);
+    }
+    CU_ASSERT_NOT_EQUAL(swif_build_layer_repair_symbols((swif_encoder_t *) enc, 4, key_tab, layer_buf), SWIF_STATUS_OK)
+    free(buf);
+    release_test_encoder(enc);
+}
+
+
+/* a repair window range that has left the coding window gives no repair symbol */
+void test_swif_rlc_encoder_repair_window_left() {
+    swif_encoder_rlc_cb_t *enc = get_test_encoder();
+    swif_encoder_t *generic_enc = (swif_encoder_t *) enc;
+    uint8_t src[max_coding_window_size + 3][SYMBOL_SIZE];
+    void *buf = NULL;
+    void *coefs;
+    esi_t first = 1234, last = 5678;
+    uint32_t nss;
+
+    memset(src, 1, sizeof(src));
+    for (esi_t esi = 0; esi < max_coding_window_size; esi++)
+        swif_encoder_add_source_symbol_to_coding_window(generic_enc, src[esi], esi);
+    CU_ASSERT_EQUAL(swif_encoder_set_repair_window(generic_enc, 1, 3), SWIF_STATUS_OK)
+    /* 0 and 1 leave the coding window: 2 and 3 remain */
+    for (esi_t esi = max_coding_window_size; esi < max_coding_window_size + 2; esi++)
+        swif_encoder_add_source_symbol_to_coding_window(generic_enc, src[esi], esi);
+    CU_ASSERT_EQUAL(swif_encoder_get_coding_window_information(generic_enc, &first, &last, &nss), SWIF_STATUS_OK)
+    CU_ASSERT_EQUAL(first, 2)
+    CU_ASSERT_EQUAL(last, 3)
+    CU_ASSERT_EQUAL(nss, 2)
+    /* then 2 and 3 leave it */
+    swif_encoder_add_source_symbol_to_coding_window(generic_enc, src[max_coding_window_size + 2], max_coding_window_size + 2);
+    swif_encoder_add_source_symbol_to_coding_window(generic_enc, src[0], max_coding_window_size + 3);
+    first = 1234;
+    last = 5678;
+    CU_ASSERT_EQUAL(swif_encoder_get_coding_window_information(generic_enc, &first, &last, &nss), SWIF_STATUS_FAILURE)
+    CU_ASSERT_EQUAL(generic_enc->swif_errno, SWIF_ERRNO_EMPTY_REPAIR_WINDOW)
+    CU_ASSERT_EQUAL(nss, 0)
+    CU_ASSERT_EQUAL(first, 1234)
+    CU_ASSERT_EQUAL(last, 5678)
+    generic_enc->swif_errno = SWIF_ERRNO_NULL;
+    CU_ASSERT_EQUAL(swif_encoder_generate_coding_coefs(generic_enc, 1, 0), SWIF_STATUS_FAILURE)
+    CU_ASSERT_EQUAL(generic_enc->swif_errno, SWIF_ERRNO_EMPTY_REPAIR_WINDOW)
+    CU_ASSERT_EQUAL(swif_encoder_get_coding_coefs_tab(generic_enc, &coefs, &nss), SWIF_STATUS_FAILURE)
+    generic_enc->swif_errno = SWIF_ERRNO_NULL;
+    CU_ASSERT_EQUAL(swif_build_repair_symbol(generic_enc, &buf), SWIF_STATUS_FAILURE)
+    CU_ASSERT_EQUAL(generic_enc->swif_errno, SWIF_ERRNO_EMPTY_REPAIR_WINDOW)
+    CU_ASSERT_PTR_NULL(buf)
+    /* the whole coding window again */
+    CU_ASSERT_EQUAL(swif_encoder_set_repair_window(generic_enc, 0, 0), SWIF_STATUS_OK)
+    CU_ASSERT_EQUAL(swif_encoder_get_coding_window_information(generic_enc, &first, &last, &nss), SWIF_STATUS_OK)
+    CU_ASSERT_EQUAL(first, 4)
+    CU_ASSERT_EQUAL(nss, max_coding_window_size)
+    CU_ASSERT_EQUAL(swif_encoder_generate_coding_coefs(generic_enc, 1, 0), SWIF_STATUS_OK)
+    CU_ASSERT_EQUAL(swif_build_repair_symbol(generic_enc, &buf), SWIF_STATUS_OK)
+    free(buf);
+    release_test_encoder(enc);
+}
+
 
 /* The main() function for setting up and running the tests.
  * Returns a CUE_SUCCESS on successful running, another
@@ -132,7 +234,10 @@ int main()
     if ((NULL == CU_add_test(pSuite, "test of swif_rlc_encoder_create ()", test_swif_rlc_encoder)) ||
         (NULL == CU_add_test(pSuite, "test of swif_rlc_encoder_set_coding_coefs_tab () with a an array of size max", test_swif_rlc_encoder_set_coding_coefs_tab_full_window)) ||
         (NULL == CU_add_test(pSuite, "test of swif_rlc_encoder_set_coding_coefs_tab () with a an array of size 0", test_swif_rlc_encoder_set_coding_coefs_tab_empty_array)) ||
-        (NULL == CU_add_test(pSuite, "test of swif_rlc_encoder_set_coding_coefs_tab () with a an array of size max-1", test_swif_rlc_encoder_set_coding_coefs_tab_partial_array)))
+        (NULL == CU_add_test(pSuite, "test of swif_rlc_encoder_set_coding_coefs_tab () with a an array of size max-1", test_swif_rlc_encoder_set_coding_coefs_tab_partial_array)) ||
+        (NULL == CU_add_test(pSuite, "test of swif_rlc_encoder_set_coding_coefs_tab () with a an array of size max+1", test_swif_rlc_encoder_set_coding_coefs_tab_too_large_array)) ||
+        (NULL == CU_add_test(pSuite, "test of multi-layer repair symbols", test_swif_rlc_encoder_layers)) ||
+        (NULL == CU_add_test(pSuite, "test of a repair window that has left the coding window", test_swif_rlc_encoder_repair_window_left)))
     {
         CU_cleanup_registry();
         return CU_get_error();
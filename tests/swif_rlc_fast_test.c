@@ -0,0 +1,116 @@
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "../src/swif_api.h"
+#include "../src/swif_rlc_fast.h"
+
+#define SYMBOL_SIZE	1400	/* with fixed-size kernels */
+#define WINDOW_SIZE	10
+#define NB_SOURCE	300
+
+static uint8_t	src[NB_SOURCE][SYMBOL_SIZE];
+static uint32_t	nb_decoded;
+static uint32_t	nb_bad;
+
+static void decoded_callback(void *context, void *new_symbol_buf, esi_t esi) {
+    if (esi >= NB_SOURCE || memcmp(new_symbol_buf, src[esi], SYMBOL_SIZE) != 0)
+        nb_bad++;
+    nb_decoded++;
+    free(new_symbol_buf);
+}
+
+/*
+ * Encode with the fast path and with swif_api.h: same repair symbols.
+ * Decode them, with 20% losses, with the fast path.
+ */
+static void run_fast(swif_codepoint_t codepoint) {
+    swif_encoder_t *enc = swif_encoder_create(codepoint, 0, SYMBOL_SIZE, WINDOW_SIZE);
+    swif_encoder_t *ref = swif_encoder_create(codepoint, 0, SYMBOL_SIZE, WINDOW_SIZE);
+    swif_decoder_t *dec = swif_decoder_create(codepoint, 0, SYMBOL_SIZE, WINDOW_SIZE, 4 * WINDOW_SIZE);
+    uint8_t repair[SYMBOL_SIZE], ref_repair[SYMBOL_SIZE];
+    uint32_t nb_lost = 0, nb_diff = 0;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(enc)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(ref)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(dec)
+    CU_ASSERT_EQUAL(swif_decoder_set_callback_functions(dec, NULL, NULL, decoded_callback, NULL), SWIF_STATUS_OK)
+    nb_decoded = nb_bad = 0;
+    srand(6);
+    for (esi_t esi = 0; esi < NB_SOURCE; esi++) {
+        for (uint32_t i = 0; i < SYMBOL_SIZE; i++)
+            src[esi][i] = (uint8_t)rand();
+        CU_ASSERT_EQUAL(swif_fast_encoder_add_source_symbol_to_coding_window(enc, src[esi], esi), SWIF_STATUS_OK)
+        swif_encoder_add_source_symbol_to_coding_window(ref, src[esi], esi);
+        if (rand() % 5 == 0) {
+            nb_lost++;
+        } else {
+            CU_ASSERT_EQUAL(swif_fast_decoder_decode_with_new_source_symbol(dec, src[esi], esi), SWIF_STATUS_OK)
+        }
+        if (esi % 3 == 2) {
+            void *p = repair, *ref_p = ref_repair;
+            esi_t first, last;
+            uint32_t nss;
+            CU_ASSERT_EQUAL(swif_fast_encoder_generate_coding_coefs(enc, esi, 0), SWIF_STATUS_OK)
+            swif_encoder_generate_coding_coefs(ref, esi, 0);
+            CU_ASSERT_EQUAL(swif_fast_build_repair_symbol(enc, &p), SWIF_STATUS_OK)
+            swif_build_repair_symbol(ref, &ref_p);
+            if (memcmp(repair, ref_repair, SYMBOL_SIZE) != 0)
+                nb_diff++;
+            CU_ASSERT_EQUAL(swif_fast_encoder_get_coding_window_information(enc, &first, &last, &nss), SWIF_STATUS_OK)
+            CU_ASSERT_EQUAL(swif_fast_decoder_reset_coding_window(dec), SWIF_STATUS_OK)
+            for (esi_t e = first; e <= last; e++)
+                swif_fast_decoder_add_source_symbol_to_coding_window(dec, e);
+            CU_ASSERT_EQUAL(swif_fast_decoder_generate_coding_coefs(dec, esi, 0), SWIF_STATUS_OK)
+            CU_ASSERT_EQUAL(swif_fast_decoder_decode_with_new_repair_symbol(dec, repair, first), SWIF_STATUS_OK)
+        }
+    }
+    CU_ASSERT_EQUAL(nb_diff, 0)
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT(nb_lost > 0 && nb_decoded > 0)
+    swif_encoder_release(enc);
+    swif_encoder_release(ref);
+    swif_decoder_release(dec);
+}
+
+void test_swif_rlc_fast(void) {
+    run_fast(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC);
+    run_fast(SWIF_CODEPOINT_RLC_GF_16_CODEC);
+    run_fast(SWIF_CODEPOINT_RLC_GF_2_CODEC);
+}
+
+
+/* The main() function for setting up and running the tests.
+ * Returns a CUE_SUCCESS on successful running, another
+ * CUnit error code on failure.
+ */
+int main()
+{
+
+    CU_pSuite pSuite = NULL;
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Suite_1", NULL, NULL);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if (NULL == CU_add_test(pSuite, "test of the direct fast path", test_swif_rlc_fast))
+    {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,130 @@
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "../src/swif_simulator.h"
+
+static swif_sim_results_t results;
+
+static void init_params(swif_sim_params_t *params, swif_codepoint_t codepoint) {
+    memset(params, 0, sizeof(*params));
+    params->codepoint = codepoint;
+    params->symbol_size = 200;
+    params->max_coding_window_size = 16;
+    params->dt = -1;
+    params->repair_ratio = 0.25;
+    params->nb_source = 40000;
+    params->channel.model = SWIF_CHANNEL_BERNOULLI;
+    params->channel.loss_rate = 0.05;
+    params->seed = 1;
+    params->nb_threads = 4;
+    params->check = true;
+}
+
+static void check_results(const swif_sim_params_t *params) {
+    CU_ASSERT_EQUAL(results.nb_threads, params->nb_threads)
+    CU_ASSERT_EQUAL(results.nb_source, params->nb_source)
+    /* repair_ratio per thread, each one rounding down */
+    CU_ASSERT(results.nb_repair <= params->nb_source / 4 && results.nb_repair + params->nb_threads > params->nb_source / 4)
+    CU_ASSERT(results.nb_source_lost > 0)
+    CU_ASSERT(results.nb_recovered > 0 && results.nb_recovered <= results.nb_source_lost)
+    CU_ASSERT_EQUAL(results.nb_bad, 0)
+    CU_ASSERT(results.residual_loss < (double)results.nb_source_lost / results.nb_source)
+    CU_ASSERT(results.cpu_ns > 0 && results.wall_ns > 0)
+    /* a symbol is decoded thanks to a repair symbol over its coding window */
+    CU_ASSERT(results.delay_max > 0 && results.delay_max < 4 * params->max_coding_window_size)
+    CU_ASSERT(swif_sim_get_delay_percentile(&results, 50) <= swif_sim_get_delay_percentile(&results, 99))
+    CU_ASSERT(swif_sim_get_delay_percentile(&results, 100) == results.delay_max)
+    CU_ASSERT(results.delay_mean <= results.delay_max)
+}
+
+void test_swif_sim_bernoulli(void) {
+    swif_sim_params_t params;
+    swif_sim_results_t first;
+
+    init_params(&params, SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC);
+    CU_ASSERT_EQUAL_FATAL(swif_sim_run(&params, &results), SWIF_STATUS_OK)
+    check_results(&params);
+    /* same seed, same results */
+    first = results;
+    CU_ASSERT_EQUAL(swif_sim_run(&params, &results), SWIF_STATUS_OK)
+    CU_ASSERT_EQUAL(results.nb_recovered, first.nb_recovered)
+    CU_ASSERT(memcmp(results.delay_hist, first.delay_hist, sizeof(first.delay_hist)) == 0)
+
+    init_params(&params, SWIF_CODEPOINT_RLC_GF_2_CODEC);
+    CU_ASSERT_EQUAL_FATAL(swif_sim_run(&params, &results), SWIF_STATUS_OK)
+    check_results(&params);
+
+    /* no loss */
+    init_params(&params, SWIF_CODEPOINT_RLC_GF_16_CODEC);
+    params.channel.loss_rate = 0;
+    CU_ASSERT_EQUAL(swif_sim_run(&params, &results), SWIF_STATUS_OK)
+    CU_ASSERT_EQUAL(results.nb_source_lost, 0)
+    CU_ASSERT_EQUAL(results.nb_recovered, 0)
+    CU_ASSERT_EQUAL(results.residual_loss, 0)
+}
+
+void test_swif_sim_gilbert_elliott(void) {
+    swif_sim_params_t params;
+
+    init_params(&params, SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC);
+    params.channel.model = SWIF_CHANNEL_GILBERT_ELLIOTT;
+    params.channel.p_good_to_bad = 0.01;
+    params.channel.p_bad_to_good = 0.3;
+    params.channel.loss_bad = 1;
+    params.nb_threads = 3;	/* not a divisor of nb_source */
+    CU_ASSERT_EQUAL_FATAL(swif_sim_run(&params, &results), SWIF_STATUS_OK)
+    check_results(&params);
+}
+
+void test_swif_sim_bad_params(void) {
+    swif_sim_params_t params;
+
+    init_params(&params, SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC);
+    params.max_linear_system_size = params.max_coding_window_size - 1;
+    CU_ASSERT_EQUAL(swif_sim_run(&params, &results), SWIF_STATUS_ERROR)
+    init_params(&params, SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC);
+    params.channel.loss_rate = 2;
+    CU_ASSERT_EQUAL(swif_sim_run(&params, &results), SWIF_STATUS_ERROR)
+    init_params(&params, SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC);
+    params.nb_source = 0;
+    CU_ASSERT_EQUAL(swif_sim_run(&params, &results), SWIF_STATUS_ERROR)
+}
+
+
+/* The main() function for setting up and running the tests.
+ * Returns a CUE_SUCCESS on successful running, another
+ * CUnit error code on failure.
+ */
+int main()
+{
+
+    CU_pSuite pSuite = NULL;
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Suite_1", NULL, NULL);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "test of a simulation with Bernoulli losses", test_swif_sim_bernoulli)) ||
+        (NULL == CU_add_test(pSuite, "test of a simulation with Gilbert-Elliott losses", test_swif_sim_gilbert_elliott)) ||
+        (NULL == CU_add_test(pSuite, "test of bad simulation parameters", test_swif_sim_bad_params)))
+    {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
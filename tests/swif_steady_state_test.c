@@ -0,0 +1,207 @@
+/*
+ * Steady state: once warmed up, an encoder and a decoder with a fixed
+ * symbol_size, max_coding_window_size and max_linear_system_size must not
+ * call the heap allocator anymore. malloc() and friends are interposed
+ * (glibc), and a long encode -> lossy channel -> decode session is run.
+ */
+#define _GNU_SOURCE
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+#include "../src/swif_api.h"
+
+#define SYMBOL_SIZE	512
+#define WINDOW_SIZE	16
+#define LS_SIZE		64
+#define NB_SOURCE	20000
+/* the codec memory is reserved at creation: only warm up stdio */
+#define NB_WARMUP	1
+#define NB_BUFS		(2 * LS_SIZE)
+
+/*
+ * Interposed allocator: counts the calls while armed
+ */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+extern void __libc_free(void *ptr);
+
+static volatile bool	armed;
+static volatile uint32_t nb_calls;
+
+void *malloc(size_t size) {
+    if (armed) nb_calls++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t nb, size_t size) {
+    if (armed) nb_calls++;
+    return __libc_calloc(nb, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+    if (armed) nb_calls++;
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) {
+    if (armed && ptr != NULL) nb_calls++;
+    __libc_free(ptr);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size) {
+    if (armed) nb_calls++;
+    *ptr = __libc_memalign(alignment, size);
+    return (*ptr == NULL) ? ENOMEM : 0;
+}
+
+void *aligned_alloc(size_t alignment, size_t size) {
+    if (armed) nb_calls++;
+    return __libc_memalign(alignment, size);
+}
+
+/*
+ * Application buffers, reused: source symbols and decoded symbols by esi,
+ * repair symbols one at a time
+ */
+static uint8_t	src[NB_BUFS][SYMBOL_SIZE];
+static uint8_t	decoded[NB_BUFS][SYMBOL_SIZE];
+static uint8_t	repair_buf[SYMBOL_SIZE];
+static uint32_t	nb_decoded;
+static uint32_t	nb_bad;
+
+static void *decodable_callback(void *context, esi_t esi) {
+    return decoded[esi % NB_BUFS];
+}
+
+static inline uint8_t source_byte(esi_t esi, uint32_t i) {
+    return (uint8_t)(esi * 31 + i * 7 + (i >> 5));
+}
+
+static void decoded_callback(void *context, void *new_symbol_buf, esi_t esi) {
+    uint8_t *p = new_symbol_buf;
+    for (uint32_t i = 0; i < SYMBOL_SIZE; i++) {
+        if (p[i] != source_byte(esi, i)) {
+            nb_bad++;
+            break;
+        }
+    }
+    nb_decoded++;
+}
+
+static void fill_source(esi_t esi) {
+    uint8_t *p = src[esi % NB_BUFS];
+    for (uint32_t i = 0; i < SYMBOL_SIZE; i++)
+        p[i] = source_byte(esi, i);
+}
+
+static void run_session(swif_codepoint_t codepoint, uint32_t block_mode) {
+    swif_encoder_t *enc = swif_encoder_create(codepoint, 0, SYMBOL_SIZE, WINDOW_SIZE);
+    swif_decoder_t *dec = swif_decoder_create(codepoint, 0, SYMBOL_SIZE, WINDOW_SIZE, LS_SIZE);
+    uint32_t nb_lost = 0;
+    bool in_burst = false;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(enc)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(dec)
+    if (block_mode) {
+        CU_ASSERT_EQUAL(swif_decoder_set_parameters(dec, swif_DECODER_SET_PARAM_BLOCK_DECODING, sizeof(block_mode), &block_mode), SWIF_STATUS_OK)
+    }
+    CU_ASSERT_EQUAL(swif_decoder_set_callback_functions(dec, NULL, decodable_callback, decoded_callback, NULL), SWIF_STATUS_OK)
+    nb_decoded = nb_bad = 0;
+    nb_calls = 0;
+    srand(3);
+    for (esi_t esi = 0; esi < NB_SOURCE; esi++) {
+        if (esi == NB_WARMUP) {
+            nb_calls = 0;
+            armed = true;
+        }
+        fill_source(esi);
+        swif_encoder_add_source_symbol_to_coding_window(enc, src[esi % NB_BUFS], esi);
+        /* Gilbert-Elliott like channel: bursts of losses */
+        in_burst = in_burst ? (rand() % 3 != 0) : (rand() % 12 == 0);
+        if (in_burst) {
+            nb_lost++;
+        } else {
+            swif_decoder_decode_with_new_source_symbol(dec, src[esi % NB_BUFS], esi);
+        }
+        if (rand() % 4 == 0) {
+            void *repair = repair_buf;
+            esi_t first, last;
+            uint32_t nss;
+            swif_encoder_generate_coding_coefs(enc, esi, 0);
+            swif_build_repair_symbol(enc, &repair);
+            if (rand() % 8 == 0)
+                continue;	/* lost too */
+            swif_encoder_get_coding_window_information(enc, &first, &last, &nss);
+            swif_decoder_reset_coding_window(dec);
+            for (esi_t e = first; e <= last; e++)
+                swif_decoder_add_source_symbol_to_coding_window(dec, e);
+            swif_decoder_generate_coding_coefs(dec, esi, 0);
+            swif_decoder_decode_with_new_repair_symbol(dec, repair, first);
+        }
+    }
+    armed = false;
+    CU_ASSERT(nb_lost > 0)
+    CU_ASSERT(nb_decoded > 0)
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    if (nb_calls != 0) {
+        fprintf(stderr, "codepoint %d block_mode %u: %u allocator calls after warm-up\n",
+                codepoint, block_mode, nb_calls);
+    }
+    CU_ASSERT_EQUAL(nb_calls, 0)
+    swif_encoder_release(enc);
+    swif_decoder_release(dec);
+}
+
+void test_swif_steady_state(void) {
+    /* check the interposition first */
+    armed = true;
+    nb_calls = 0;
+    void *volatile p = malloc(16);
+    free(p);
+    armed = false;
+    CU_ASSERT_EQUAL_FATAL(nb_calls, 2)
+    run_session(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 0);
+    run_session(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 1);
+    run_session(SWIF_CODEPOINT_RLC_GF_16_CODEC, 0);
+    run_session(SWIF_CODEPOINT_RLC_GF_2_CODEC, 0);
+}
+
+
+/* The main() function for setting up and running the tests.
+ * Returns a CUE_SUCCESS on successful running, another
+ * CUnit error code on failure.
+ */
+int main()
+{
+
+    CU_pSuite pSuite = NULL;
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Suite_1", NULL, NULL);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if (NULL == CU_add_test(pSuite, "test of an allocation-free steady state", test_swif_steady_state))
+    {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,161 @@
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include "../src/swif_api.h"
+#include "../src/swif_stripe_pool.h"
+
+#define NB_THREADS	4
+#define STRIPE_SIZE	1024
+#define SYMBOL_SIZE	(16 * 1024)
+#define WINDOW_SIZE	8
+#define NB_SOURCE	64
+
+static uint8_t	src[NB_SOURCE][SYMBOL_SIZE];
+static bool	received[NB_SOURCE];
+static uint32_t	nb_decoded;
+static uint32_t	nb_bad;
+static uint8_t	count_tab[3 * SYMBOL_SIZE];
+
+static void count_range(void *arg, uint32_t offset, uint32_t size) {
+    uint8_t *tab = arg;
+    for (uint32_t i = offset; i < offset + size; i++)
+        tab[i]++;
+}
+
+static void decoded_callback(void *context, void *new_symbol_buf, esi_t esi) {
+    if (esi >= NB_SOURCE || memcmp(new_symbol_buf, src[esi], SYMBOL_SIZE) != 0) {
+        nb_bad++;
+    } else if (!received[esi]) {
+        received[esi] = true;
+        nb_decoded++;
+    }
+    free(new_symbol_buf);
+}
+
+void test_swif_stripe_pool_run(void) {
+    swif_stripe_pool_t *pool = swif_stripe_pool_create(NB_THREADS, STRIPE_SIZE);
+    uint32_t size_tab[] = { 1, STRIPE_SIZE, 2 * STRIPE_SIZE + 1, SYMBOL_SIZE - 3, 3 * SYMBOL_SIZE };
+    CU_ASSERT_PTR_NOT_NULL_FATAL(pool)
+    CU_ASSERT_PTR_NULL(swif_stripe_pool_create(0, STRIPE_SIZE))
+    /* each byte exactly once, whatever the size */
+    for (uint32_t k = 0; k < sizeof(size_tab) / sizeof(size_tab[0]); k++) {
+        uint32_t nb_bad_bytes = 0;
+        memset(count_tab, 0, sizeof(count_tab));
+        for (uint32_t n = 0; n < 100; n++)
+            swif_stripe_pool_run(pool, count_range, count_tab, size_tab[k]);
+        for (uint32_t i = 0; i < sizeof(count_tab); i++) {
+            if (count_tab[i] != ((i < size_tab[k]) ? 100 : 0))
+                nb_bad_bytes++;
+        }
+        CU_ASSERT_EQUAL(nb_bad_bytes, 0)
+    }
+    swif_stripe_pool_run(NULL, count_range, count_tab, 1);
+    CU_ASSERT_EQUAL(count_tab[0], 101)
+    swif_stripe_pool_release(pool);
+}
+
+/*
+ * Encode with and without the pool: same repair symbols. Decode them,
+ * with 25% losses, with the pool.
+ */
+static void run_striped(swif_codepoint_t codepoint, uint32_t block_mode) {
+    swif_stripe_pool_t *pool = swif_stripe_pool_create(NB_THREADS, STRIPE_SIZE);
+    swif_encoder_t *enc = swif_encoder_create(codepoint, 0, SYMBOL_SIZE, WINDOW_SIZE);
+    swif_encoder_t *ref = swif_encoder_create(codepoint, 0, SYMBOL_SIZE, WINDOW_SIZE);
+    swif_decoder_t *dec = swif_decoder_create(codepoint, 0, SYMBOL_SIZE, WINDOW_SIZE, 4 * WINDOW_SIZE);
+    uint32_t nb_lost = 0, nb_diff = 0;
+    CU_ASSERT_PTR_NOT_NULL_FATAL(pool)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(dec)
+    CU_ASSERT_EQUAL(swif_encoder_set_parameters(enc, swif_ENCODER_SET_PARAM_STRIPE_POOL, sizeof(pool), &pool), SWIF_STATUS_OK)
+    CU_ASSERT_EQUAL(swif_decoder_set_parameters(dec, swif_DECODER_SET_PARAM_STRIPE_POOL, sizeof(pool), &pool), SWIF_STATUS_OK)
+    if (block_mode) {
+        CU_ASSERT_EQUAL(swif_decoder_set_parameters(dec, swif_DECODER_SET_PARAM_BLOCK_DECODING, sizeof(block_mode), &block_mode), SWIF_STATUS_OK)
+    }
+    CU_ASSERT_EQUAL(swif_decoder_set_callback_functions(dec, NULL, NULL, decoded_callback, NULL), SWIF_STATUS_OK)
+    memset(received, 0, sizeof(received));
+    nb_decoded = nb_bad = 0;
+    srand(1);
+    for (esi_t esi = 0; esi < NB_SOURCE; esi++) {
+        for (uint32_t i = 0; i < SYMBOL_SIZE; i++)
+            src[esi][i] = (uint8_t)rand();
+        swif_encoder_add_source_symbol_to_coding_window(enc, src[esi], esi);
+        swif_encoder_add_source_symbol_to_coding_window(ref, src[esi], esi);
+        if (rand() % 4 == 0) {
+            nb_lost++;
+        } else {
+            received[esi] = true;
+            swif_decoder_decode_with_new_source_symbol(dec, src[esi], esi);
+        }
+        if (esi % 2 == 1) {
+            void *repair = NULL, *ref_repair = NULL;
+            esi_t first, last;
+            uint32_t nss;
+            swif_encoder_generate_coding_coefs(enc, esi, 0);
+            swif_encoder_generate_coding_coefs(ref, esi, 0);
+            CU_ASSERT_EQUAL(swif_build_repair_symbol(enc, &repair), SWIF_STATUS_OK)
+            CU_ASSERT_EQUAL(swif_build_repair_symbol(ref, &ref_repair), SWIF_STATUS_OK)
+            if (memcmp(repair, ref_repair, SYMBOL_SIZE) != 0)
+                nb_diff++;
+            swif_encoder_get_coding_window_information(enc, &first, &last, &nss);
+            swif_decoder_reset_coding_window(dec);
+            for (esi_t e = first; e <= last; e++)
+                swif_decoder_add_source_symbol_to_coding_window(dec, e);
+            swif_decoder_generate_coding_coefs(dec, esi, 0);
+            swif_decoder_decode_with_new_repair_symbol(dec, repair, first);
+            free(repair);
+            free(ref_repair);
+        }
+    }
+    CU_ASSERT_EQUAL(nb_diff, 0)
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT(nb_lost > 0 && nb_decoded > 0)
+    swif_encoder_release(enc);
+    swif_encoder_release(ref);
+    swif_decoder_release(dec);
+    swif_stripe_pool_release(pool);
+}
+
+void test_swif_stripe_pool_codec(void) {
+    run_striped(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 0);
+    run_striped(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC, 1);
+    run_striped(SWIF_CODEPOINT_RLC_GF_16_CODEC, 0);
+    run_striped(SWIF_CODEPOINT_RLC_GF_2_CODEC, 0);
+}
+
+
+/* The main() function for setting up and running the tests.
+ * Returns a CUE_SUCCESS on successful running, another
+ * CUnit error code on failure.
+ */
+int main()
+{
+
+    CU_pSuite pSuite = NULL;
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Suite_1", NULL, NULL);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "test of striped operations", test_swif_stripe_pool_run)) ||
+        (NULL == CU_add_test(pSuite, "test of striped encoding and decoding", test_swif_stripe_pool_codec)))
+    {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}
@@ -0,0 +1,280 @@
+#include <CUnit/Basic.h>
+#include <CUnit/CUnit.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "../src/swif_api.h"
+#include "../src/swif_symbol.h"
+#include "../src/swif_linear-code.h"
+
+#define SYMBOL_SIZE	1000	/* not a multiple of SWIF_SYMBOL_ALIGNMENT */
+#define PADDED_SIZE	SWIF_SYMBOL_PADDED_SIZE(SYMBOL_SIZE)
+#define WINDOW_SIZE	10
+#define NB_SOURCE	200
+
+static void	*src[NB_SOURCE];
+static uint32_t	nb_decoded;
+static uint32_t	nb_bad;
+static bool	variable_length;
+
+static bool is_zero(const uint8_t *p, uint32_t size) {
+    for (uint32_t i = 0; i < size; i++) {
+        if (p[i] != 0)
+            return false;
+    }
+    return true;
+}
+
+void test_swif_symbol_buffer_alloc(void) {
+    uint32_t size_tab[] = { 1, 63, 64, 65, SYMBOL_SIZE, 4096 };
+    CU_ASSERT_EQUAL(PADDED_SIZE, 1024)
+    for (uint32_t k = 0; k < sizeof(size_tab) / sizeof(size_tab[0]); k++) {
+        uint8_t *p = swif_symbol_buffer_alloc(size_tab[k]);
+        CU_ASSERT_PTR_NOT_NULL_FATAL(p)
+        CU_ASSERT_EQUAL((uintptr_t)p % SWIF_SYMBOL_ALIGNMENT, 0)
+        CU_ASSERT(SWIF_SYMBOL_PADDED_SIZE(size_tab[k]) % SWIF_SYMBOL_ALIGNMENT == 0)
+        CU_ASSERT(SWIF_SYMBOL_PADDED_SIZE(size_tab[k]) >= size_tab[k])
+        CU_ASSERT(is_zero(p, SWIF_SYMBOL_PADDED_SIZE(size_tab[k])))
+        swif_symbol_buffer_free(p);
+    }
+}
+
+/* the aligned kernels compute the same as the others */
+void test_swif_symbol_buffer_kernels(void) {
+    uint8_t *data = swif_symbol_buffer_alloc(PADDED_SIZE);
+    uint8_t *res = swif_symbol_buffer_alloc(PADDED_SIZE);
+    uint8_t *ref = swif_symbol_buffer_alloc(PADDED_SIZE);
+    uint8_t l_tab[] = { 2, 3 };
+    uint8_t coef_tab[] = { 0, 1, 2, 7, 13 };
+    uint32_t nb_diff = 0;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(data)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(res)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(ref)
+    srand(4);
+    for (uint32_t k = 0; k < sizeof(l_tab) / sizeof(l_tab[0]); k++) {
+        for (uint32_t c = 0; c < sizeof(coef_tab) / sizeof(coef_tab[0]); c++) {
+            for (uint32_t i = 0; i < PADDED_SIZE; i++) {
+                data[i] = (uint8_t)rand();
+                res[i] = ref[i] = (uint8_t)rand();
+            }
+            lc_vector_add_mul(coef_tab[c], data, PADDED_SIZE, l_tab[k], ref);
+            lc_vector_add_mul_aligned(coef_tab[c], data, PADDED_SIZE, l_tab[k], res);
+            nb_diff += (memcmp(res, ref, PADDED_SIZE) != 0);
+            lc_vector_mul(coef_tab[c], data, PADDED_SIZE, l_tab[k], ref);
+            lc_vector_mul_aligned(coef_tab[c], data, PADDED_SIZE, l_tab[k], res);
+            nb_diff += (memcmp(res, ref, PADDED_SIZE) != 0);
+        }
+    }
+    symbol_xor(ref, data, PADDED_SIZE);
+    symbol_xor_aligned(res, data, PADDED_SIZE);
+    nb_diff += (memcmp(res, ref, PADDED_SIZE) != 0);
+    CU_ASSERT_EQUAL(nb_diff, 0)
+    swif_symbol_buffer_free(data);
+    swif_symbol_buffer_free(res);
+    swif_symbol_buffer_free(ref);
+}
+
+static void decoded_callback(void *context, void *new_symbol_buf, esi_t esi) {
+    if (esi >= NB_SOURCE || memcmp(new_symbol_buf, src[esi], SYMBOL_SIZE) != 0)
+        nb_bad++;
+    /* recovered with its length prefix, and zero-padded */
+    else if (variable_length && swif_get_symbol_length(new_symbol_buf) != swif_get_symbol_length(src[esi]))
+        nb_bad++;
+    nb_decoded++;
+    free(new_symbol_buf);
+}
+
+/*
+ * Encode with and without aligned symbols: same repair symbols, with zero
+ * padding. Decode them, with 20% losses.
+ */
+static void run_aligned(swif_codepoint_t codepoint) {
+    swif_encoder_t *enc = swif_encoder_create(codepoint, 0, SYMBOL_SIZE, WINDOW_SIZE);
+    swif_encoder_t *ref = swif_encoder_create(codepoint, 0, SYMBOL_SIZE, WINDOW_SIZE);
+    swif_decoder_t *dec = swif_decoder_create(codepoint, 0, SYMBOL_SIZE, WINDOW_SIZE, 4 * WINDOW_SIZE);
+    void *repair = swif_symbol_buffer_alloc(SYMBOL_SIZE);
+    uint32_t aligned = 1;
+    uint32_t nb_lost = 0, nb_diff = 0;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(enc)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(ref)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(dec)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(repair)
+    CU_ASSERT_EQUAL(swif_encoder_set_parameters(enc, swif_ENCODER_SET_PARAM_ALIGNED_SYMBOLS, sizeof(aligned), &aligned), SWIF_STATUS_OK)
+    /* incompatible with variable-length symbols */
+    CU_ASSERT_EQUAL(swif_encoder_set_parameters(enc, swif_ENCODER_SET_PARAM_VARIABLE_LENGTH_SYMBOLS, sizeof(aligned), &aligned), SWIF_STATUS_ERROR)
+    CU_ASSERT_EQUAL(swif_decoder_set_callback_functions(dec, NULL, NULL, decoded_callback, NULL), SWIF_STATUS_OK)
+    nb_decoded = nb_bad = 0;
+    srand(5);
+    for (esi_t esi = 0; esi < NB_SOURCE; esi++) {
+        src[esi] = swif_symbol_buffer_alloc(SYMBOL_SIZE);
+        CU_ASSERT_PTR_NOT_NULL_FATAL(src[esi])
+        for (uint32_t i = 0; i < SYMBOL_SIZE; i++)
+            ((uint8_t *)src[esi])[i] = (uint8_t)rand();
+        if (esi == 0) {
+            /* misaligned */
+            CU_ASSERT_EQUAL(swif_encoder_add_source_symbol_to_coding_window(enc, (uint8_t *)src[esi] + 1, esi), SWIF_STATUS_ERROR)
+            CU_ASSERT_EQUAL(enc->swif_errno, SWIF_ERRNO_MISALIGNED_SYMBOL_BUFFER)
+        }
+        CU_ASSERT_EQUAL(swif_encoder_add_source_symbol_to_coding_window(enc, src[esi], esi), SWIF_STATUS_OK)
+        swif_encoder_add_source_symbol_to_coding_window(ref, src[esi], esi);
+        if (rand() % 5 == 0) {
+            nb_lost++;
+        } else {
+            swif_decoder_decode_with_new_source_symbol(dec, src[esi], esi);
+        }
+        if (esi % 3 == 2) {
+            void *new_repair = NULL, *ref_repair = NULL;
+            esi_t first, last;
+            uint32_t nss;
+            swif_encoder_generate_coding_coefs(enc, esi, 0);
+            swif_encoder_generate_coding_coefs(ref, esi, 0);
+            CU_ASSERT_EQUAL(swif_build_repair_symbol(enc, &repair), SWIF_STATUS_OK)
+            CU_ASSERT_EQUAL(swif_build_repair_symbol(enc, &new_repair), SWIF_STATUS_OK)
+            CU_ASSERT_EQUAL(swif_build_repair_symbol(ref, &ref_repair), SWIF_STATUS_OK)
+            CU_ASSERT_EQUAL((uintptr_t)new_repair % SWIF_SYMBOL_ALIGNMENT, 0)
+            if (memcmp(repair, ref_repair, SYMBOL_SIZE) != 0
+                || memcmp(new_repair, ref_repair, SYMBOL_SIZE) != 0
+                || !is_zero((uint8_t *)repair + SYMBOL_SIZE, PADDED_SIZE - SYMBOL_SIZE))
+                nb_diff++;
+            swif_encoder_get_coding_window_information(enc, &first, &last, &nss);
+            swif_decoder_reset_coding_window(dec);
+            for (esi_t e = first; e <= last; e++)
+                swif_decoder_add_source_symbol_to_coding_window(dec, e);
+            swif_decoder_generate_coding_coefs(dec, esi, 0);
+            swif_decoder_decode_with_new_repair_symbol(dec, repair, first);
+            free(new_repair);
+            free(ref_repair);
+        }
+    }
+    CU_ASSERT_EQUAL(nb_diff, 0)
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT(nb_lost > 0 && nb_decoded > 0)
+    swif_encoder_release(enc);
+    swif_encoder_release(ref);
+    swif_decoder_release(dec);
+    swif_symbol_buffer_free(repair);
+    for (esi_t esi = 0; esi < NB_SOURCE; esi++)
+        swif_symbol_buffer_free(src[esi]);
+}
+
+void test_swif_symbol_buffer_codec(void) {
+    run_aligned(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC);
+    run_aligned(SWIF_CODEPOINT_RLC_GF_16_CODEC);
+    run_aligned(SWIF_CODEPOINT_RLC_GF_2_CODEC);
+}
+
+/*
+ * Encode length-prefixed source symbols, send only the meaningful bytes
+ * of the repair symbols, and decode them with 20% losses.
+ */
+static void run_variable_length(swif_codepoint_t codepoint) {
+    swif_encoder_t *enc = swif_encoder_create(codepoint, 0, SYMBOL_SIZE, WINDOW_SIZE);
+    swif_decoder_t *dec = swif_decoder_create(codepoint, 0, SYMBOL_SIZE, WINDOW_SIZE, 4 * WINDOW_SIZE);
+    uint8_t received[SYMBOL_SIZE];
+    uint32_t one = 1;
+    uint32_t nb_lost = 0, nb_short = 0;
+
+    CU_ASSERT_PTR_NOT_NULL_FATAL(enc)
+    CU_ASSERT_PTR_NOT_NULL_FATAL(dec)
+    CU_ASSERT_EQUAL(swif_encoder_set_parameters(enc, swif_ENCODER_SET_PARAM_VARIABLE_LENGTH_SYMBOLS, sizeof(one), &one), SWIF_STATUS_OK)
+    CU_ASSERT_EQUAL(swif_decoder_set_parameters(dec, swif_DECODER_SET_PARAM_VARIABLE_LENGTH_SYMBOLS, sizeof(one), &one), SWIF_STATUS_OK)
+    CU_ASSERT_EQUAL(swif_decoder_set_callback_functions(dec, NULL, NULL, decoded_callback, NULL), SWIF_STATUS_OK)
+    variable_length = true;
+    nb_decoded = nb_bad = 0;
+    srand(6);
+    for (esi_t esi = 0; esi < NB_SOURCE; esi++) {
+        /* mostly short symbols, sometimes a full one */
+        uint32_t len = (rand() % 8 == 0) ? SYMBOL_SIZE - SWIF_LENGTH_PREFIX_SIZE : rand() % 100;
+        src[esi] = calloc(1, SYMBOL_SIZE);
+        CU_ASSERT_PTR_NOT_NULL_FATAL(src[esi])
+        swif_set_symbol_length_prefix(src[esi], (uint16_t)len);
+        for (uint32_t i = 0; i < len; i++)
+            ((uint8_t *)src[esi])[SWIF_LENGTH_PREFIX_SIZE + i] = (uint8_t)rand();
+        CU_ASSERT_EQUAL(swif_encoder_add_source_symbol_to_coding_window(enc, src[esi], esi), SWIF_STATUS_OK)
+        if (rand() % 5 == 0) {
+            nb_lost++;
+        } else {
+            swif_decoder_decode_with_new_source_symbol(dec, src[esi], esi);
+        }
+        if (esi % 3 == 2) {
+            void *repair = NULL;
+            esi_t first, last;
+            uint32_t nss, repair_size, max_len = 0;
+            swif_encoder_generate_coding_coefs(enc, esi, 0);
+            CU_ASSERT_EQUAL(swif_build_repair_symbol(enc, &repair), SWIF_STATUS_OK)
+            CU_ASSERT_EQUAL(swif_encoder_get_parameters(enc, swif_ENCODER_GET_PARAM_REPAIR_SYMBOL_SIZE,
+                                                        sizeof(repair_size), &repair_size), SWIF_STATUS_OK)
+            swif_encoder_get_coding_window_information(enc, &first, &last, &nss);
+            for (esi_t e = first; e <= last; e++)
+                if (swif_get_symbol_length(src[e]) > max_len)
+                    max_len = swif_get_symbol_length(src[e]);
+            CU_ASSERT_EQUAL(repair_size, max_len)
+            nb_short += (repair_size < SYMBOL_SIZE);
+            /* only repair_size bytes are received */
+            memset(received, 0xAA, SYMBOL_SIZE);
+            memcpy(received, repair, repair_size);
+            free(repair);
+            swif_decoder_reset_coding_window(dec);
+            CU_ASSERT_EQUAL(swif_decoder_set_parameters(dec, swif_DECODER_SET_PARAM_REPAIR_SYMBOL_SIZE,
+                                                        sizeof(repair_size), &repair_size), SWIF_STATUS_OK)
+            for (esi_t e = first; e <= last; e++)
+                swif_decoder_add_source_symbol_to_coding_window(dec, e);
+            swif_decoder_generate_coding_coefs(dec, esi, 0);
+            swif_decoder_decode_with_new_repair_symbol(dec, received, first);
+        }
+    }
+    CU_ASSERT_EQUAL(nb_bad, 0)
+    CU_ASSERT(nb_lost > 0 && nb_decoded > 0 && nb_short > 0)
+    variable_length = false;
+    swif_encoder_release(enc);
+    swif_decoder_release(dec);
+    for (esi_t esi = 0; esi < NB_SOURCE; esi++)
+        free(src[esi]);
+}
+
+void test_swif_symbol_buffer_variable_length(void) {
+    run_variable_length(SWIF_CODEPOINT_RLC_GF_256_FULL_DENSITY_CODEC);
+    run_variable_length(SWIF_CODEPOINT_RLC_GF_16_CODEC);
+    run_variable_length(SWIF_CODEPOINT_RLC_GF_2_CODEC);
+}
+
+
+/* The main() function for setting up and running the tests.
+ * Returns a CUE_SUCCESS on successful running, another
+ * CUnit error code on failure.
+ */
+int main()
+{
+
+    CU_pSuite pSuite = NULL;
+
+    CU_basic_set_mode(CU_BRM_VERBOSE);
+    /* initialize the CUnit test registry */
+    if (CUE_SUCCESS != CU_initialize_registry())
+        return CU_get_error();
+
+    /* add a suite to the registry */
+    pSuite = CU_add_suite("Suite_1", NULL, NULL);
+    if (NULL == pSuite) {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* add the tests to the suite */
+    if ((NULL == CU_add_test(pSuite, "test of symbol buffer allocation", test_swif_symbol_buffer_alloc)) ||
+        (NULL == CU_add_test(pSuite, "test of the aligned kernels", test_swif_symbol_buffer_kernels)) ||
+        (NULL == CU_add_test(pSuite, "test of encoding with aligned symbols", test_swif_symbol_buffer_codec)) ||
+        (NULL == CU_add_test(pSuite, "test of variable-length symbols with losses", test_swif_symbol_buffer_variable_length)))
+    {
+        CU_cleanup_registry();
+        return CU_get_error();
+    }
+
+    /* Run all tests using the CUnit Basic interface */
+    CU_basic_run_tests();
+    CU_cleanup_registry();
+    return CU_get_error();
+}